@@ -399,9 +399,9 @@ call_stack::push (const symbol_scope& scope)
 
   get_new_frame_index_and_links (new_frame_idx, parent_link, static_link);
 
-  std::shared_ptr<stack_frame>
-  new_frame (stack_frame::create (m_evaluator, scope, new_frame_idx,
-                                  parent_link, static_link));
+  std::shared_ptr<stack_frame> new_frame
+    = stack_frame::create (m_evaluator, scope, new_frame_idx,
+                           parent_link, static_link);
 
   m_cs.push_back (new_frame);
 
@@ -418,10 +418,10 @@ call_stack::push (octave_user_function *fcn,
 
   get_new_frame_index_and_links (new_frame_idx, parent_link, static_link);
 
-  std::shared_ptr<stack_frame>
-  new_frame (stack_frame::create (m_evaluator, fcn, new_frame_idx,
-                                  parent_link, static_link,
-                                  closure_frames));
+  std::shared_ptr<stack_frame> new_frame
+    = stack_frame::create (m_evaluator, fcn, new_frame_idx,
+                           parent_link, static_link,
+                           closure_frames);
 
   m_cs.push_back (new_frame);
 
@@ -439,10 +439,10 @@ call_stack::push (octave_user_function *fcn,
 
   get_new_frame_index_and_links (new_frame_idx, parent_link, static_link);
 
-  std::shared_ptr<stack_frame>
-  new_frame (stack_frame::create (m_evaluator, fcn, new_frame_idx,
-                                  parent_link, static_link, local_vars,
-                                  closure_frames));
+  std::shared_ptr<stack_frame> new_frame
+    = stack_frame::create (m_evaluator, fcn, new_frame_idx,
+                           parent_link, static_link, local_vars,
+                           closure_frames);
 
   m_cs.push_back (new_frame);
 
@@ -458,9 +458,9 @@ call_stack::push (octave_user_script *script)
 
   get_new_frame_index_and_links (new_frame_idx, parent_link, static_link);
 
-  std::shared_ptr<stack_frame>
-  new_frame (stack_frame::create (m_evaluator, script, new_frame_idx,
-                                  parent_link, static_link));
+  std::shared_ptr<stack_frame> new_frame
+    = stack_frame::create (m_evaluator, script, new_frame_idx,
+                           parent_link, static_link);
 
   m_cs.push_back (new_frame);
 
@@ -476,9 +476,9 @@ call_stack::push (octave_function *fcn)
 
   get_new_frame_index_and_links (new_frame_idx, parent_link, static_link);
 
-  std::shared_ptr<stack_frame>
-  new_frame (stack_frame::create (m_evaluator, fcn, new_frame_idx,
-                                  parent_link, static_link));
+  std::shared_ptr<stack_frame> new_frame
+    = stack_frame::create (m_evaluator, fcn, new_frame_idx,
+                           parent_link, static_link);
 
   m_cs.push_back (new_frame);
 
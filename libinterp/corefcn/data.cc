@@ -2613,6 +2613,26 @@ returns the original array @var{A}.
   return do_permute (args, true);
 }
 
+/*
+## Moving singleton dimensions shares the data
+%!test
+%! x = rand (40, 1, 50);
+%! old_state = __array_stats__ (true);
+%! unwind_protect
+%!   s0 = __array_stats__ ();
+%!   y = permute (x, [1, 3, 2]);
+%!   s1 = __array_stats__ ();
+%! unwind_protect_cleanup
+%!   __array_stats__ (old_state);
+%! end_unwind_protect
+%! assert (s1.bytes - s0.bytes < 8000);
+%! assert (y, reshape (x, 40, 50));
+%! assert (ipermute (y, [1, 3, 2]), x);
+%! assert (permute (x, [2, 1, 3]), reshape (x, 1, 40, 50));
+%! assert (permute (x, [3, 1, 2]), reshape (x, 40, 50).');
+%! assert (permute (int8 ([1, 2, 3]), [3, 1, 2]), int8 (cat (3, 1, 2, 3)));
+*/
+
 DEFUN (length, args, ,
        doc: /* -*- texinfo -*-
 @deftypefn {} {@var{n} =} length (@var{A})
@@ -7286,6 +7306,46 @@ ordered lists.
 %! assert (v, [false, false, true, true]);
 %! assert (i, [2, 4, 1, 3]);
 
+## Long vectors and many vectors, sorted serially and in parallel
+%!test
+%! old_n = maxNumCompThreads ();
+%! old_threshold = __parallel_threshold__ (1000);
+%! unwind_protect
+%!   x = [randn(1, 5000), zeros(1, 500), -zeros(1, 500), Inf, -Inf, NaN];
+%!   x(1:2000) = round (x(1:2000));
+%!   x = x(randperm (numel (x)));
+%!   vals = {x, single(x), int8(100*x), uint16(1000*abs (x)), x > 0};
+%!   for n = [1, 4]
+%!     maxNumCompThreads (n);
+%!     for k = 1:numel (vals)
+%!       y = vals{k};
+%!       [v, i] = sort (y);
+%!       assert (v, y(i));
+%!       assert (issorted (v));
+%!       ## Equal elements, including 0 and -0, keep their order.
+%!       assert (all (diff (i)(diff (double (v)) == 0) > 0));
+%!       assert (sort (y), v);
+%!       [v, i] = sort (y, "descend");
+%!       assert (v, y(i));
+%!       assert (issorted (fliplr (v(! isnan (v)))));
+%!       assert (all (diff (i)(diff (double (v)) == 0) > 0));
+%!     endfor
+%!     assert (sort (x)(end), NaN);
+%!     assert (sort (x, "descend")(1), NaN);
+%!     a = reshape (x(1:6000), 1000, 6);
+%!     [v, i] = sort (a);
+%!     for k = 1:6
+%!       [vk, ik] = sort (a(:,k));
+%!       assert (v(:,k), vk);
+%!       assert (i(:,k), ik);
+%!     endfor
+%!     assert (sort (a', 2), v');
+%!   endfor
+%! unwind_protect_cleanup
+%!   maxNumCompThreads (old_n);
+%!   __parallel_threshold__ (old_threshold);
+%! end_unwind_protect
+
 ## Sparse Double
 %!assert (sort (sparse ([0, NaN, 1, 0, -1, 2, Inf])),
 %!        sparse ([-1, 0, 0, 1, 2, Inf, NaN]))
@@ -30,15 +30,25 @@
 #  include "config.h"
 #endif
 
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
 #include <clocale>
 #include <cmath>
 #include <cctype>
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
+#include <iterator>
 #include <limits>
+#include <vector>
 
 #include "file-ops.h"
 #include "lo-ieee.h"
 #include "lo-sysdep.h"
+#include "mman-wrappers.h"
+#include "oct-parallel.h"
+#include "quit.h"
 
 #include "defun.h"
 #include "interpreter.h"
@@ -167,6 +177,587 @@ parse_range_spec (const octave_value& range_spec,
   return stat;
 }
 
+// Fast reading of files that only contain numbers and empty fields.
+// The file is mapped into memory, or read at once if that is not
+// possible, and split into pieces at line boundaries that are parsed in
+// parallel.  Lines are split into fields exactly as in the general code
+// in Fdlmread below, and the result is the same.  If a field is found
+// that the general code might read differently, for example a complex
+// number or a number followed by text, the file is read again by the
+// general code.
+
+// The contents of a data file in memory.
+
+class dlm_file_data
+{
+public:
+
+  dlm_file_data (const std::string& name)
+    : m_map (nullptr), m_len (0), m_buf ()
+  {
+    // Files are not mapped on Windows, where they are always read
+    // completely into memory.
+#if ! defined (OCTAVE_USE_WINDOWS_API)
+    m_map = static_cast<char *> (octave_mmap_file_wrapper (name.c_str (),
+                                                           &m_len));
+#endif
+
+    if (! m_map)
+      {
+#if defined (OCTAVE_USE_WINDOWS_API)
+        std::wstring wname = octave::sys::u8_to_wstring (name);
+        std::ifstream is (wname.c_str (), std::ios::in | std::ios::binary);
+#else
+        std::ifstream is (name.c_str (), std::ios::in | std::ios::binary);
+#endif
+
+        if (is)
+          m_buf.assign (std::istreambuf_iterator<char> (is),
+                        std::istreambuf_iterator<char> ());
+
+        m_len = m_buf.size ();
+      }
+  }
+
+  OCTAVE_DISABLE_CONSTRUCT_COPY_MOVE (dlm_file_data)
+
+  ~dlm_file_data ()
+  {
+    if (m_map)
+      octave_munmap_wrapper (m_map, m_len);
+  }
+
+  const char * begin () const { return m_map ? m_map : m_buf.data (); }
+
+  const char * end () const { return begin () + m_len; }
+
+private:
+
+  char *m_map;
+  std::size_t m_len;
+  std::vector<char> m_buf;
+};
+
+static inline bool
+dlm_isspace (char c)
+{
+  return (c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f'
+          || c == '\r');
+}
+
+static inline bool
+dlm_isdigit (char c)
+{
+  return c >= '0' && c <= '9';
+}
+
+// Return true if [P, END) matches the (case-insensitive) string WORD.
+
+static bool
+dlm_equal_nocase (const char *p, const char *end, const char *word)
+{
+  for (; p < end && *word; p++, word++)
+    if (std::tolower (static_cast<unsigned char> (*p)) != *word)
+      return false;
+
+  return p == end && ! *word;
+}
+
+// Convert the decimal number [P, END) without a sign to X.  Return
+// false if it is not a complete number or is out of range.
+
+static bool
+dlm_read_decimal (const char *p, const char *end, double& x)
+{
+  // Check the syntax, which std::from_chars and strtod would accept in
+  // more forms than C++ streams do.
+
+  const char *q = p;
+  bool digits = false;
+
+  while (q < end && dlm_isdigit (*q))
+    {
+      q++;
+      digits = true;
+    }
+
+  if (q < end && *q == '.')
+    {
+      q++;
+
+      while (q < end && dlm_isdigit (*q))
+        {
+          q++;
+          digits = true;
+        }
+    }
+
+  if (! digits)
+    return false;
+
+  if (q < end && (*q == 'e' || *q == 'E'))
+    {
+      q++;
+
+      if (q < end && (*q == '+' || *q == '-'))
+        q++;
+
+      if (q == end || ! dlm_isdigit (*q))
+        return false;
+
+      while (q < end && dlm_isdigit (*q))
+        q++;
+    }
+
+  if (q != end)
+    return false;
+
+#if defined (__cpp_lib_to_chars)
+  std::from_chars_result res = std::from_chars (p, end, x);
+
+  if (res.ec != std::errc () || res.ptr != end)
+    return false;
+#else
+  // The locale is "C" while Fdlmread reads the data.
+
+  char buf[64];
+
+  if (end - p >= static_cast<std::ptrdiff_t> (sizeof (buf)))
+    return false;
+
+  std::memcpy (buf, p, end - p);
+  buf[end - p] = '\0';
+
+  errno = 0;
+  x = std::strtod (buf, nullptr);
+
+  if (errno == ERANGE)
+    return false;
+#endif
+
+  // C++ streams might not accept subnormal numbers.
+  if (x != 0 && x < std::numeric_limits<double>::min ())
+    return false;
+
+  return true;
+}
+
+// Read the field [P, END).  Return 1 and set X if it is a number, 0 if
+// the general code would leave it empty, and -1 if it must be read by
+// the general code.
+
+static int
+dlm_read_field (const char *p, const char *end, double& x)
+{
+  while (p < end && dlm_isspace (*p))
+    p++;
+
+  while (end > p && dlm_isspace (end[-1]))
+    end--;
+
+  if (p == end)
+    return 0;
+
+  bool neg = false;
+  const char *q = p;
+
+  if (*q == '+' || *q == '-')
+    {
+      neg = (*q == '-');
+      q++;
+    }
+
+  if (q < end && (dlm_isdigit (*q) || *q == '.'))
+    {
+      if (! dlm_read_decimal (q, end, x))
+        return -1;
+
+      if (neg)
+        x = -x;
+
+      return 1;
+    }
+
+  // Inf, NaN, and NA, which are read by read_value<double>.  A sign
+  // is ignored for NaN and NA.
+
+  if (dlm_equal_nocase (q, end, "inf"))
+    {
+      x = (neg ? -1 : 1) * octave::numeric_limits<double>::Inf ();
+      return 1;
+    }
+  else if (dlm_equal_nocase (q, end, "nan"))
+    {
+      x = octave::numeric_limits<double>::NaN ();
+      return 1;
+    }
+  else if (dlm_equal_nocase (q, end, "na"))
+    {
+      x = octave::numeric_limits<double>::NA ();
+      return 1;
+    }
+
+  // Other text is left empty, unless it could be the beginning of Inf,
+  // NaN, or NA followed by more text, or a sign followed by text.
+
+  if (q != p || dlm_equal_nocase (q, std::min (q + 2, end), "na")
+      || dlm_equal_nocase (q, std::min (q + 3, end), "inf"))
+    return -1;
+
+  return 0;
+}
+
+// A piece of the file that ends at a line boundary.  For each line,
+// FIELDS is the number of fields, or -1 if the line is skipped.
+// FIRST_ROW is the row of the result that the first line fills.
+
+struct dlm_piece
+{
+  const char *begin;
+  const char *end;
+  std::vector<octave_idx_type> fields;
+  octave_idx_type first_row;
+  bool ok;
+};
+
+// Split the line [BEGIN, END) into fields as done by Fdlmread below and
+// call FCN (COL, FIELD_BEGIN, FIELD_END) for each of them.  Return the
+// number of fields, -1 if the line is skipped, or -2 if FCN returns
+// false.
+
+template <typename FCN>
+static octave_idx_type
+dlm_split_line (const char *begin, const char *end, const bool *is_sep,
+                bool auto_sep_is_wspace, bool skip_blank, FCN fcn)
+{
+  const char *p = begin;
+
+  while (p < end && (*p == ' ' || *p == '\t'))
+    p++;
+
+  // Skip blank lines for compatibility.
+  if (p == end && skip_blank)
+    return -1;
+
+  // Skip leading whitespace.
+  if (! auto_sep_is_wspace)
+    p = begin;
+
+  octave_idx_type nfields = 0;
+
+  while (true)
+    {
+      const char *q = p;
+
+      while (q < end && ! is_sep[static_cast<unsigned char> (*q)])
+        q++;
+
+      const char *field_end = q;
+      bool at_end = (q == end);
+
+      if (auto_sep_is_wspace && ! at_end)
+        {
+          // Treat consecutive separators as one.
+          while (q < end && is_sep[static_cast<unsigned char> (*q)])
+            q++;
+
+          q--;
+        }
+
+      // Separator followed by EOL doesn't generate extra column.
+      if (at_end && field_end == p)
+        break;
+
+      if (! fcn (nfields, p, field_end))
+        return -2;
+
+      nfields++;
+
+      if (at_end)
+        break;
+
+      p = q + 1;
+    }
+
+  return nfields;
+}
+
+// Read the numeric file FNAME directly from memory.  Return false if
+// the file must be read by the general code in Fdlmread.
+
+static bool
+dlmread_fast (const std::string& fname, std::string sep, double empty_value,
+              octave_idx_type r0, octave_idx_type c0,
+              octave_idx_type r1, octave_idx_type c1, Matrix& result)
+{
+  dlm_file_data file (fname);
+
+  const char *p = file.begin ();
+  const char *end = file.end ();
+
+  // Strip Byte Order Mark (BOM).
+  if (r0 == 0 && end - p >= 3 && std::memcmp (p, "\xEF\xBB\xBF", 3) == 0)
+    p += 3;
+
+  // Skip the r0 leading lines.
+  for (octave_idx_type rcnt = r0; rcnt > 0; rcnt--)
+    {
+      if (p == end)
+        {
+          result = Matrix (0, 0);
+          return true;
+        }
+
+      const char *nl = static_cast<const char *> (std::memchr (p, '\n',
+                                                               end - p));
+      p = (nl ? nl + 1 : end);
+    }
+
+  r1 -= r0;
+
+  bool sep_is_wspace = (sep.find_first_of (" \t") != std::string::npos);
+  bool auto_sep_is_wspace = false;
+
+  auto line_end = [end] (const char *s)
+  {
+    const char *nl = static_cast<const char *> (std::memchr (s, '\n',
+                                                             end - s));
+    return nl ? nl : end;
+  };
+
+  // Infer separator from the first line that is not blank.
+  if (sep.empty ())
+    {
+      for (const char *s = p; s < end; )
+        {
+          const char *e = line_end (s);
+          const char *pos1 = s;
+
+          while (pos1 < e && (*pos1 == ' ' || *pos1 == '\t'))
+            pos1++;
+
+          if (pos1 < e)
+            {
+              const char *n = pos1;
+
+              while (n < e && ! std::strchr (",:; \t", *n))
+                n++;
+
+              if (n == e || *n == ' ' || *n == '\t')
+                {
+                  sep = " \t";
+                  auto_sep_is_wspace = true;
+                }
+              else
+                sep = *n;
+
+              break;
+            }
+
+          s = e + 1;
+        }
+    }
+
+  bool is_sep[256] = { false };
+  for (unsigned char ch : sep)
+    is_sep[ch] = true;
+
+  bool skip_blank = (! sep_is_wspace || auto_sep_is_wspace);
+
+  // Split the data into pieces that end at line boundaries.
+
+  std::size_t piece_size = 1 << 20;
+  std::vector<dlm_piece> pieces;
+
+  for (const char *s = p; s < end; )
+    {
+      const char *e = (end - s > static_cast<std::ptrdiff_t> (piece_size)
+                       ? line_end (s + piece_size) : end);
+
+      if (e < end)
+        e++;
+
+      pieces.push_back ({s, e, {}, 0, true});
+
+      s = e;
+    }
+
+  auto next_line = [end, line_end] (const char *s, const char *& e)
+  {
+    e = line_end (s);
+
+    const char *next = (e < end ? e + 1 : end);
+
+#if defined (OCTAVE_USE_WINDOWS_API)
+    // The general code reads the file in text mode.
+    if (e > s && e[-1] == '\r')
+      e--;
+#endif
+
+    return next;
+  };
+
+  octave_idx_type npieces = pieces.size ();
+  octave_idx_type batch = 4 * octave::max_num_threads ();
+
+  // Count the fields of each line and the rows and columns as the
+  // general code does.  Stop after the batch of pieces that contains
+  // the last row that is read.
+
+  octave_idx_type i = 0;
+  octave_idx_type j = 0;
+  octave_idx_type r = 1;
+  octave_idx_type c = 1;
+  octave_idx_type max_fields = 0;
+  octave_idx_type nused = 0;
+  bool done = false;
+
+  for (octave_idx_type first = 0; first < npieces && ! done; first += batch)
+    {
+      octave_quit ();
+
+      octave_idx_type last = std::min (first + batch, npieces);
+
+      octave::maybe_parallel_for (last - first,
+                                  [&] (octave_idx_type k0, octave_idx_type k1)
+      {
+        auto count_field = [] (octave_idx_type, const char *, const char *)
+        { return true; };
+
+        for (octave_idx_type k = first + k0; k < first + k1; k++)
+          {
+            dlm_piece& piece = pieces[k];
+
+            for (const char *s = piece.begin; s < piece.end; )
+              {
+                const char *e;
+                const char *next = next_line (s, e);
+
+                piece.fields.push_back
+                  (dlm_split_line (s, e, is_sep, auto_sep_is_wspace,
+                                   skip_blank, count_field));
+
+                s = next;
+              }
+          }
+      }, piece_size);
+
+      for (octave_idx_type k = first; k < last && ! done; k++)
+        {
+          pieces[k].first_row = i;
+          nused = k + 1;
+
+          for (octave_idx_type nf : pieces[k].fields)
+            {
+              if (nf < 0)
+                continue;
+
+              r = std::max (r, i + 1);
+              j = nf;
+              c = std::max (c, j);
+              max_fields = std::max (max_fields, nf);
+
+              if (i == r1)
+                {
+                  done = true;
+                  break;
+                }
+
+              i++;
+            }
+        }
+    }
+
+  // Leave files with only empty lines to the general code.
+  if (max_fields == 0)
+    return false;
+
+  // Clip selection indices to actual size of data
+  if (r1 >= r)
+    r1 = r - 1;
+  if (c1 >= c)
+    c1 = c - 1;
+
+  if ((i == 0 && j == 0) || (c0 > c1))
+    {
+      result = Matrix (0, 0);
+      return true;
+    }
+
+  octave_idx_type nr = r1 + 1;
+  octave_idx_type nc = c1 - c0 + 1;
+
+  result = Matrix (nr, nc, empty_value);
+
+  double *data = result.rwdata ();
+
+  // Read the values of the selected rows directly into RESULT.  Empty
+  // fields keep EMPTY_VALUE.
+
+  for (octave_idx_type first = 0; first < nused; first += batch)
+    {
+      octave_quit ();
+
+      octave_idx_type last = std::min (first + batch, nused);
+
+      octave::maybe_parallel_for (last - first,
+                                  [&] (octave_idx_type k0, octave_idx_type k1)
+      {
+        for (octave_idx_type k = first + k0; k < first + k1; k++)
+          {
+            dlm_piece& piece = pieces[k];
+
+            octave_idx_type row = piece.first_row;
+            const char *s = piece.begin;
+
+            for (octave_idx_type nf : piece.fields)
+              {
+                if (row >= nr)
+                  break;
+
+                const char *e;
+                const char *next = next_line (s, e);
+
+                if (nf >= 0)
+                  {
+                    auto read_field = [=] (octave_idx_type col,
+                                           const char *fb, const char *fe)
+                    {
+                      double x = 0;
+                      int status = dlm_read_field (fb, fe, x);
+
+                      if (status < 0)
+                        return false;
+
+                      if (status > 0 && col >= c0 && col <= c1)
+                        data[row + (col - c0) * nr] = x;
+
+                      return true;
+                    };
+
+                    if (dlm_split_line (s, e, is_sep, auto_sep_is_wspace,
+                                        skip_blank, read_field) < -1)
+                      {
+                        piece.ok = false;
+                        break;
+                      }
+
+                    row++;
+                  }
+
+                s = next;
+              }
+          }
+      }, piece_size);
+
+      for (octave_idx_type k = first; k < last; k++)
+        if (! pieces[k].ok)
+          return false;
+    }
+
+  return true;
+}
+
 OCTAVE_BEGIN_NAMESPACE(octave)
 
 DEFMETHOD (dlmread, interp, args, ,
@@ -221,13 +812,14 @@ such as text, are also replaced by the @qcode{"emptyvalue"}.
 
   std::istream *input = nullptr;
   std::ifstream input_file;
+  std::string tname;
 
   if (args(0).is_string ())
     {
       // Filename.
       std::string fname (args(0).string_value ());
 
-      std::string tname = sys::file_ops::tilde_expand (fname);
+      tname = sys::file_ops::tilde_expand (fname);
 
       tname = find_data_file_in_load_path ("dlmread", tname);
 
@@ -343,6 +935,15 @@ such as text, are also replaced by the @qcode{"emptyvalue"}.
   unwind_action act
   ([old_locale] () { std::setlocale (LC_ALL, old_locale.c_str ()); });
 
+  // Try the fast reader first if a file name was given.
+  if (! tname.empty ())
+    {
+      Matrix result;
+
+      if (dlmread_fast (tname, sep, empty_value, r0, c0, r1, c1, result))
+        return ovl (result);
+    }
+
   std::string line;
 
   // Skip the r0 leading lines
@@ -763,6 +1364,34 @@ such as text, are also replaced by the @qcode{"emptyvalue"}.
 %!   unlink (file);
 %! end_unwind_protect
 
+## Large files are read in pieces, with the same result as from a stream
+%!test
+%! file = tempname ();
+%! unwind_protect
+%!   x = reshape (1:240000, 40000, 6) / 7;
+%!   x(2:7:end,3) = NaN;
+%!   x(5:11:end,5) = -Inf;
+%!   fid = fopen (file, "wt");
+%!   fprintf (fid, "a,b,c,d,e,f\n");
+%!   fprintf (fid, "%.17g,%.17g,%.17g,%.17g,%.17g,%.17g\n", x(1:1000,:).');
+%!   fprintf (fid, "%.17g,%.17g,%.17g,,%.17g\n", x(1001:end,[1,2,3,5]).');
+%!   fprintf (fid, "\n1\n");
+%!   fclose (fid);
+%!
+%!   y = x;
+%!   y(1001:end,4) = -1;
+%!   y(1001:end,6) = -1;
+%!   y(end+1,:) = [1, -1, -1, -1, -1, -1];
+%!   data = dlmread (file, "emptyvalue", -1);
+%!   assert (data, [-1(1,6); y]);
+%!   fid = fopen (file, "rt");
+%!   assert (dlmread (fid, "emptyvalue", -1), data);
+%!   fclose (fid);
+%!   assert (dlmread (file, ",", [20000, 2, 30000, 4]), y(20000:30000,3:5));
+%! unwind_protect_cleanup
+%!   unlink (file);
+%! end_unwind_protect
+
 */
 
 OCTAVE_END_NAMESPACE(octave)
@@ -1122,6 +1122,60 @@ fcn_info::fcn_info_rep::dump () const
   return octave_value (m);
 }
 
+OCTAVE_THREAD_LOCAL std::size_t fcn_lookup_cache::s_generation = 1;
+
+OCTAVE_THREAD_LOCAL bool fcn_lookup_cache::s_enabled = true;
+
+octave_value
+fcn_lookup_cache::find (const std::string& name,
+                        const octave_value_list& args)
+{
+  symbol_scope scope = __get_current_scope__ ();
+
+  std::shared_ptr<void> scope_rep = scope.get_rep ();
+
+  std::string dispatch_type
+    = args.empty () ? "" : get_dispatch_type (args);
+
+  if (s_enabled && m_generation == s_generation
+      && ! m_scope.owner_before (scope_rep)
+      && ! scope_rep.owner_before (m_scope)
+      && dispatch_type == m_dispatch_type)
+    {
+      if (m_fcn_val.is_defined ())
+        return m_fcn_val;
+      else if (m_fcn)
+        return octave_value (m_fcn, true);
+    }
+
+  symbol_table& symtab = __get_symbol_table__ ();
+
+  octave_value fcn = symtab.find_function (name, args, scope);
+
+  clear ();
+
+  if (! s_enabled || ! fcn.is_function ())
+    return fcn;
+
+  // Loading a function file may itself have started a new generation,
+  // so the generation is only read after the search is done.  Functions
+  // loaded from shared libraries, scripts, and anonymous functions are
+  // never cached.
+
+  if (fcn.is_user_function () && ! fcn.is_anonymous_function ())
+    m_fcn = fcn.function_value (true);
+  else if (fcn.is_builtin_function ())
+    m_fcn_val = fcn;
+  else
+    return fcn;
+
+  m_generation = s_generation;
+  m_scope = scope_rep;
+  m_dispatch_type = dispatch_type;
+
+  return fcn;
+}
+
 octave_value
 dump_function_map (const std::map<std::string, octave_value>& fcn_map)
 {
@@ -1222,4 +1276,48 @@ recompiled.
 %!error ignore_function_time_stamp (42)
 */
 
+DEFUN (__fcn_lookup_cache__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn  {} {@var{tf} =} __fcn_lookup_cache__ ()
+@deftypefnx {} {@var{old_tf} =} __fcn_lookup_cache__ (@var{new_tf})
+Query or set whether the function found by each call site in a parse tree
+is cached.
+
+When enabled (the default), an identifier or index expression that calls a
+function remembers the function it found and reuses it on later calls
+until the load path, the function table, or the class table changes, the
+current directory changes, or Octave returns to the prompt.  Disabling the
+cache searches for the function on every call.
+
+This function is intended for testing and benchmarking.
+@end deftypefn */)
+{
+  int nargin = args.length ();
+
+  if (nargin > 1)
+    print_usage ();
+
+  if (nargin == 0)
+    return ovl (fcn_lookup_cache::enabled ());
+
+  bool flag = args(0).xbool_value ("__fcn_lookup_cache__: TF must be a logical value");
+
+  return ovl (fcn_lookup_cache::enabled (flag));
+}
+
+/*
+%!test
+%! old = __fcn_lookup_cache__ (false);
+%! unwind_protect
+%!   assert (__fcn_lookup_cache__ (), false);
+%!   assert (__fcn_lookup_cache__ (true), false);
+%!   assert (__fcn_lookup_cache__ (), true);
+%! unwind_protect_cleanup
+%!   __fcn_lookup_cache__ (old);
+%! end_unwind_protect
+
+%!error __fcn_lookup_cache__ (true, false)
+%!error <TF must be a logical value> __fcn_lookup_cache__ ("on")
+*/
+
 OCTAVE_END_NAMESPACE(octave)
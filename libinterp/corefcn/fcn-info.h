@@ -352,6 +352,84 @@ private:
   std::shared_ptr<fcn_info_rep> m_rep;
 };
 
+// Cache the function that a call site resolves to so that repeated
+// calls skip the search described for fcn_info::find.  The cached
+// function is used as long as the search scope, the dispatch type of
+// the arguments, and the global lookup generation are the same as when
+// it was found.  The generation is incremented whenever the load path,
+// the function table, or the class table changes, at each prompt, and
+// when the current directory changes.
+
+class OCTINTERP_API fcn_lookup_cache
+{
+public:
+
+  fcn_lookup_cache ()
+    : m_generation (0), m_scope (), m_dispatch_type (), m_fcn (nullptr),
+      m_fcn_val ()
+  { }
+
+  // Caches are not shared by copies of a parse tree.
+  fcn_lookup_cache (const fcn_lookup_cache&) : fcn_lookup_cache () { }
+
+  fcn_lookup_cache& operator = (const fcn_lookup_cache&)
+  {
+    clear ();
+    return *this;
+  }
+
+  ~fcn_lookup_cache () = default;
+
+  // Find the function NAME called with arguments ARGS in the current
+  // scope, using the cached result if it is still valid.
+  octave_value find (const std::string& name,
+                     const octave_value_list& args = octave_value_list ());
+
+  void clear ()
+  {
+    m_generation = 0;
+    m_fcn = nullptr;
+    m_fcn_val = octave_value ();
+  }
+
+  static std::size_t generation () { return s_generation; }
+
+  static void new_generation () { s_generation++; }
+
+  static bool enabled () { return s_enabled; }
+
+  static bool enabled (bool flag)
+  {
+    bool val = s_enabled;
+    s_enabled = flag;
+    new_generation ();
+    return val;
+  }
+
+private:
+
+  std::size_t m_generation;
+
+  // The search scope.  A weak pointer is used so that a scope created
+  // at the address of a deleted one is not mistaken for it.
+  std::weak_ptr<void> m_scope;
+
+  std::string m_dispatch_type;
+
+  // User functions are not referenced by the cache because a function
+  // that calls itself would never be deleted.  Deleting a user function
+  // starts a new generation instead.  Built-in functions are kept in
+  // M_FCN_VAL.
+  octave_function *m_fcn;
+
+  octave_value m_fcn_val;
+
+  // Starts at 1 so that a cache with generation 0 is always invalid.
+  OCTAVE_THREAD_LOCAL static std::size_t s_generation;
+
+  OCTAVE_THREAD_LOCAL static bool s_enabled;
+};
+
 extern OCTINTERP_API std::string
 get_dispatch_type (const octave_value_list& args);
 
@@ -45,6 +45,7 @@
 #include <cstdio>
 
 #include <iomanip>
+#include <memory>
 #include <string>
 
 #if defined (HAVE_ZLIB_H)
@@ -1600,6 +1601,99 @@ as the name of the function when reporting errors.
                             args.splice (0, 1));
 }
 
+DEFMETHOD (__textscan_reader_open__, interp, args, ,
+           doc: /* -*- texinfo -*-
+@deftypefn {} {[@var{id}, @var{done}] =} __textscan_reader_open__ (@var{who}, @var{fid}, @var{format}, @var{param}, @var{value}, @dots{})
+Create a reader for records of the open file @var{fid} in the textscan
+format @var{format}, and return its identifier and whether the file is
+already at its end.  Undocumented internal function.
+@end deftypefn */)
+{
+  if (args.length () < 3)
+    print_usage ();
+
+  std::string who
+    = args(0).xstring_value ("__textscan_reader_open__: WHO must be a string");
+
+  stream_list& streams = interp.get_stream_list ();
+
+  stream os = streams.lookup (args(1), who);
+
+  if (interp.interactive () && os.file_number () == 0)
+    error ("%s: unable to read from stdin while running interactively",
+           who.c_str ());
+
+  std::string fmt = args(2).xstring_value ("%s: FORMAT must be a string",
+                                           who.c_str ());
+
+  if (args(2).is_sq_string ())
+    fmt = do_string_escapes (fmt);
+
+  std::unique_ptr<textscan_reader> reader
+    (new textscan_reader (os, fmt, args.splice (0, 3), who));
+
+  bool done = reader->eof ();
+
+  int id = streams.insert_textscan_reader (reader.release ());
+
+  return ovl (id, done);
+}
+
+DEFMETHOD (__textscan_reader_read__, interp, args, ,
+           doc: /* -*- texinfo -*-
+@deftypefn {} {[@var{C}, @var{done}] =} __textscan_reader_read__ (@var{who}, @var{id}, @var{n})
+Read up to @var{n} records with the reader @var{id} and return them as
+@code{textscan} does, and whether the end of the file was reached.
+Undocumented internal function.
+@end deftypefn */)
+{
+  if (args.length () != 3)
+    print_usage ();
+
+  std::string who
+    = args(0).xstring_value ("__textscan_reader_read__: WHO must be a string");
+
+  stream_list& streams = interp.get_stream_list ();
+
+  int id = args(1).xint_value ("%s: invalid reader ID", who.c_str ());
+
+  textscan_reader& reader = streams.lookup_textscan_reader (id, who);
+
+  octave_idx_type n = args(2).xidx_type_value ("%s: N must be an integer",
+                                               who.c_str ());
+
+  octave_value result = reader.read (n);
+
+  return ovl (result, reader.eof ());
+}
+
+DEFMETHOD (__textscan_reader_close__, interp, args, ,
+           doc: /* -*- texinfo -*-
+@deftypefn  {} {} __textscan_reader_close__ (@var{id})
+@deftypefnx {} {} __textscan_reader_close__ (@var{id}, @var{wait})
+Destroy the reader @var{id}.  The file that it reads is not closed.  If
+@var{wait} is true, wait until the file is no longer read in the
+background.  Undocumented internal function.
+@end deftypefn */)
+{
+  int nargin = args.length ();
+
+  if (nargin < 1 || nargin > 2)
+    print_usage ();
+
+  int id = args(0).xint_value ("__textscan_reader_close__: invalid reader ID");
+
+  bool wait = false;
+  if (nargin > 1)
+    wait = args(1).xbool_value ("__textscan_reader_close__: WAIT must be a logical value");
+
+  stream_list& streams = interp.get_stream_list ();
+
+  streams.remove_textscan_reader (id, wait);
+
+  return ovl ();
+}
+
 /*
 %!test
 %! str = "1,  2,  3,  4\n 5,  ,  ,  8\n 9, 10, 11, 12";
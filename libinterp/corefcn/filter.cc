@@ -35,6 +35,7 @@
 #  include "config.h"
 #endif
 
+#include "oct-parallel.h"
 #include "quit.h"
 
 #include "defun.h"
@@ -118,119 +119,130 @@ filter (MArray<T>& b, MArray<T>& a, MArray<T>& x, MArray<T>& si,
   // For deconv and fftfilt, x_num seems to always be 1.
   // For directly calling filter, it can be more than 1.
 
-  for (octave_idx_type num = 0; num < x_num; num++)
-    {
-      octave_idx_type x_offset = (x_stride == 1) ? num * x_len
-                                 : num + (num / x_stride) * x_stride * (x_len - 1);
-
-      octave_idx_type si_offset = num * si_len;
-
-      // Try to achieve a balance between speed and interruptibility.
-      //
-      // One extreme is to not check for interruptions at all, which gives
-      // good speed but the user cannot use Ctrl-C for the whole duration.
-      // The other end is to check frequently from inside an inner loop,
-      // which slows down performance by 5X or 6X.
-      //
-      // Putting any sort of check in an inner loop seems to prevent the
-      // compiler from optimizing the loop, so we cannot say "check for
-      // interruptions every M iterations" using an if-statement.
-      //
-      // This is a compromise approach to split the total numer of loop
-      // executions into num_outer and num_inner, to provide periodic checks
-      // for interruptions without writing a conditional inside a tight loop.
-      //
-      // To make it more interruptible and run more slowly, reduce num_inner.
-      // To speed it up but make it less interruptible, increase it.
-      // May need to increase it slowly over time as computers get faster.
-      // The aim is to not lose Ctrl-C ability for longer than about 2 seconds.
-      //
-      // In December 2021, num_inner = 100000 is acceptable.
-
-      octave_idx_type num_execs = si_len-1; // 0 to num_execs-1
-      octave_idx_type num_inner = 100000;
-      octave_idx_type num_outer = num_execs / num_inner;
-
-      // The following if-else block depends on a_len and si_len,
-      // both of which are loop invariants in this 0 <= num < x_num loop.
-      // But x_num is so small in practice that using the if-else inside
-      // the loop has more benefits than duplicating the outer for-loop,
-      // even though the checks are on loop invariants.
-
-      // We cannot have a_len <= 1 AND si_len <= 0 because that case already
-      // returned above. This means exactly one of the following blocks
-      // inside the if-conditional will be obeyed: it is not possible for the
-      // if-block and the else-block to *both* skip. Therefore any code that
-      // is common to both branches can be pulled out here without affecting
-      // correctness or speed.
-
-      T *py = y.rwdata ();
-      T *psi = si.rwdata ();
-      const T *pb = b.data ();
-      const T *px = x.data ();
-      psi += si_offset;
-
-      if (a_len > 1)
+  // Try to achieve a balance between speed and interruptibility.
+  //
+  // One extreme is to not check for interruptions at all, which gives
+  // good speed but the user cannot use Ctrl-C for the whole duration.
+  // The other end is to check frequently from inside an inner loop,
+  // which slows down performance by 5X or 6X.
+  //
+  // Putting any sort of check in an inner loop seems to prevent the
+  // compiler from optimizing the loop, so we cannot say "check for
+  // interruptions every M iterations" using an if-statement.
+  //
+  // This is a compromise approach to split the total numer of loop
+  // executions into num_outer and num_inner, to provide periodic checks
+  // for interruptions without writing a conditional inside a tight loop.
+  //
+  // To make it more interruptible and run more slowly, reduce num_inner.
+  // To speed it up but make it less interruptible, increase it.
+  // May need to increase it slowly over time as computers get faster.
+  // The aim is to not lose Ctrl-C ability for longer than about 2 seconds.
+  //
+  // In December 2021, num_inner = 100000 is acceptable.
+
+  octave_idx_type num_execs = si_len-1; // 0 to num_execs-1
+  octave_idx_type num_inner = 100000;
+  octave_idx_type num_outer = num_execs / num_inner;
+
+  T *py = y.rwdata ();
+  T *psi0 = si.rwdata ();
+  const T *pa = a.data ();
+  const T *pb = b.data ();
+  const T *px = x.data ();
+
+  // The vectors are independent, so several threads may filter them.
+  // Interrupts can only be checked by the thread that runs the
+  // interpreter, so they are checked once all vectors are done if the
+  // loop is split.
+
+  parallel_for_slices (x_stride, x_len, x_num / x_stride,
+                       [=] (octave_idx_type l0, octave_idx_type l1,
+                            octave_idx_type u0, octave_idx_type u1)
+  {
+    bool check_quit = ! in_parallel_loop ();
+
+    for (octave_idx_type k = u0; k < u1; k++)
+      for (octave_idx_type num = k * x_stride + l0;
+           num < k * x_stride + l1; num++)
         {
-          const T *pa = a.data ();
+          octave_idx_type x_offset = (x_stride == 1) ? num * x_len
+                                     : num + k * x_stride * (x_len - 1);
 
-          // Usually the last element to be written will be si_len-1
-          // but if si_len is 0, then we need the 0th element to be written.
-          // Pulling this check out of the for-loop makes it run faster.
-          octave_idx_type iidx = (si_len > 0) ? si_len-1 : 0;
+          T *psi = psi0 + num * si_len;
 
-          for (octave_idx_type i = 0, idx = x_offset;
-               i < x_len;
-               i++, idx += x_stride)
-            {
-              py[idx] = psi[0] + pb[0] * px[idx];
+          // We cannot have a_len <= 1 AND si_len <= 0 because that case
+          // already returned above.  This means exactly one of the
+          // following blocks inside the if-conditional will be obeyed: it
+          // is not possible for the if-block and the else-block to *both*
+          // skip.
 
-              // Outer and inner loops for interruption management
-              for (octave_idx_type u = 0; u <= num_outer; u++)
+          if (a_len > 1)
+            {
+              // Usually the last element to be written will be si_len-1
+              // but if si_len is 0, then we need the 0th element to be
+              // written.  Pulling this check out of the for-loop makes it
+              // run faster.
+              octave_idx_type iidx = (si_len > 0) ? si_len-1 : 0;
+
+              for (octave_idx_type i = 0, idx = x_offset;
+                   i < x_len;
+                   i++, idx += x_stride)
                 {
-                  octave_idx_type lo = u * num_inner;
-                  octave_idx_type hi = (lo + num_inner < num_execs-1)
-                                       ? lo + num_inner : num_execs-1;
+                  py[idx] = psi[0] + pb[0] * px[idx];
 
-                  // Inner loop, no interruption
-                  for (octave_idx_type j = lo; j <= hi; j++)
-                    psi[j] = psi[j+1] - pa[j+1] * py[idx] + pb[j+1] * px[idx];
+                  // Outer and inner loops for interruption management
+                  for (octave_idx_type u = 0; u <= num_outer; u++)
+                    {
+                      octave_idx_type lo = u * num_inner;
+                      octave_idx_type hi = (lo + num_inner < num_execs-1)
+                                           ? lo + num_inner : num_execs-1;
 
-                  octave_quit();  // Check for interruptions
-                }
+                      // Inner loop, no interruption
+                      for (octave_idx_type j = lo; j <= hi; j++)
+                        psi[j] = psi[j+1] - pa[j+1] * py[idx]
+                                 + pb[j+1] * px[idx];
 
-              psi[iidx] = pb[si_len] * px[idx] - pa[si_len] * py[idx];
-            }
-        }
-      else // a_len <= 1 ==> si_len MUST be > 0
-        {
-          // This else-block is almost the same as the above if-block,
-          // except for the absence of variable pa.
+                      if (check_quit)
+                        octave_quit ();  // Check for interruptions
+                    }
 
-          for (octave_idx_type i = 0, idx = x_offset;
-               i < x_len;
-               i++, idx += x_stride)
+                  psi[iidx] = pb[si_len] * px[idx] - pa[si_len] * py[idx];
+                }
+            }
+          else // a_len <= 1 ==> si_len MUST be > 0
             {
-              py[idx] = psi[0] + pb[0] * px[idx];
+              // This else-block is almost the same as the above if-block,
+              // except for the absence of variable pa.
 
-              // Outer and inner loops for interruption management
-              for (octave_idx_type u = 0; u <= num_outer; u++)
+              for (octave_idx_type i = 0, idx = x_offset;
+                   i < x_len;
+                   i++, idx += x_stride)
                 {
-                  octave_idx_type lo = u * num_inner;
-                  octave_idx_type hi = (lo + num_inner < num_execs-1)
-                                       ? lo + num_inner : num_execs-1;
+                  py[idx] = psi[0] + pb[0] * px[idx];
 
-                  // Inner loop, no interruption
-                  for (octave_idx_type j = lo; j <= hi; j++)
-                    psi[j] = psi[j+1] + pb[j+1] * px[idx];
+                  // Outer and inner loops for interruption management
+                  for (octave_idx_type u = 0; u <= num_outer; u++)
+                    {
+                      octave_idx_type lo = u * num_inner;
+                      octave_idx_type hi = (lo + num_inner < num_execs-1)
+                                           ? lo + num_inner : num_execs-1;
 
-                  octave_quit();  // Check for interruptions
-                }
+                      // Inner loop, no interruption
+                      for (octave_idx_type j = lo; j <= hi; j++)
+                        psi[j] = psi[j+1] + pb[j+1] * px[idx];
+
+                      if (check_quit)
+                        octave_quit ();  // Check for interruptions
+                    }
 
-              psi[si_len-1] = pb[si_len] * px[idx];
+                  psi[si_len-1] = pb[si_len] * px[idx];
+                }
             }
         }
-    }
+  });
+
+  octave_quit ();
 
   return y;
 }
@@ -436,7 +436,7 @@ private:
 
   //--------
 
-  static ft_manager *s_instance;
+  OCTAVE_THREAD_LOCAL static ft_manager *s_instance;
 
   // Cache the fonts loaded by FreeType.  This cache only contains
   // weak references to the fonts, strong references are only present
@@ -448,7 +448,7 @@ private:
   bool m_fontconfig_initialized;
 };
 
-ft_manager *ft_manager::s_instance = nullptr;
+OCTAVE_THREAD_LOCAL ft_manager *ft_manager::s_instance = nullptr;
 
 static void
 ft_face_destroyed (void *object)
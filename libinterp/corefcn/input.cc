@@ -79,7 +79,7 @@
 #include "variables.h"
 
 // The time we last printed a prompt.
-octave::sys::time Vlast_prompt_time = 0.0;
+OCTAVE_THREAD_LOCAL octave::sys::time Vlast_prompt_time = 0.0;
 
 // TRUE after a call to completion_matches.
 bool octave_completion_matches_called = false;
@@ -657,6 +657,7 @@ std::string
 input_system::interactive_input (const std::string& s, bool& eof)
 {
   Vlast_prompt_time.stamp ();
+  fcn_lookup_cache::new_generation ();
 
   if (Vdrawnow_requested && m_interpreter.interactive ())
     {
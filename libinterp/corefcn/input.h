@@ -48,7 +48,7 @@ extern OCTINTERP_API bool octave_completion_matches_called;
 // the next user prompt.
 extern OCTINTERP_API bool Vdrawnow_requested;
 
-extern OCTINTERP_API octave::sys::time Vlast_prompt_time;
+extern OCTINTERP_API OCTAVE_THREAD_LOCAL octave::sys::time Vlast_prompt_time;
 
 class octave_value;
 
@@ -48,6 +48,7 @@
 #include "quit.h"
 #include "str-vec.h"
 #include "signal-wrappers.h"
+#include "singleton-cleanup.h"
 #include "unistd-wrappers.h"
 
 #include "builtin-defun-decls.h"
@@ -342,7 +343,7 @@ temporary_file_list::cleanup ()
 }
 
 // The time we last time we changed directories.
-sys::time Vlast_chdir_time = 0.0;
+OCTAVE_THREAD_LOCAL sys::time Vlast_chdir_time = 0.0;
 
 static void
 initialize_version_info ()
@@ -467,14 +468,16 @@ interpreter::interpreter (application *app_context)
     m_executing_atexit (false),
     m_initialized (false)
 {
-  // FIXME: When thread_local storage is used by default, this message
-  // should change to say something like
-  //
-  //   only one Octave interpreter may be active in any given thread
-
   if (s_instance)
-    throw std::runtime_error
-    ("only one Octave interpreter may be active");
+    {
+#if defined (OCTAVE_ENABLE_THREAD_LOCAL_INTERPRETERS)
+      throw std::runtime_error
+      ("only one Octave interpreter may be active in any given thread");
+#else
+      throw std::runtime_error
+      ("only one Octave interpreter may be active");
+#endif
+    }
 
   s_instance = this;
 
@@ -640,6 +643,14 @@ interpreter::~interpreter ()
     shutdown ();
 
   delete m_gh_manager;
+
+#if defined (OCTAVE_ENABLE_THREAD_LOCAL_INTERPRETERS)
+  // Free the singletons created by this thread and allow the thread
+  // to create another interpreter.
+  singleton_cleanup_list::cleanup ();
+
+  s_instance = nullptr;
+#endif
 }
 
 void
@@ -1410,6 +1421,7 @@ interpreter::chdir (const std::string& dir)
   // so that functions in the new current directory can shadow functions
   // further back in the load path order.
   Vlast_prompt_time.stamp ();
+  fcn_lookup_cache::new_generation ();
 
   m_event_manager.directory_changed (sys::env::get_current_directory ());
 
@@ -79,7 +79,7 @@ class child_list;
 class push_parser;
 
 // The time we last time we changed directories.
-extern sys::time Vlast_chdir_time;
+extern OCTAVE_THREAD_LOCAL sys::time Vlast_chdir_time;
 
 // The application object contains a pointer to the current
 // interpreter and the interpreter contains a pointer back to the
@@ -595,13 +595,11 @@ private:
 
   //--------
 
-  // The interpreter instance;  Currently it is only possible to
-  // have one, so OCTAVE_THREAD_LOCAL will normally be defined to be
-  // empty.  Eventually we would like to allow multiple interpreters
-  // to be active at once, but they will still be limited to one per
-  // thread.  When that is possible, OCTAVE_THREAD_LOCAL can be
-  // replaced by the C++ thread_local keyword.  For now, use a macro
-  // to allow experimenting with thread_local storage.
+  // The interpreter instance.  If Octave is configured with
+  // --enable-thread-local-interpreters, OCTAVE_THREAD_LOCAL is
+  // defined to be thread_local and each thread may have its own
+  // interpreter.  Otherwise, OCTAVE_THREAD_LOCAL is empty and only
+  // one interpreter may exist at a time.
 
   OCTAVE_THREAD_LOCAL static interpreter *s_instance;
 
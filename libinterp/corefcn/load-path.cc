@@ -29,9 +29,11 @@
 
 #include <algorithm>
 #include <cctype>
+#include <vector>
 
 #include "dir-ops.h"
 #include "file-ops.h"
+#include "inotify-wrappers.h"
 #include "lo-sysdep.h"
 #include "oct-env.h"
 #include "pathsearch.h"
@@ -54,6 +56,38 @@
 
 OCTAVE_BEGIN_NAMESPACE(octave)
 
+// Counters for the file system operations done to keep the load path up
+// to date.  They are reported by __load_path_stats__.
+
+struct load_path_stats
+{
+  // Number of calls to load_path::update.
+  std::size_t updates = 0;
+
+  // Number of calls to stat for directories and files.
+  std::size_t stat_calls = 0;
+
+  // Number of directory listings read.
+  std::size_t dir_reads = 0;
+
+  // Number of times all files in a directory were read again.
+  std::size_t rescans = 0;
+
+  // Number of directories not checked because they were watched and
+  // had not changed.
+  std::size_t watched_skips = 0;
+
+  // Number of change notifications received.
+  std::size_t events = 0;
+};
+
+static OCTAVE_THREAD_LOCAL load_path_stats lp_stats;
+
+// Minimum time in seconds between checks of the time stamps of a
+// directory that could not be watched.
+
+static const double unwatchable_dir_check_interval = 1.0;
+
 // Canonicalize file name (keeping the path relative) if it exists.
 // Return it unmodified otherwise.
 
@@ -171,10 +205,12 @@ in_path_list (const std::string& path_list, const std::string& path)
   return false;
 }
 
-//! Check if directory contains modified subdirectories.
+//! Check if any of the private, class, or package subdirectories of a
+//! directory were modified.
 //!
-//! @param d directory to check
-//! @param last_checked time of last check
+//! The list of subdirectories is collected when the directory is read,
+//! so only these directories need to be checked.  New subdirectories
+//! change the time stamp of the parent directory.
 //!
 //! Path patterns that need to be checked for modifications:
 //!
@@ -197,50 +233,31 @@ in_path_list (const std::string& path_list, const std::string& path)
 //! +namespace/+subnamespace/<like above>
 //! @endcode
 //!
-//! @return true if directory contains modified subdirectories
+//! @param subdirs subdirectories to check
+//! @param last_checked time of last check
+//!
+//! @return true if any subdirectory was modified or removed
 
 static bool
-subdirs_modified (const std::string& d, const sys::file_time& last_checked)
+subdirs_modified (const std::list<std::string>& subdirs,
+                  const sys::file_time& last_checked)
 {
-  sys::dir_entry dir (d);
-
-  if (dir)
+  for (const auto& d : subdirs)
     {
-      string_vector flist = dir.read ();
-
-      octave_idx_type len = flist.numel ();
-
-      for (octave_idx_type i = 0; i < len; i++)
-        {
-          std::string fname = flist[i];
+      lp_stats.stat_calls++;
 
-          std::string full_name = sys::file_ops::concat (d, fname);
-
-          // Check if directory AND if relevant (@,+,private)
-          // AND (if modified OR recursion into (@,+) sub-directories)
 #if defined (OCTAVE_USE_WINDOWS_API)
-          if (sys::dir_exists (full_name)
+      if (! sys::dir_exists (d)
+          || (sys::file_time (d) + sys::file_time::time_resolution ()
+              > last_checked))
 #else
-          sys::file_stat fs (full_name);
+      sys::file_stat fs (d);
 
-          if (fs && fs.is_dir ()
-#endif
-              && (fname[0] == '@' || fname[0] == '+' || fname == "private")
-#if defined (OCTAVE_USE_WINDOWS_API)
-              && ((sys::file_time (full_name)
-#else
-              && ((sys::file_time (fs.mtime ().unix_time ())
+      if (! fs || ! fs.is_dir ()
+          || (sys::file_time (fs.mtime ().unix_time ())
+              + sys::file_time::time_resolution () > last_checked))
 #endif
-                   + sys::file_time::time_resolution () > last_checked)
-                  || ((fname[0] == '@' || fname[0] == '+')
-                      && subdirs_modified (full_name, last_checked))))
-            return true;
-        }
-    }
-  else
-    {
-      std::string msg = dir.error ();
-      warning ("load_path: %s: %s", d.c_str (), msg.c_str ());
+        return true;
     }
 
   return false;
@@ -253,7 +270,8 @@ load_path::load_path (interpreter& interp)
   : m_add_hook ([this] (const std::string& dir) { this->execute_pkg_add (dir); }),
 m_remove_hook ([this] (const std::string& dir) { this->execute_pkg_del (dir); }),
 m_interpreter (interp), m_package_map (), m_top_level_package (),
-m_dir_info_list (), m_init_dirs (), m_command_line_path ()
+m_dir_info_list (), m_init_dirs (), m_command_line_path (),
+m_dir_watcher ()
 { }
 
 void
@@ -297,8 +315,12 @@ load_path::initialize (bool set_initial_path)
 void
 load_path::clear ()
 {
+  fcn_lookup_cache::new_generation ();
+
   m_dir_info_list.clear ();
 
+  m_dir_watcher.unwatch_all ();
+
   m_top_level_package.clear ();
 
   m_package_map.clear ();
@@ -405,6 +427,8 @@ load_path::remove (const std::string& dir_arg)
 
               remove (di);
 
+              m_dir_watcher.unwatch (di.dir_name);
+
               m_dir_info_list.erase (i);
             }
         }
@@ -416,18 +440,50 @@ load_path::remove (const std::string& dir_arg)
 void
 load_path::update ()
 {
-  // I don't see a better way to do this because we need to
-  // preserve the correct directory ordering for new files that
-  // have appeared.
+  lp_stats.updates++;
 
-  m_top_level_package.clear ();
+  m_dir_watcher.read_events ();
 
-  m_package_map.clear ();
+  bool modified = false;
 
   for (dir_info_list_iterator di = m_dir_info_list.begin ();
        di != m_dir_info_list.end ();)
     {
-      bool ok = di->update ();
+      // Relative directories are always checked because their meaning
+      // changes with the current directory.
+
+      bool watch = m_dir_watcher.enabled () && ! di->is_relative;
+
+      if (watch && m_dir_watcher.is_unwatchable (di->dir_name))
+        {
+          watch = false;
+
+          if (! m_dir_watcher.check_unwatchable (di->dir_name))
+            {
+              di++;
+              continue;
+            }
+        }
+
+      if (watch)
+        {
+          if (m_dir_watcher.is_current (di->dir_name))
+            {
+              lp_stats.watched_skips++;
+              di++;
+              continue;
+            }
+
+          // Start watching before checking the directory so that no
+          // change made while it is checked is missed.
+
+          m_dir_watcher.mark_checked (di->dir_name);
+          watch = m_dir_watcher.watch (di->dir_name, di->subdir_list);
+        }
+
+      bool dir_modified = false;
+
+      bool ok = di->update (dir_modified);
 
       if (! ok)
         {
@@ -441,14 +497,46 @@ load_path::update ()
 
           remove (*di);
 
+          m_dir_watcher.unwatch (di->dir_name);
+
           di = m_dir_info_list.erase (di);
+
+          modified = true;
         }
       else
         {
-          add (*di, true, "", true);
+          if (dir_modified)
+            {
+              modified = true;
+
+              if (watch)
+                {
+                  // Watch any new subdirectories and check the
+                  // directory once more next time in case they changed
+                  // before they were watched.
+
+                  if (m_dir_watcher.watch (di->dir_name, di->subdir_list))
+                    m_dir_watcher.mark_changed (di->dir_name);
+                }
+            }
+
           di++;
         }
     }
+
+  if (! modified)
+    return;
+
+  // I don't see a better way to do this because we need to
+  // preserve the correct directory ordering for new files that
+  // have appeared.
+
+  m_top_level_package.clear ();
+
+  m_package_map.clear ();
+
+  for (const auto& di : m_dir_info_list)
+    add (di, true, "", true);
 }
 
 bool
@@ -971,6 +1059,10 @@ load_path::execute_pkg_del (const std::string& dir)
 void
 load_path::rehash ()
 {
+  // Check all directories, even if no change was reported for them.
+
+  m_dir_watcher.mark_all_changed ();
+
   update ();
 
   // Signal the GUI allowing updating the load path dialog
@@ -984,6 +1076,7 @@ load_path::rehash ()
 
   // This will force updated functions to be found.
   Vlast_prompt_time.stamp ();
+  fcn_lookup_cache::new_generation ();
 }
 
 void
@@ -1141,6 +1234,8 @@ load_path::add (const std::string& dir_arg, bool at_end, bool warn)
 void
 load_path::remove (const dir_info& di, const std::string& pname)
 {
+  fcn_lookup_cache::new_generation ();
+
   package_info& l = get_package (pname);
 
   l.remove (di);
@@ -1246,6 +1341,8 @@ void
 load_path::add (const dir_info& di, bool at_end,
                 const std::string& pname, bool updating)
 {
+  fcn_lookup_cache::new_generation ();
+
   package_info& l = get_package (pname);
 
   l.add (di, at_end, updating);
@@ -1336,6 +1433,8 @@ get_fcn_files (const std::string& d)
   string_vector flist;
   std::string msg;
 
+  lp_stats.dir_reads++;
+
   if (! sys::get_dirlist (d, flist, msg))
     warning ("load_path: %s: %s", d.c_str (), msg.c_str ());
   else
@@ -1383,8 +1482,12 @@ get_fcn_files (const std::string& d)
 }
 
 bool
-load_path::dir_info::update ()
+load_path::dir_info::update (bool& modified)
 {
+  modified = false;
+
+  lp_stats.stat_calls++;
+
 #if defined (OCTAVE_USE_WINDOWS_API)
   std::string msg;
 
@@ -1427,10 +1530,24 @@ load_path::dir_info::update ()
 #endif
                    + sys::file_time::time_resolution ()
                    > di.dir_time_last_checked)
-                  || subdirs_modified (dir_name, dir_time_last_checked))
-                initialize ();
+                  || subdirs_modified (di.subdir_list,
+                                       dir_time_last_checked))
+                {
+                  initialize ();
+
+                  modified = true;
+                }
               else
                 {
+                  // The cached information may have been updated for
+                  // another entry with the same absolute name, or the
+                  // current directory may have changed.
+
+                  modified = (abs_dir_name != di.abs_dir_name
+                              || dir_mtime != di.dir_mtime
+                              || dir_time_last_checked
+                                 != di.dir_time_last_checked);
+
                   // Copy over info from cache, but leave dir_name and
                   // is_relative unmodified.
                   abs_dir_name = di.abs_dir_name;
@@ -1441,12 +1558,15 @@ load_path::dir_info::update ()
                   private_file_map = di.private_file_map;
                   method_file_map = di.method_file_map;
                   package_dir_map = di.package_dir_map;
+                  subdir_list = di.subdir_list;
                 }
             }
           else
             {
               // We haven't seen this directory before.
               initialize ();
+
+              modified = true;
             }
         }
       catch (const execution_exception& ee)
@@ -1466,8 +1586,12 @@ load_path::dir_info::update ()
   else if (sys::file_time (fs.mtime ().unix_time ())
 #endif
            + sys::file_time::time_resolution () > dir_time_last_checked
-           || subdirs_modified (dir_name, dir_time_last_checked))
-    initialize ();
+           || subdirs_modified (subdir_list, dir_time_last_checked))
+    {
+      initialize ();
+
+      modified = true;
+    }
 
   return true;
 }
@@ -1496,6 +1620,9 @@ load_path::dir_info::is_package (const std::string& name) const
 void
 load_path::dir_info::initialize ()
 {
+  lp_stats.rescans++;
+  lp_stats.stat_calls++;
+
   is_relative = ! sys::env::absolute_pathname (dir_name);
 
   dir_time_last_checked = sys::file_time (static_cast<OCTAVE_TIME_T> (0));
@@ -1512,6 +1639,7 @@ load_path::dir_info::initialize ()
     {
       method_file_map.clear ();
       package_dir_map.clear ();
+      subdir_list.clear ();
 
 #if defined (OCTAVE_USE_WINDOWS_API)
       dir_mtime = sys::file_time (dir_name);
@@ -1558,6 +1686,8 @@ load_path::dir_info::get_file_list (const std::string& d)
   string_vector flist;
   std::string msg;
 
+  lp_stats.dir_reads++;
+
   if (! sys::get_dirlist (d, flist, msg))
     {
       warning ("load_path: %s: %s", d.c_str (), msg.c_str ());
@@ -1578,7 +1708,21 @@ load_path::dir_info::get_file_list (const std::string& d)
 
       std::string full_name = sys::file_ops::concat (d, fname);
 
-      if (sys::dir_exists (full_name))
+#if defined (OCTAVE_USE_WINDOWS_API)
+      bool is_dir = sys::dir_exists (full_name);
+      bool is_file = ! is_dir && sys::file_exists (full_name);
+
+      lp_stats.stat_calls += (is_dir ? 1 : 2);
+#else
+      // One call to stat is enough to tell directories from files.
+      sys::file_stat fs (full_name);
+      bool is_dir = fs && fs.is_dir ();
+      bool is_file = fs && fs.is_reg ();
+
+      lp_stats.stat_calls++;
+#endif
+
+      if (is_dir)
         {
           if (fname == "private")
             get_private_file_map (full_name);
@@ -1587,7 +1731,7 @@ load_path::dir_info::get_file_list (const std::string& d)
           else if (fname[0] == '+')
             get_package_dir (full_name, fname.substr (1));
         }
-      else if (sys::file_exists (full_name))
+      else if (is_file)
         {
           all_files[all_files_count++] = fname;
 
@@ -1615,6 +1759,8 @@ load_path::dir_info::get_file_list (const std::string& d)
 void
 load_path::dir_info::get_private_file_map (const std::string& d)
 {
+  subdir_list.push_back (d);
+
   private_file_map = get_fcn_files (d);
 }
 
@@ -1622,19 +1768,31 @@ void
 load_path::dir_info::get_method_file_map (const std::string& d,
     const std::string& class_name)
 {
+  subdir_list.push_back (d);
+
   method_file_map[class_name].method_file_map = get_fcn_files (d);
 
   std::string pd = sys::file_ops::concat (d, "private");
 
+  lp_stats.stat_calls++;
+
   if (sys::dir_exists (pd))
-    method_file_map[class_name].private_file_map = get_fcn_files (pd);
+    {
+      subdir_list.push_back (pd);
+
+      method_file_map[class_name].private_file_map = get_fcn_files (pd);
+    }
 }
 
 void
 load_path::dir_info::get_package_dir (const std::string& d,
                                       const std::string& package_name)
 {
-  package_dir_map[package_name] = dir_info (d);
+  const dir_info& di = package_dir_map[package_name] = dir_info (d);
+
+  subdir_list.push_back (d);
+  subdir_list.insert (subdir_list.end (), di.subdir_list.begin (),
+                      di.subdir_list.end ());
 }
 
 void
@@ -2426,6 +2584,177 @@ load_path::package_info::print_fcn_list (std::ostream& os,
     }
 }
 
+load_path::dir_watcher::dir_watcher ()
+  : m_fd (octave_inotify_init_wrapper ()), m_watches (), m_watched_dirs (),
+    m_changed (), m_unwatchable ()
+{ }
+
+load_path::dir_watcher::~dir_watcher ()
+{
+  if (m_fd >= 0)
+    octave_inotify_close_wrapper (m_fd);
+}
+
+bool
+load_path::dir_watcher::watch (const std::string& dir,
+                               const std::list<std::string>& subdirs)
+{
+  if (m_fd < 0)
+    return false;
+
+  unwatch (dir);
+
+  std::set<int> wds;
+
+  // The directory itself is watched first so that it is watched even
+  // if it has no subdirectories.
+
+  std::list<std::string> dirs = subdirs;
+  dirs.push_front (dir);
+
+  for (const auto& d : dirs)
+    {
+      int wd = octave_inotify_add_watch_wrapper (m_fd, d.c_str ());
+
+      if (wd < 0)
+        {
+          // Check this directory by its time stamps instead.
+
+          for (int w : wds)
+            remove_watch (w, dir);
+
+          // It was just checked or is about to be.
+
+          m_unwatchable[dir] = sys::time ().double_value ();
+
+          return false;
+        }
+
+      wds.insert (wd);
+      m_watched_dirs[wd].insert (dir);
+    }
+
+  m_watches[dir] = wds;
+
+  return true;
+}
+
+void
+load_path::dir_watcher::unwatch (const std::string& dir)
+{
+  m_unwatchable.erase (dir);
+
+  auto p = m_watches.find (dir);
+
+  if (p == m_watches.end ())
+    return;
+
+  for (int wd : p->second)
+    remove_watch (wd, dir);
+
+  m_watches.erase (p);
+  m_changed.erase (dir);
+}
+
+void
+load_path::dir_watcher::unwatch_all ()
+{
+  for (const auto& wd_dirs : m_watched_dirs)
+    octave_inotify_rm_watch_wrapper (m_fd, wd_dirs.first);
+
+  m_watches.clear ();
+  m_watched_dirs.clear ();
+  m_changed.clear ();
+  m_unwatchable.clear ();
+}
+
+void
+load_path::dir_watcher::mark_all_changed ()
+{
+  for (const auto& dir_wds : m_watches)
+    m_changed.insert (dir_wds.first);
+
+  // Check the directories that can't be watched the next time, too.
+
+  for (auto& dir_time : m_unwatchable)
+    dir_time.second = 0;
+}
+
+bool
+load_path::dir_watcher::check_unwatchable (const std::string& dir)
+{
+  auto p = m_unwatchable.find (dir);
+
+  if (p == m_unwatchable.end ())
+    return true;
+
+  double now = sys::time ().double_value ();
+
+  if (now - p->second < unwatchable_dir_check_interval
+      && now >= p->second)
+    return false;
+
+  p->second = now;
+
+  return true;
+}
+
+void
+load_path::dir_watcher::read_events ()
+{
+  if (m_fd < 0 || m_watches.empty ())
+    return;
+
+  std::vector<int> wds (1024);
+  int overflow = 0;
+
+  int n = octave_inotify_read_wrapper (m_fd, wds.data (), wds.size (),
+                                       &overflow);
+
+  if (n < 0 || overflow)
+    {
+      // Some changes may have been lost.
+
+      mark_all_changed ();
+
+      if (n < 0)
+        return;
+    }
+
+  lp_stats.events += n;
+
+  for (int i = 0; i < n; i++)
+    {
+      auto p = m_watched_dirs.find (wds[i]);
+
+      if (p != m_watched_dirs.end ())
+        m_changed.insert (p->second.begin (), p->second.end ());
+    }
+}
+
+// Stop using the watch WD for DIR.  The same directory may be watched
+// for more than one directory in the load path, for example if a
+// directory and one of its package subdirectories are both in the
+// path, so the watch is only removed if it is no longer used.
+
+void
+load_path::dir_watcher::remove_watch (int wd, const std::string& dir)
+{
+  auto p = m_watched_dirs.find (wd);
+
+  if (p == m_watched_dirs.end ())
+    return;
+
+  p->second.erase (dir);
+
+  if (p->second.empty ())
+    {
+      octave_inotify_rm_watch_wrapper (m_fd, wd);
+
+      m_watched_dirs.erase (p);
+    }
+}
+
 std::string
 genpath (const std::string& dirname, const string_vector& skip)
 {
@@ -2849,4 +3178,150 @@ Pretty print Octave path directories and the files within each directory.
   return ovl ();
 }
 
+DEFMETHOD (__load_path_stats__, interp, args, ,
+           doc: /* -*- texinfo -*-
+@deftypefn  {} {@var{stats} =} __load_path_stats__ ()
+@deftypefnx {} {@var{stats} =} __load_path_stats__ ("reset")
+Return counts of the file system operations done to keep the load path up to
+date.
+
+The fields of the structure @var{stats} are
+
+@table @code
+@item updates
+Number of times the load path was checked for changes.
+
+@item stat_calls
+Number of calls to @code{stat} for directories and files.
+
+@item dir_reads
+Number of directory listings read.
+
+@item rescans
+Number of times the information for a directory was read again.
+
+@item watched_skips
+Number of times a directory was not checked because it was watched and no
+change was reported for it.
+
+@item events
+Number of change notifications received for watched directories.
+
+@item watched_dirs
+Number of directories in the load path that are currently watched.
+
+@item method
+@qcode{"inotify"} if directories can be watched for changes and
+@qcode{"polling"} if the time stamps of all directories are checked.
+@end table
+
+If called with the argument @qcode{"reset"}, set the counters to zero after
+returning their values.
+@end deftypefn */)
+{
+  int nargin = args.length ();
+
+  if (nargin > 1)
+    print_usage ();
+
+  bool reset = false;
+
+  if (nargin == 1)
+    {
+      std::string opt = args(0).xstring_value ("__load_path_stats__: argument must be a string");
+
+      if (opt != "reset")
+        error (R"(__load_path_stats__: argument must be "reset")");
+
+      reset = true;
+    }
+
+  load_path& lp = interp.get_load_path ();
+
+  octave_scalar_map retval;
+
+  retval.assign ("updates", static_cast<double> (lp_stats.updates));
+  retval.assign ("stat_calls", static_cast<double> (lp_stats.stat_calls));
+  retval.assign ("dir_reads", static_cast<double> (lp_stats.dir_reads));
+  retval.assign ("rescans", static_cast<double> (lp_stats.rescans));
+  retval.assign ("watched_skips",
+                 static_cast<double> (lp_stats.watched_skips));
+  retval.assign ("events", static_cast<double> (lp_stats.events));
+  retval.assign ("watched_dirs", static_cast<double> (lp.num_watched_dirs ()));
+  retval.assign ("method", lp.watching_dirs () ? "inotify" : "polling");
+
+  if (reset)
+    lp_stats = load_path_stats ();
+
+  return ovl (retval);
+}
+
+/*
+%!test
+%! s = __load_path_stats__ ();
+%! assert (fieldnames (s),
+%!         {"updates"; "stat_calls"; "dir_reads"; "rescans"; "watched_skips";
+%!          "events"; "watched_dirs"; "method"});
+%! assert (any (strcmp (s.method, {"inotify", "polling"})));
+
+## New and removed files in a directory in the load path are found
+%!test
+%! dir = tempname ();
+%! unwind_protect
+%!   mkdir (dir);
+%!   addpath (dir);
+%!   assert (exist ("__lp_stats_fcn__"), 0);
+%!   fid = fopen (fullfile (dir, "__lp_stats_fcn__.m"), "w");
+%!   fprintf (fid, "function r = __lp_stats_fcn__ ()\n  r = 42;\nendfunction\n");
+%!   fclose (fid);
+%!   ## Make sure the change is seen even if the time stamp of the directory
+%!   ## is not newer than the last check.
+%!   rehash ();
+%!   assert (__lp_stats_fcn__ (), 42);
+%!   __load_path_stats__ ("reset");
+%!   for i = 1:10
+%!     __load_path_stats__ ();
+%!     rehash ();
+%!   endfor
+%!   s = __load_path_stats__ ();
+%!   assert (s.updates >= 10);
+%!   assert (s.stat_calls > 0);
+%!   delete (fullfile (dir, "__lp_stats_fcn__.m"));
+%!   clear __lp_stats_fcn__;
+%!   rehash ();
+%!   assert (exist ("__lp_stats_fcn__"), 0);
+%! unwind_protect_cleanup
+%!   rmpath (dir);
+%!   confirm_recursive_rmdir (false, "local");
+%!   rmdir (dir, "s");
+%! end_unwind_protect
+
+## A new file in a watched directory is found without calling rehash
+%!testif ; strcmp (__load_path_stats__ ().method, "inotify")
+%! dir = tempname ();
+%! unwind_protect
+%!   mkdir (dir);
+%!   addpath (dir);
+%!   rehash ();
+%!   nwatched = __load_path_stats__ ().watched_dirs;
+%!   assert (nwatched > 0);
+%!   __load_path_stats__ ("reset");
+%!   fid = fopen (fullfile (dir, "__lp_watch_fcn__.m"), "w");
+%!   fprintf (fid, "function r = __lp_watch_fcn__ ()\n  r = 7;\nendfunction\n");
+%!   fclose (fid);
+%!   assert (__lp_watch_fcn__ (), 7);
+%!   s = __load_path_stats__ ();
+%!   assert (s.events > 0);
+%!   assert (s.watched_dirs, nwatched);
+%! unwind_protect_cleanup
+%!   clear __lp_watch_fcn__;
+%!   rmpath (dir);
+%!   confirm_recursive_rmdir (false, "local");
+%!   rmdir (dir, "s");
+%! end_unwind_protect
+
+%!error __load_path_stats__ (1, 2)
+%!error <argument must be "reset"> __load_path_stats__ ("clear")
+*/
+
 OCTAVE_END_NAMESPACE(octave)
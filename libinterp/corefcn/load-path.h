@@ -209,6 +209,13 @@ public:
 
   void rehash ();
 
+  bool watching_dirs () const { return m_dir_watcher.enabled (); }
+
+  std::size_t num_watched_dirs () const
+  {
+    return m_dir_watcher.num_watched_dirs ();
+  }
+
   static const int M_FILE = 1;
   static const int OCT_FILE = 2;
   static const int MEX_FILE = 4;
@@ -271,7 +278,8 @@ private:
     dir_info (const std::string& d)
       : dir_name (d), abs_dir_name (), is_relative (false),
         dir_mtime (), dir_time_last_checked (), all_files (), fcn_files (),
-        private_file_map (), method_file_map (), package_dir_map ()
+        private_file_map (), method_file_map (), package_dir_map (),
+        subdir_list ()
     {
       initialize ();
     }
@@ -282,7 +290,10 @@ private:
 
     dir_info& operator = (const dir_info&) = default;
 
-    bool update ();
+    // Check whether the directory has changed and read it again if
+    // it has.  Set MODIFIED to true if the directory information was
+    // changed.
+    bool update (bool& modified);
 
     std::string dir_name;
     std::string abs_dir_name;
@@ -295,6 +306,10 @@ private:
     method_file_map_type method_file_map;
     package_dir_map_type package_dir_map;
 
+    // All private, class, and package subdirectories, including those
+    // in class and package subdirectories.
+    std::list<std::string> subdir_list;
+
     bool is_package (const std::string& name) const;
 
   private:
@@ -515,6 +530,84 @@ private:
   typedef package_map_type::const_iterator const_package_map_iterator;
   typedef package_map_type::iterator package_map_iterator;
 
+  // Watch the directories in the load path for changes so that update
+  // does not need to check their time stamps each time it is called.
+  // Directories that can't be watched, for example because inotify is
+  // not available or the directory is on a network file system, are
+  // checked by their time stamps instead.  Once a directory could not be
+  // watched, it is not tried again, and its time stamps are checked at
+  // most once per second unless rehash is called.
+
+  class dir_watcher
+  {
+  public:
+
+    dir_watcher ();
+
+    OCTAVE_DISABLE_COPY_MOVE (dir_watcher)
+
+    ~dir_watcher ();
+
+    bool enabled () const { return m_fd >= 0; }
+
+    // Watch DIR and its subdirectories SUBDIRS, replacing any previous
+    // watches for DIR.  Return false and remember DIR as unwatchable if
+    // any of them can't be watched.
+    bool watch (const std::string& dir,
+                const std::list<std::string>& subdirs);
+
+    void unwatch (const std::string& dir);
+
+    // Return true if DIR could not be watched before.
+    bool is_unwatchable (const std::string& dir) const
+    {
+      return m_unwatchable.find (dir) != m_unwatchable.end ();
+    }
+
+    // Return true if the unwatchable directory DIR should be checked
+    // now, and note the time if so.
+    bool check_unwatchable (const std::string& dir);
+
+    void unwatch_all ();
+
+    // Read the pending notifications and mark the directories that
+    // changed.
+    void read_events ();
+
+    void mark_changed (const std::string& dir) { m_changed.insert (dir); }
+
+    void mark_all_changed ();
+
+    void mark_checked (const std::string& dir) { m_changed.erase (dir); }
+
+    // Return true if DIR is watched and has not changed since it was
+    // last checked.
+    bool is_current (const std::string& dir) const
+    {
+      return (m_watches.find (dir) != m_watches.end ()
+              && m_changed.find (dir) == m_changed.end ());
+    }
+
+    std::size_t num_watched_dirs () const { return m_watches.size (); }
+
+  private:
+
+    void remove_watch (int wd, const std::string& dir);
+
+    int m_fd;
+
+    // <DIR, WATCH_DESCRIPTORS>
+    std::map<std::string, std::set<int>> m_watches;
+
+    // <WATCH_DESCRIPTOR, DIRS>
+    std::map<int, std::set<std::string>> m_watched_dirs;
+
+    std::set<std::string> m_changed;
+
+    // <DIR, TIME_LAST_CHECKED>
+    std::map<std::string, double> m_unwatchable;
+  };
+
   std::function<void (const std::string&)> m_add_hook;
 
   std::function<void (const std::string&)> m_remove_hook;
@@ -580,6 +673,7 @@ private:
 
   std::string m_command_line_path;
 
+  dir_watcher m_dir_watcher;
 };
 
 extern std::string
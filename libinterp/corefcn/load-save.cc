@@ -30,18 +30,31 @@
 #include <cstring>
 
 #include <fstream>
+#include <functional>
 #include <iomanip>
 #include <iostream>
 #include <list>
+#include <map>
 #include <sstream>
 #include <string>
+#include <vector>
 
+#include "CNDArray.h"
+#include "boolNDArray.h"
 #include "byte-swap.h"
 #include "dMatrix.h"
+#include "dNDArray.h"
+#include "dRowVector.h"
+#include "fCNDArray.h"
+#include "fNDArray.h"
 #include "data-conv.h"
 #include "file-ops.h"
 #include "file-stat.h"
 #include "glob-match.h"
+#include "int16NDArray.h"
+#include "int32NDArray.h"
+#include "int64NDArray.h"
+#include "int8NDArray.h"
 #include "lo-mappers.h"
 #include "lo-sysdep.h"
 #include "mach-info.h"
@@ -51,6 +64,10 @@
 #include "quit.h"
 #include "str-vec.h"
 #include "strftime-wrapper.h"
+#include "uint16NDArray.h"
+#include "uint32NDArray.h"
+#include "uint64NDArray.h"
+#include "uint8NDArray.h"
 
 #include "Cell.h"
 #include "defun.h"
@@ -64,6 +81,7 @@
 #include "ovl.h"
 #include "oct-map.h"
 #include "ov-cell.h"
+#include "ov-typeinfo.h"
 #include "pager.h"
 #include "syminfo.h"
 #include "sysdep.h"
@@ -258,7 +276,10 @@ load_save_system::load_save_system (interpreter& interp)
     m_octave_core_file_name ("octave-workspace"),
     m_save_default_options ("-text"),
     m_octave_core_file_options ("-binary"),
-    m_save_header_format_string (init_save_header_format ())
+    m_save_header_format_string (init_save_header_format ()),
+    m_hdf5_compress (false), m_hdf5_deflate_level (6), m_hdf5_shuffle (true),
+    m_hdf5_fletcher32 (false), m_hdf5_chunk_bytes (1048576.0),
+    m_hdf5_chunk_shape ()
 {
 #if defined (HAVE_HDF5)
   H5dont_atexit ();
@@ -320,6 +341,104 @@ load_save_system::save_header_format_string (const octave_value_list& args,
                                 "save_header_format_string");
 }
 
+octave_value
+load_save_system::save_hdf5_options (const octave_value_list& args,
+                                     int nargout)
+{
+  octave_scalar_map retval;
+
+  RowVector chunk (m_hdf5_chunk_shape.size ());
+  for (std::size_t i = 0; i < m_hdf5_chunk_shape.size (); i++)
+    chunk(i) = m_hdf5_chunk_shape[i];
+
+  retval.assign ("deflate", m_hdf5_deflate_level);
+  retval.assign ("shuffle", m_hdf5_shuffle);
+  retval.assign ("fletcher32", m_hdf5_fletcher32);
+  retval.assign ("chunk_size", m_hdf5_chunk_bytes);
+  retval.assign ("chunk", chunk.isempty () ? Matrix () : Matrix (chunk));
+
+  int nargin = args.length ();
+
+  if (nargin == 0)
+    return retval;
+
+  octave_scalar_map opts;
+
+  if (nargin == 1)
+    opts = args(0).xscalar_map_value ("save_hdf5_options: OPTS must be a scalar structure");
+  else if (nargin % 2 == 0)
+    {
+      for (int i = 0; i < nargin; i += 2)
+        {
+          std::string field = args(i).xstring_value ("save_hdf5_options: option name must be a string");
+
+          opts.assign (field, args(i+1));
+        }
+    }
+  else
+    error ("save_hdf5_options: options must be given as NAME, VALUE pairs");
+
+  // Validate all options before changing any of them.
+
+  int deflate_level = m_hdf5_deflate_level;
+  bool shuffle = m_hdf5_shuffle;
+  bool fletcher32 = m_hdf5_fletcher32;
+  double chunk_bytes = m_hdf5_chunk_bytes;
+  std::vector<octave_idx_type> chunk_shape = m_hdf5_chunk_shape;
+
+  for (auto p = opts.begin (); p != opts.end (); p++)
+    {
+      std::string field = opts.key (p);
+      octave_value val = opts.contents (p);
+
+      if (field == "deflate")
+        {
+          deflate_level = val.xint_value ("save_hdf5_options: DEFLATE must be an integer from 0 to 9");
+
+          if (deflate_level < 0 || deflate_level > 9)
+            error ("save_hdf5_options: DEFLATE must be an integer from 0 to 9");
+        }
+      else if (field == "shuffle")
+        shuffle = val.xbool_value ("save_hdf5_options: SHUFFLE must be a logical value");
+      else if (field == "fletcher32")
+        fletcher32 = val.xbool_value ("save_hdf5_options: FLETCHER32 must be a logical value");
+      else if (field == "chunk_size")
+        {
+          chunk_bytes = val.xdouble_value ("save_hdf5_options: CHUNK_SIZE must be a positive number of bytes");
+
+          if (! (chunk_bytes >= 1 && chunk_bytes <= 4294967295.0))
+            error ("save_hdf5_options: CHUNK_SIZE must be a positive number of bytes less than 4 GiB");
+        }
+      else if (field == "chunk")
+        {
+          chunk_shape.clear ();
+
+          if (! val.isempty ())
+            {
+              Array<octave_idx_type> v = val.xoctave_idx_type_vector_value ("save_hdf5_options: CHUNK must be a vector of positive integers");
+
+              for (octave_idx_type i = 0; i < v.numel (); i++)
+                {
+                  if (v(i) < 1)
+                    error ("save_hdf5_options: CHUNK must be a vector of positive integers");
+
+                  chunk_shape.push_back (v(i));
+                }
+            }
+        }
+      else
+        error (R"(save_hdf5_options: unknown option "%s")", field.c_str ());
+    }
+
+  m_hdf5_deflate_level = deflate_level;
+  m_hdf5_shuffle = shuffle;
+  m_hdf5_fletcher32 = fletcher32;
+  m_hdf5_chunk_bytes = chunk_bytes;
+  m_hdf5_chunk_shape = chunk_shape;
+
+  return nargout > 0 ? octave_value (retval) : octave_value ();
+}
+
 load_save_format
 load_save_system::get_file_format (const std::string& fname,
                                    const std::string& orig_fname,
@@ -1512,6 +1631,10 @@ load_save_system::save (const octave_value_list& args, int nargout)
             = ! (append && H5Fis_hdf5 (ascii_fname.c_str ()) > 0);
 #  endif
 
+          // With -zip, arrays are written to chunked datasets with
+          // HDF5's own filters instead of compressing the whole file.
+          unwind_protect_var<bool> restore_var (m_hdf5_compress, use_zlib);
+
           hdf5_ofstream hdf5_file (fname.c_str (), mode);
 
           if (hdf5_file.file_id == -1)
@@ -1805,6 +1928,12 @@ Use the gzip algorithm to compress the file.  This works on files that are
 compressed with gzip outside of Octave, and gzip can also be used to convert
 the files for backward compatibility.  This option is only available if Octave
 was built with a link to the zlib libraries.
+
+With @option{-hdf5}, the file itself is not compressed.  Instead, numeric and
+logical arrays are stored in chunked datasets that are compressed with the
+shuffle and deflate filters of HDF5, so that other programs that read HDF5
+files can decompress them and read parts of them.  The filters and the shape
+of the chunks are set with @code{save_hdf5_options}.
 @end table
 
 The list of variables to save may use wildcard patterns (glob patterns)
@@ -2097,4 +2226,1743 @@ The original variable value is restored when exiting the function.
   return load_save_sys.save_header_format_string (args, nargout);
 }
 
+DEFMETHOD (save_hdf5_options, interp, args, nargout,
+           doc: /* -*- texinfo -*-
+@deftypefn  {} {@var{opts} =} save_hdf5_options ()
+@deftypefnx {} {@var{old_opts} =} save_hdf5_options (@var{new_opts})
+@deftypefnx {} {@var{old_opts} =} save_hdf5_options (@var{name}, @var{value}, @dots{})
+Query or set the options for compressed arrays in HDF5 files.
+
+When data is saved with @code{save -hdf5 -zip}, numeric and logical arrays
+larger than 1 kilobyte are stored in chunked datasets, and each chunk is
+compressed separately.  Large arrays are compressed by several threads at once.
+The options are given as fields of the structure @var{new_opts} or as
+@var{name}, @var{value} pairs.  Options that are not given keep their current
+values.
+
+@table @code
+@item deflate
+The compression level of the deflate filter, an integer from 0 (no
+compression) to 9 (best compression).  The default is 6.
+
+@item shuffle
+If true, reorder the bytes of the elements of each chunk before deflating it,
+so that the bytes with the same significance are stored together.  This often
+improves the compression of numeric data.  The default is true.
+
+@item fletcher32
+If true, store a checksum with each chunk, which is verified when the data is
+read.  The default is false.
+
+@item chunk_size
+The approximate size of the chunks in bytes if their shape is chosen
+automatically.  The default is 1048576 (1 MiB).
+
+@item chunk
+The dimensions of the chunks in Octave's order, for example @code{[1000, 1]}
+to store each block of 1000 rows of a column separately.  Dimensions that are
+missing are 1, and dimensions that are larger than the array are reduced to
+the size of the array.  If empty (the default), chunks hold complete columns,
+pages, etc.@: of about @code{chunk_size} bytes.
+@end table
+
+@seealso{save, save_default_options}
+@end deftypefn */)
+{
+  load_save_system& load_save_sys = interp.get_load_save_system ();
+
+  return load_save_sys.save_hdf5_options (args, nargout);
+}
+
+/*
+%!test
+%! old = save_hdf5_options ();
+%! unwind_protect
+%!   save_hdf5_options ("deflate", 9, "shuffle", false, "chunk", [100, 1]);
+%!   opts = save_hdf5_options ();
+%!   assert (opts.deflate, 9);
+%!   assert (opts.shuffle, false);
+%!   assert (opts.chunk, [100, 1]);
+%!   assert (opts.chunk_size, old.chunk_size);
+%!   prev = save_hdf5_options (struct ("chunk", [], "fletcher32", true));
+%!   assert (prev, opts);
+%!   assert (save_hdf5_options ().chunk, []);
+%!   assert (save_hdf5_options ().fletcher32, true);
+%! unwind_protect_cleanup
+%!   save_hdf5_options (old);
+%! end_unwind_protect
+%! assert (save_hdf5_options (), old);
+
+%!testif HAVE_HDF5, HAVE_ZLIB
+%! a = reshape (1:60000, 200, 300);
+%! b = int16 (a(1:100, :));
+%! c = rand (50) > 0.5;
+%! d = single (a) + 1i;
+%! tmp = [tempname(), ".h5"];
+%! tmp_z = [tempname(), ".h5"];
+%! old = save_hdf5_options ();
+%! unwind_protect
+%!   save ("-hdf5", tmp, "a", "b", "c", "d");
+%!   save ("-hdf5", "-zip", tmp_z, "a", "b", "c", "d");
+%!   s = load (tmp_z);
+%!   assert (s, struct ("a", a, "b", b, "c", c, "d", d));
+%!   assert (stat (tmp_z).size < stat (tmp).size / 2);
+%!   save_hdf5_options ("chunk", [64, 64], "fletcher32", true, "deflate", 1);
+%!   save ("-hdf5", "-zip", tmp_z, "a", "b", "c", "d");
+%!   s = load (tmp_z);
+%!   assert (s, struct ("a", a, "b", b, "c", c, "d", d));
+%! unwind_protect_cleanup
+%!   save_hdf5_options (old);
+%!   unlink (tmp);
+%!   unlink (tmp_z);
+%! end_unwind_protect
+
+## Chunks may be compressed in parallel, including those at the edges that
+## are only partly filled
+%!testif HAVE_HDF5, HAVE_ZLIB
+%! a = reshape (1:60000, 200, 300) + 0.5;
+%! b = int16 (a(1:100, 1:130));
+%! d = single (a(:, 1:70)) - 2i;
+%! tmp = [tempname(), ".h5"];
+%! old = save_hdf5_options ();
+%! old_n = maxNumCompThreads ();
+%! old_threshold = __parallel_threshold__ (16);
+%! unwind_protect
+%!   maxNumCompThreads (4);
+%!   save_hdf5_options ("chunk", [64, 64], "shuffle", true, "deflate", 4,
+%!                      "fletcher32", false);
+%!   save ("-hdf5", "-zip", tmp, "a", "b", "d");
+%!   s = load (tmp);
+%!   assert (s, struct ("a", a, "b", b, "d", d));
+%!   assert (s.a(193:200, 257:300), a(193:200, 257:300));
+%! unwind_protect_cleanup
+%!   maxNumCompThreads (old_n);
+%!   __parallel_threshold__ (old_threshold);
+%!   save_hdf5_options (old);
+%!   unlink (tmp);
+%! end_unwind_protect
+%! assert (save_hdf5_options (), old);
+
+%!error <NAME, VALUE pairs> save_hdf5_options ("deflate", 1, "shuffle")
+%!error <from 0 to 9> save_hdf5_options ("deflate", 10)
+%!error <positive integers> save_hdf5_options ("chunk", [10, 0])
+%!error <unknown option "level"> save_hdf5_options ("level", 1)
+%!error <scalar structure> save_hdf5_options (1)
+*/
+
+// Access to parts of the variables in a file, used by the matfile
+// class.  Numeric and logical arrays in HDF5 files and in uncompressed
+// Octave binary files are read and written in rectangular blocks
+// without loading the rest of the variable.  Other variables are
+// loaded completely when they are accessed.  To list the variables,
+// only the headers and dimensions of arrays, strings, sparse matrices,
+// cell arrays, and structures are read, and only other, small values
+// are loaded.
+
+template <typename A>
+static octave_value
+matfile_read_array (const dim_vector& dv,
+                    const std::function<void (char *)>& fill)
+{
+  A a (dv);
+
+  fill (reinterpret_cast<char *> (a.rwdata ()));
+
+  return octave_value (a);
+}
+
+template <typename A>
+static void
+matfile_write_array (const octave_value& val,
+                     const std::function<void (const char *)>& use)
+{
+  A a = octave_value_extract<A> (val);
+
+  use (reinterpret_cast<const char *> (a.data ()));
+}
+
+struct matfile_array_type
+{
+  // The name of the type in the file.
+  const char *name;
+
+  // Elements of double and single precision arrays are saved as NCOMP
+  // numbers by write_doubles or write_floats, which may convert them
+  // to a smaller integer type.  Integer and logical arrays are saved
+  // as they are stored in memory, and NCOMP is zero.
+  int ncomp;
+
+  bool single;
+
+  // The size of an element in memory.
+  int size;
+
+  octave_value (*read) (const dim_vector&,
+                        const std::function<void (char *)>&);
+
+  void (*write) (const octave_value&,
+                 const std::function<void (const char *)>&);
+};
+
+#define MATFILE_ARRAY_TYPE(NAME, A, NCOMP, SINGLE)                      \
+  { NAME, NCOMP, SINGLE, sizeof (A::element_type),                      \
+    matfile_read_array<A>, matfile_write_array<A> }
+
+static const matfile_array_type matfile_array_types[] =
+{
+  MATFILE_ARRAY_TYPE ("matrix", NDArray, 1, false),
+  MATFILE_ARRAY_TYPE ("complex matrix", ComplexNDArray, 2, false),
+  MATFILE_ARRAY_TYPE ("float matrix", FloatNDArray, 1, true),
+  MATFILE_ARRAY_TYPE ("float complex matrix", FloatComplexNDArray, 2, true),
+  MATFILE_ARRAY_TYPE ("int8 matrix", int8NDArray, 0, false),
+  MATFILE_ARRAY_TYPE ("int16 matrix", int16NDArray, 0, false),
+  MATFILE_ARRAY_TYPE ("int32 matrix", int32NDArray, 0, false),
+  MATFILE_ARRAY_TYPE ("int64 matrix", int64NDArray, 0, false),
+  MATFILE_ARRAY_TYPE ("uint8 matrix", uint8NDArray, 0, false),
+  MATFILE_ARRAY_TYPE ("uint16 matrix", uint16NDArray, 0, false),
+  MATFILE_ARRAY_TYPE ("uint32 matrix", uint32NDArray, 0, false),
+  MATFILE_ARRAY_TYPE ("uint64 matrix", uint64NDArray, 0, false),
+  MATFILE_ARRAY_TYPE ("bool matrix", boolNDArray, 0, false)
+};
+
+#undef MATFILE_ARRAY_TYPE
+
+static const matfile_array_type *
+matfile_find_array_type (const std::string& name)
+{
+  for (const auto& t : matfile_array_types)
+    {
+      if (name == t.name)
+        return &t;
+    }
+
+  return nullptr;
+}
+
+// A variable in a file, as found by matfile_list_vars.
+
+struct matfile_var
+{
+public:
+
+  matfile_var ()
+    : name (), type (), class_name (), dims (), bytes (0), complex (false),
+      global (false), array (nullptr), in_place (false), offset (-1),
+      data_offset (-1), st (LS_DOUBLE)
+  { }
+
+  OCTAVE_DEFAULT_COPY_MOVE_DELETE (matfile_var)
+
+  std::string name;
+
+  // The name of the type of the variable.
+  std::string type;
+
+  std::string class_name;
+
+  dim_vector dims;
+
+  // The size of the value in memory, as returned by byte_size.
+  double bytes;
+
+  bool complex;
+
+  bool global;
+
+  // The type of an array that can be read in parts, or nullptr.
+  const matfile_array_type *array;
+
+  // True if parts of the array can be written without converting the
+  // elements to a different type in the file.
+  bool in_place;
+
+  // In binary files, the position of the record of the variable and
+  // of its data, and the type of the numbers in the data.
+  std::streamoff offset;
+  std::streamoff data_offset;
+  save_type st;
+};
+
+// A block of an array.  START, COUNT, and STRIDE have one element per
+// dimension of the array, and START is zero-based.
+
+struct matfile_block
+{
+public:
+
+  matfile_block () = default;
+
+  OCTAVE_DEFAULT_COPY_MOVE_DELETE (matfile_block)
+
+  dim_vector dims () const
+  {
+    dim_vector dv = dim_vector::alloc (count.numel ());
+
+    for (octave_idx_type i = 0; i < count.numel (); i++)
+      dv(i) = count(i);
+
+    return dv;
+  }
+
+  Array<octave_idx_type> start;
+  Array<octave_idx_type> count;
+  Array<octave_idx_type> stride;
+};
+
+static matfile_block
+matfile_get_block (const octave_value_list& args, int idx,
+                   const matfile_var& var)
+{
+  matfile_block b;
+
+  b.start = args(idx).xoctave_idx_type_vector_value ("matfile: START must be a vector of integers");
+  b.count = args(idx+1).xoctave_idx_type_vector_value ("matfile: COUNT must be a vector of integers");
+  b.stride = args(idx+2).xoctave_idx_type_vector_value ("matfile: STRIDE must be a vector of integers");
+
+  int nd = var.dims.ndims ();
+
+  if (b.start.numel () != nd || b.count.numel () != nd
+      || b.stride.numel () != nd)
+    error ("matfile: START, COUNT, and STRIDE must have %d elements for '%s'",
+           nd, var.name.c_str ());
+
+  for (int i = 0; i < nd; i++)
+    {
+      if (b.start(i) < 0 || b.count(i) < 0 || b.stride(i) < 1)
+        error ("matfile: invalid block of '%s'", var.name.c_str ());
+
+      if (b.count(i) > 0
+          && b.start(i) + (b.count(i) - 1) * b.stride(i) >= var.dims(i))
+        error ("matfile: index out of bound for dimension %d of '%s'",
+               i+1, var.name.c_str ());
+    }
+
+  return b;
+}
+
+// Call FCN (ELT, N, K) for each run of N elements of block B of an
+// array with dimensions DV that are consecutive in the array.  ELT is
+// the index of the first element of the run in the array and K its
+// index in the block.
+
+static void
+matfile_block_runs (const dim_vector& dv, const matfile_block& b,
+                    const std::function<void (octave_idx_type,
+                                              octave_idx_type,
+                                              octave_idx_type)>& fcn)
+{
+  int nd = dv.ndims ();
+
+  if (b.dims ().numel () == 0)
+    return;
+
+  std::vector<octave_idx_type> idx (nd, 0);
+
+  octave_idx_type k = 0;
+
+  while (true)
+    {
+      octave_idx_type elt = b.start(0);
+      octave_idx_type n = dv(0);
+
+      for (int i = 1; i < nd; i++)
+        {
+          elt += (b.start(i) + idx[i] * b.stride(i)) * n;
+          n *= dv(i);
+        }
+
+      if (b.stride(0) == 1)
+        {
+          fcn (elt, b.count(0), k);
+          k += b.count(0);
+        }
+      else
+        {
+          for (octave_idx_type j = 0; j < b.count(0); j++)
+            fcn (elt + j * b.stride(0), 1, k++);
+        }
+
+      int i = 1;
+
+      for (; i < nd; i++)
+        {
+          if (++idx[i] < b.count(i))
+            break;
+
+          idx[i] = 0;
+        }
+
+      if (i == nd)
+        break;
+    }
+}
+
+static int
+matfile_save_type_size (save_type st)
+{
+  switch (st)
+    {
+    case LS_U_CHAR:
+    case LS_CHAR:
+      return 1;
+
+    case LS_U_SHORT:
+    case LS_SHORT:
+      return 2;
+
+    case LS_U_INT:
+    case LS_INT:
+    case LS_FLOAT:
+      return 4;
+
+    case LS_DOUBLE:
+      return 8;
+
+    default:
+      return 0;
+    }
+}
+
+// Set the type, class, dimensions, and size of VAR from the loaded
+// value VAL.
+
+static void
+matfile_set_value_info (matfile_var& var, const octave_value& val)
+{
+  var.type = val.type_name ();
+  var.class_name = val.class_name ();
+  var.dims = val.dims ();
+  var.bytes = val.byte_size ();
+  var.complex = val.iscomplex ();
+}
+
+// Set the type and class of VAR from the name TYPE of its type.
+
+static void
+matfile_set_type_info (matfile_var& var, const std::string& type)
+{
+  octave_value val = __get_type_info__ ().lookup_type (type);
+
+  var.type = type;
+  var.class_name = val.class_name ();
+  var.complex = val.iscomplex ();
+}
+
+static bool
+matfile_is_sparse_type (const std::string& type)
+{
+  return (type == "sparse matrix" || type == "sparse complex matrix"
+          || type == "sparse bool matrix");
+}
+
+static int32_t
+matfile_read_int32 (std::istream& is, bool swap, const std::string& filename)
+{
+  int32_t val = 0;
+
+  if (! is.read (reinterpret_cast<char *> (&val), 4))
+    error ("matfile: trouble reading binary file '%s'", filename.c_str ());
+  if (swap)
+    swap_bytes<4> (&val);
+
+  return val;
+}
+
+static void
+matfile_skip_bytes (std::istream& is, std::streamoff n,
+                    const std::string& filename)
+{
+  if (! is.seekg (n, std::ios::cur))
+    error ("matfile: trouble reading binary file '%s'", filename.c_str ());
+}
+
+// Read MDIMS dimensions from the binary file IS.  A single dimension is
+// the length of a row vector.
+
+static dim_vector
+matfile_read_dims (std::istream& is, bool swap, const std::string& filename,
+                   int32_t mdims)
+{
+  dim_vector dv = dim_vector::alloc (std::max (mdims, 2));
+  dv(0) = 1;
+
+  for (int i = (mdims == 1 ? 1 : 0); i < dv.ndims (); i++)
+    dv(i) = matfile_read_int32 (is, swap, filename);
+
+  return dv;
+}
+
+static bool
+matfile_binary_next (std::istream& is, bool swap,
+                     mach_info::float_format flt_fmt,
+                     const std::string& filename, matfile_var& var);
+
+// Skip the data of a value of type TYPE in the binary file IS, which
+// follows the header of its record, and describe the value in VAR.
+// Only the dimensions and the sizes of the parts of arrays, strings,
+// sparse matrices, cell arrays, and structures are read.  Return false
+// for other values, which are small and are loaded instead, and for
+// arrays saved in an old format.
+
+static bool
+matfile_binary_skip (std::istream& is, bool swap,
+                     mach_info::float_format flt_fmt,
+                     const std::string& filename, const std::string& type,
+                     matfile_var& var)
+{
+  const matfile_array_type *array = matfile_find_array_type (type);
+
+  if (array || type == "string" || type == "sq_string" || type == "cell")
+    {
+      int32_t mdims = matfile_read_int32 (is, swap, filename);
+
+      if (mdims >= 0)
+        return false;
+
+      dim_vector dv = matfile_read_dims (is, swap, filename, - mdims);
+
+      if (array)
+        {
+          std::streamoff size = array->size;
+
+          if (array->ncomp > 0)
+            {
+              unsigned char tmp = 0;
+
+              if (! is.read (reinterpret_cast<char *> (&tmp), 1))
+                error ("matfile: trouble reading binary file '%s'",
+                       filename.c_str ());
+
+              var.st = static_cast<save_type> (tmp);
+
+              size = array->ncomp * matfile_save_type_size (var.st);
+
+              if (size == 0)
+                error ("matfile: unrecognized data format in '%s'",
+                       filename.c_str ());
+            }
+
+          var.array = array;
+          var.data_offset = is.tellg ();
+
+          var.in_place
+            = (! swap && flt_fmt == mach_info::native_float_format ()
+               && (array->ncomp == 0
+                   || var.st == (array->single ? LS_FLOAT : LS_DOUBLE)));
+
+          matfile_skip_bytes (is, size * dv.numel (), filename);
+
+          var.bytes = static_cast<double> (array->size) * dv.numel ();
+        }
+      else if (type == "cell")
+        {
+          for (octave_idx_type i = 0; i < dv.numel (); i++)
+            {
+              octave_quit ();
+
+              matfile_var elt;
+
+              if (! matfile_binary_next (is, swap, flt_fmt, filename, elt))
+                error ("matfile: trouble reading binary file '%s'",
+                       filename.c_str ());
+
+              var.bytes += elt.bytes;
+            }
+        }
+      else
+        {
+          matfile_skip_bytes (is, dv.numel (), filename);
+
+          var.bytes = dv.numel ();
+        }
+
+      var.dims = dv;
+    }
+  else if (type == "struct" || type == "scalar struct")
+    {
+      dim_vector dv (1, 1);
+
+      int32_t nfields = matfile_read_int32 (is, swap, filename);
+
+      if (type == "struct" && nfields < 0)
+        {
+          dv = matfile_read_dims (is, swap, filename, - nfields);
+
+          nfields = matfile_read_int32 (is, swap, filename);
+        }
+
+      if (nfields < 0)
+        return false;
+
+      // The fields of a structure array are saved as cell arrays.
+
+      for (int32_t i = 0; i < nfields; i++)
+        {
+          matfile_var field;
+
+          if (! matfile_binary_next (is, swap, flt_fmt, filename, field))
+            error ("matfile: trouble reading binary file '%s'",
+                   filename.c_str ());
+
+          var.bytes += field.bytes;
+        }
+
+      var.dims = dv;
+    }
+  else if (matfile_is_sparse_type (type))
+    {
+      if (matfile_read_int32 (is, swap, filename) != -2)
+        return false;
+
+      int32_t nr = matfile_read_int32 (is, swap, filename);
+      int32_t nc = matfile_read_int32 (is, swap, filename);
+      int32_t nz = matfile_read_int32 (is, swap, filename);
+
+      // Column and row indices.
+      matfile_skip_bytes (is, 4 * (std::streamoff (nc) + 1 + nz), filename);
+
+      std::size_t elt_size = sizeof (bool);
+
+      if (type == "sparse bool matrix")
+        matfile_skip_bytes (is, nz, filename);
+      else
+        {
+          unsigned char tmp = 0;
+
+          if (! is.read (reinterpret_cast<char *> (&tmp), 1))
+            error ("matfile: trouble reading binary file '%s'",
+                   filename.c_str ());
+
+          int ncomp = (type == "sparse matrix" ? 1 : 2);
+
+          int size = matfile_save_type_size (static_cast<save_type> (tmp));
+
+          if (size == 0)
+            error ("matfile: unrecognized data format in '%s'",
+                   filename.c_str ());
+
+          matfile_skip_bytes (is, std::streamoff (ncomp) * size * nz,
+                              filename);
+
+          elt_size = ncomp * sizeof (double);
+        }
+
+      // As returned by Sparse<T>::byte_size.
+      var.bytes = ((nc + 1.0) * sizeof (octave_idx_type)
+                   + std::max (nz, 1) * double (elt_size
+                                                + sizeof (octave_idx_type)));
+
+      var.dims = dim_vector (nr, nc);
+    }
+  else
+    return false;
+
+  matfile_set_type_info (var, type);
+
+  return true;
+}
+
+// Read the record of a variable from the binary file IS.  Values with
+// large data are skipped by matfile_binary_skip, other values are
+// loaded.  Return false at the end of the file.
+
+static bool
+matfile_binary_next (std::istream& is, bool swap,
+                     mach_info::float_format flt_fmt,
+                     const std::string& filename, matfile_var& var)
+{
+  var = matfile_var ();
+
+  var.offset = is.tellg ();
+
+  int32_t name_len = 0;
+  if (! is.read (reinterpret_cast<char *> (&name_len), 4))
+    return false;
+  if (swap)
+    swap_bytes<4> (&name_len);
+
+  std::string name (name_len, '\0');
+  int32_t doc_len = 0;
+  unsigned char global = 0;
+  unsigned char tmp = 0;
+
+  if (! is.read (&name[0], name_len)
+      || ! is.read (reinterpret_cast<char *> (&doc_len), 4))
+    error ("matfile: trouble reading binary file '%s'", filename.c_str ());
+  if (swap)
+    swap_bytes<4> (&doc_len);
+
+  if (! is.seekg (doc_len, std::ios::cur)
+      || ! is.read (reinterpret_cast<char *> (&global), 1)
+      || ! is.read (reinterpret_cast<char *> (&tmp), 1))
+    error ("matfile: trouble reading binary file '%s'", filename.c_str ());
+
+  std::string type;
+
+  if (tmp == 2)
+    type = "matrix";
+  else if (tmp == 4)
+    type = "complex matrix";
+  else if (tmp == 7)
+    type = "string";
+  else if (tmp == 255)
+    {
+      int32_t len = matfile_read_int32 (is, swap, filename);
+
+      type.resize (len);
+      if (! is.read (&type[0], len))
+        error ("matfile: trouble reading binary file '%s'", filename.c_str ());
+    }
+
+  if (! type.empty ()
+      && matfile_binary_skip (is, swap, flt_fmt, filename, type, var))
+    {
+      var.name = name;
+      var.global = global;
+
+      return true;
+    }
+
+  std::streamoff offset = var.offset;
+
+  var = matfile_var ();
+  var.offset = offset;
+
+  is.clear ();
+  is.seekg (offset);
+
+  bool is_global = false;
+  std::string doc;
+  octave_value val;
+
+  var.name = read_binary_data (is, swap, flt_fmt, filename, is_global,
+                               val, doc);
+
+  if (var.name.empty ())
+    return false;
+
+  matfile_set_value_info (var, val);
+  var.global = is_global;
+
+  return true;
+}
+
+static bool
+matfile_binary_open (std::istream& is, bool& swap,
+                     mach_info::float_format& flt_fmt)
+{
+  return is && read_binary_file_header (is, swap, flt_fmt, true) == 0;
+}
+
+#if defined (HAVE_HDF5)
+
+// Return a new HDF5 type for the elements of arrays of type T in
+// memory.
+
+static hid_t
+matfile_hdf5_mem_type (const matfile_array_type& t)
+{
+  std::string name = t.name;
+
+  if (name == "matrix")
+    return H5Tcopy (H5T_NATIVE_DOUBLE);
+  else if (name == "complex matrix")
+    return hdf5_make_complex_type (H5T_NATIVE_DOUBLE);
+  else if (name == "float matrix")
+    return H5Tcopy (H5T_NATIVE_FLOAT);
+  else if (name == "float complex matrix")
+    return hdf5_make_complex_type (H5T_NATIVE_FLOAT);
+  else if (name == "int8 matrix")
+    return H5Tcopy (H5T_NATIVE_INT8);
+  else if (name == "int16 matrix")
+    return H5Tcopy (H5T_NATIVE_INT16);
+  else if (name == "int32 matrix")
+    return H5Tcopy (H5T_NATIVE_INT32);
+  else if (name == "int64 matrix")
+    return H5Tcopy (H5T_NATIVE_INT64);
+  else if (name == "uint8 matrix")
+    return H5Tcopy (H5T_NATIVE_UINT8);
+  else if (name == "uint16 matrix")
+    return H5Tcopy (H5T_NATIVE_UINT16);
+  else if (name == "uint32 matrix")
+    return H5Tcopy (H5T_NATIVE_UINT32);
+  else if (name == "uint64 matrix")
+    return H5Tcopy (H5T_NATIVE_UINT64);
+  else
+    {
+      // Elements of bool matrices are read and written in place, so the
+      // type must have the size of bool.  H5T_NATIVE_HBOOL does not
+      // have it in all versions of HDF5.
+
+      hid_t type_id = H5Tcopy (H5T_NATIVE_UINT8);
+
+      if (sizeof (bool) != 1 && H5Tset_size (type_id, sizeof (bool)) < 0)
+        {
+          H5Tclose (type_id);
+          return -1;
+        }
+
+      return type_id;
+    }
+}
+
+// Return the name of the type of a variable saved in the group
+// GROUP_ID by add_hdf5_data, or an empty string.
+
+static std::string
+matfile_hdf5_type_name (hid_t group_id)
+{
+  std::string retval;
+
+#if defined (HAVE_HDF5_18)
+  hid_t data_id = H5Dopen (group_id, "type", octave_H5P_DEFAULT);
+#else
+  hid_t data_id = H5Dopen (group_id, "type");
+#endif
+
+  if (data_id < 0)
+    return retval;
+
+  hid_t type_id = H5Dget_type (data_id);
+
+  if (H5Tget_class (type_id) == H5T_STRING)
+    {
+      std::size_t slen = H5Tget_size (type_id);
+
+      std::vector<char> typ (slen + 1, '\0');
+
+      hid_t st_id = H5Tcopy (H5T_C_S1);
+      H5Tset_size (st_id, slen);
+
+      if (H5Dread (data_id, st_id, octave_H5S_ALL, octave_H5S_ALL,
+                   octave_H5P_DEFAULT, typ.data ()) >= 0)
+        retval = typ.data ();
+
+      H5Tclose (st_id);
+    }
+
+  H5Tclose (type_id);
+  H5Dclose (data_id);
+
+  return retval;
+}
+
+static hid_t
+matfile_hdf5_open_group (hid_t loc_id, const char *name)
+{
+#if defined (HAVE_HDF5_18)
+  return H5Gopen (loc_id, name, octave_H5P_DEFAULT);
+#else
+  return H5Gopen (loc_id, name);
+#endif
+}
+
+static hid_t
+matfile_hdf5_open_dataset (hid_t loc_id, const char *name)
+{
+#if defined (HAVE_HDF5_18)
+  return H5Dopen (loc_id, name, octave_H5P_DEFAULT);
+#else
+  return H5Dopen (loc_id, name);
+#endif
+}
+
+// Return in DV the dimensions of the dataset NAME in the group LOC_ID,
+// which are saved in reverse order.  Return false if the dataset does
+// not have at least two dimensions.
+
+static bool
+matfile_hdf5_dataset_dims (hid_t loc_id, const char *name, dim_vector& dv)
+{
+  hid_t data_id = matfile_hdf5_open_dataset (loc_id, name);
+
+  if (data_id < 0)
+    return false;
+
+  hid_t space_id = H5Dget_space (data_id);
+  int rank = H5Sget_simple_extent_ndims (space_id);
+
+  bool retval = (rank >= 2);
+
+  if (retval)
+    {
+      OCTAVE_LOCAL_BUFFER (hsize_t, hdims, rank);
+
+      H5Sget_simple_extent_dims (space_id, hdims, nullptr);
+
+      dv = dim_vector::alloc (rank);
+      for (int i = 0; i < rank; i++)
+        dv(i) = hdims[rank-i-1];
+    }
+
+  H5Sclose (space_id);
+  H5Dclose (data_id);
+
+  return retval;
+}
+
+// Read the dataset NAME of integers with at most one dimension in the
+// group LOC_ID.
+
+static bool
+matfile_hdf5_read_idx (hid_t loc_id, const char *name,
+                       std::vector<octave_idx_type>& val)
+{
+  hid_t data_id = matfile_hdf5_open_dataset (loc_id, name);
+
+  if (data_id < 0)
+    return false;
+
+  hid_t space_id = H5Dget_space (data_id);
+  int rank = H5Sget_simple_extent_ndims (space_id);
+
+  bool retval = (rank == 0 || rank == 1);
+
+  if (retval)
+    {
+      hsize_t n = 1;
+
+      if (rank == 1)
+        H5Sget_simple_extent_dims (space_id, &n, nullptr);
+
+      val.resize (n);
+
+      retval = H5Dread (data_id, H5T_NATIVE_IDX, octave_H5S_ALL,
+                        octave_H5S_ALL, octave_H5P_DEFAULT, val.data ()) >= 0;
+    }
+
+  H5Sclose (space_id);
+  H5Dclose (data_id);
+
+  return retval;
+}
+
+static bool
+matfile_hdf5_describe (hid_t group_id, matfile_var& var);
+
+// Describe the groups in GROUP_ID, which are the elements of a cell
+// array or the fields of a structure, and add their sizes to VAR.
+// Return the number of groups, with the dimensions of the first one in
+// FIRST_DIMS, or -1 if one of them cannot be described.
+
+static octave_idx_type
+matfile_hdf5_describe_members (hid_t group_id, matfile_var& var,
+                               dim_vector& first_dims)
+{
+  hsize_t num_obj = 0;
+  H5Gget_num_objs (group_id, &num_obj);
+
+  octave_idx_type retval = 0;
+
+  for (hsize_t i = 0; i < num_obj; i++)
+    {
+      octave_quit ();
+
+      // The dimensions of a cell array are saved in a dataset.
+      if (H5Gget_objtype_by_idx (group_id, i) != H5G_GROUP)
+        continue;
+
+      std::size_t len = H5Gget_objname_by_idx (group_id, i, nullptr, 0);
+      std::vector<char> name (len + 1, '\0');
+      H5Gget_objname_by_idx (group_id, i, name.data (), len + 1);
+
+      hid_t member_id = matfile_hdf5_open_group (group_id, name.data ());
+
+      if (member_id < 0)
+        return -1;
+
+      matfile_var member;
+
+      bool ok = matfile_hdf5_describe (member_id, member);
+
+      H5Gclose (member_id);
+
+      if (! ok)
+        return -1;
+
+      if (retval++ == 0)
+        first_dims = member.dims;
+
+      var.bytes += member.bytes;
+    }
+
+  return retval;
+}
+
+// Describe in VAR the value that add_hdf5_data saved in the group
+// GROUP_ID.  Only the type and the dimensions of arrays, strings,
+// sparse matrices, cell arrays, and structures are read.  Return false
+// for other values, which are small and are loaded instead.
+
+static bool
+matfile_hdf5_describe (hid_t group_id, matfile_var& var)
+{
+  std::string type = matfile_hdf5_type_name (group_id);
+
+  const matfile_array_type *array = matfile_find_array_type (type);
+
+  bool is_string = (type == "string" || type == "sq_string");
+  bool is_sparse = matfile_is_sparse_type (type);
+
+  dim_vector dv;
+
+  if ((array || is_string || is_sparse || type == "cell")
+      && load_hdf5_empty (group_id, "value", dv) > 0)
+    var.bytes = 0;
+  else if (array || is_string)
+    {
+      if (! matfile_hdf5_dataset_dims (group_id, "value", dv))
+        return false;
+
+      var.bytes = (array ? array->size : 1) * double (dv.numel ());
+    }
+  else if (is_sparse || type == "cell" || type == "struct"
+           || type == "scalar struct")
+    {
+      hid_t value_id = matfile_hdf5_open_group (group_id, "value");
+
+      if (value_id < 0)
+        return false;
+
+      unwind_action close_value ([=] () { H5Gclose (value_id); });
+
+      if (is_sparse)
+        {
+          std::vector<octave_idx_type> nr, nc, nz;
+
+          if (! matfile_hdf5_read_idx (value_id, "nr", nr)
+              || ! matfile_hdf5_read_idx (value_id, "nc", nc)
+              || ! matfile_hdf5_read_idx (value_id, "nz", nz))
+            return false;
+
+          std::size_t elt_size
+            = (type == "sparse bool matrix" ? sizeof (bool)
+               : type == "sparse matrix" ? sizeof (double) : sizeof (Complex));
+
+          dv = dim_vector (nr[0], nc[0]);
+
+          // As returned by Sparse<T>::byte_size.
+          var.bytes = ((nc[0] + 1.0) * sizeof (octave_idx_type)
+                       + std::max<octave_idx_type> (nz[0], 1)
+                       * double (elt_size + sizeof (octave_idx_type)));
+        }
+      else
+        {
+          dim_vector first_dims;
+
+          octave_idx_type n
+            = matfile_hdf5_describe_members (value_id, var, first_dims);
+
+          if (n < 0)
+            return false;
+
+          if (type == "cell")
+            {
+              std::vector<octave_idx_type> hdims;
+
+              if (! matfile_hdf5_read_idx (value_id, "dims", hdims)
+                  || hdims.size () < 2)
+                return false;
+
+              int rank = hdims.size ();
+
+              dv = dim_vector::alloc (rank);
+              for (int i = 0; i < rank; i++)
+                dv(i) = hdims[rank-i-1];
+            }
+          else if (type == "struct")
+            {
+              // The fields of a structure array are saved as cell
+              // arrays of its size.
+              if (n == 0)
+                return false;
+
+              dv = first_dims;
+            }
+          else
+            dv = dim_vector (1, 1);
+        }
+    }
+  else
+    return false;
+
+  var.dims = dv;
+
+  matfile_set_type_info (var, type);
+
+  return true;
+}
+
+// Open the dataset of the variable NAME in the HDF5 file FILE_ID.  If
+// the variable is an array that can be accessed in parts, describe it
+// in VAR and return the identifier of the dataset.  Otherwise, return
+// -1.  If DESCRIBE is true, the other variable is then described in VAR,
+// and it is loaded only if matfile_hdf5_describe cannot describe it.
+
+static hid_t
+matfile_hdf5_var (hid_t file_id, const std::string& name, matfile_var& var,
+                  bool describe)
+{
+  var = matfile_var ();
+
+  var.name = name;
+
+  H5G_stat_t info;
+
+  if (H5Gget_objinfo (file_id, name.c_str (), 1, &info) < 0)
+    return -1;
+
+  if (info.type == H5G_GROUP)
+    {
+      hid_t group_id = matfile_hdf5_open_group (file_id, name.c_str ());
+
+      if (group_id >= 0 && hdf5_check_attr (group_id, "OCTAVE_NEW_FORMAT"))
+        {
+          var.type = matfile_hdf5_type_name (group_id);
+          var.global = hdf5_check_attr (group_id, "OCTAVE_GLOBAL");
+
+          const matfile_array_type *array
+            = matfile_find_array_type (var.type);
+
+          dim_vector dv;
+
+          if (array && load_hdf5_empty (group_id, "value", dv) == 0
+              && matfile_hdf5_dataset_dims (group_id, "value", dv))
+            {
+              hid_t data_id = matfile_hdf5_open_dataset (group_id, "value");
+
+              var.dims = dv;
+              var.array = array;
+              matfile_set_type_info (var, var.type);
+              var.bytes = static_cast<double> (array->size) * dv.numel ();
+
+              hid_t file_type_id = H5Dget_type (data_id);
+              hid_t mem_type_id = matfile_hdf5_mem_type (*array);
+
+              var.in_place
+                = (mem_type_id >= 0
+                   && H5Tget_class (file_type_id) == H5Tget_class (mem_type_id)
+                   && H5Tget_size (file_type_id) == H5Tget_size (mem_type_id));
+
+              if (mem_type_id >= 0)
+                H5Tclose (mem_type_id);
+              H5Tclose (file_type_id);
+              H5Gclose (group_id);
+
+              return data_id;
+            }
+
+          if (describe && matfile_hdf5_describe (group_id, var))
+            {
+              H5Gclose (group_id);
+
+              return -1;
+            }
+        }
+
+      if (group_id >= 0)
+        H5Gclose (group_id);
+    }
+
+  if (! describe)
+    return -1;
+
+  hdf5_callback_data d;
+
+  if (hdf5_read_next_data (file_id, name.c_str (), &d) > 0)
+    {
+      bool global = var.global;
+
+      matfile_set_value_info (var, d.tc);
+
+      var.global = global || d.global;
+    }
+
+  return -1;
+}
+
+// Select block B of VAR in the dataspace SPACE_ID of its dataset, and
+// return a new dataspace for the elements of the block in memory.
+
+static hid_t
+matfile_hdf5_select (hid_t space_id, const matfile_var& var,
+                     const matfile_block& b)
+{
+  int rank = var.dims.ndims ();
+
+  OCTAVE_LOCAL_BUFFER (hsize_t, hstart, rank);
+  OCTAVE_LOCAL_BUFFER (hsize_t, hcount, rank);
+  OCTAVE_LOCAL_BUFFER (hsize_t, hstride, rank);
+
+  for (int i = 0; i < rank; i++)
+    {
+      hstart[i] = b.start(rank-i-1);
+      hcount[i] = b.count(rank-i-1);
+      hstride[i] = b.stride(rank-i-1);
+    }
+
+  if (H5Sselect_hyperslab (space_id, H5S_SELECT_SET, hstart, hstride,
+                           hcount, nullptr) < 0)
+    error ("matfile: unable to select part of '%s'", var.name.c_str ());
+
+  return H5Screate_simple (rank, hcount, nullptr);
+}
+
+#endif
+
+// Return the variables in FILENAME, which must be an HDF5 file or an
+// uncompressed Octave binary file.
+
+static std::vector<matfile_var>
+matfile_list_vars (const std::string& filename)
+{
+  std::vector<matfile_var> retval;
+
+  std::map<std::string, std::size_t> index;
+
+  auto add_var = [&retval, &index] (const matfile_var& var)
+  {
+    auto p = index.find (var.name);
+
+    // A variable may be saved again at the end of a binary file, and
+    // load uses the last value.
+
+    if (p == index.end ())
+      {
+        index[var.name] = retval.size ();
+        retval.push_back (var);
+      }
+    else
+      retval[p->second] = var;
+  };
+
+  bool use_zlib = false;
+
+  load_save_format format
+    = load_save_system::get_file_format (filename, filename, use_zlib, true);
+
+  if (format.type () == load_save_system::HDF5)
+    {
+#if defined (HAVE_HDF5)
+      hdf5_ifstream hs (filename.c_str ());
+
+      if (hs.file_id < 0)
+        err_file_open ("matfile", filename);
+
+      hsize_t num_obj = 0;
+#if defined (HAVE_HDF5_18)
+      hid_t group_id = H5Gopen (hs.file_id, "/", octave_H5P_DEFAULT);
+#else
+      hid_t group_id = H5Gopen (hs.file_id, "/");
+#endif
+      H5Gget_num_objs (group_id, &num_obj);
+      H5Gclose (group_id);
+
+      for (hsize_t i = 0; i < num_obj; i++)
+        {
+          std::size_t len
+            = H5Gget_objname_by_idx (hs.file_id, i, nullptr, 0);
+          std::vector<char> name (len + 1, '\0');
+          H5Gget_objname_by_idx (hs.file_id, i, name.data (), len + 1);
+
+          matfile_var var;
+
+          hid_t data_id = matfile_hdf5_var (hs.file_id, name.data (), var,
+                                            true);
+
+          if (data_id >= 0)
+            H5Dclose (data_id);
+
+          if (! var.type.empty ())
+            add_var (var);
+        }
+
+      hs.close ();
+#else
+      err_disabled_feature ("matfile", "HDF5");
+#endif
+    }
+  else if (format.type () == load_save_system::BINARY && ! use_zlib)
+    {
+      std::ifstream is = sys::ifstream (filename.c_str (),
+                                        std::ios::in | std::ios::binary);
+
+      bool swap = false;
+      mach_info::float_format flt_fmt = mach_info::flt_fmt_unknown;
+
+      if (! matfile_binary_open (is, swap, flt_fmt))
+        err_file_open ("matfile", filename);
+
+      matfile_var var;
+
+      while (matfile_binary_next (is, swap, flt_fmt, filename, var))
+        add_var (var);
+    }
+  else
+    error ("matfile: '%s' is not an HDF5 file or an uncompressed Octave binary file",
+           filename.c_str ());
+
+  return retval;
+}
+
+DEFUN (__matfile_whos__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {@var{info} =} __matfile_whos__ (@var{file})
+Undocumented internal function.
+@end deftypefn */)
+{
+  if (args.length () != 1)
+    print_usage ();
+
+  std::string filename
+    = sys::file_ops::tilde_expand (args(0).xstring_value ("matfile: FILE must be a string"));
+
+  std::vector<matfile_var> vars = matfile_list_vars (filename);
+
+  octave_idx_type n = vars.size ();
+
+  Cell name (n, 1);
+  Cell size (n, 1);
+  Cell bytes (n, 1);
+  Cell cls (n, 1);
+  Cell global (n, 1);
+  Cell complex (n, 1);
+  Cell partial (n, 1);
+  Cell in_place (n, 1);
+  Cell offset (n, 1);
+
+  for (octave_idx_type i = 0; i < n; i++)
+    {
+      const matfile_var& var = vars[i];
+
+      RowVector sz (var.dims.ndims ());
+      for (int j = 0; j < var.dims.ndims (); j++)
+        sz(j) = var.dims(j);
+
+      name(i) = var.name;
+      size(i) = sz;
+      bytes(i) = var.bytes;
+      cls(i) = var.class_name;
+      global(i) = var.global;
+      complex(i) = var.complex;
+      partial(i) = (var.array != nullptr);
+      in_place(i) = var.in_place;
+      offset(i) = static_cast<double> (var.offset);
+    }
+
+  octave_map retval (dim_vector (n, 1));
+
+  retval.assign ("name", name);
+  retval.assign ("size", size);
+  retval.assign ("bytes", bytes);
+  retval.assign ("class", cls);
+  retval.assign ("global", global);
+  retval.assign ("complex", complex);
+  retval.assign ("partial", partial);
+  retval.assign ("in_place", in_place);
+  retval.assign ("offset", offset);
+
+  return ovl (retval);
+}
+
+#if defined (HAVE_HDF5)
+
+// Return true if the HDF5 file FILE_ID has an object called NAME.
+
+static bool
+matfile_hdf5_exists (hid_t file_id, const std::string& name)
+{
+  H5E_auto_t err_fcn;
+  void *err_fcn_data;
+
+  // Turn off error reporting temporarily, since H5Gget_objinfo fails
+  // for names that do not exist.
+
+#if defined (HAVE_HDF5_18)
+  H5Eget_auto (octave_H5E_DEFAULT, &err_fcn, &err_fcn_data);
+  H5Eset_auto (octave_H5E_DEFAULT, nullptr, nullptr);
+#else
+  H5Eget_auto (&err_fcn, &err_fcn_data);
+  H5Eset_auto (nullptr, nullptr);
+#endif
+
+  H5G_stat_t info;
+
+  bool retval = H5Gget_objinfo (file_id, name.c_str (), 1, &info) >= 0;
+
+#if defined (HAVE_HDF5_18)
+  H5Eset_auto (octave_H5E_DEFAULT, err_fcn, err_fcn_data);
+#else
+  H5Eset_auto (err_fcn, err_fcn_data);
+#endif
+
+  return retval;
+}
+
+// Read or write block B of the array NAME in the HDF5 file FILE_ID.
+// FCN receives the dataset and the identifiers that H5Dread and
+// H5Dwrite need.
+
+static void
+matfile_hdf5_access (hid_t file_id, const std::string& name,
+                     const octave_value_list& args, int idx, bool write,
+                     const std::function<void (const matfile_var&,
+                                               const matfile_block&,
+                                               hid_t, hid_t,
+                                               hid_t, hid_t)>& fcn)
+{
+  if (! matfile_hdf5_exists (file_id, name))
+    error ("matfile: variable '%s' not found", name.c_str ());
+
+  matfile_var var;
+
+  hid_t data_id = matfile_hdf5_var (file_id, name, var, false);
+
+  if (data_id < 0)
+    error ("matfile: '%s' cannot be accessed in parts", name.c_str ());
+
+  unwind_action close_data ([=] () { H5Dclose (data_id); });
+
+  if (write && ! var.in_place)
+    error ("matfile: '%s' is saved with a different type and cannot be written in parts",
+           name.c_str ());
+
+  matfile_block b = matfile_get_block (args, idx, var);
+
+  hid_t space_id = H5Dget_space (data_id);
+
+  unwind_action close_space ([=] () { H5Sclose (space_id); });
+
+  hid_t mem_space_id = matfile_hdf5_select (space_id, var, b);
+
+  unwind_action close_mem_space ([=] () { H5Sclose (mem_space_id); });
+
+  hid_t mem_type_id = matfile_hdf5_mem_type (*var.array);
+
+  if (mem_type_id < 0)
+    error ("matfile: '%s' cannot be accessed in parts", name.c_str ());
+
+  unwind_action close_mem_type ([=] () { H5Tclose (mem_type_id); });
+
+  fcn (var, b, data_id, mem_type_id, mem_space_id, space_id);
+}
+
+#endif
+
+// Find the array NAME whose record starts at OFFSET in the binary file
+// IS.
+
+static matfile_var
+matfile_binary_find (std::istream& is, bool swap,
+                     mach_info::float_format flt_fmt,
+                     const std::string& filename, const std::string& name,
+                     std::streamoff offset)
+{
+  matfile_var var;
+
+  is.seekg (offset);
+
+  if (! is || ! matfile_binary_next (is, swap, flt_fmt, filename, var)
+      || var.name != name)
+    error ("matfile: variable '%s' not found", name.c_str ());
+
+  if (! var.array)
+    error ("matfile: '%s' cannot be accessed in parts", name.c_str ());
+
+  return var;
+}
+
+DEFUN (__matfile_read__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {@var{val} =} __matfile_read__ (@var{file}, @var{name}, @var{offset}, @var{start}, @var{count}, @var{stride})
+Undocumented internal function.
+@end deftypefn */)
+{
+  if (args.length () != 6)
+    print_usage ();
+
+  std::string filename
+    = sys::file_ops::tilde_expand (args(0).xstring_value ("matfile: FILE must be a string"));
+  std::string name = args(1).xstring_value ("matfile: NAME must be a string");
+  std::streamoff offset = args(2).xidx_type_value ("matfile: OFFSET must be an integer");
+
+  octave_value retval;
+
+  bool use_zlib = false;
+
+  load_save_format format
+    = load_save_system::get_file_format (filename, filename, use_zlib, true);
+
+  if (format.type () == load_save_system::HDF5)
+    {
+#if defined (HAVE_HDF5)
+      hdf5_ifstream hs (filename.c_str ());
+
+      if (hs.file_id < 0)
+        err_file_open ("matfile", filename);
+
+      matfile_hdf5_access (hs.file_id, name, args, 3, false,
+                           [&] (const matfile_var& var, const matfile_block& b,
+                                hid_t data_id, hid_t mem_type_id,
+                                hid_t mem_space_id, hid_t space_id)
+      {
+        retval = var.array->read (b.dims (), [&] (char *p)
+        {
+          if (b.dims ().numel () > 0
+              && H5Dread (data_id, mem_type_id, mem_space_id, space_id,
+                          octave_H5P_DEFAULT, p) < 0)
+            error ("matfile: trouble reading '%s' from '%s'",
+                   name.c_str (), filename.c_str ());
+        });
+      });
+
+      hs.close ();
+#else
+      err_disabled_feature ("matfile", "HDF5");
+#endif
+    }
+  else if (format.type () == load_save_system::BINARY && ! use_zlib)
+    {
+      std::ifstream is = sys::ifstream (filename.c_str (),
+                                        std::ios::in | std::ios::binary);
+
+      bool swap = false;
+      mach_info::float_format flt_fmt = mach_info::flt_fmt_unknown;
+
+      if (! matfile_binary_open (is, swap, flt_fmt))
+        err_file_open ("matfile", filename);
+
+      matfile_var var = matfile_binary_find (is, swap, flt_fmt, filename,
+                                             name, offset);
+
+      matfile_block b = matfile_get_block (args, 3, var);
+
+      const matfile_array_type& t = *var.array;
+
+      std::streamoff size = (t.ncomp > 0
+                             ? t.ncomp * matfile_save_type_size (var.st)
+                             : t.size);
+
+      retval = t.read (b.dims (), [&] (char *p)
+      {
+        matfile_block_runs (var.dims, b, [&] (octave_idx_type elt,
+                                              octave_idx_type n,
+                                              octave_idx_type k)
+        {
+          char *dest = p + k * t.size;
+
+          is.seekg (var.data_offset + elt * size);
+
+          if (t.ncomp == 0)
+            {
+              is.read (dest, n * t.size);
+
+              if (swap)
+                {
+                  if (t.size == 2)
+                    swap_bytes<2> (dest, n);
+                  else if (t.size == 4)
+                    swap_bytes<4> (dest, n);
+                  else if (t.size == 8)
+                    swap_bytes<8> (dest, n);
+                }
+            }
+          else if (t.single)
+            read_floats (is, reinterpret_cast<float *> (dest), var.st,
+                         n * t.ncomp, swap, flt_fmt);
+          else
+            read_doubles (is, reinterpret_cast<double *> (dest), var.st,
+                          n * t.ncomp, swap, flt_fmt);
+
+          if (! is)
+            error ("matfile: trouble reading binary file '%s'",
+                   filename.c_str ());
+        });
+      });
+    }
+  else
+    error ("matfile: '%s' is not an HDF5 file or an uncompressed Octave binary file",
+           filename.c_str ());
+
+  return retval;
+}
+
+DEFUN (__matfile_write__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn  {} {} __matfile_write__ (@var{file}, @var{name}, @var{val})
+@deftypefnx {} {} __matfile_write__ (@var{file}, @var{name}, @var{offset}, @var{start}, @var{count}, @var{stride}, @var{val})
+Undocumented internal function.
+@end deftypefn */)
+{
+  int nargin = args.length ();
+
+  if (nargin != 3 && nargin != 7)
+    print_usage ();
+
+  std::string filename
+    = sys::file_ops::tilde_expand (args(0).xstring_value ("matfile: FILE must be a string"));
+  std::string name = args(1).xstring_value ("matfile: NAME must be a string");
+
+  octave_value val = args(nargin-1);
+
+  bool use_zlib = false;
+
+  load_save_format format
+    = load_save_system::get_file_format (filename, filename, use_zlib, true);
+
+  if (nargin == 3)
+    {
+      // Save the whole variable.  New files are HDF5 files.
+
+      if (! valid_identifier (name))
+        error ("matfile: invalid variable name '%s'", name.c_str ());
+
+      if (format.type () == load_save_system::HDF5
+          || (format.type () == load_save_system::UNKNOWN
+              && ! sys::file_exists (filename)))
+        {
+#if defined (HAVE_HDF5)
+          hdf5_ofstream hs (filename.c_str (),
+                            std::ios::out | std::ios::app | std::ios::binary);
+
+          if (hs.file_id < 0)
+            err_file_open ("matfile", filename);
+
+          if (matfile_hdf5_exists (hs.file_id, name))
+            {
+#if defined (HAVE_HDF5_18)
+              H5Ldelete (hs.file_id, name.c_str (), octave_H5P_DEFAULT);
+#else
+              H5Gunlink (hs.file_id, name.c_str ());
+#endif
+            }
+
+          add_hdf5_data (hs.file_id, val, name, "", false, false);
+
+          hs.close ();
+#else
+          err_disabled_feature ("matfile", "HDF5");
+#endif
+        }
+      else if (format.type () == load_save_system::BINARY && ! use_zlib)
+        {
+          bool swap = false;
+          mach_info::float_format flt_fmt = mach_info::flt_fmt_unknown;
+
+          {
+            std::ifstream is = sys::ifstream (filename.c_str (),
+                                              std::ios::in | std::ios::binary);
+
+            if (! matfile_binary_open (is, swap, flt_fmt))
+              err_file_open ("matfile", filename);
+          }
+
+          if (swap || flt_fmt != mach_info::native_float_format ())
+            error ("matfile: cannot write to '%s', which was saved with a different byte order",
+                   filename.c_str ());
+
+          // The new value is appended, and replaces previous ones when
+          // the file is loaded.
+
+          std::ofstream os = sys::ofstream (filename.c_str (),
+                                            std::ios::out | std::ios::app
+                                            | std::ios::binary);
+
+          if (! os || ! save_binary_data (os, val, name, "", false, false))
+            error ("matfile: trouble writing binary file '%s'",
+                   filename.c_str ());
+        }
+      else
+        error ("matfile: '%s' is not an HDF5 file or an uncompressed Octave binary file",
+               filename.c_str ());
+
+      return ovl ();
+    }
+
+  std::streamoff offset = args(2).xidx_type_value ("matfile: OFFSET must be an integer");
+
+  auto check_numel = [&] (const matfile_block& b)
+  {
+    if (val.numel () != b.dims ().numel ())
+      error ("matfile: =: nonconformant arguments (op1 is %s, op2 is %s)",
+             b.dims ().str ().c_str (), val.dims ().str ().c_str ());
+  };
+
+  if (format.type () == load_save_system::HDF5)
+    {
+#if defined (HAVE_HDF5)
+      hdf5_ofstream hs (filename.c_str (),
+                        std::ios::out | std::ios::app | std::ios::binary);
+
+      if (hs.file_id < 0)
+        err_file_open ("matfile", filename);
+
+      matfile_hdf5_access (hs.file_id, name, args, 3, true,
+                           [&] (const matfile_var& var, const matfile_block& b,
+                                hid_t data_id, hid_t mem_type_id,
+                                hid_t mem_space_id, hid_t space_id)
+      {
+        check_numel (b);
+
+        var.array->write (val, [&] (const char *p)
+        {
+          if (b.dims ().numel () > 0
+              && H5Dwrite (data_id, mem_type_id, mem_space_id, space_id,
+                           octave_H5P_DEFAULT, p) < 0)
+            error ("matfile: trouble writing '%s' to '%s'",
+                   name.c_str (), filename.c_str ());
+        });
+      });
+
+      hs.close ();
+#else
+      err_disabled_feature ("matfile", "HDF5");
+#endif
+    }
+  else if (format.type () == load_save_system::BINARY && ! use_zlib)
+    {
+      std::fstream fs = sys::fstream (filename.c_str (),
+                                      std::ios::in | std::ios::out
+                                      | std::ios::binary);
+
+      bool swap = false;
+      mach_info::float_format flt_fmt = mach_info::flt_fmt_unknown;
+
+      if (! matfile_binary_open (fs, swap, flt_fmt))
+        err_file_open ("matfile", filename);
+
+      matfile_var var = matfile_binary_find (fs, swap, flt_fmt, filename,
+                                             name, offset);
+
+      if (! var.in_place)
+        error ("matfile: '%s' is saved with a different type and cannot be written in parts",
+               name.c_str ());
+
+      matfile_block b = matfile_get_block (args, 3, var);
+
+      check_numel (b);
+
+      const matfile_array_type& t = *var.array;
+
+      t.write (val, [&] (const char *p)
+      {
+        matfile_block_runs (var.dims, b, [&] (octave_idx_type elt,
+                                              octave_idx_type n,
+                                              octave_idx_type k)
+        {
+          fs.seekp (var.data_offset + elt * t.size);
+
+          if (! fs.write (p + k * t.size, n * t.size))
+            error ("matfile: trouble writing binary file '%s'",
+                   filename.c_str ());
+        });
+      });
+    }
+  else
+    error ("matfile: '%s' is not an HDF5 file or an uncompressed Octave binary file",
+           filename.c_str ());
+
+  return ovl ();
+}
+
 OCTAVE_END_NAMESPACE(octave)
@@ -30,6 +30,7 @@
 
 #include <iosfwd>
 #include <string>
+#include <vector>
 
 #include "mach-info.h"
 
@@ -157,6 +158,28 @@ public:
     return set (m_save_header_format_string, format);
   }
 
+  OCTINTERP_API octave_value
+  save_hdf5_options (const octave_value_list& args, int nargout);
+
+  // True while "save -hdf5 -zip" writes a file.  Arrays are then
+  // stored in chunked datasets using the filters below.
+  bool hdf5_compress () const { return m_hdf5_compress; }
+
+  int hdf5_deflate_level () const { return m_hdf5_deflate_level; }
+
+  bool hdf5_shuffle () const { return m_hdf5_shuffle; }
+
+  bool hdf5_fletcher32 () const { return m_hdf5_fletcher32; }
+
+  double hdf5_chunk_bytes () const { return m_hdf5_chunk_bytes; }
+
+  // Dimensions of the chunks in Octave's order.  If empty, the chunk
+  // shape is chosen from the dimensions of each array.
+  const std::vector<octave_idx_type>& hdf5_chunk_shape () const
+  {
+    return m_hdf5_chunk_shape;
+  }
+
   static OCTINTERP_API load_save_format
   get_file_format (const std::string& fname, const std::string& orig_fname,
                    bool& use_zlib, bool quiet = false);
@@ -221,6 +244,14 @@ private:
   // '#' and contain no newline characters.
   std::string m_save_header_format_string;
 
+  // Storage options for arrays in HDF5 files.  See save_hdf5_options.
+  bool m_hdf5_compress;
+  int m_hdf5_deflate_level;
+  bool m_hdf5_shuffle;
+  bool m_hdf5_fletcher32;
+  double m_hdf5_chunk_bytes;
+  std::vector<octave_idx_type> m_hdf5_chunk_shape;
+
   OCTINTERP_API void
   write_header (std::ostream& os, const load_save_format& fmt);
 
@@ -30,7 +30,9 @@
 #if defined (HAVE_HDF5)
 
 #include <cctype>
+#include <cstring>
 
+#include <algorithm>
 #include <iomanip>
 #include <istream>
 #include <limits>
@@ -45,6 +47,7 @@
 #include "lo-mappers.h"
 #include "mach-info.h"
 #include "oct-env.h"
+#include "oct-parallel.h"
 #include "oct-time.h"
 #include "quit.h"
 #include "str-vec.h"
@@ -73,6 +76,10 @@
 #include "ls-utils.h"
 #include "ls-hdf5.h"
 
+#if defined (HAVE_ZLIB)
+#  include <zlib.h>
+#endif
+
 #if defined (HAVE_HDF5)
 
 static hid_t
@@ -1246,6 +1253,371 @@ hdf5_add_scalar_attr (octave_hdf5_id loc_id, octave_hdf5_id type_id,
 #endif
 }
 
+#if defined (HAVE_HDF5)
+
+// Compute the dimensions CHUNK of the chunks of a dataset with
+// dimensions DIMS in HDF5's order, in which the last dimension varies
+// fastest.
+
+static void
+hdf5_chunk_dims (const octave::load_save_system& lss, int rank,
+                 const hsize_t *dims, std::size_t elt_size, hsize_t *chunk)
+{
+  const std::vector<octave_idx_type>& shape = lss.hdf5_chunk_shape ();
+
+  if (! shape.empty ())
+    {
+      for (int i = 0; i < rank; i++)
+        {
+          std::size_t k = rank - i - 1;
+
+          hsize_t n = (k < shape.size () ? shape[k] : 1);
+
+          chunk[i] = std::min (n, dims[i]);
+        }
+    }
+  else
+    {
+      // Chunks hold complete columns, pages, etc. as long as they are
+      // not larger than the requested size.
+
+      hsize_t max_elts = std::max (lss.hdf5_chunk_bytes () / elt_size, 1.0);
+      hsize_t n = 1;
+
+      for (int i = rank - 1; i >= 0; i--)
+        {
+          chunk[i] = std::max<hsize_t> (std::min (dims[i], max_elts / n), 1);
+          n *= chunk[i];
+        }
+    }
+}
+
+#endif
+
+// Create the dataset NAME in LOC_ID for elements of type TYPE_ID with
+// the dimensions of SPACE_ID.  While "save -hdf5 -zip" writes a file,
+// arrays of at least 1 kilobyte are stored in chunks that are
+// compressed with the filters that are selected by save_hdf5_options.
+// Returns the ID of the dataset or a negative value on error.
+
+octave_hdf5_id
+hdf5_create_dataset (octave_hdf5_id loc_id, const char *name,
+                     octave_hdf5_id type_id, octave_hdf5_id space_id)
+{
+#if defined (HAVE_HDF5)
+
+  hid_t dcpl_hid = H5Pcreate (H5P_DATASET_CREATE);
+
+  if (dcpl_hid < 0)
+    return -1;
+
+  octave::unwind_action close_dcpl ([dcpl_hid] () { H5Pclose (dcpl_hid); });
+
+  octave::load_save_system& lss = octave::__get_load_save_system__ ();
+
+  int rank = H5Sget_simple_extent_ndims (space_id);
+  std::size_t elt_size = H5Tget_size (type_id);
+  hssize_t numel = H5Sget_simple_extent_npoints (space_id);
+
+  if (lss.hdf5_compress () && rank > 0 && elt_size > 0 && numel > 0
+      && numel * elt_size >= 1024)
+    {
+      OCTAVE_LOCAL_BUFFER (hsize_t, dims, rank);
+      OCTAVE_LOCAL_BUFFER (hsize_t, chunk, rank);
+
+      H5Sget_simple_extent_dims (space_id, dims, nullptr);
+
+      hdf5_chunk_dims (lss, rank, dims, elt_size, chunk);
+
+      if (H5Pset_chunk (dcpl_hid, rank, chunk) < 0)
+        return -1;
+
+      if (lss.hdf5_shuffle () && elt_size > 1
+          && H5Pset_shuffle (dcpl_hid) < 0)
+        return -1;
+
+      if (lss.hdf5_deflate_level () > 0
+          && H5Zfilter_avail (H5Z_FILTER_DEFLATE) > 0
+          && H5Pset_deflate (dcpl_hid, lss.hdf5_deflate_level ()) < 0)
+        return -1;
+
+      if (lss.hdf5_fletcher32 () && H5Pset_fletcher32 (dcpl_hid) < 0)
+        return -1;
+    }
+
+#  if defined (HAVE_HDF5_18)
+  return H5Dcreate (loc_id, name, type_id, space_id, octave_H5P_DEFAULT,
+                    dcpl_hid, octave_H5P_DEFAULT);
+#  else
+  return H5Dcreate (loc_id, name, type_id, space_id, dcpl_hid);
+#  endif
+
+#else
+  octave_unused_parameter (loc_id);
+  octave_unused_parameter (name);
+  octave_unused_parameter (type_id);
+  octave_unused_parameter (space_id);
+
+  err_disabled_feature ("hdf5_create_dataset", "HDF5");
+#endif
+}
+
+#if defined (HAVE_HDF5) && defined (HAVE_H5DWRITE_CHUNK) && defined (HAVE_ZLIB)
+
+// Write the dataset DATA_HID from BUF by compressing its chunks in
+// parallel and writing them directly, bypassing the filter pipeline of
+// HDF5.  This is only done if the chunks are compressed with deflate,
+// optionally after shuffling the bytes of their elements, and if the
+// elements in memory have the same type as in the file.  Returns 1 if
+// the data was written, 0 if the dataset is not suitable, and -1 on
+// error.
+
+static int
+hdf5_write_chunks_parallel (hid_t data_hid, hid_t mem_type_hid,
+                            const void *buf)
+{
+  hid_t dcpl_hid = H5Dget_create_plist (data_hid);
+  hid_t type_hid = H5Dget_type (data_hid);
+  hid_t space_hid = H5Dget_space (data_hid);
+
+  octave::unwind_action close_ids ([=] ()
+  {
+    if (space_hid >= 0)
+      H5Sclose (space_hid);
+    if (type_hid >= 0)
+      H5Tclose (type_hid);
+    if (dcpl_hid >= 0)
+      H5Pclose (dcpl_hid);
+  });
+
+  if (dcpl_hid < 0 || type_hid < 0 || space_hid < 0)
+    return -1;
+
+  if (H5Pget_layout (dcpl_hid) != H5D_CHUNKED
+      || H5Tequal (type_hid, mem_type_hid) <= 0)
+    return 0;
+
+  int nfilters = H5Pget_nfilters (dcpl_hid);
+  bool shuffle = false;
+  int level = -1;
+
+  for (int i = 0; i < nfilters; i++)
+    {
+      unsigned int flags;
+      std::size_t nvals = 1;
+      unsigned int vals[1] = { 0 };
+      unsigned int config;
+
+      H5Z_filter_t filter = H5Pget_filter2 (dcpl_hid, i, &flags, &nvals,
+                                            vals, 0, nullptr, &config);
+
+      if (filter == H5Z_FILTER_SHUFFLE && i == 0)
+        shuffle = true;
+      else if (filter == H5Z_FILTER_DEFLATE && i == nfilters - 1)
+        level = vals[0];
+      else
+        return 0;
+    }
+
+  if (level < 0)
+    return 0;
+
+  int rank = H5Sget_simple_extent_ndims (space_hid);
+
+  if (rank <= 0)
+    return 0;
+
+  std::vector<hsize_t> dims (rank);
+  std::vector<hsize_t> chunk (rank);
+
+  H5Sget_simple_extent_dims (space_hid, dims.data (), nullptr);
+
+  if (H5Pget_chunk (dcpl_hid, rank, chunk.data ()) != rank)
+    return 0;
+
+  std::size_t elt_size = H5Tget_size (type_hid);
+
+  // Number of chunks along each dimension and distance between
+  // consecutive elements of each dimension in BUF and in a chunk.
+
+  std::vector<hsize_t> nchunks_dim (rank);
+  std::vector<hsize_t> buf_stride (rank);
+  std::vector<hsize_t> chunk_stride (rank);
+
+  hsize_t nchunks = 1;
+  hsize_t chunk_elts = 1;
+  hsize_t buf_elts = 1;
+
+  for (int i = rank - 1; i >= 0; i--)
+    {
+      nchunks_dim[i] = (dims[i] + chunk[i] - 1) / chunk[i];
+      nchunks *= nchunks_dim[i];
+
+      buf_stride[i] = buf_elts;
+      buf_elts *= dims[i];
+
+      chunk_stride[i] = chunk_elts;
+      chunk_elts *= chunk[i];
+    }
+
+  if (! octave::use_parallel_loop (nchunks, chunk_elts))
+    return 0;
+
+  std::size_t chunk_bytes = chunk_elts * elt_size;
+  uLong max_len = compressBound (chunk_bytes);
+
+  // The offset of chunk K in elements along each dimension.
+
+  auto chunk_offset = [&] (hsize_t k, hsize_t *offset)
+  {
+    for (int i = rank - 1; i >= 0; i--)
+      {
+        offset[i] = (k % nchunks_dim[i]) * chunk[i];
+        k /= nchunks_dim[i];
+      }
+  };
+
+  const char *src = static_cast<const char *> (buf);
+
+  // Compress a batch of chunks in parallel, then write them in order.
+
+  octave_idx_type batch_size
+    = std::min<hsize_t> (nchunks, 4 * octave::max_num_threads ());
+
+  std::vector<std::vector<Bytef>> out (batch_size,
+                                       std::vector<Bytef> (max_len));
+  std::vector<uLongf> out_len (batch_size);
+
+  std::vector<hsize_t> offset (rank);
+
+  for (hsize_t first = 0; first < nchunks; first += batch_size)
+    {
+      octave_quit ();
+
+      octave_idx_type n = std::min<hsize_t> (batch_size, nchunks - first);
+
+      octave::parallel_for (n, [&] (octave_idx_type b0, octave_idx_type b1)
+      {
+        std::vector<char> data (chunk_bytes);
+        std::vector<char> tmp (shuffle ? chunk_bytes : 0);
+        std::vector<hsize_t> start (rank);
+        std::vector<hsize_t> count (rank);
+        std::vector<hsize_t> pos (rank);
+
+        for (octave_idx_type b = b0; b < b1; b++)
+          {
+            chunk_offset (first + b, start.data ());
+
+            for (int i = 0; i < rank; i++)
+              count[i] = std::min (chunk[i], dims[i] - start[i]);
+
+            // Copy the rows along the last dimension that are in the
+            // chunk.  Edge chunks are padded with zeros.
+
+            if (count != chunk)
+              std::fill (data.begin (), data.end (), 0);
+
+            std::fill (pos.begin (), pos.end (), 0);
+
+            std::size_t row_bytes = count[rank-1] * elt_size;
+
+            while (true)
+              {
+                hsize_t src_idx = start[rank-1];
+                hsize_t dst_idx = 0;
+
+                for (int i = 0; i < rank - 1; i++)
+                  {
+                    src_idx += (start[i] + pos[i]) * buf_stride[i];
+                    dst_idx += pos[i] * chunk_stride[i];
+                  }
+
+                std::memcpy (data.data () + dst_idx * elt_size,
+                             src + src_idx * elt_size, row_bytes);
+
+                int i = rank - 2;
+
+                for (; i >= 0; i--)
+                  {
+                    if (++pos[i] < count[i])
+                      break;
+
+                    pos[i] = 0;
+                  }
+
+                if (i < 0)
+                  break;
+              }
+
+            const char *in = data.data ();
+
+            if (shuffle && elt_size > 1)
+              {
+                // Byte J of element I is moved to position J*N+I, as
+                // done by the shuffle filter of HDF5.
+
+                for (std::size_t j = 0; j < elt_size; j++)
+                  for (hsize_t i = 0; i < chunk_elts; i++)
+                    tmp[j*chunk_elts+i] = data[i*elt_size+j];
+
+                in = tmp.data ();
+              }
+
+            out_len[b] = max_len;
+
+            if (compress2 (out[b].data (), &out_len[b],
+                           reinterpret_cast<const Bytef *> (in),
+                           chunk_bytes, level) != Z_OK)
+              out_len[b] = 0;
+          }
+      }, chunk_elts);
+
+      for (octave_idx_type b = 0; b < n; b++)
+        {
+          if (out_len[b] == 0)
+            return -1;
+
+          chunk_offset (first + b, offset.data ());
+
+          if (H5Dwrite_chunk (data_hid, octave_H5P_DEFAULT, 0, offset.data (),
+                              out_len[b], out[b].data ()) < 0)
+            return -1;
+        }
+    }
+
+  return 1;
+}
+
+#endif
+
+// Write all elements of the dataset DATA_ID from BUF, in which they
+// have the type MEM_TYPE_ID.  Returns true on success.
+
+bool
+hdf5_write_dataset (octave_hdf5_id data_id, octave_hdf5_id mem_type_id,
+                    const void *buf)
+{
+#if defined (HAVE_HDF5)
+
+#  if defined (HAVE_H5DWRITE_CHUNK) && defined (HAVE_ZLIB)
+  int status = hdf5_write_chunks_parallel (data_id, mem_type_id, buf);
+
+  if (status != 0)
+    return status > 0;
+#  endif
+
+  return H5Dwrite (data_id, mem_type_id, octave_H5S_ALL, octave_H5S_ALL,
+                   octave_H5P_DEFAULT, buf) >= 0;
+
+#else
+  octave_unused_parameter (data_id);
+  octave_unused_parameter (mem_type_id);
+  octave_unused_parameter (buf);
+
+  err_disabled_feature ("hdf5_write_dataset", "HDF5");
+#endif
+}
+
 // Save an empty matrix, if needed.  Returns
 //    > 0  Saved empty matrix
 //    = 0  Not an empty matrix; did nothing
@@ -145,6 +145,14 @@ add_hdf5_data (octave_hdf5_id loc_id, const octave_value& tc,
                const std::string& name, const std::string& doc,
                bool mark_global, bool save_as_floats);
 
+extern OCTINTERP_API octave_hdf5_id
+hdf5_create_dataset (octave_hdf5_id loc_id, const char *name,
+                     octave_hdf5_id type_id, octave_hdf5_id space_id);
+
+extern OCTINTERP_API bool
+hdf5_write_dataset (octave_hdf5_id data_id, octave_hdf5_id mem_type_id,
+                    const void *buf);
+
 extern OCTINTERP_API int
 save_hdf5_empty (octave_hdf5_id loc_id, const char *name, const dim_vector& d);
 
@@ -29,6 +29,7 @@
 
 #include <cstring>
 
+#include <algorithm>
 #include <iomanip>
 #include <istream>
 #include <limits>
@@ -48,6 +49,7 @@
 #include "mach-info.h"
 #include "oct-env.h"
 #include "oct-locbuf.h"
+#include "oct-parallel.h"
 #include "oct-time.h"
 #include "quit.h"
 #include "str-vec.h"
@@ -467,6 +469,186 @@ read_int (std::istream& is, bool swap, int32_t& val)
     swap_bytes<4> (&val);
 }
 
+#if defined (HAVE_ZLIB)
+
+// A stream buffer for reading an uncompressed data element from
+// memory without the copy that std::istringstream would make.
+
+class mat5_element_buf : public std::streambuf
+{
+public:
+
+  mat5_element_buf (char *data, std::size_t len)
+  {
+    setg (data, data, data + len);
+  }
+
+  OCTAVE_DISABLE_CONSTRUCT_COPY_MOVE (mat5_element_buf)
+
+  ~mat5_element_buf () = default;
+
+protected:
+
+  pos_type seekoff (off_type off, std::ios_base::seekdir dir,
+                    std::ios_base::openmode which = std::ios_base::in)
+  {
+    if (! (which & std::ios_base::in))
+      return pos_type (off_type (-1));
+
+    off_type base = (dir == std::ios_base::beg ? 0
+                     : dir == std::ios_base::cur ? gptr () - eback ()
+                     : egptr () - eback ());
+
+    off_type pos = base + off;
+
+    if (pos < 0 || pos > egptr () - eback ())
+      return pos_type (off_type (-1));
+
+    setg (eback (), eback () + pos, egptr ());
+
+    return pos_type (pos);
+  }
+
+  pos_type seekpos (pos_type pos,
+                    std::ios_base::openmode which = std::ios_base::in)
+  {
+    return seekoff (off_type (pos), std::ios_base::beg, which);
+  }
+};
+
+static std::string
+zlib_error_message (int err)
+{
+  switch (err)
+    {
+    case Z_STREAM_END:
+      return "stream end";
+
+    case Z_NEED_DICT:
+      return "need dict";
+
+    case Z_ERRNO:
+      return "errno case";
+
+    case Z_STREAM_ERROR:
+      return "stream error";
+
+    case Z_DATA_ERROR:
+      return "data error";
+
+    case Z_MEM_ERROR:
+      return "mem error";
+
+    case Z_BUF_ERROR:
+      return "buf error";
+
+    case Z_VERSION_ERROR:
+      return "version error";
+
+    default:
+      return "unknown error";
+    }
+}
+
+// Inflate the compressed data element of ELEMENT_LENGTH bytes at the
+// current position of IS into OUTBUF.  The compressed data is read in
+// pieces and inflated in a single pass.  The tag of the uncompressed
+// element is inflated first, and its length determines the size of
+// OUTBUF.
+
+static void
+inflate_mat5_element (std::istream& is, int32_t element_length, bool swap,
+                      std::vector<char>& outbuf)
+{
+  z_stream strm;
+  strm.zalloc = Z_NULL;
+  strm.zfree = Z_NULL;
+  strm.opaque = Z_NULL;
+  strm.next_in = Z_NULL;
+  strm.avail_in = 0;
+
+  if (inflateInit (&strm) != Z_OK)
+    error ("load: error uncompressing data element (%s from zlib)",
+           zlib_error_message (Z_MEM_ERROR).c_str ());
+
+  octave::unwind_action end_inflate ([&strm] () { inflateEnd (&strm); });
+
+  const std::size_t max_piece = 1 << 20;
+
+  std::size_t remaining = element_length;
+  std::vector<char> inbuf (std::min (remaining, max_piece));
+
+  uint32_t tag[2] = { 0, 0 };
+
+  strm.next_out = reinterpret_cast<Bytef *> (tag);
+  strm.avail_out = 8;
+
+  bool have_tag = false;
+
+  while (true)
+    {
+      if (strm.avail_in == 0 && remaining > 0)
+        {
+          std::size_t n = std::min (remaining, max_piece);
+
+          if (! is.read (inbuf.data (), n))
+            error ("load: failed to read compressed data element");
+
+          remaining -= n;
+
+          strm.next_in = reinterpret_cast<Bytef *> (inbuf.data ());
+          strm.avail_in = n;
+        }
+
+      int err = inflate (&strm, Z_NO_FLUSH);
+
+      if (! have_tag && strm.avail_out == 0)
+        {
+          if (swap)
+            swap_bytes<4> (tag, 2);
+
+          std::size_t len = static_cast<std::size_t> (tag[1]) + 8;
+
+          outbuf.resize (len);
+          std::memcpy (outbuf.data (), tag, 8);
+
+          strm.next_out = reinterpret_cast<Bytef *> (outbuf.data () + 8);
+          strm.avail_out = len - 8;
+
+          have_tag = true;
+
+          if (err == Z_OK && len > 8)
+            continue;
+        }
+
+      // Stop when the stream ends or when as many bytes were inflated
+      // as the data element header says.  Some files contain more data
+      // after that, which is skipped.
+
+      if (have_tag && (err == Z_STREAM_END || strm.avail_out == 0))
+        break;
+
+      if (err == Z_BUF_ERROR && strm.avail_in == 0 && remaining == 0)
+        error ("load: error uncompressing data element (%s from zlib)",
+               zlib_error_message (err).c_str ());
+
+      if (err != Z_OK && err != Z_BUF_ERROR)
+        error ("load: error uncompressing data element (%s from zlib)",
+               zlib_error_message (err).c_str ());
+    }
+
+  if (strm.avail_out != 0)
+    error ("load: error uncompressing data element (%s from zlib)",
+           zlib_error_message (Z_BUF_ERROR).c_str ());
+
+  // Skip the compressed data that was not needed.
+
+  if (remaining > 0)
+    is.seekg (remaining, std::ios::cur);
+}
+
+#endif
+
 // Extract one data element (scalar, matrix, string, etc.) from stream
 // IS and place it in TC, returning the name of the variable.
 //
@@ -518,94 +700,14 @@ read_mat5_binary_element (std::istream& is, const std::string& filename,
   if (type == miCOMPRESSED)
     {
 #if defined (HAVE_ZLIB)
-      // If C++ allowed us direct access to the file descriptor of an
-      // ifstream in a uniform way, the code below could be vastly
-      // simplified, and additional copies of the data in memory
-      // wouldn't be needed.
-
-      OCTAVE_LOCAL_BUFFER (char, inbuf, element_length);
-      is.read (inbuf, element_length);
-
-      // We uncompress the first 8 bytes of the header to get the buffer length
-      // This will fail with an error Z_MEM_ERROR
-      uLongf destLen = 8;
-      uLongf elt_len = element_length;
-      OCTAVE_LOCAL_BUFFER (unsigned int, tmp, 2);
-      if (uncompress2 (reinterpret_cast<Bytef *> (tmp), &destLen,
-                       reinterpret_cast<Bytef *> (inbuf), &elt_len)
-          == Z_MEM_ERROR)
-        error ("load: error probing size of compressed data element");
-
-      // Why should I have to initialize outbuf as I'll just overwrite!!
-      if (swap)
-        swap_bytes<4> (tmp, 2);
-
-      destLen = tmp[1] + 8;
-      std::string outbuf (destLen, ' ');
-
-      // FIXME: find a way to avoid casting away const here!
-
-      elt_len = element_length;
-      int err = uncompress2 (reinterpret_cast<Bytef *>
-                             (const_cast<char *> (outbuf.c_str ())),
-                             &destLen, reinterpret_cast<Bytef *> (inbuf),
-                             &elt_len);
-
-      // Ignore buffer error if we have consumed all the input buffer
-      // and uncompressing the data generated as many bytes of output as
-      // we were expecting given the data element size that was stored
-      // in the Matlab data element header.
-      if (err == Z_BUF_ERROR && destLen == tmp[1] + 8
-          && elt_len == static_cast<uLongf> (element_length))
-        err = Z_OK;
-
-      if (err != Z_OK)
-        {
-          std::string msg;
-          switch (err)
-            {
-            case Z_STREAM_END:
-              msg = "stream end";
-              break;
-
-            case Z_NEED_DICT:
-              msg = "need dict";
-              break;
+      std::vector<char> outbuf;
 
-            case Z_ERRNO:
-              msg = "errno case";
-              break;
+      inflate_mat5_element (is, element_length, swap, outbuf);
 
-            case Z_STREAM_ERROR:
-              msg = "stream error";
-              break;
+      mat5_element_buf gz_buf (outbuf.data (), outbuf.size ());
+      std::istream gz_is (&gz_buf);
 
-            case Z_DATA_ERROR:
-              msg = "data error";
-              break;
-
-            case Z_MEM_ERROR:
-              msg = "mem error";
-              break;
-
-            case Z_BUF_ERROR:
-              msg = "buf error";
-              break;
-
-            case Z_VERSION_ERROR:
-              msg = "version error";
-              break;
-            }
-
-          error ("load: error uncompressing data element (%s from zlib)",
-                 msg.c_str ());
-        }
-      else
-        {
-          std::istringstream gz_is (outbuf);
-          retval = read_mat5_binary_element (gz_is, filename,
-                                             swap, global, tc);
-        }
+      retval = read_mat5_binary_element (gz_is, filename, swap, global, tc);
 
       return retval;
 
@@ -2314,6 +2416,138 @@ warn_dim_too_large (const std::string& name)
                    name.c_str ());
 }
 
+#if defined (HAVE_ZLIB)
+
+// Compress the LEN bytes at SRC into the zlib stream OUT.  Data of
+// more than one block is split into blocks that are compressed in
+// parallel with raw deflate.  Each block except the last ends with a
+// sync flush, so that the blocks can simply be concatenated, and uses
+// the 32 kilobytes of data before it as the dictionary, so that the
+// data compresses almost as well as in a single stream.  The checksums
+// of the blocks are combined into the one of the stream.  Returns false
+// on error.  The blocks do not depend on the number of threads, so
+// neither does the file.
+
+static bool
+compress_mat5_element (const char *src, std::size_t len,
+                       std::vector<char>& out)
+{
+  const std::size_t block_size = 1 << 20;
+  const std::size_t dict_size = 1 << 15;
+
+  octave_idx_type nblocks = (len + block_size - 1) / block_size;
+
+  if (nblocks < 2)
+    {
+      uLongf dest_len = compressBound (len);
+
+      out.resize (dest_len);
+
+      if (compress (reinterpret_cast<Bytef *> (out.data ()), &dest_len,
+                    reinterpret_cast<const Bytef *> (src), len)
+          != Z_OK)
+        return false;
+
+      out.resize (dest_len);
+
+      return true;
+    }
+
+  std::vector<std::vector<char>> blocks (nblocks);
+  std::vector<uLong> checksums (nblocks);
+  std::vector<char> ok (nblocks, false);
+
+  octave::parallel_for (nblocks, [&] (octave_idx_type b0, octave_idx_type b1)
+  {
+    for (octave_idx_type b = b0; b < b1; b++)
+      {
+        std::size_t offset = b * block_size;
+        std::size_t n = std::min (block_size, len - offset);
+        const Bytef *in = reinterpret_cast<const Bytef *> (src + offset);
+
+        checksums[b] = adler32 (adler32 (0, Z_NULL, 0), in, n);
+
+        z_stream strm;
+        strm.zalloc = Z_NULL;
+        strm.zfree = Z_NULL;
+        strm.opaque = Z_NULL;
+
+        if (deflateInit2 (&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -15, 8,
+                          Z_DEFAULT_STRATEGY) != Z_OK)
+          continue;
+
+        std::size_t dict_len = std::min (offset, dict_size);
+
+        bool last = (b == nblocks - 1);
+
+        // The sync flush marker needs up to 5 bytes more than
+        // deflateBound allows for.
+
+        std::vector<char>& buf = blocks[b];
+        buf.resize (deflateBound (&strm, n) + 16);
+
+        strm.next_in = const_cast<Bytef *> (in);
+        strm.avail_in = n;
+        strm.next_out = reinterpret_cast<Bytef *> (buf.data ());
+        strm.avail_out = buf.size ();
+
+        if (dict_len == 0
+            || deflateSetDictionary (&strm, in - dict_len, dict_len) == Z_OK)
+          {
+            int err = deflate (&strm, last ? Z_FINISH : Z_SYNC_FLUSH);
+
+            ok[b] = (last ? err == Z_STREAM_END
+                     : err == Z_OK && strm.avail_in == 0
+                       && strm.avail_out > 0);
+          }
+
+        buf.resize (strm.total_out);
+
+        deflateEnd (&strm);
+      }
+  }, block_size);
+
+  std::size_t total = 6;
+
+  for (octave_idx_type b = 0; b < nblocks; b++)
+    {
+      if (! ok[b])
+        return false;
+
+      total += blocks[b].size ();
+    }
+
+  out.resize (total);
+
+  // zlib header for the default compression level.
+
+  char *p = out.data ();
+  *p++ = 0x78;
+  *p++ = 0x9c;
+
+  uLong checksum = checksums[0];
+
+  for (octave_idx_type b = 0; b < nblocks; b++)
+    {
+      std::memcpy (p, blocks[b].data (), blocks[b].size ());
+      p += blocks[b].size ();
+
+      if (b > 0)
+        checksum = adler32_combine (checksum, checksums[b],
+                                    std::min (block_size,
+                                              len - b * block_size));
+    }
+
+  // The checksum is stored in big-endian byte order.
+
+  for (int i = 3; i >= 0; i--)
+    *p++ = static_cast<char> ((checksum >> (8 * i)) & 0xff);
+
+  return true;
+}
+
+#endif
+
 // save the data from TC along with the corresponding NAME on stream
 // OS in the MatLab version 5 binary format.  Return true on success.
 
@@ -2390,23 +2624,17 @@ save_mat5_binary_element (std::ostream& os,
 
       if (ret)
         {
-          // destLen must be at least 0.1% larger than source buffer
-          // + 12 bytes.  Reality is it must be larger again than that.
           std::string buf_str = buf.str ();
-          uLongf srcLen = buf_str.length ();
-          uLongf destLen = compressBound (srcLen);
-          OCTAVE_LOCAL_BUFFER (char, out_buf, destLen);
-
-          if (compress (reinterpret_cast<Bytef *> (out_buf), &destLen,
-                        reinterpret_cast<const Bytef *> (buf_str.c_str ()),
-                        srcLen)
-              != Z_OK)
+          std::vector<char> out_buf;
+
+          if (! compress_mat5_element (buf_str.data (), buf_str.length (),
+                                       out_buf))
             error ("save: error compressing data element");
 
           write_mat5_tag (os, miCOMPRESSED,
-                          static_cast<octave_idx_type> (destLen));
+                          static_cast<octave_idx_type> (out_buf.size ()));
 
-          os.write (out_buf, destLen);
+          os.write (out_buf.data (), out_buf.size ());
         }
 
       return ret;
@@ -27,8 +27,11 @@
 #  include "config.h"
 #endif
 
+#include "mx-simd.h"
 #include "nproc-wrapper.h"
+#include "oct-parallel.h"
 
+#include "Cell.h"
 #include "defun.h"
 #include "error.h"
 
@@ -112,4 +115,332 @@ same as @code{current}, but overridable through the
 %!error nproc ("no_valid_option")
 */
 
+DEFUN (maxNumCompThreads, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn  {} {@var{n} =} maxNumCompThreads ()
+@deftypefnx {} {@var{old_n} =} maxNumCompThreads (@var{n})
+@deftypefnx {} {@var{old_n} =} maxNumCompThreads ("automatic")
+Query or set the maximum number of threads used by element-wise operations
+and reductions on large arrays.
+
+Operations such as @code{@var{x} .* @var{y}}, @code{sum}, @code{prod},
+@code{max}, and @code{cumsum} split arrays with many elements among up to
+@var{n} threads, including the thread of the interpreter.  Setting @var{n}
+to 1 disables this.  The results do not depend on the number of threads.
+
+When called with an argument, set the maximum number of threads to @var{n}
+and return the previous value.  The value @qcode{"automatic"} restores the
+default, which is the number of processors returned by @code{nproc}.
+
+The number of threads used by the BLAS and LAPACK libraries, for example
+for matrix multiplication, is not affected.
+@seealso{nproc}
+@end deftypefn */)
+{
+  int nargin = args.length ();
+
+  if (nargin > 1)
+    print_usage ();
+
+  if (nargin == 0)
+    return ovl (max_num_threads ());
+
+  int n;
+
+  if (args(0).is_string ())
+    {
+      if (args(0).string_value () != "automatic")
+        error (R"(maxNumCompThreads: N must be a positive integer or "automatic")");
+
+      n = 0;
+    }
+  else
+    {
+      n = args(0).xint_value (R"(maxNumCompThreads: N must be a positive integer or "automatic")");
+
+      if (n < 1)
+        error (R"(maxNumCompThreads: N must be a positive integer or "automatic")");
+    }
+
+  return ovl (set_max_num_threads (n));
+}
+
+/*
+%!assert (maxNumCompThreads () >= 1)
+
+%!test
+%! old_n = maxNumCompThreads (3);
+%! unwind_protect
+%!   assert (maxNumCompThreads (), 3);
+%!   assert (maxNumCompThreads ("automatic"), 3);
+%!   assert (maxNumCompThreads (), nproc ());
+%! unwind_protect_cleanup
+%!   maxNumCompThreads (old_n);
+%! end_unwind_protect
+
+## Results must not depend on the number of threads
+%!test
+%! old_n = maxNumCompThreads ();
+%! old_threshold = __parallel_threshold__ (16);
+%! unwind_protect
+%!   x = rand (300, 400) - 0.5;
+%!   y = rand (300, 400);
+%!   x(7) = NaN;
+%!   v = x(:);
+%!   f = @(x, y, v) {x .* y, x - 2, y ./ x, sum (x), sum (x, 2), ...
+%!                   sum (v), prod (v + 1), sumsq (v), ...
+%!                   sum (single (v)), sum (int32 (1000 * v)), ...
+%!                   cumsum (x), max (x), min (x, [], 2), cummax (x), ...
+%!                   any (isnan (x)), all (x > -1), nnz (x > 0)};
+%!   maxNumCompThreads (1);
+%!   r1 = f (x, y, v);
+%!   maxNumCompThreads (4);
+%!   r4 = f (x, y, v);
+%!   assert (r4, r1);
+%!   [m, i] = max (x);
+%!   assert (x(sub2ind (size (x), i, 1:columns (x))), m);
+%! unwind_protect_cleanup
+%!   maxNumCompThreads (old_n);
+%!   __parallel_threshold__ (old_threshold);
+%! end_unwind_protect
+
+## Vectors along any dimension may be processed in parallel
+%!test
+%! old_n = maxNumCompThreads ();
+%! old_threshold = __parallel_threshold__ (16);
+%! unwind_protect
+%!   x = rand (40, 50, 3) - 0.5;
+%!   x([7, 300, 2500]) = NaN;
+%!   f = @(x) {cumsum(x, 2), cumprod(x, 3), cummax(x, 2), cummin(x, 3), ...
+%!             diff(x, 1, 2), diff(x, 2, 2), diff(x, 3, 3), ...
+%!             sort(x, 2), sort(x, 3, "descend"), ...
+%!             filter([1, 2], [1, -0.5], x, [], 2), filter(1, [1, 0.5], x)};
+%!   maxNumCompThreads (1);
+%!   r1 = f (x);
+%!   [m1, i1] = cummin (x, [], 2);
+%!   [s1, j1] = sort (x, 2);
+%!   maxNumCompThreads (4);
+%!   r4 = f (x);
+%!   [m4, i4] = cummin (x, [], 2);
+%!   [s4, j4] = sort (x, 2);
+%!   assert (r4, r1);
+%!   assert ({m4, i4, s4, j4}, {m1, i1, s1, j1});
+%!   assert (r4{1}(:,:,2), cumsum (x(:,:,2)')');
+%! unwind_protect_cleanup
+%!   maxNumCompThreads (old_n);
+%!   __parallel_threshold__ (old_threshold);
+%! end_unwind_protect
+
+## Indexing and indexed assignment may be processed in parallel
+%!test
+%! old_n = maxNumCompThreads ();
+%! old_threshold = __parallel_threshold__ (16);
+%! unwind_protect
+%!   x = rand (200, 300);
+%!   m = x > 0.3;
+%!   m(end) = false;
+%!   idx = randi (numel (x), 1, 5000);
+%!   cols = [300:-2:1, 5, 5, 7];
+%!   v = -(1:nnz (m));
+%!   b = rand (200, numel (cols));
+%!   mc = rand (1, 300) > 0.2;
+%!   bc = rand (200, nnz (mc));
+%!   f = @(x) {x(idx), x(m), x(:, cols), x(1:3:end, cols), ...
+%!             subsasgn (x, substruct ("()", {m}), v), ...
+%!             subsasgn (x, substruct ("()", {m}), 0), ...
+%!             subsasgn (x, substruct ("()", {idx}), 1:5000), ...
+%!             subsasgn (x, substruct ("()", {":", cols}), b), ...
+%!             subsasgn (x, substruct ("()", {":", 300:-1:1}), x), ...
+%!             single (x)(m), int8 (10 * x)(:, cols), ...
+%!             x(:, mc), x(1:2:end, mc), ...
+%!             subsasgn (x, substruct ("()", {":", mc}), bc)};
+%!   maxNumCompThreads (1);
+%!   r1 = f (x);
+%!   maxNumCompThreads (4);
+%!   r4 = f (x);
+%!   assert (r4, r1);
+%!   assert (r4{2}, x(find (m)));
+%!   assert (r4{13}, x(1:2:end, find (mc)));
+%!   y = x;
+%!   y(:, find (mc)) = bc;
+%!   assert (r4{14}, y);
+%!   y = x;
+%!   y(find (m)) = v;
+%!   assert (r4{5}, y);
+%!   assert (r4{8}(:,5), b(:,end-1));
+%!   assert (r4{9}, fliplr (x));
+%! unwind_protect_cleanup
+%!   maxNumCompThreads (old_n);
+%!   __parallel_threshold__ (old_threshold);
+%! end_unwind_protect
+
+## Slabs of N-dimensional arrays may be indexed in parallel
+%!test
+%! old_n = maxNumCompThreads ();
+%! old_threshold = __parallel_threshold__ (16);
+%! unwind_protect
+%!   x = rand (20, 30, 40);
+%!   m = mod (1:40, 3) == 0;
+%!   mm = mod (1:30, 7) != 0;
+%!   f = @(x) {x(3:15, :, :), x(:, 2:2:end, m), x(:, :, [40, 1, 1]), ...
+%!             subsasgn (x, substruct ("()", {3:15, ":", ":"}), 0), ...
+%!             subsasgn (x, substruct ("()", {":", ":", m}), ...
+%!                       -x(:, :, m)), ...
+%!             subsasgn (x, substruct ("()", {":", ":", [2, 2]}), ...
+%!                       cat (3, x(:, :, 1), x(:, :, 3))), ...
+%!             x(1:2:end, mm, :), ...
+%!             subsasgn (x, substruct ("()", {1:2:20, mm, ":"}), ...
+%!                       -x(1:2:end, mm, :)), ...
+%!             subsasgn (x, substruct ("()", {1:2:20, mm, ":"}), 0)};
+%!   maxNumCompThreads (1);
+%!   r1 = f (x);
+%!   maxNumCompThreads (4);
+%!   r4 = f (x);
+%!   assert (r4, r1);
+%!   assert (r4{2}(:, :, 1), x(:, 2:2:end, 3));
+%!   assert (r4{6}(:, :, 2), x(:, :, 3));
+%!   assert (r4{7}, x(1:2:end, find (mm), :));
+%!   y = x;
+%!   y(1:2:end, find (mm), :) = 0;
+%!   assert (r4{9}, y);
+%!   y(1:2:end, find (mm), :) = -x(1:2:end, find (mm), :);
+%!   assert (r4{8}, y);
+%! unwind_protect_cleanup
+%!   maxNumCompThreads (old_n);
+%!   __parallel_threshold__ (old_threshold);
+%! end_unwind_protect
+
+%!error <Invalid call> maxNumCompThreads (1, 2)
+%!error <N must be a positive integer> maxNumCompThreads (0)
+%!error <N must be a positive integer> maxNumCompThreads (1.5)
+%!error <N must be a positive integer> maxNumCompThreads ("manual")
+*/
+
+DEFUN (__parallel_threshold__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn  {} {@var{n} =} __parallel_threshold__ ()
+@deftypefnx {} {@var{old_n} =} __parallel_threshold__ (@var{n})
+Query or set the minimum number of elements for which element-wise
+operations and reductions are split among several threads.
+@seealso{maxNumCompThreads}
+@end deftypefn */)
+{
+  int nargin = args.length ();
+
+  if (nargin > 1)
+    print_usage ();
+
+  if (nargin == 0)
+    return ovl (parallel_threshold ());
+
+  octave_idx_type n
+    = args(0).xidx_type_value ("__parallel_threshold__: N must be a positive integer");
+
+  if (n < 1)
+    error ("__parallel_threshold__: N must be a positive integer");
+
+  return ovl (set_parallel_threshold (n));
+}
+
+/*
+%!test
+%! old_n = __parallel_threshold__ (1000);
+%! unwind_protect
+%!   assert (__parallel_threshold__ (), 1000);
+%! unwind_protect_cleanup
+%!   __parallel_threshold__ (old_n);
+%! end_unwind_protect
+
+%!error <N must be a positive integer> __parallel_threshold__ (0)
+*/
+
+DEFUN (__simd_level__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn  {} {@var{level} =} __simd_level__ ()
+@deftypefnx {} {@var{old_level} =} __simd_level__ (@var{level})
+@deftypefnx {} {[@var{level}, @var{available}] =} __simd_level__ (@dots{})
+Query or set the SIMD instruction set used by element-wise kernels.
+
+@var{level} is one of @qcode{"none"}, @qcode{"avx2"}, or @qcode{"avx512"}.
+If the processor does not support @var{level}, the best supported
+instruction set is used instead.
+
+The second output @var{available} is a cell array of the names of all
+instruction sets that the processor supports, from @qcode{"none"} to the
+best one.
+@seealso{maxNumCompThreads}
+@end deftypefn */)
+{
+  static const char *names[] = { "none", "avx2", "avx512" };
+
+  int nargin = args.length ();
+
+  if (nargin > 1)
+    print_usage ();
+
+  int max_level = mx_simd_max_level ();
+
+  Cell available (1, max_level + 1);
+  for (int i = 0; i <= max_level; i++)
+    available(i) = names[i];
+
+  if (nargin == 0)
+    return ovl (names[mx_simd_current_level ()], available);
+
+  std::string name
+    = args(0).xstring_value ("__simd_level__: LEVEL must be a string");
+
+  mx_simd_level level;
+
+  if (name == "none")
+    level = MX_SIMD_NONE;
+  else if (name == "avx2")
+    level = MX_SIMD_AVX2;
+  else if (name == "avx512")
+    level = MX_SIMD_AVX512;
+  else
+    error (R"(__simd_level__: LEVEL must be "none", "avx2", or "avx512")");
+
+  return ovl (names[mx_simd_set_level (level)], available);
+}
+
+/*
+## Results must not depend on the instruction set
+%!test
+%! old_level = __simd_level__ ();
+%! unwind_protect
+%!   x = [-1, 0, -0, 1, NaN, Inf, -Inf, 2.5](randi (8, 1, 101));
+%!   y = [-1, 0, -0, 1, NaN, Inf, -Inf, 2.5](randi (8, 1, 101));
+%!   a = int8 (randi ([-128, 127], 1, 101));
+%!   b = uint16 (randi ([0, 65535], 1, 101));
+%!   f = @(x, y, a, b) {x < y, x <= 0, 1 > y, x >= y, x == y, x != y, ...
+%!                      single (x) < single (y), single (x) != 0, ...
+%!                      max (x, y), min (single (x), single (y)), ...
+%!                      isnan (x), isnan (single (y)), any (isnan (x)), ...
+%!                      a + a, a - 100, 100 - a, a .* a, a .* int8 (-3), ...
+%!                      uint8 (a) + uint8 (200), uint8 (a) - uint8 (a'), ...
+%!                      int16 (b / 2) .* int16 (3), b + b, b - 30000, ...
+%!                      b .* b};
+%!   [~, available] = __simd_level__ ();
+%!   assert (available{1}, "none");
+%!   __simd_level__ ("none");
+%!   r1 = f (x, y, a, b);
+%!   for i = 2:numel (available)
+%!     __simd_level__ (available{i});
+%!     assert (__simd_level__ (), available{i});
+%!     r2 = f (x, y, a, b);
+%!     assert (r2, r1);
+%!     assert (signbit (r2{9}), signbit (r1{9}));
+%!   endfor
+%! unwind_protect_cleanup
+%!   __simd_level__ (old_level);
+%! end_unwind_protect
+
+%!assert (int8 ([100, -100]) + int8 ([100, -100]), int8 ([127, -128]))
+%!assert (uint8 (1:40) - uint8 (20), uint8 ([zeros(1, 20), 1:20]))
+%!assert (int16 (1:40) .* int16 (1000), int16 (min (1000 * (1:40), 32767)))
+
+%!error <LEVEL must be> __simd_level__ ("sse")
+*/
+
 OCTAVE_END_NAMESPACE(octave)
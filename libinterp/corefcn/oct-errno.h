@@ -74,7 +74,7 @@ private:
 
   std::map<std::string, int> m_errno_tbl;
 
-  static octave_errno *s_instance;
+  OCTAVE_THREAD_LOCAL static octave_errno *s_instance;
 };
 
 #endif
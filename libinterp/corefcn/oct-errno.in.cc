@@ -37,7 +37,7 @@
 #include "oct-map.h"
 #include "error.h"
 
-octave_errno *octave_errno::s_instance = nullptr;
+OCTAVE_THREAD_LOCAL octave_errno *octave_errno::s_instance = nullptr;
 
 octave_errno::octave_errno ()
 {
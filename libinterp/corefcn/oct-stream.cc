@@ -31,13 +31,20 @@
 #include <cstring>
 
 #include <algorithm>
+#include <chrono>
+#include <condition_variable>
 #include <deque>
+#include <exception>
 #include <fstream>
 #include <limits>
 #include <iomanip>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <sstream>
+#include <streambuf>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "Array.h"
@@ -47,6 +54,7 @@
 #include "lo-mappers.h"
 #include "lo-utils.h"
 #include "oct-locbuf.h"
+#include "oct-syscalls.h"
 #include "octave-preserve-stream-state.h"
 #include "quit.h"
 #include "str-vec.h"
@@ -1256,6 +1264,10 @@ public:
   // Read character that will be got by the next get.
   int peek_undelim ();
 
+  // True if only characters in CHARS are left in the input.  More data
+  // may be read into the buffer, but no characters are consumed.
+  bool only_remaining (const std::string& chars);
+
   // Undo a 'get' or 'get_undelim'.  It is the caller's responsibility
   // to avoid overflow by calling putbacks only for a character got by
   // get() or get_undelim(), with no intervening
@@ -1439,6 +1451,32 @@ delimited_stream::peek_undelim ()
   return retval;
 }
 
+bool
+delimited_stream::only_remaining (const std::string& chars)
+{
+  // Number of characters after the current position that were checked.
+  std::ptrdiff_t n = 0;
+
+  while (true)
+    {
+      for (; m_idx + n < m_eob; n++)
+        {
+          if (chars.find (m_idx[n]) == std::string::npos)
+            return false;
+        }
+
+      if (eof () || m_i_stream.eof ())
+        return true;
+
+      refresh_buf ();
+
+      // The buffer is full of such characters.  Assume that more data
+      // follows.
+      if (m_eob - m_idx == n && ! m_i_stream.eof ())
+        return false;
+    }
+}
+
 // Copy remaining unprocessed data to the start of the buffer and load
 // new data to fill it.  Return EOF if the file is at EOF before
 // reading any data and all of the data that has been read has been
@@ -1814,9 +1852,23 @@ private:
 
   friend class textscan_format_list;
 
+  friend class textscan_reader;
+
   octave_value do_scan (std::istream& isp, textscan_format_list& fmt_list,
                         octave_idx_type ntimes);
 
+  octave_value scan_records (delimited_stream& is, std::istream& isp,
+                             textscan_format_list& fmt_list,
+                             octave_idx_type ntimes, bool first);
+
+  void check_format (const textscan_format_list& fmt_list) const;
+
+  void skip_header_lines (std::istream& isp) const;
+
+  int max_lookahead () const;
+
+  std::string buffer_delimiters () const;
+
   void parse_options (const octave_value_list& args,
                       textscan_format_list& fmt_list);
 
@@ -2567,30 +2619,53 @@ textscan::scan (std::istream& isp, const std::string& fmt,
   return result;
 }
 
-octave_value
-textscan::do_scan (std::istream& isp, textscan_format_list& fmt_list,
-                   octave_idx_type ntimes)
+void
+textscan::check_format (const textscan_format_list& fmt_list) const
 {
-  octave_value retval;
-
   if (fmt_list.num_conversions () == -1)
     error ("%s: invalid format specified", m_who.c_str ());
 
   if (fmt_list.num_conversions () == 0)
     error ("%s: no valid format conversion specifiers", m_who.c_str ());
+}
 
-  // skip the first header_lines
+void
+textscan::skip_header_lines (std::istream& isp) const
+{
   std::string dummy;
   for (int i = 0; i < m_header_lines && isp; i++)
     getline (isp, dummy, static_cast<char> (m_eol2));
+}
 
-  // Create our own buffered stream, for fast get/putback/tell/seek.
+// How far ahead the buffered stream should let us look.
+
+int
+textscan::max_lookahead () const
+{
+  return std::max ({m_comment_len, m_treat_as_empty_len,
+                    m_delim_len, 3});  // 3 for NaN and Inf
+}
+
+// The characters that end a fast read in the buffered stream.
+
+std::string
+textscan::buffer_delimiters () const
+{
+  return m_delims.empty () ? m_whitespace + "\r\n" : m_delims;
+}
+
+octave_value
+textscan::do_scan (std::istream& isp, textscan_format_list& fmt_list,
+                   octave_idx_type ntimes)
+{
+  check_format (fmt_list);
 
-  // First, see how far ahead it should let us look.
-  int max_lookahead = std::max ({m_comment_len, m_treat_as_empty_len,
-                                 m_delim_len, 3});  // 3 for NaN and Inf
+  // skip the first header_lines
+  skip_header_lines (isp);
+
+  // Create our own buffered stream, for fast get/putback/tell/seek.
 
-  // Next, choose a buffer size to avoid reading too much, or too often.
+  // Choose a buffer size to avoid reading too much, or too often.
   octave_idx_type buf_size = 4096;
   if (m_buffer_size)
     buf_size = m_buffer_size;
@@ -2601,10 +2676,23 @@ textscan::do_scan (std::istream& isp, textscan_format_list& fmt_list,
       buf_size = std::max (buf_size, ntimes);
     }
   // Finally, create the stream.
-  delimited_stream is (isp,
-                       (m_delims.empty () ? m_whitespace + "\r\n"
-                        : m_delims),
-                       max_lookahead, buf_size);
+  delimited_stream is (isp, buffer_delimiters (), max_lookahead (), buf_size);
+
+  return scan_records (is, isp, fmt_list, ntimes, true);
+}
+
+// Read up to NTIMES records from IS, which buffers ISP.  FIRST is false
+// if records have already been read from IS with the same format list,
+// as textscan_reader does.
+
+octave_value
+textscan::scan_records (delimited_stream& is, std::istream& isp,
+                        textscan_format_list& fmt_list,
+                        octave_idx_type ntimes, bool first)
+{
+  octave_value retval;
+
+  m_lines = 0;
 
   // Grow retval dynamically.  "size" is half the initial size
   // (FIXME: Should we start smaller if ntimes is large?)
@@ -2621,7 +2709,7 @@ textscan::do_scan (std::istream& isp, textscan_format_list& fmt_list,
   int done_after;  // Number of columns read when EOF seen.
 
   // If FORMAT explicitly "", read first line and see how many "%f" match
-  if (fmt_list.set_from_first)
+  if (fmt_list.set_from_first && first)
     {
       err = fmt_list.read_first_row (is, *this);
       m_lines = 1;
@@ -2635,6 +2723,13 @@ textscan::do_scan (std::istream& isp, textscan_format_list& fmt_list,
 
   std::list<octave_value> out = fmt_list.out_buf ();
 
+  // The first row of a format read from the data was already returned.
+  if (fmt_list.set_from_first && ! first)
+    {
+      for (auto& col : out)
+        col = col.resize (dim_vector (0, 1), 0);
+    }
+
   // We will later merge adjacent columns of the same type.
   // Check now which columns to merge.
   // Reals may become complex, and so we can't trust types
@@ -4020,6 +4115,412 @@ textscan::match_literal (delimited_stream& is,
   return true;
 }
 
+// A read-only stream buffer that reads blocks from another stream in a
+// background thread.  The next block is read while the current one is
+// used, so that reading a large file or pipe overlaps with parsing it.
+// Only the current position may be queried, and the last character of
+// the input may be read again once all of it has been consumed, as
+// textscan does to find out whether the input ends with a newline.
+//
+// The state that the background thread uses is shared with it and
+// keeps the stream alive.  A thread that is blocked reading, for
+// example from a pipe with no data, is not waited for when the buffer
+// is destroyed.  It finishes when the read returns.
+//
+// The thread does not exist in a process that was forked after the
+// buffer was created, such as a parfor worker, and the lock that it
+// shares may have been held at the time of the fork.  There, the buffer
+// can only be destroyed.
+
+class prefetch_streambuf : public std::streambuf
+{
+public:
+
+  prefetch_streambuf (const stream& os, std::istream& src,
+                      std::size_t block_size, const std::string& who)
+    : m_state (new prefetch_state (os, src, block_size)),
+      m_cur (block_size), m_cur_pos (0), m_last_char (0),
+      m_have_last_char (false), m_who (who), m_pid (sys::getpid ())
+  {
+    setg (m_cur.data (), m_cur.data (), m_cur.data ());
+
+    m_thread = std::thread (&prefetch_streambuf::fill, m_state);
+  }
+
+  OCTAVE_DISABLE_CONSTRUCT_COPY_MOVE (prefetch_streambuf)
+
+  ~prefetch_streambuf ()
+  {
+    if (usable () && stop ())
+      m_thread.join ();
+    else
+      m_thread.detach ();
+  }
+
+  // False in a process that was forked after the buffer was created.
+  bool usable () const { return m_pid == sys::getpid (); }
+
+  // Tell the background thread to finish.  Return true if it has
+  // finished, or false if it is still reading from the stream.  In a
+  // forked process, the stream is left as the thread may have left it,
+  // so it must not be closed there either.
+
+  bool stop ()
+  {
+    if (! usable ())
+      return false;
+
+    prefetch_state& st = *m_state;
+
+    std::unique_lock<std::mutex> lock (st.m_mutex);
+
+    st.m_stop = true;
+    st.m_cv.notify_all ();
+
+    // A thread that is waiting for the next block finishes at once.
+    st.m_cv.wait (lock, [&st] () { return st.m_finished || st.m_reading; });
+
+    return st.m_finished;
+  }
+
+protected:
+
+  int_type underflow ()
+  {
+    if (gptr () < egptr ())
+      return traits_type::to_int_type (*gptr ());
+
+    prefetch_state& st = *m_state;
+
+    std::size_t len;
+
+    {
+      std::unique_lock<std::mutex> lock (st.m_mutex);
+
+      // Wait in short intervals, so that reading from a pipe that has
+      // no data can be interrupted.
+      while (! st.m_cv.wait_for (lock, std::chrono::milliseconds (100),
+                                 [&st] ()
+                                 { return st.m_next_ready || st.m_src_done; }))
+        octave_quit ();
+
+      if (! st.m_next_ready)
+        {
+          if (st.m_error)
+            {
+              try
+                {
+                  std::rethrow_exception (st.m_error);
+                }
+              catch (const std::exception& e)
+                {
+                  ::error ("%s: error reading input: %s",
+                           m_who.c_str (), e.what ());
+                }
+            }
+
+          if (st.m_read_failed)
+            ::error ("%s: error reading input", m_who.c_str ());
+
+          return traits_type::eof ();
+        }
+
+      m_cur_pos += egptr () - eback ();
+
+      m_cur.swap (st.m_next);
+      len = st.m_next_len;
+      st.m_next_ready = false;
+    }
+
+    // Start reading the following block.
+    st.m_cv.notify_all ();
+
+    m_last_char = m_cur[len-1];
+    m_have_last_char = true;
+
+    setg (m_cur.data (), m_cur.data (), m_cur.data () + len);
+
+    return traits_type::to_int_type (*gptr ());
+  }
+
+  pos_type seekoff (off_type off, std::ios_base::seekdir dir,
+                    std::ios_base::openmode which)
+  {
+    if (! (which & std::ios_base::in))
+      return pos_type (off_type (-1));
+
+    if (dir == std::ios_base::cur && off == 0)
+      return pos_type (m_cur_pos + (gptr () - eback ()));
+
+    if (dir == std::ios_base::end && off == -1 && m_have_last_char
+        && gptr () == egptr () && input_done ())
+      {
+        m_cur_pos += egptr () - eback () - 1;
+
+        setg (&m_last_char, &m_last_char, &m_last_char + 1);
+
+        return pos_type (m_cur_pos);
+      }
+
+    return pos_type (off_type (-1));
+  }
+
+  pos_type seekpos (pos_type pos, std::ios_base::openmode which)
+  {
+    return seekoff (off_type (pos), std::ios_base::beg, which);
+  }
+
+private:
+
+  struct prefetch_state
+  {
+    prefetch_state (const stream& os, std::istream& src,
+                    std::size_t block_size)
+      : m_stream (os), m_src (src), m_next (block_size), m_next_len (0),
+        m_next_ready (false), m_src_done (false), m_read_failed (false),
+        m_error (), m_stop (false), m_reading (false), m_finished (false)
+    { }
+
+    OCTAVE_DISABLE_CONSTRUCT_COPY_MOVE (prefetch_state)
+
+    ~prefetch_state () = default;
+
+    // The stream that owns SRC.
+    stream m_stream;
+
+    std::istream& m_src;
+
+    // The block that is being read or was read ahead.
+    std::vector<char> m_next;
+
+    std::size_t m_next_len;
+
+    bool m_next_ready;
+
+    bool m_src_done;
+
+    // True if reading SRC failed, and the exception thrown while
+    // reading it, if any.
+    bool m_read_failed;
+
+    std::exception_ptr m_error;
+
+    bool m_stop;
+
+    // True while the thread reads from SRC without holding the lock.
+    bool m_reading;
+
+    bool m_finished;
+
+    std::mutex m_mutex;
+
+    std::condition_variable m_cv;
+  };
+
+  bool input_done ()
+  {
+    std::lock_guard<std::mutex> lock (m_state->m_mutex);
+
+    return m_state->m_src_done && ! m_state->m_next_ready;
+  }
+
+  // Executed by the background thread.  It must not call back into
+  // the interpreter.
+
+  static void fill (std::shared_ptr<prefetch_state> state)
+  {
+    prefetch_state& st = *state;
+
+    while (true)
+      {
+        {
+          std::unique_lock<std::mutex> lock (st.m_mutex);
+
+          st.m_cv.wait (lock, [&st] ()
+                        { return st.m_stop || ! (st.m_next_ready
+                                                 || st.m_src_done); });
+
+          if (st.m_stop)
+            break;
+
+          st.m_reading = true;
+        }
+
+        std::size_t len = 0;
+        bool done = true;
+        bool failed = false;
+        std::exception_ptr err;
+
+        try
+          {
+            st.m_src.read (st.m_next.data (), st.m_next.size ());
+            len = st.m_src.gcount ();
+
+            // A short read is the end of the input, or an error if
+            // the stream is bad.
+            failed = st.m_src.bad ();
+            done = ! st.m_src;
+          }
+        catch (...)
+          {
+            err = std::current_exception ();
+          }
+
+        {
+          std::lock_guard<std::mutex> lock (st.m_mutex);
+
+          st.m_next_len = len;
+          st.m_next_ready = (len > 0);
+          st.m_src_done = done;
+          st.m_read_failed = failed;
+          st.m_error = err;
+          st.m_reading = false;
+        }
+
+        st.m_cv.notify_all ();
+      }
+
+    // Release the stream.  If it was closed while this thread was
+    // reading, this closes the file.
+    st.m_stream = stream ();
+
+    {
+      std::lock_guard<std::mutex> lock (st.m_mutex);
+
+      st.m_finished = true;
+    }
+
+    st.m_cv.notify_all ();
+  }
+
+  std::shared_ptr<prefetch_state> m_state;
+
+  // The block that is being used.
+  std::vector<char> m_cur;
+
+  // Position in the input of the beginning of the current block.
+  std::streamoff m_cur_pos;
+
+  char m_last_char;
+
+  bool m_have_last_char;
+
+  std::string m_who;
+
+  // The process in which the background thread was started.
+  pid_t m_pid;
+
+  std::thread m_thread;
+};
+
+textscan_reader::textscan_reader (stream& os, const std::string& fmt,
+                                  const octave_value_list& options,
+                                  const std::string& who)
+  : m_fid (os.file_number ()), m_who (who), m_buf (), m_is (),
+    m_scanner (new textscan (who, os.encoding ())),
+    m_fmt_list (new textscan_format_list (fmt, who)), m_ds (), m_first (true),
+    m_failed (false)
+{
+  std::istream *isp = os.input_stream ();
+
+  if (! isp)
+    ::error ("%s: FID is not open for reading", who.c_str ());
+
+  m_buf.reset (new prefetch_streambuf (os, *isp, 1 << 20, who));
+  m_is.reset (new std::istream (m_buf.get ()));
+
+  // Let errors and interrupts while waiting for the input propagate
+  // instead of only setting badbit.
+  m_is->exceptions (std::ios::badbit);
+
+  m_scanner->parse_options (options, *m_fmt_list);
+
+  m_scanner->check_format (*m_fmt_list);
+
+  m_scanner->skip_header_lines (*m_is);
+
+  // The buffer of the delimited stream is kept between calls to read,
+  // so that no data is read twice.
+  octave_idx_type buf_size = std::max<octave_idx_type>
+                               (m_scanner->m_buffer_size, 65536);
+
+  m_ds.reset (new delimited_stream (*m_is, m_scanner->buffer_delimiters (),
+                                    m_scanner->max_lookahead (), buf_size));
+}
+
+// Defined here, where the types of the members are complete.
+textscan_reader::~textscan_reader () = default;
+
+octave_value
+textscan_reader::read (octave_idx_type nrecords)
+{
+  check_process ();
+
+  if (m_failed)
+    ::error ("%s: unable to continue after an error or interrupt",
+               m_who.c_str ());
+
+  octave_value retval;
+
+  try
+    {
+      retval = m_scanner->scan_records (*m_ds, *m_is, *m_fmt_list,
+                                        nrecords, m_first);
+    }
+  catch (...)
+    {
+      // The position in the input is unknown.
+      m_failed = true;
+      throw;
+    }
+
+  m_first = false;
+
+  return retval;
+}
+
+bool
+textscan_reader::eof ()
+{
+  check_process ();
+
+  if (m_failed || m_ds->eof ())
+    return true;
+
+  // Trailing whitespace and empty lines do not make another record.
+
+  std::string skip = m_scanner->m_whitespace;
+
+  if (m_scanner->m_eol1 >= 0)
+    skip += static_cast<char> (m_scanner->m_eol1);
+  if (m_scanner->m_eol2 >= 0)
+    skip += static_cast<char> (m_scanner->m_eol2);
+
+  try
+    {
+      return m_ds->only_remaining (skip);
+    }
+  catch (...)
+    {
+      m_failed = true;
+      throw;
+    }
+}
+
+bool
+textscan_reader::stop ()
+{
+  return m_buf->stop ();
+}
+
+void
+textscan_reader::check_process () const
+{
+  if (! m_buf->usable ())
+    ::error ("%s: reader cannot be used in a child process",
+             m_who.c_str ());
+}
+
 void
 base_stream::error (const std::string& msg)
 {
@@ -7371,7 +7872,8 @@ stream::mode_as_string (int mode)
 
 stream_list::stream_list (interpreter& interp)
   : m_list (), m_lookup_cache (m_list.end ()), m_stdin_file (-1),
-    m_stdout_file (-1), m_stderr_file (-1)
+    m_stdout_file (-1), m_stderr_file (-1), m_textscan_readers (),
+    m_stopped_textscan_readers (), m_last_textscan_reader_id (0)
 {
   stream stdin_stream = istream::create (&std::cin, "stdin");
 
@@ -7438,6 +7940,17 @@ err_invalid_file_id (int fid, const std::string& who)
     ::error ("%s: invalid stream number = %d", who.c_str (), fid);
 }
 
+OCTAVE_NORETURN static
+void
+err_file_id_in_use (int fid, const std::string& who)
+{
+  if (who.empty ())
+    ::error ("stream number = %d is being read by a textscanreader", fid);
+  else
+    ::error ("%s: stream number = %d is being read by a textscanreader",
+             who.c_str (), fid);
+}
+
 stream
 stream_list::lookup (int fid, const std::string& who) const
 {
@@ -7459,6 +7972,10 @@ stream_list::lookup (int fid, const std::string& who) const
       m_lookup_cache = iter;
     }
 
+  // The background thread of a reader may be using the stream.
+  if (in_use_by_textscan_reader (fid))
+    err_file_id_in_use (fid, who);
+
   return retval;
 }
 
@@ -7491,7 +8008,10 @@ stream_list::remove (int fid, const std::string& who)
   if (! os.is_valid ())
     err_invalid_file_id (fid, who);
 
-  os.close ();
+  // If a reader is still reading from the stream, the file is closed
+  // when that read returns and the stream is released.
+  if (remove_textscan_readers (fid))
+    os.close ();
 
   return 0;
 }
@@ -7550,7 +8070,7 @@ stream_list::clear (bool flush)
         }
 
       // Normal file handle.  Close and delete from m_list.
-      if (os.is_valid ())
+      if (remove_textscan_readers (fid) && os.is_valid ())
         os.close ();
 
       m_list.erase (iter++);
@@ -7559,6 +8079,122 @@ stream_list::clear (bool flush)
   m_lookup_cache = m_list.end ();
 }
 
+int
+stream_list::insert_textscan_reader (textscan_reader *reader)
+{
+  int id = ++m_last_textscan_reader_id;
+
+  m_textscan_readers[id].reset (reader);
+
+  return id;
+}
+
+textscan_reader&
+stream_list::lookup_textscan_reader (int id, const std::string& who) const
+{
+  auto p = m_textscan_readers.find (id);
+
+  if (p == m_textscan_readers.end ())
+    ::error ("%s: invalid reader ID", who.c_str ());
+
+  return *(p->second);
+}
+
+void
+stream_list::remove_textscan_reader (int id, bool wait)
+{
+  auto p = m_textscan_readers.find (id);
+
+  if (p == m_textscan_readers.end ())
+    return;
+
+  std::unique_ptr<textscan_reader> reader = std::move (p->second);
+
+  m_textscan_readers.erase (p);
+
+  // Unless WAIT is true, don't wait for a read that may never return,
+  // e.g., from a pipe with no data.
+
+  if (! wait)
+    {
+      if (! reader->stop ())
+        m_stopped_textscan_readers.push_back (std::move (reader));
+
+      return;
+    }
+
+  while (! reader->stop ())
+    {
+      try
+        {
+          std::this_thread::sleep_for (std::chrono::milliseconds (10));
+
+          octave_quit ();
+        }
+      catch (const interrupt_exception&)
+        {
+          m_stopped_textscan_readers.push_back (std::move (reader));
+
+          throw;
+        }
+    }
+}
+
+bool
+stream_list::remove_textscan_readers (int fid)
+{
+  for (auto p = m_textscan_readers.begin ();
+       p != m_textscan_readers.end (); )
+    {
+      if (p->second->file_number () == fid)
+        {
+          if (! p->second->stop ())
+            m_stopped_textscan_readers.push_back (std::move (p->second));
+
+          p = m_textscan_readers.erase (p);
+        }
+      else
+        p++;
+    }
+
+  bool retval = true;
+
+  // Also forget readers whose reads have finished in the meantime.
+  for (auto p = m_stopped_textscan_readers.begin ();
+       p != m_stopped_textscan_readers.end (); )
+    {
+      if ((*p)->stop ())
+        p = m_stopped_textscan_readers.erase (p);
+      else
+        {
+          if ((*p)->file_number () == fid)
+            retval = false;
+
+          p++;
+        }
+    }
+
+  return retval;
+}
+
+bool
+stream_list::in_use_by_textscan_reader (int fid) const
+{
+  for (const auto& id_reader : m_textscan_readers)
+    {
+      if (id_reader.second->file_number () == fid)
+        return true;
+    }
+
+  for (const auto& reader : m_stopped_textscan_readers)
+    {
+      if (reader->file_number () == fid && ! reader->stop ())
+        return true;
+    }
+
+  return false;
+}
+
 string_vector
 stream_list::get_info (int fid) const
 {
@@ -61,6 +61,11 @@ class scanf_format_list;
 class printf_format_elt;
 class printf_format_list;
 
+class delimited_stream;
+class prefetch_streambuf;
+class textscan;
+class textscan_format_list;
+
 // Provide an interface for Octave streams.
 
 class OCTINTERP_API base_stream
@@ -495,6 +500,66 @@ private:
                  mach_info::float_format ffmt);
 };
 
+// Read records from a text stream with a textscan format in batches.
+// The parsed format, the options, and the buffered input are kept
+// between calls to read, so that a file that is too large to read at
+// once can be processed in pieces.  The next block of the input is read
+// by a background thread while the current one is parsed.  The
+// stream_list refuses other operations on the stream until the reader
+// is destroyed, and its position is unspecified afterwards.  A reader
+// cannot be used in a process that was forked after it was created.
+
+class OCTINTERP_API textscan_reader
+{
+public:
+
+  OCTINTERP_API
+  textscan_reader (stream& os, const std::string& fmt,
+                   const octave_value_list& options,
+                   const std::string& who = "textscan");
+
+  OCTAVE_DISABLE_CONSTRUCT_COPY_MOVE (textscan_reader)
+
+  OCTINTERP_API ~textscan_reader ();
+
+  // Read up to NRECORDS records, or all remaining records if NRECORDS
+  // is -1, and return them as textscan does.  After an error or an
+  // interrupt, the reader cannot be used any more.
+  OCTINTERP_API octave_value read (octave_idx_type nrecords);
+
+  // True if no more records can be read.
+  OCTINTERP_API bool eof ();
+
+  // Stop reading ahead.  Return false if the background thread is
+  // still reading from the stream.  It keeps the stream alive until
+  // that read returns.
+  OCTINTERP_API bool stop ();
+
+  int file_number () const { return m_fid; }
+
+private:
+
+  void check_process () const;
+
+  int m_fid;
+
+  std::string m_who;
+
+  std::unique_ptr<prefetch_streambuf> m_buf;
+
+  std::unique_ptr<std::istream> m_is;
+
+  std::unique_ptr<textscan> m_scanner;
+
+  std::unique_ptr<textscan_format_list> m_fmt_list;
+
+  std::unique_ptr<delimited_stream> m_ds;
+
+  bool m_first;
+
+  bool m_failed;
+};
+
 class OCTINTERP_API stream_list
 {
 public:
@@ -530,8 +595,28 @@ public:
   OCTINTERP_API octave_value stdout_file () const;
   OCTINTERP_API octave_value stderr_file () const;
 
+  // Textscan readers (see textscanreader.m), identified by positive
+  // integers.  A reader is destroyed when its stream is closed.
+
+  OCTINTERP_API int insert_textscan_reader (textscan_reader *reader);
+
+  OCTINTERP_API textscan_reader&
+  lookup_textscan_reader (int id, const std::string& who = "") const;
+
+  // Destroy the reader ID.  If WAIT is true, wait until its background
+  // thread no longer reads from the stream.
+  OCTINTERP_API void remove_textscan_reader (int id, bool wait = false);
+
 private:
 
+  // Destroy the readers of the stream FID before it is closed.  Return
+  // false if one of them is still reading from it.
+  bool remove_textscan_readers (int fid);
+
+  // True if a reader exists for the stream FID or if one that was
+  // destroyed is still reading from it.
+  bool in_use_by_textscan_reader (int fid) const;
+
   typedef std::map<int, stream> ostrl_map;
 
   ostrl_map m_list;
@@ -541,6 +626,13 @@ private:
   int m_stdin_file;
   int m_stdout_file;
   int m_stderr_file;
+
+  std::map<int, std::unique_ptr<textscan_reader>> m_textscan_readers;
+
+  // Readers that were removed while still reading from their stream.
+  std::list<std::unique_ptr<textscan_reader>> m_stopped_textscan_readers;
+
+  int m_last_textscan_reader_id;
 };
 
 OCTAVE_END_NAMESPACE(octave)
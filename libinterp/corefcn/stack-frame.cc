@@ -27,10 +27,16 @@
 #  include "config.h"
 #endif
 
+#include <algorithm>
+#include <array>
 #include <iostream>
+#include <new>
+#include <stdexcept>
+#include <utility>
 
 #include "lo-regexp.h"
 #include "lo-sysdep.h"
+#include "oct-pool.h"
 #include "str-vec.h"
 
 #include "defun.h"
@@ -81,6 +87,197 @@ static void display_scope (std::ostream& os, const symbol_scope& scope)
     }
 }
 
+static OCTAVE_THREAD_LOCAL stack_frame::allocation_stats frame_allocation_stats;
+
+const stack_frame::allocation_stats&
+stack_frame::get_allocation_stats ()
+{
+  return frame_allocation_stats;
+}
+
+// Allocator for std::allocate_shared that places each stack frame and
+// its reference count in a single block taken from a pool of blocks of
+// that size.  Frames are almost always released in the reverse order
+// of their creation, so the next call usually reuses the block of the
+// frame that was just released.
+
+template <typename T>
+class frame_allocator
+{
+public:
+
+  typedef T value_type;
+
+  frame_allocator () = default;
+
+  template <typename U>
+  frame_allocator (const frame_allocator<U>&) { }
+
+  T * allocate (std::size_t n)
+  {
+    if (n != 1)
+      return static_cast<T *> (::operator new (n * sizeof (T)));
+
+    typedef fixed_size_pool<sizeof (T)> pool;
+
+    if (pool::free_count () > 0)
+      frame_allocation_stats.m_reused++;
+    else
+      frame_allocation_stats.m_allocated++;
+
+    return static_cast<T *> (pool::allocate (sizeof (T)));
+  }
+
+  void deallocate (T *p, std::size_t n)
+  {
+    if (n != 1)
+      ::operator delete (p);
+    else
+      fixed_size_pool<sizeof (T)>::deallocate (p, sizeof (T));
+  }
+
+  template <typename U>
+  bool operator == (const frame_allocator<U>&) const { return true; }
+
+  template <typename U>
+  bool operator != (const frame_allocator<U>&) const { return false; }
+};
+
+template <typename T, typename... ARGS>
+static std::shared_ptr<stack_frame>
+make_frame (ARGS&&... args)
+{
+  frame_allocation_stats.m_frames++;
+
+  return std::allocate_shared<T> (frame_allocator<T> (),
+                                  std::forward<ARGS> (args)...);
+}
+
+// Array of variable values or flags that stores up to N elements in
+// the stack frame itself.  Elements are destroyed from first to last
+// so that the order in which objects are deleted when a frame is
+// released does not depend on the standard library.
+
+template <typename T, std::size_t N>
+class frame_vector
+{
+public:
+
+  frame_vector (std::size_t n, const T& val)
+  {
+    resize (n, val);
+  }
+
+  frame_vector (const frame_vector& v)
+  {
+    reserve (v.m_size);
+
+    for (std::size_t i = 0; i < v.m_size; i++)
+      new (m_data + i) T (v.m_data[i]);
+
+    m_size = v.m_size;
+  }
+
+  frame_vector& operator = (const frame_vector&) = delete;
+
+  ~frame_vector ()
+  {
+    clear ();
+
+    if (m_data != inline_data ())
+      ::operator delete (m_data);
+  }
+
+  std::size_t size () const { return m_size; }
+
+  T * begin () { return m_data; }
+  T * end () { return m_data + m_size; }
+
+  const T * begin () const { return m_data; }
+  const T * end () const { return m_data + m_size; }
+
+  T& at (std::size_t i)
+  {
+    if (i >= m_size)
+      throw std::out_of_range ("frame_vector::at");
+
+    return m_data[i];
+  }
+
+  const T& at (std::size_t i) const
+  {
+    if (i >= m_size)
+      throw std::out_of_range ("frame_vector::at");
+
+    return m_data[i];
+  }
+
+  void resize (std::size_t n, const T& val)
+  {
+    if (n < m_size)
+      {
+        for (std::size_t i = n; i < m_size; i++)
+          m_data[i].~T ();
+
+        m_size = n;
+      }
+    else
+      {
+        reserve (n);
+
+        for (; m_size < n; m_size++)
+          new (m_data + m_size) T (val);
+      }
+  }
+
+  void clear ()
+  {
+    for (std::size_t i = 0; i < m_size; i++)
+      m_data[i].~T ();
+
+    m_size = 0;
+  }
+
+private:
+
+  T * inline_data ()
+  {
+    return reinterpret_cast<T *> (m_inline_data);
+  }
+
+  void reserve (std::size_t n)
+  {
+    if (n <= m_capacity)
+      return;
+
+    std::size_t capacity = std::max (n, 2 * m_capacity);
+
+    T *data = static_cast<T *> (::operator new (capacity * sizeof (T)));
+
+    for (std::size_t i = 0; i < m_size; i++)
+      {
+        new (data + i) T (std::move (m_data[i]));
+        m_data[i].~T ();
+      }
+
+    if (m_data == inline_data ())
+      frame_allocation_stats.m_value_arrays++;
+    else
+      ::operator delete (m_data);
+
+    m_data = data;
+    m_capacity = capacity;
+  }
+
+  std::size_t m_size {0};
+
+  std::size_t m_capacity {N};
+
+  T *m_data {inline_data ()};
+
+  alignas (T) unsigned char m_inline_data[N * sizeof (T)];
+};
+
 class compiled_fcn_stack_frame;
 class script_stack_frame;
 class user_fcn_stack_frame;
@@ -372,7 +569,7 @@ public:
     : stack_frame (tw, index, parent_link, static_link, access_link),
       m_values (num_symbols, octave_value ()),
       m_flags (num_symbols, LOCAL),
-      m_auto_vars (NUM_AUTO_VARS, octave_value ())
+      m_auto_vars ()
   { }
 
   base_value_stack_frame (const base_value_stack_frame& elt) = default;
@@ -382,21 +579,14 @@ public:
 
   ~base_value_stack_frame ()
   {
-    // The C++ standard doesn't guarantee in which order the elements of a
-    // std::vector are destroyed.  GNU libstdc++ and LLVM libc++ seem to
-    // destroy them in a different order.  So, erase elements manually
-    // from first to last to be able to guarantee a destructor call order
-    // independent of the used STL, e.g., for classdef objects.
-
-    // Member dtor order is last to first.  So, m_auto_vars before m_values.
+    // Release values from first to last to guarantee a destructor call
+    // order, e.g., for classdef objects.  Member dtor order is last to
+    // first.  So, m_auto_vars before m_values.
 
-    for (auto auto_vars_iter = m_auto_vars.begin ();
-         auto_vars_iter != m_auto_vars.end ();)
-      auto_vars_iter = m_auto_vars.erase (auto_vars_iter);
+    for (auto& val : m_auto_vars)
+      val = octave_value ();
 
-    for (auto values_iter = m_values.begin ();
-         values_iter != m_values.end ();)
-      values_iter = m_values.erase (values_iter);
+    m_values.clear ();
   }
 
   std::size_t size () const
@@ -450,10 +640,14 @@ public:
 
 protected:
 
+  // The number of values stored in the stack frame itself.  Frames
+  // for functions with more variables allocate a separate array.
+  static const std::size_t NUM_INLINE_VALUES = 16;
+
   // Variable values.  This array is indexed by the data_offset
   // value stored in the symbol_record objects of the scope
   // associated with this stack frame.
-  std::vector<octave_value> m_values;
+  frame_vector<octave_value, NUM_INLINE_VALUES> m_values;
 
   // The type of each variable (local, global, persistent) of each
   // value.  This array is indexed by the data_offset value stored
@@ -462,12 +656,12 @@ protected:
   // Global values are stored in the tree_evaluator object that contains
   // the stack frame.  Persistent values are stored in the function
   // scope corresponding to the stack frame.
-  std::vector<scope_flags> m_flags;
+  frame_vector<scope_flags, NUM_INLINE_VALUES> m_flags;
 
   // A fixed list of Automatic variables created for this function.
-  // The elements of this vector correspond to the auto_var_type
+  // The elements of this array correspond to the auto_var_type
   // enum.
-  std::vector<octave_value> m_auto_vars;
+  std::array<octave_value, NUM_AUTO_VARS> m_auto_vars;
 };
 
 // User-defined functions have a symbol_scope object to store the set
@@ -1078,38 +1272,40 @@ private:
   std::set<std::string> m_found_names;
 };
 
-stack_frame *
+std::shared_ptr<stack_frame>
 stack_frame::create (tree_evaluator& tw, octave_function *fcn,
                      std::size_t index,
                      const std::shared_ptr<stack_frame>& parent_link,
                      const std::shared_ptr<stack_frame>& static_link)
 {
-  return new compiled_fcn_stack_frame (tw, fcn, index,
-                                       parent_link, static_link);
+  return make_frame<compiled_fcn_stack_frame> (tw, fcn, index,
+                                               parent_link, static_link);
 }
 
-stack_frame *
+std::shared_ptr<stack_frame>
 stack_frame::create (tree_evaluator& tw,
                      octave_user_script *script,
                      std::size_t index,
                      const std::shared_ptr<stack_frame>& parent_link,
                      const std::shared_ptr<stack_frame>& static_link)
 {
-  return new script_stack_frame (tw, script, index, parent_link, static_link);
+  return make_frame<script_stack_frame> (tw, script, index,
+                                         parent_link, static_link);
 }
 
-stack_frame *
+std::shared_ptr<stack_frame>
 stack_frame::create (tree_evaluator& tw,
                      octave_user_function *fcn, std::size_t index,
                      const std::shared_ptr<stack_frame>& parent_link,
                      const std::shared_ptr<stack_frame>& static_link,
                      const std::shared_ptr<stack_frame>& access_link)
 {
-  return new user_fcn_stack_frame (tw, fcn, index,
-                                   parent_link, static_link, access_link);
+  return make_frame<user_fcn_stack_frame> (tw, fcn, index,
+                                           parent_link, static_link,
+                                           access_link);
 }
 
-stack_frame *
+std::shared_ptr<stack_frame>
 stack_frame::create (tree_evaluator& tw,
                      octave_user_function *fcn, std::size_t index,
                      const std::shared_ptr<stack_frame>& parent_link,
@@ -1117,18 +1313,19 @@ stack_frame::create (tree_evaluator& tw,
                      const local_vars_map& local_vars,
                      const std::shared_ptr<stack_frame>& access_link)
 {
-  return new user_fcn_stack_frame (tw, fcn, index,
-                                   parent_link, static_link, local_vars,
-                                   access_link);
+  return make_frame<user_fcn_stack_frame> (tw, fcn, index,
+                                           parent_link, static_link,
+                                           local_vars, access_link);
 }
 
-stack_frame *
+std::shared_ptr<stack_frame>
 stack_frame::create (tree_evaluator& tw,
                      const symbol_scope& scope, std::size_t index,
                      const std::shared_ptr<stack_frame>& parent_link,
                      const std::shared_ptr<stack_frame>& static_link)
 {
-  return new scope_stack_frame (tw, scope, index, parent_link, static_link);
+  return make_frame<scope_stack_frame> (tw, scope, index,
+                                        parent_link, static_link);
 }
 
 // This function is only implemented and should only be called for
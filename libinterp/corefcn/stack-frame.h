@@ -137,6 +137,28 @@ public:
     NUM_AUTO_VARS
   };
 
+  // Counts of the memory allocations made for stack frames.  Frames
+  // are allocated from a pool of recently released frames of the same
+  // type where possible, and the values of small functions are stored
+  // in the frame itself.
+
+  struct allocation_stats
+  {
+    // Number of frames created.
+    std::size_t m_frames {0};
+
+    // Number of frames that reused memory released by an earlier frame.
+    std::size_t m_reused {0};
+
+    // Number of frames that required a new heap allocation.
+    std::size_t m_allocated {0};
+
+    // Number of variable arrays too large to be stored in the frame.
+    std::size_t m_value_arrays {0};
+  };
+
+  static OCTINTERP_API const allocation_stats& get_allocation_stats ();
+
   stack_frame () = delete;
 
   stack_frame (tree_evaluator& tw, std::size_t index,
@@ -150,26 +172,26 @@ public:
   { }
 
   // Compiled function.
-  static stack_frame *
+  static std::shared_ptr<stack_frame>
   create (tree_evaluator& tw, octave_function *fcn, std::size_t index,
           const std::shared_ptr<stack_frame>& parent_link,
           const std::shared_ptr<stack_frame>& static_link);
 
   // Script.
-  static stack_frame *
+  static std::shared_ptr<stack_frame>
   create (tree_evaluator& tw, octave_user_script *script, std::size_t index,
           const std::shared_ptr<stack_frame>& parent_link,
           const std::shared_ptr<stack_frame>& static_link);
 
   // User-defined function.
-  static stack_frame *
+  static std::shared_ptr<stack_frame>
   create (tree_evaluator& tw, octave_user_function *fcn, std::size_t index,
           const std::shared_ptr<stack_frame>& parent_link,
           const std::shared_ptr<stack_frame>& static_link,
           const std::shared_ptr<stack_frame>& access_link = std::shared_ptr<stack_frame> ());
 
   // Anonymous user-defined function with init vars.
-  static stack_frame *
+  static std::shared_ptr<stack_frame>
   create (tree_evaluator& tw, octave_user_function *fcn, std::size_t index,
           const std::shared_ptr<stack_frame>& parent_link,
           const std::shared_ptr<stack_frame>& static_link,
@@ -177,7 +199,7 @@ public:
           const std::shared_ptr<stack_frame>& access_link = std::shared_ptr<stack_frame> ());
 
   // Scope.
-  static stack_frame *
+  static std::shared_ptr<stack_frame>
   create (tree_evaluator& tw, const symbol_scope& scope, std::size_t index,
           const std::shared_ptr<stack_frame>& parent_link,
           const std::shared_ptr<stack_frame>& static_link);
@@ -339,6 +339,8 @@ void
 symbol_table::install_cmdline_function (const std::string& name,
                                         const octave_value& fcn)
 {
+  fcn_lookup_cache::new_generation ();
+
   auto p = m_fcn_table.find (name);
 
   if (p != m_fcn_table.end ())
@@ -365,6 +367,8 @@ symbol_table::install_local_function (const std::string& name,
                                       const octave_value& fcn,
                                       const std::string& file_name)
 {
+  fcn_lookup_cache::new_generation ();
+
   auto p = m_fcn_table.find (name);
 
   if (p != m_fcn_table.end ())
@@ -387,6 +391,8 @@ void
 symbol_table::install_user_function (const std::string& name,
                                      const octave_value& fcn)
 {
+  fcn_lookup_cache::new_generation ();
+
   auto p = m_fcn_table.find (name);
 
   if (p != m_fcn_table.end ())
@@ -411,6 +417,8 @@ void
 symbol_table::install_built_in_function (const std::string& name,
     const octave_value& fcn)
 {
+  fcn_lookup_cache::new_generation ();
+
   auto p = m_fcn_table.find (name);
 
   if (p != m_fcn_table.end ())
@@ -436,6 +444,8 @@ symbol_table::install_built_in_function (const std::string& name,
 void
 symbol_table::clear_functions (bool force)
 {
+  fcn_lookup_cache::new_generation ();
+
   auto p = m_fcn_table.begin ();
 
   while (p != m_fcn_table.end ())
@@ -451,6 +461,8 @@ symbol_table::clear_function (const std::string& name)
 void
 symbol_table::clear_function_pattern (const std::string& pat)
 {
+  fcn_lookup_cache::new_generation ();
+
   symbol_match pattern (pat);
 
   auto p = m_fcn_table.begin ();
@@ -467,6 +479,8 @@ symbol_table::clear_function_pattern (const std::string& pat)
 void
 symbol_table::clear_function_regexp (const std::string& pat)
 {
+  fcn_lookup_cache::new_generation ();
+
   regexp pattern (pat);
 
   auto p = m_fcn_table.begin ();
@@ -483,6 +497,8 @@ symbol_table::clear_function_regexp (const std::string& pat)
 void
 symbol_table::clear_user_function (const std::string& name)
 {
+  fcn_lookup_cache::new_generation ();
+
   auto p = m_fcn_table.find (name);
 
   if (p != m_fcn_table.end ())
@@ -500,6 +516,8 @@ symbol_table::clear_user_function (const std::string& name)
 void
 symbol_table::clear_dld_function (const std::string& name)
 {
+  fcn_lookup_cache::new_generation ();
+
   auto p = m_fcn_table.find (name);
 
   if (p != m_fcn_table.end ())
@@ -514,6 +532,8 @@ symbol_table::clear_dld_function (const std::string& name)
 void
 symbol_table::clear_mex_functions ()
 {
+  fcn_lookup_cache::new_generation ();
+
   auto p = m_fcn_table.begin ();
 
   while (p != m_fcn_table.end ())
@@ -528,6 +548,8 @@ bool
 symbol_table::set_class_relationship (const std::string& sup_class,
                                       const std::string& inf_class)
 {
+  fcn_lookup_cache::new_generation ();
+
   if (is_superiorto (inf_class, sup_class))
     return false;
 
@@ -569,6 +591,8 @@ void
 symbol_table::alias_built_in_function (const std::string& alias,
                                        const std::string& name)
 {
+  fcn_lookup_cache::new_generation ();
+
   octave_value fcn = find_built_in_function (name);
 
   if (fcn.is_defined ())
@@ -587,6 +611,8 @@ void
 symbol_table::install_built_in_dispatch (const std::string& name,
     const std::string& klass)
 {
+  fcn_lookup_cache::new_generation ();
+
   auto p = m_fcn_table.find (name);
 
   if (p != m_fcn_table.end ())
@@ -690,6 +716,8 @@ void
 symbol_table::add_to_parent_map (const std::string& classname,
                                  const std::list<std::string>& parent_list)
 {
+  fcn_lookup_cache::new_generation ();
+
   m_parent_map[classname] = parent_list;
 }
 
@@ -380,6 +380,12 @@ specified option.
         { "ENABLE_OPENMP", false },
 #endif
 
+#if defined (OCTAVE_ENABLE_THREAD_LOCAL_INTERPRETERS)
+        { "ENABLE_THREAD_LOCAL_INTERPRETERS", true },
+#else
+        { "ENABLE_THREAD_LOCAL_INTERPRETERS", false },
+#endif
+
         { "api_version", OCTAVE_API_VERSION },
         { "archlibdir", config::arch_lib_dir () },
         { "bindir", config::bin_dir () },
@@ -35,6 +35,7 @@
 #endif
 
 #include "oct-fftw.h"
+#include "oct-mutex.h"
 
 #include "defun-dld.h"
 #include "error.h"
@@ -228,6 +229,8 @@ current process or @var{3} is used (whichever is smaller).
     }
   else if (arg0 == "dwisdom")
     {
+      autolock guard (fftw_planner::planner_mutex ());
+
       if (nargin == 2)  //dwisdom setter
         {
           // Use STL function to convert to lower case
@@ -263,6 +266,8 @@ current process or @var{3} is used (whichever is smaller).
     }
   else if (arg0 == "swisdom")
     {
+      autolock guard (fftw_planner::planner_mutex ());
+
       //swisdom uses fftwf_ functions (float), dwisdom fftw_ (real)
       if (nargin == 2)  //swisdom setter
         {
@@ -33,6 +33,7 @@
 #include "cdef-method.h"
 #include "cdef-package.h"
 #include "cdef-property.h"
+#include "fcn-info.h"
 #include "ov-builtin.h"
 
 OCTAVE_BEGIN_NAMESPACE(octave)
@@ -67,21 +68,29 @@ public:
   void register_class (const cdef_class& cls)
   {
     m_all_classes[cls.get_name ()] = cls;
+
+    fcn_lookup_cache::new_generation ();
   }
 
   void unregister_class (const cdef_class& cls)
   {
     m_all_classes.erase(cls.get_name ());
+
+    fcn_lookup_cache::new_generation ();
   }
 
   void register_package (const cdef_package& pkg)
   {
     m_all_packages[pkg.get_name ()] = pkg;
+
+    fcn_lookup_cache::new_generation ();
   }
 
   void unregister_package (const cdef_package& pkg)
   {
     m_all_packages.erase (pkg.get_name ());
+
+    fcn_lookup_cache::new_generation ();
   }
 
   const cdef_class& meta_class () const { return m_meta_class; }
@@ -447,22 +447,15 @@ octave_base_int_matrix<T>::save_hdf5_internal (octave_hdf5_id loc_id,
   space_hid = H5Screate_simple (rank, hdims, nullptr);
 
   if (space_hid < 0) return false;
-#if defined (HAVE_HDF5_18)
-  data_hid = H5Dcreate (loc_id, name, save_type_hid, space_hid,
-                        octave_H5P_DEFAULT, octave_H5P_DEFAULT,
-                        octave_H5P_DEFAULT);
-#else
-  data_hid = H5Dcreate (loc_id, name, save_type_hid, space_hid,
-                        octave_H5P_DEFAULT);
-#endif
+  data_hid = hdf5_create_dataset (loc_id, name, save_type_hid, space_hid);
   if (data_hid < 0)
     {
       H5Sclose (space_hid);
       return false;
     }
 
-  retval = H5Dwrite (data_hid, save_type_hid, octave_H5S_ALL, octave_H5S_ALL,
-                     octave_H5P_DEFAULT, this->m_matrix.data ()) >= 0;
+  retval = hdf5_write_dataset (data_hid, save_type_hid,
+                               this->m_matrix.data ());
 
   H5Dclose (data_hid);
   H5Sclose (space_hid);
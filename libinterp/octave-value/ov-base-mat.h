@@ -251,6 +251,26 @@ protected:
     delete m_idx_cache; m_idx_cache = nullptr;
   }
 
+  // Replace each element of the matrix, whose data must not be shared,
+  // by FCN applied to it.
+
+  template <typename F>
+  void apply_in_place (F fcn)
+  {
+    clear_cached_info ();
+
+    const typename MT::element_type *old_data = m_matrix.data ();
+    typename MT::element_type *p = m_matrix.rwdata ();
+    octave_idx_type n = m_matrix.numel ();
+
+    for (octave_idx_type i = 0; i < n; i++)
+      p[i] = fcn (p[i]);
+
+    // Count the reuse only if rwdata did not have to copy the data.
+    if (p == old_data)
+      octave::count_array_reuse ();
+  }
+
   mutable MatrixType *m_typ;
   mutable octave::idx_vector *m_idx_cache;
 
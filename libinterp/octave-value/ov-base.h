@@ -904,6 +904,15 @@ public:
 
   virtual OCTINTERP_API octave_value map (unary_mapper_t) const;
 
+  // Apply the mapper function to the data of this value in place and
+  // return true if the result has the same type as this value and the
+  // data is not shared.  Otherwise, return false without changing
+  // anything.
+  virtual bool map_in_place (unary_mapper_t) { return false; }
+
+  // The name of the built-in function that applies a mapper function.
+  OCTINTERP_API static const char * get_umap_name (unary_mapper_t);
+
   // These are fast indexing & assignment shortcuts for extracting
   // or inserting a single scalar from/to an array.
 
@@ -962,8 +971,6 @@ protected:
   OCTAVE_DEPRECATED (9, "use octave_base_value::m_count instead")
   octave::refcount<octave_idx_type>& count;
 
-  OCTINTERP_API static const char * get_umap_name (unary_mapper_t);
-
   OCTINTERP_API void warn_load (const char *type) const;
   OCTINTERP_API void warn_save (const char *type) const;
 
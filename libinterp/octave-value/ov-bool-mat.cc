@@ -442,14 +442,7 @@ octave_bool_matrix::save_hdf5 (octave_hdf5_id loc_id, const char *name,
 
   space_hid = H5Screate_simple (rank, hdims, nullptr);
   if (space_hid < 0) return false;
-#if defined (HAVE_HDF5_18)
-  data_hid = H5Dcreate (loc_id, name, H5T_NATIVE_HBOOL, space_hid,
-                        octave_H5P_DEFAULT, octave_H5P_DEFAULT,
-                        octave_H5P_DEFAULT);
-#else
-  data_hid = H5Dcreate (loc_id, name, H5T_NATIVE_HBOOL, space_hid,
-                        octave_H5P_DEFAULT);
-#endif
+  data_hid = hdf5_create_dataset (loc_id, name, H5T_NATIVE_HBOOL, space_hid);
   if (data_hid < 0)
     {
       H5Sclose (space_hid);
@@ -458,9 +451,7 @@ octave_bool_matrix::save_hdf5 (octave_hdf5_id loc_id, const char *name,
 
   const bool *mtmp = m_matrix.data ();
 
-  retval = H5Dwrite (data_hid, H5T_NATIVE_HBOOL, octave_H5S_ALL, octave_H5S_ALL,
-                     octave_H5P_DEFAULT,
-                     reinterpret_cast<const char *> (mtmp)) >= 0;
+  retval = hdf5_write_dataset (data_hid, H5T_NATIVE_HBOOL, mtmp);
 
   H5Dclose (data_hid);
   H5Sclose (space_hid);
@@ -616,6 +607,34 @@ issues an error.
 %!   assert (logical (eye (2, c{i})), m);
 %!   assert (logical (eye (1, c{i})), s);
 %! endfor
+
+## The index vector of a mask is reused and discarded when the mask changes
+%!test
+%! old_n = maxNumCompThreads ();
+%! old_threshold = __parallel_threshold__ (16);
+%! unwind_protect
+%!   x = rand (100, 300);
+%!   m = x > 0.25;
+%!   for nt = [1, 4]
+%!     maxNumCompThreads (nt);
+%!     assert (x(m), x(find (m)));
+%!     assert (x(m), x(find (m)));
+%!     y = x;
+%!     y(m) = 0;
+%!     assert (nnz (y), numel (x) - nnz (m));
+%!     assert (find (m), find (x > 0.25));
+%!   endfor
+%!   m(1:2:end) = true;
+%!   assert (nnz (m), nnz (x > 0.25 | mod (reshape (1:numel (x), size (x)), 2)));
+%!   assert (x(m), x(find (m)));
+%!   m(:) = false;
+%!   assert (nnz (m), 0);
+%!   assert (find (m), zeros (0, 1));
+%!   assert (x(m), zeros (0, 1));
+%! unwind_protect_cleanup
+%!   maxNumCompThreads (old_n);
+%!   __parallel_threshold__ (old_threshold);
+%! end_unwind_protect
 */
 
 OCTAVE_END_NAMESPACE(octave)
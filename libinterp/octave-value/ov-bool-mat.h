@@ -96,6 +96,11 @@ public:
            : set_idx_cache (octave::idx_vector (m_matrix));
   }
 
+  // The index vector of a logical mask knows the number of true
+  // elements, so use it if it has been cached.
+  octave_idx_type nnz () const
+  { return m_idx_cache ? m_idx_cache->length (0) : m_matrix.nnz (); }
+
   builtin_type_t builtin_type () const { return btyp_bool; }
 
   bool is_bool_matrix () const { return true; }
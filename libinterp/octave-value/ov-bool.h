@@ -35,6 +35,7 @@
 
 #include "lo-utils.h"
 #include "mx-base.h"
+#include "oct-pool.h"
 #include "str-vec.h"
 
 #include "oct-stream.h"
@@ -65,6 +66,8 @@ public:
 
   ~octave_bool () = default;
 
+  OCTAVE_POOL_ALLOCATED (octave_bool)
+
   octave_base_value * clone () const { return new octave_bool (*this); }
   octave_base_value * empty_clone () const
   { return new octave_bool_matrix (); }
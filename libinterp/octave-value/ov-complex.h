@@ -34,6 +34,7 @@
 #include <string>
 
 #include "mx-base.h"
+#include "oct-pool.h"
 #include "str-vec.h"
 
 #include "errwarn.h"
@@ -64,6 +65,8 @@ public:
 
   ~octave_complex () = default;
 
+  OCTAVE_POOL_ALLOCATED (octave_complex)
+
   octave_base_value * clone () const { return new octave_complex (*this); }
 
   // We return an octave_complex_matrix object here instead of an
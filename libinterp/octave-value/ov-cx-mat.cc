@@ -590,13 +590,7 @@ octave_complex_matrix::save_hdf5 (octave_hdf5_id loc_id, const char *name,
       H5Sclose (space_hid);
       return false;
     }
-#if defined (HAVE_HDF5_18)
-  data_hid = H5Dcreate (loc_id, name, type_hid, space_hid,
-                        octave_H5P_DEFAULT, octave_H5P_DEFAULT,
-                        octave_H5P_DEFAULT);
-#else
-  data_hid = H5Dcreate (loc_id, name, type_hid, space_hid, octave_H5P_DEFAULT);
-#endif
+  data_hid = hdf5_create_dataset (loc_id, name, type_hid, space_hid);
   if (data_hid < 0)
     {
       H5Sclose (space_hid);
@@ -610,9 +604,7 @@ octave_complex_matrix::save_hdf5 (octave_hdf5_id loc_id, const char *name,
   if (retval)
     {
       const Complex *mtmp = m.data ();
-      if (H5Dwrite (data_hid, complex_type_hid, octave_H5S_ALL, octave_H5S_ALL,
-                    octave_H5P_DEFAULT, mtmp)
-          < 0)
+      if (! hdf5_write_dataset (data_hid, complex_type_hid, mtmp))
         {
           H5Tclose (complex_type_hid);
           retval = false;
@@ -835,3 +827,60 @@ octave_complex_matrix::map (unary_mapper_t umap) const
       return octave_base_value::map (umap);
     }
 }
+
+bool
+octave_complex_matrix::map_in_place (unary_mapper_t umap)
+{
+  Complex (*fcn) (const Complex&) = nullptr;
+
+  switch (umap)
+    {
+#define IN_PLACE_MAPPER(UMAP, FCN)              \
+    case umap_ ## UMAP:                         \
+      fcn = FCN;                                \
+      break
+
+      IN_PLACE_MAPPER (acos, octave::math::acos);
+      IN_PLACE_MAPPER (acosh, octave::math::acosh);
+      IN_PLACE_MAPPER (asin, octave::math::asin);
+      IN_PLACE_MAPPER (asinh, octave::math::asinh);
+      IN_PLACE_MAPPER (atan, octave::math::atan);
+      IN_PLACE_MAPPER (atanh, octave::math::atanh);
+      IN_PLACE_MAPPER (erf, octave::math::erf);
+      IN_PLACE_MAPPER (erfc, octave::math::erfc);
+      IN_PLACE_MAPPER (erfcx, octave::math::erfcx);
+      IN_PLACE_MAPPER (erfi, octave::math::erfi);
+      IN_PLACE_MAPPER (dawson, octave::math::dawson);
+      IN_PLACE_MAPPER (ceil, octave::math::ceil);
+      IN_PLACE_MAPPER (cos, std::cos);
+      IN_PLACE_MAPPER (cosh, std::cosh);
+      IN_PLACE_MAPPER (exp, std::exp);
+      IN_PLACE_MAPPER (expm1, octave::math::expm1);
+      IN_PLACE_MAPPER (fix, octave::math::fix);
+      IN_PLACE_MAPPER (floor, octave::math::floor);
+      IN_PLACE_MAPPER (log, std::log);
+      IN_PLACE_MAPPER (log2, octave::math::log2);
+      IN_PLACE_MAPPER (log10, std::log10);
+      IN_PLACE_MAPPER (log1p, octave::math::log1p);
+      IN_PLACE_MAPPER (round, octave::math::round);
+      IN_PLACE_MAPPER (roundb, octave::math::roundb);
+      IN_PLACE_MAPPER (signum, octave::math::signum);
+      IN_PLACE_MAPPER (sin, std::sin);
+      IN_PLACE_MAPPER (sinh, std::sinh);
+      IN_PLACE_MAPPER (sqrt, std::sqrt);
+      IN_PLACE_MAPPER (tan, std::tan);
+      IN_PLACE_MAPPER (tanh, std::tanh);
+
+#undef IN_PLACE_MAPPER
+
+    default:
+      return false;
+    }
+
+  if (m_matrix.is_shared ())
+    return false;
+
+  apply_in_place (fcn);
+
+  return true;
+}
@@ -175,6 +175,8 @@ public:
 
   octave_value map (unary_mapper_t umap) const;
 
+  bool map_in_place (unary_mapper_t umap);
+
 private:
 
   DECLARE_OV_TYPEID_FUNCTIONS_AND_DATA_API (OCTINTERP_API)
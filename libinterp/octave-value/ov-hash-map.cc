@@ -0,0 +1,582 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <type_traits>
+
+#include "Cell.h"
+#include "defun.h"
+#include "error.h"
+#include "ov-hash-map.h"
+#include "ovl.h"
+
+DEFINE_OV_TYPEID_FUNCTIONS_AND_DATA (octave_hash_map, "hash_map",
+                                     "hash_map");
+
+template <typename T>
+static void
+put_key (std::string& enc, T val)
+{
+  enc.assign (reinterpret_cast<const char *> (&val), sizeof (T));
+}
+
+template <typename T>
+static T
+get_key (const std::string& enc)
+{
+  T val;
+  std::memcpy (&val, enc.data (), sizeof (T));
+  return val;
+}
+
+template <typename T>
+static bool
+key_less (const std::string& a, const std::string& b)
+{
+  T x = get_key<T> (a);
+  T y = get_key<T> (b);
+
+  // NaN keys are sorted last, as they are by sort.
+  if constexpr (std::is_floating_point<T>::value)
+    {
+      if (std::isnan (y))
+        return ! std::isnan (x);
+    }
+
+  return x < y;
+}
+
+static bool
+char_key_less (const std::string& a, const std::string& b)
+{
+  return a < b;
+}
+
+octave_hash_map::octave_hash_map ()
+  : octave_base_value (), m_key_type (btyp_char),
+    m_rep (std::make_shared<rep> ())
+{ }
+
+octave_hash_map::octave_hash_map (builtin_type_t key_type)
+  : octave_base_value (), m_key_type (key_type),
+    m_rep (std::make_shared<rep> ())
+{ }
+
+bool
+octave_hash_map::contains (const octave_value& key) const
+{
+  std::string enc;
+
+  if (! encode_key (key, enc))
+    return false;
+
+  return m_rep->m_table.find (enc) != m_rep->m_table.end ();
+}
+
+bool
+octave_hash_map::lookup (const octave_value& key, octave_value& val) const
+{
+  std::string enc;
+
+  if (! encode_key (key, enc))
+    return false;
+
+  auto p = m_rep->m_table.find (enc);
+
+  if (p == m_rep->m_table.end ())
+    return false;
+
+  val = p->second;
+
+  return true;
+}
+
+void
+octave_hash_map::assign (const octave_value& key,
+                         const octave_value& val) const
+{
+  std::string enc;
+
+  if (! encode_key (key, enc))
+    error ("containers.Map: specified key type does not match the type of this container");
+
+  if (m_rep->m_table.insert_or_assign (enc, val).second)
+    m_rep->m_sorted_valid = false;
+}
+
+bool
+octave_hash_map::remove (const octave_value& key) const
+{
+  std::string enc;
+
+  if (! encode_key (key, enc) || m_rep->m_table.erase (enc) == 0)
+    return false;
+
+  m_rep->m_sorted_valid = false;
+
+  return true;
+}
+
+Cell
+octave_hash_map::keys () const
+{
+  const std::vector<const entry_type *>& sorted = sorted_entries ();
+
+  octave_idx_type n = sorted.size ();
+
+  Cell retval (1, n);
+
+  for (octave_idx_type i = 0; i < n; i++)
+    retval(i) = decode_key (sorted[i]->first);
+
+  return retval;
+}
+
+Cell
+octave_hash_map::values () const
+{
+  const std::vector<const entry_type *>& sorted = sorted_entries ();
+
+  octave_idx_type n = sorted.size ();
+
+  Cell retval (1, n);
+
+  for (octave_idx_type i = 0; i < n; i++)
+    retval(i) = sorted[i]->second;
+
+  return retval;
+}
+
+void
+octave_hash_map::print (std::ostream& os, bool pr_as_read_syntax)
+{
+  print_raw (os, pr_as_read_syntax);
+  newline (os);
+}
+
+void
+octave_hash_map::print_raw (std::ostream& os, bool) const
+{
+  os << "<hash map with " << count () << " entries>";
+}
+
+// Convert KEY to the key type of the map and store its representation
+// in the table in ENC.  Return false if KEY is not a valid key for the
+// map.
+
+bool
+octave_hash_map::encode_key (const octave_value& key, std::string& enc) const
+{
+  if (m_key_type == btyp_char)
+    {
+      if (! key.is_string () || key.rows () > 1)
+        return false;
+
+      enc = key.isempty () ? "" : key.string_value ();
+
+      return true;
+    }
+
+  if (! (key.isnumeric () || key.islogical ()) || key.iscomplex ()
+      || key.numel () != 1)
+    return false;
+
+  switch (m_key_type)
+    {
+    case btyp_double:
+      put_key (enc, key.double_value ());
+      break;
+
+    case btyp_float:
+      put_key (enc, key.float_value ());
+      break;
+
+    case btyp_int32:
+      put_key (enc, key.int32_scalar_value ().value ());
+      break;
+
+    case btyp_uint32:
+      put_key (enc, key.uint32_scalar_value ().value ());
+      break;
+
+    case btyp_int64:
+      put_key (enc, key.int64_scalar_value ().value ());
+      break;
+
+    case btyp_uint64:
+      put_key (enc, key.uint64_scalar_value ().value ());
+      break;
+
+    default:
+      return false;
+    }
+
+  return true;
+}
+
+octave_value
+octave_hash_map::decode_key (const std::string& enc) const
+{
+  switch (m_key_type)
+    {
+    case btyp_double:
+      return octave_value (get_key<double> (enc));
+
+    case btyp_float:
+      return octave_value (get_key<float> (enc));
+
+    case btyp_int32:
+      return octave_value (octave_int32 (get_key<int32_t> (enc)));
+
+    case btyp_uint32:
+      return octave_value (octave_uint32 (get_key<uint32_t> (enc)));
+
+    case btyp_int64:
+      return octave_value (octave_int64 (get_key<int64_t> (enc)));
+
+    case btyp_uint64:
+      return octave_value (octave_uint64 (get_key<uint64_t> (enc)));
+
+    default:
+      return octave_value (enc);
+    }
+}
+
+const std::vector<const octave_hash_map::entry_type *>&
+octave_hash_map::sorted_entries () const
+{
+  std::vector<const entry_type *>& sorted = m_rep->m_sorted;
+
+  if (m_rep->m_sorted_valid && sorted.size () == count ())
+    return sorted;
+
+  sorted.clear ();
+  sorted.reserve (count ());
+
+  for (const auto& entry : m_rep->m_table)
+    sorted.push_back (&entry);
+
+  bool (*less) (const std::string&, const std::string&);
+
+  switch (m_key_type)
+    {
+    case btyp_double:
+      less = key_less<double>;
+      break;
+
+    case btyp_float:
+      less = key_less<float>;
+      break;
+
+    case btyp_int32:
+      less = key_less<int32_t>;
+      break;
+
+    case btyp_uint32:
+      less = key_less<uint32_t>;
+      break;
+
+    case btyp_int64:
+      less = key_less<int64_t>;
+      break;
+
+    case btyp_uint64:
+      less = key_less<uint64_t>;
+      break;
+
+    default:
+      less = char_key_less;
+      break;
+    }
+
+  std::sort (sorted.begin (), sorted.end (),
+             [less] (const entry_type *a, const entry_type *b)
+             { return less (a->first, b->first); });
+
+  m_rep->m_sorted_valid = true;
+
+  return sorted;
+}
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+static const octave_hash_map&
+get_hash_map (const octave_value& val, const char *who)
+{
+  const octave_hash_map *hm
+    = dynamic_cast<const octave_hash_map *> (&(val.get_rep ()));
+
+  if (! hm)
+    error ("%s: H must be a hash map", who);
+
+  return *hm;
+}
+
+DEFUN (__hash_map_new__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn  {} {@var{h} =} __hash_map_new__ (@var{key_type})
+@deftypefnx {} {@var{h} =} __hash_map_new__ (@var{key_type}, @var{keys}, @var{vals})
+Undocumented internal function.
+@end deftypefn */)
+{
+  int nargin = args.length ();
+
+  if (nargin != 1 && nargin != 3)
+    print_usage ();
+
+  std::string type
+    = args(0).xstring_value ("__hash_map_new__: KEY_TYPE must be a string");
+
+  builtin_type_t key_type;
+
+  if (type == "char")
+    key_type = btyp_char;
+  else if (type == "double")
+    key_type = btyp_double;
+  else if (type == "single")
+    key_type = btyp_float;
+  else if (type == "int32")
+    key_type = btyp_int32;
+  else if (type == "uint32")
+    key_type = btyp_uint32;
+  else if (type == "int64")
+    key_type = btyp_int64;
+  else if (type == "uint64")
+    key_type = btyp_uint64;
+  else
+    error ("__hash_map_new__: unsupported KEY_TYPE '%s'", type.c_str ());
+
+  octave_hash_map *hm = new octave_hash_map (key_type);
+
+  octave_value retval (hm);
+
+  if (nargin == 3)
+    {
+      Cell keys = args(1).xcell_value ("__hash_map_new__: KEYS must be a cell array");
+      Cell vals = args(2).xcell_value ("__hash_map_new__: VALS must be a cell array");
+
+      if (keys.numel () != vals.numel ())
+        error ("__hash_map_new__: KEYS and VALS must have the same number of elements");
+
+      for (octave_idx_type i = 0; i < keys.numel (); i++)
+        hm->assign (keys(i), vals(i));
+    }
+
+  return retval;
+}
+
+DEFUN (__hash_map_set__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {} __hash_map_set__ (@var{h}, @var{keys}, @var{vals})
+Undocumented internal function.
+@end deftypefn */)
+{
+  if (args.length () != 3)
+    print_usage ();
+
+  const octave_hash_map& hm = get_hash_map (args(0), "__hash_map_set__");
+
+  if (args(1).iscell ())
+    {
+      Cell keys = args(1).cell_value ();
+      Cell vals = args(2).xcell_value ("__hash_map_set__: VALS must be a cell array");
+
+      if (keys.numel () != vals.numel ())
+        error ("__hash_map_set__: KEYS and VALS must have the same number of elements");
+
+      for (octave_idx_type i = 0; i < keys.numel (); i++)
+        hm.assign (keys(i), vals(i));
+    }
+  else
+    hm.assign (args(1), args(2));
+
+  return ovl ();
+}
+
+DEFUN (__hash_map_get__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {[@var{vals}, @var{found}] =} __hash_map_get__ (@var{h}, @var{keys})
+Undocumented internal function.
+@end deftypefn */)
+{
+  if (args.length () != 2)
+    print_usage ();
+
+  const octave_hash_map& hm = get_hash_map (args(0), "__hash_map_get__");
+
+  if (! args(1).iscell ())
+    {
+      octave_value val = Matrix ();
+      bool found = hm.lookup (args(1), val);
+
+      return ovl (val, found);
+    }
+
+  Cell keys = args(1).cell_value ();
+
+  Cell vals (keys.dims ());
+  boolNDArray found (keys.dims ());
+
+  for (octave_idx_type i = 0; i < keys.numel (); i++)
+    found(i) = hm.lookup (keys(i), vals(i));
+
+  return ovl (vals, found);
+}
+
+DEFUN (__hash_map_iskey__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {@var{tf} =} __hash_map_iskey__ (@var{h}, @var{keys})
+Undocumented internal function.
+@end deftypefn */)
+{
+  if (args.length () != 2)
+    print_usage ();
+
+  const octave_hash_map& hm = get_hash_map (args(0), "__hash_map_iskey__");
+
+  if (! args(1).iscell ())
+    return ovl (hm.contains (args(1)));
+
+  Cell keys = args(1).cell_value ();
+
+  boolNDArray retval (keys.dims ());
+
+  for (octave_idx_type i = 0; i < keys.numel (); i++)
+    retval(i) = hm.contains (keys(i));
+
+  return ovl (retval);
+}
+
+DEFUN (__hash_map_remove__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {} __hash_map_remove__ (@var{h}, @var{keys})
+Undocumented internal function.
+@end deftypefn */)
+{
+  if (args.length () != 2)
+    print_usage ();
+
+  const octave_hash_map& hm = get_hash_map (args(0), "__hash_map_remove__");
+
+  if (args(1).iscell ())
+    {
+      Cell keys = args(1).cell_value ();
+
+      for (octave_idx_type i = 0; i < keys.numel (); i++)
+        hm.remove (keys(i));
+    }
+  else
+    hm.remove (args(1));
+
+  return ovl ();
+}
+
+DEFUN (__hash_map_keys__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {@var{keys} =} __hash_map_keys__ (@var{h})
+Undocumented internal function.
+@end deftypefn */)
+{
+  if (args.length () != 1)
+    print_usage ();
+
+  return ovl (get_hash_map (args(0), "__hash_map_keys__").keys ());
+}
+
+DEFUN (__hash_map_values__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {@var{vals} =} __hash_map_values__ (@var{h})
+Undocumented internal function.
+@end deftypefn */)
+{
+  if (args.length () != 1)
+    print_usage ();
+
+  return ovl (get_hash_map (args(0), "__hash_map_values__").values ());
+}
+
+DEFUN (__hash_map_count__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn {} {@var{n} =} __hash_map_count__ (@var{h})
+Undocumented internal function.
+@end deftypefn */)
+{
+  if (args.length () != 1)
+    print_usage ();
+
+  const octave_hash_map& hm = get_hash_map (args(0), "__hash_map_count__");
+
+  return ovl (octave_uint64 (hm.count ()));
+}
+
+/*
+%!test
+%! h = __hash_map_new__ ("char", {"b", "a", "c"}, {2, 1, 3});
+%! assert (__hash_map_count__ (h), uint64 (3));
+%! assert (__hash_map_keys__ (h), {"a", "b", "c"});
+%! assert (__hash_map_values__ (h), {1, 2, 3});
+%! [v, tf] = __hash_map_get__ (h, {"a", "x"; "c", "b"});
+%! assert (v, {1, []; 3, 2});
+%! assert (tf, [true, false; true, true]);
+%! [v, tf] = __hash_map_get__ (h, "x");
+%! assert (tf, false);
+%! assert (__hash_map_iskey__ (h, {"a", 1, ""}), [true, false, false]);
+
+## Copies share the table.
+%!test
+%! h = __hash_map_new__ ("char");
+%! h2 = h;
+%! __hash_map_set__ (h2, "a", 1);
+%! __hash_map_set__ (h2, {"b", "a"}, {2, 3});
+%! assert (__hash_map_values__ (h), {3, 2});
+%! __hash_map_remove__ (h, {"a", "x"});
+%! assert (__hash_map_keys__ (h2), {"b"});
+
+%!test
+%! h = __hash_map_new__ ("int64", {intmax("int64"), -1, 0}, {1, 2, 3});
+%! assert (__hash_map_keys__ (h), {int64(-1), int64(0), intmax("int64")});
+%! assert (__hash_map_iskey__ (h, {int8(-1), 0.2, [0, 0], "a"}),
+%!         [true, true, false, false]);
+%! h = __hash_map_new__ ("double", {NaN, Inf, -0, 1}, {1, 2, 3, 4});
+%! k = __hash_map_keys__ (h);
+%! assert (k(1:3), {-0, 1, Inf});
+%! assert (isnan (k{4}));
+
+%!error <unsupported KEY_TYPE> __hash_map_new__ ("cell")
+%!error <same number of elements> __hash_map_new__ ("char", {"a"}, {})
+%!error <H must be a hash map> __hash_map_keys__ (1)
+%!error <key type does not match>
+%! __hash_map_set__ (__hash_map_new__ ("char"), 1, 2);
+*/
+
+OCTAVE_END_NAMESPACE(octave)
@@ -0,0 +1,139 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if ! defined (octave_ov_hash_map_h)
+#define octave_ov_hash_map_h 1
+
+#include "octave-config.h"
+
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ov-base.h"
+#include "ov.h"
+
+class Cell;
+
+// Hash table that stores the keys and values of a containers.Map
+// object.  Keys are either character strings or numeric scalars of a
+// single class.  Numeric keys are converted to that class and stored
+// by their bit pattern, so, for example, 0 and -0 are different double
+// keys.
+//
+// Copies of an octave_hash_map value share the same table, in the same
+// way that copies of a handle object refer to the same object, so the
+// table can be modified in place by the functions that operate on it.
+
+class octave_hash_map : public octave_base_value
+{
+public:
+
+  octave_hash_map ();
+
+  octave_hash_map (builtin_type_t key_type);
+
+  octave_hash_map (const octave_hash_map&) = default;
+
+  ~octave_hash_map () = default;
+
+  octave_base_value * clone () const
+  { return new octave_hash_map (*this); }
+
+  octave_base_value * empty_clone () const
+  { return new octave_hash_map (m_key_type); }
+
+  bool is_defined () const { return true; }
+
+  bool is_constant () const { return true; }
+
+  dim_vector dims () const
+  {
+    static dim_vector dv (1, 1);
+    return dv;
+  }
+
+  builtin_type_t key_type () const { return m_key_type; }
+
+  std::size_t count () const { return m_rep->m_table.size (); }
+
+  // Return true if KEY is a key of the map.
+  bool contains (const octave_value& key) const;
+
+  // Store the value of KEY in VAL and return true if KEY is a key of
+  // the map.  Otherwise, return false and leave VAL unchanged.
+  bool lookup (const octave_value& key, octave_value& val) const;
+
+  // Add KEY to the map or replace its value.  It is an error if KEY
+  // does not have the type of the keys of the map.
+  void assign (const octave_value& key, const octave_value& val) const;
+
+  // Remove KEY from the map and return true if it was a key of the
+  // map.
+  bool remove (const octave_value& key) const;
+
+  // All keys of the map in ascending order.
+  Cell keys () const;
+
+  // The values of all keys in the same order as the keys.
+  Cell values () const;
+
+  void print (std::ostream& os, bool pr_as_read_syntax = false);
+
+  void print_raw (std::ostream& os, bool pr_as_read_syntax = false) const;
+
+private:
+
+  typedef std::unordered_map<std::string, octave_value> table_type;
+
+  typedef table_type::value_type entry_type;
+
+  struct rep
+  {
+    table_type m_table;
+
+    // Entries in the order of their keys.  The order is computed
+    // again when it is needed after keys were added or removed.
+    std::vector<const entry_type *> m_sorted;
+
+    bool m_sorted_valid = true;
+  };
+
+  bool encode_key (const octave_value& key, std::string& enc) const;
+
+  octave_value decode_key (const std::string& enc) const;
+
+  const std::vector<const entry_type *>& sorted_entries () const;
+
+  builtin_type_t m_key_type;
+
+  std::shared_ptr<rep> m_rep;
+
+  DECLARE_OV_TYPEID_FUNCTIONS_AND_DATA_API (OCTINTERP_API)
+};
+
+#endif
@@ -739,14 +739,7 @@ octave_matrix::save_hdf5 (octave_hdf5_id loc_id, const char *name,
     }
 #endif
 
-#if defined (HAVE_HDF5_18)
-  data_hid = H5Dcreate (loc_id, name, save_type_hid, space_hid,
-                        octave_H5P_DEFAULT, octave_H5P_DEFAULT,
-                        octave_H5P_DEFAULT);
-#else
-  data_hid = H5Dcreate (loc_id, name, save_type_hid, space_hid,
-                        octave_H5P_DEFAULT);
-#endif
+  data_hid = hdf5_create_dataset (loc_id, name, save_type_hid, space_hid);
   if (data_hid < 0)
     {
       H5Sclose (space_hid);
@@ -754,8 +747,7 @@ octave_matrix::save_hdf5 (octave_hdf5_id loc_id, const char *name,
     }
 
   const double *mtmp = m.data ();
-  retval = H5Dwrite (data_hid, H5T_NATIVE_DOUBLE, octave_H5S_ALL,
-                     octave_H5S_ALL, octave_H5P_DEFAULT, mtmp) >= 0;
+  retval = hdf5_write_dataset (data_hid, H5T_NATIVE_DOUBLE, mtmp);
 
   H5Dclose (data_hid);
   H5Sclose (space_hid);
@@ -1002,3 +994,58 @@ octave_matrix::map (unary_mapper_t umap) const
       return octave_base_value::map (umap);
     }
 }
+
+bool
+octave_matrix::map_in_place (unary_mapper_t umap)
+{
+  double (*fcn) (double) = nullptr;
+
+  switch (umap)
+    {
+#define IN_PLACE_MAPPER(UMAP, FCN)              \
+    case umap_ ## UMAP:                         \
+      fcn = FCN;                                \
+      break
+
+      IN_PLACE_MAPPER (abs, ::fabs);
+      IN_PLACE_MAPPER (angle, std::arg);
+      IN_PLACE_MAPPER (arg, std::arg);
+      IN_PLACE_MAPPER (asinh, octave::math::asinh);
+      IN_PLACE_MAPPER (atan, ::atan);
+      IN_PLACE_MAPPER (erf, octave::math::erf);
+      IN_PLACE_MAPPER (erfinv, octave::math::erfinv);
+      IN_PLACE_MAPPER (erfcinv, octave::math::erfcinv);
+      IN_PLACE_MAPPER (erfc, octave::math::erfc);
+      IN_PLACE_MAPPER (erfcx, octave::math::erfcx);
+      IN_PLACE_MAPPER (erfi, octave::math::erfi);
+      IN_PLACE_MAPPER (dawson, octave::math::dawson);
+      IN_PLACE_MAPPER (gamma, octave::math::gamma);
+      IN_PLACE_MAPPER (cbrt, octave::math::cbrt);
+      IN_PLACE_MAPPER (ceil, ::ceil);
+      IN_PLACE_MAPPER (cos, ::cos);
+      IN_PLACE_MAPPER (cosh, ::cosh);
+      IN_PLACE_MAPPER (exp, ::exp);
+      IN_PLACE_MAPPER (expm1, octave::math::expm1);
+      IN_PLACE_MAPPER (fix, octave::math::fix);
+      IN_PLACE_MAPPER (floor, ::floor);
+      IN_PLACE_MAPPER (round, octave::math::round);
+      IN_PLACE_MAPPER (roundb, octave::math::roundb);
+      IN_PLACE_MAPPER (signum, octave::math::signum);
+      IN_PLACE_MAPPER (sin, ::sin);
+      IN_PLACE_MAPPER (sinh, ::sinh);
+      IN_PLACE_MAPPER (tan, ::tan);
+      IN_PLACE_MAPPER (tanh, ::tanh);
+
+#undef IN_PLACE_MAPPER
+
+    default:
+      return false;
+    }
+
+  if (m_matrix.is_shared ())
+    return false;
+
+  apply_in_place (fcn);
+
+  return true;
+}
@@ -36,6 +36,7 @@
 #include "lo-mappers.h"
 #include "lo-utils.h"
 #include "mx-base.h"
+#include "oct-pool.h"
 #include "str-vec.h"
 
 #include "errwarn.h"
@@ -65,6 +66,8 @@ public:
 
   ~octave_scalar () = default;
 
+  OCTAVE_POOL_ALLOCATED (octave_scalar)
+
   octave_base_value * clone () const { return new octave_scalar (*this); }
 
   // We return an octave_matrix here instead of an octave_scalar so
@@ -203,6 +203,14 @@ public:
   binary_op_fcn
   lookup_binary_op (octave_value::compound_binary_op, int, int);
 
+  // Incremented whenever a binary operator function is registered.
+  // Callers that cache the result of lookup_binary_op use this to
+  // detect that the cached function may be out of date.
+  std::size_t binary_ops_generation () const
+  {
+    return m_binary_ops_generation;
+  }
+
   cat_op_fcn lookup_cat_op (int, int);
 
   assign_op_fcn lookup_assign_op (octave_value::assign_op, int, int);
@@ -260,6 +268,8 @@ private:
   Array<int> m_pref_assign_conv;
 
   Array<void *> m_widening_ops;
+
+  std::size_t m_binary_ops_generation;
 };
 
 OCTAVE_END_NAMESPACE(octave)
@@ -234,6 +234,10 @@ octave_user_function::octave_user_function (const octave::symbol_scope& scope, o
 
 octave_user_function::~octave_user_function ()
 {
+  // Call sites may still refer to this function in their lookup caches.
+  if (! m_anonymous_function)
+    octave::fcn_lookup_cache::new_generation ();
+
   delete m_id;
   delete m_param_list;
   delete m_ret_list;
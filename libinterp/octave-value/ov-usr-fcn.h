@@ -28,6 +28,7 @@
 
 #include "octave-config.h"
 
+#include <memory>
 #include <string>
 
 #include "comment-list.h"
@@ -45,6 +46,7 @@ class octave_value;
 
 OCTAVE_BEGIN_NAMESPACE(octave)
 
+class bytecode;
 class filepos;
 class file_info;
 class stack_frame;
@@ -385,6 +387,18 @@ public:
 
   bool subsasgn_optimization_ok ();
 
+  // Compiled form of the function body, or nullptr if it has not been
+  // compiled yet or can not be compiled.
+  std::shared_ptr<octave::bytecode> bytecode () const { return m_bytecode; }
+
+  void bytecode (const std::shared_ptr<octave::bytecode>& code)
+  {
+    m_bytecode = code;
+    m_bytecode_unsupported = ! code;
+  }
+
+  bool bytecode_unsupported () const { return m_bytecode_unsupported; }
+
   void accept (octave::tree_walker& tw);
 
   octave_value dump () const;
@@ -444,6 +458,12 @@ private:
   // Enum describing whether this function is a method for a class.
   class_method_type m_class_method {none};
 
+  // Cached compiled form of the function body.
+  std::shared_ptr<octave::bytecode> m_bytecode;
+
+  // TRUE means an attempt to compile the body failed.
+  bool m_bytecode_unsupported {false};
+
   void maybe_relocate_end_internal ();
 
   void print_code_function_header (const std::string& prefix);
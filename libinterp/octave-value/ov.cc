@@ -31,6 +31,8 @@
 
 #include <type_traits>
 
+#include "Array-alloc.h"
+#include "Array-stats.h"
 #include "data-conv.h"
 #include "quit.h"
 #include "str-vec.h"
@@ -80,6 +82,7 @@
 #include "ov-dld-fcn.h"
 #include "ov-usr-fcn.h"
 #include "ov-fcn-handle.h"
+#include "ov-hash-map.h"
 #include "ov-typeinfo.h"
 #include "ov-magic-int.h"
 #include "ov-null-mat.h"
@@ -2244,6 +2247,23 @@ octave_value::make_storable_value ()
     maybe_economize ();
 }
 
+octave_value
+octave_value::map (octave_base_value::unary_mapper_t umap) const
+{
+  if (octave::reusable_argument::is_reusable (*this)
+      && m_rep->map_in_place (umap))
+    {
+      octave_value retval = *this;
+
+      // As when constructing a value from the result of map.
+      retval.maybe_mutate ();
+
+      return retval;
+    }
+
+  return m_rep->map (umap);
+}
+
 float_display_format
 octave_value::get_edit_display_format () const
 {
@@ -3377,6 +3397,201 @@ make_char_range (const octave_value& base, const octave_value& increment,
   return retval.convert_to_str (false, true, type);
 }
 
+// Elements of an integer range, computed the same way as the values
+// stored by make_int_range.
+
+template <typename T>
+class int_colon_range : public colon_range
+{
+public:
+
+  typedef typename std::make_unsigned<T>::type UT;
+
+  int_colon_range (T base, UT increment, bool increasing,
+                   octave_idx_type numel)
+    : m_base (base), m_increment (increment), m_increasing (increasing),
+      m_numel (numel)
+  { }
+
+  OCTAVE_DISABLE_COPY_MOVE (int_colon_range)
+
+  ~int_colon_range () = default;
+
+  octave_idx_type numel () const { return m_numel; }
+
+  octave_value elem (octave_idx_type i) const
+  {
+    // Compute modulo 2^64 so that no intermediate value can overflow.
+    // The result is always in the range of T.
+
+    uint64_t offset = static_cast<uint64_t> (i) * m_increment;
+    uint64_t val = static_cast<uint64_t> (m_base);
+
+    val = m_increasing ? val + offset : val - offset;
+
+    return octave_value (octave_int<T> (static_cast<T> (val)));
+  }
+
+private:
+
+  T m_base;
+  UT m_increment;
+  bool m_increasing;
+  octave_idx_type m_numel;
+};
+
+class float_colon_range : public colon_range
+{
+public:
+
+  float_colon_range (const range<float>& r) : m_range (r) { }
+
+  OCTAVE_DISABLE_COPY_MOVE (float_colon_range)
+
+  ~float_colon_range () = default;
+
+  octave_idx_type numel () const { return m_range.numel (); }
+
+  octave_value elem (octave_idx_type i) const
+  {
+    return octave_value (m_range.elem (i));
+  }
+
+  bool is_infinite () const
+  {
+    return math::isinf (m_range.base ()) || math::isinf (m_range.limit ());
+  }
+
+private:
+
+  range<float> m_range;
+};
+
+template <typename T,
+          typename IT,
+          typename std::enable_if<(std::is_integral<T>::value
+                                   && std::is_arithmetic<IT>::value),
+                                  bool>::type = true>
+std::unique_ptr<colon_range>
+make_int_colon_range (T base, IT increment, T limit)
+{
+  octave_idx_type nel = range_numel (base, increment, limit);
+
+  if (nel <= 0)
+    return std::unique_ptr<colon_range> ();
+
+  typedef typename std::make_unsigned<T>::type UT;
+
+  UT unsigned_increment = range_increment<T> (increment);
+
+  return std::unique_ptr<colon_range>
+           (new int_colon_range<T> (base, unsigned_increment, limit > base,
+                                    nel));
+}
+
+template <typename T>
+std::unique_ptr<colon_range>
+make_int_colon_range (const octave_value& base, const octave_value& increment,
+                      const octave_value& limit)
+{
+  check_colon_operand<T> (base, "lower bound");
+  check_colon_operand<T> (limit, "upper bound");
+
+  typename T::val_type base_val = octave_value_extract<T> (base).value ();
+  typename T::val_type limit_val = octave_value_extract<T> (limit).value ();
+
+  if (increment.is_double_type ())
+    {
+      double increment_val = increment.double_value ();
+
+      return make_int_colon_range (base_val, increment_val, limit_val);
+    }
+
+  check_colon_operand<T> (increment, "increment");
+
+  typename T::val_type increment_val
+    = octave_value_extract<T> (increment).value ();
+
+  return make_int_colon_range (base_val, increment_val, limit_val);
+}
+
+static std::unique_ptr<colon_range>
+make_float_colon_range (const octave_value& base,
+                        const octave_value& increment,
+                        const octave_value& limit)
+{
+  float base_val = octave_value_extract<float> (base);
+  float increment_val = octave_value_extract<float> (increment);
+  float limit_val = octave_value_extract<float> (limit);
+
+  // Leave NaN values and empty ranges to make_float_range.
+
+  if (math::isnan (base_val)
+      || math::isnan (increment_val)
+      || math::isnan (limit_val)
+      || increment_val == 0
+      || (increment_val > 0 && base_val > limit_val)
+      || (increment_val < 0 && base_val < limit_val))
+    return std::unique_ptr<colon_range> ();
+
+  range<float> r (base_val, increment_val, limit_val);
+
+  return std::unique_ptr<colon_range> (new float_colon_range (r));
+}
+
+std::unique_ptr<colon_range>
+make_colon_range (const octave_value& base, const octave_value& increment_arg,
+                  const octave_value& limit)
+{
+  if (base.isobject () || increment_arg.isobject () || limit.isobject ())
+    return std::unique_ptr<colon_range> ();
+
+  octave_value increment
+    = increment_arg.is_defined () ? increment_arg : octave_value (1.0);
+
+  // Empty, nonscalar, and complex operands are handled (and warned
+  // about) by colon_op.
+
+  if (base.numel () != 1 || limit.numel () != 1 || increment.numel () != 1
+      || base.iscomplex () || limit.iscomplex () || increment.iscomplex ())
+    return std::unique_ptr<colon_range> ();
+
+  // Double precision ranges are already stored efficiently by colon_op.
+
+  switch (get_colon_op_type (base, increment, limit))
+    {
+    case btyp_float:
+      return make_float_colon_range (base, increment, limit);
+
+    case btyp_int8:
+      return make_int_colon_range<octave_int8> (base, increment, limit);
+
+    case btyp_int16:
+      return make_int_colon_range<octave_int16> (base, increment, limit);
+
+    case btyp_int32:
+      return make_int_colon_range<octave_int32> (base, increment, limit);
+
+    case btyp_int64:
+      return make_int_colon_range<octave_int64> (base, increment, limit);
+
+    case btyp_uint8:
+      return make_int_colon_range<octave_uint8> (base, increment, limit);
+
+    case btyp_uint16:
+      return make_int_colon_range<octave_uint16> (base, increment, limit);
+
+    case btyp_uint32:
+      return make_int_colon_range<octave_uint32> (base, increment, limit);
+
+    case btyp_uint64:
+      return make_int_colon_range<octave_uint64> (base, increment, limit);
+
+    default:
+      return std::unique_ptr<colon_range> ();
+    }
+}
+
 octave_value
 colon_op (const octave_value& base, const octave_value& increment_arg,
           const octave_value& limit, bool is_for_cmd_expr)
@@ -3543,6 +3758,25 @@ unary_op (octave_value::unary_op op, const octave_value& v)
   return unary_op (ti, op, v);
 }
 
+static thread_local const octave_base_value *s_reusable_rep = nullptr;
+
+reusable_argument::reusable_argument (const octave_value& val)
+  : m_saved (s_reusable_rep)
+{
+  s_reusable_rep = &val.get_rep ();
+}
+
+reusable_argument::~reusable_argument ()
+{
+  s_reusable_rep = m_saved;
+}
+
+bool
+reusable_argument::is_reusable (const octave_value& val)
+{
+  return &val.get_rep () == s_reusable_rep && val.get_count () == 1;
+}
+
 OCTAVE_END_NAMESPACE(octave)
 
 void
@@ -3611,6 +3845,7 @@ install_types (octave::type_info& ti)
   octave_null_sq_str::register_type (ti);
   octave_lazy_index::register_type (ti);
   octave_oncleanup::register_type (ti);
+  octave_hash_map::register_type (ti);
   octave_java::register_type (ti);
   octave_trivial_range::register_type (ti);
 }
@@ -4048,4 +4283,242 @@ setting is restored when exiting the function.
 %!assert (typeinfo (__test_dr__ (false)), "matrix")
 */
 
+DEFUN (__array_stats__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn  {} {@var{stats} =} __array_stats__ ()
+@deftypefnx {} {@var{old_state} =} __array_stats__ (@var{state})
+Return counts of array allocations and of arrays reused for results.
+
+@var{stats} is a structure with the fields @code{allocations} and
+@code{bytes}, the number and total size of all array buffers allocated
+so far, @code{reused}, the number of operations that stored their
+result in the buffer of an operand instead of allocating a new one, and
+@code{pooled}, the number of large buffers that were taken from the pool
+of freed buffers.
+
+Counting is off by default.  If @var{state} is true, turn it on; if it
+is false, turn it off.  The previous state is returned.
+@end deftypefn */)
+{
+  int nargin = args.length ();
+
+  if (nargin > 1)
+    print_usage ();
+
+  if (nargin == 1)
+    {
+      bool state
+        = args(0).xbool_value ("__array_stats__: STATE must be a logical value");
+
+      return ovl (enable_array_stats (state));
+    }
+
+  array_stats stats = get_array_stats ();
+
+  octave_scalar_map m;
+
+  m.assign ("allocations", static_cast<double> (stats.allocations));
+  m.assign ("bytes", static_cast<double> (stats.bytes));
+  m.assign ("reused", static_cast<double> (stats.reused));
+  m.assign ("pooled", static_cast<double> (stats.pooled));
+
+  return ovl (m);
+}
+
+/*
+%!test
+%! x = rand (1000, 1);
+%! y = x;
+%! old_state = __array_stats__ (true);
+%! unwind_protect
+%!   s0 = __array_stats__ ();
+%!   x = sin (x);
+%!   s1 = __array_stats__ ();
+%! unwind_protect_cleanup
+%!   __array_stats__ (old_state);
+%! end_unwind_protect
+%! assert (x, sin (y));
+%! assert (s1.reused > s0.reused);
+%! assert (s1.bytes - s0.bytes < 8000);
+
+%!test
+%! x = rand (1000, 1);
+%! y = x + 1;
+%! old_state = __array_stats__ (true);
+%! unwind_protect
+%!   s0 = __array_stats__ ();
+%!   x = x + 1;
+%!   s1 = __array_stats__ ();
+%! unwind_protect_cleanup
+%!   __array_stats__ (old_state);
+%! end_unwind_protect
+%! assert (x, y);
+%! assert (s1.reused > s0.reused);
+%! assert (s1.bytes - s0.bytes < 8000);
+
+## Temporaries are reused by the operators that consume them
+%!test
+%! x = rand (1000, 1);
+%! y = rand (1000, 1);
+%! old_state = __array_stats__ (true);
+%! unwind_protect
+%!   s0 = __array_stats__ ();
+%!   z = sin (x + 1) .* y;
+%!   s1 = __array_stats__ ();
+%! unwind_protect_cleanup
+%!   __array_stats__ (old_state);
+%! end_unwind_protect
+%! assert (z, sin (x + 1) .* y);
+%! assert (s1.reused - s0.reused >= 2);
+
+## Data that must be copied before it is modified is not counted as reused
+%!test
+%! z = rand (10, 100);
+%! x = reshape (z, 1000, 1);
+%! old_state = __array_stats__ (true);
+%! unwind_protect
+%!   s0 = __array_stats__ ();
+%!   x = sin (x);
+%!   s1 = __array_stats__ ();
+%! unwind_protect_cleanup
+%!   __array_stats__ (old_state);
+%! end_unwind_protect
+%! assert (x, sin (z(:)));
+%! assert (s1.reused, s0.reused);
+
+## Nothing is counted while counting is off
+%!test
+%! old_state = __array_stats__ (false);
+%! unwind_protect
+%!   s0 = __array_stats__ ();
+%!   x = sin (rand (1000, 1) + 1);
+%!   s1 = __array_stats__ ();
+%! unwind_protect_cleanup
+%!   __array_stats__ (old_state);
+%! end_unwind_protect
+%! assert (s1, s0);
+
+## Shared values are never modified
+%!test
+%! x = [0, pi/2, pi];
+%! z = x;
+%! x = sin (x);
+%! assert (z, [0, pi/2, pi]);
+%! x = x * 2;
+%! assert (z, [0, pi/2, pi]);
+%! c = {z};
+%! z = z + 1;
+%! assert (c{1}, [0, pi/2, pi]);
+
+%!test
+%! x = single ([1+2i, 3-4i]);
+%! x = exp (x);
+%! assert (x, exp (single ([1+2i, 3-4i])));
+%! x = int8 ([100, -100]);
+%! x = x + 100;
+%! assert (x, int8 ([127, 0]));
+%! x = [1, 2, 3];
+%! x = x + [1; 2];
+%! assert (x, [2, 3, 4; 3, 4, 5]);
+
+%!error <operator \+: nonconformant arguments>
+%! x = ones (2, 3);
+%! x = x + ones (3, 2);
+
+## A failed index after the call leaves the variable unchanged
+%!test
+%! y = [0, pi/2, pi];
+%! try
+%!   y = sin (y)(4);
+%! end_try_catch
+%! assert (y, [0, pi/2, pi]);
+*/
+
+DEFUN (__large_array_threshold__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn  {} {@var{bytes} =} __large_array_threshold__ ()
+@deftypefnx {} {@var{old_bytes} =} __large_array_threshold__ (@var{bytes})
+Query or set the minimum size in bytes of the numeric arrays whose data is
+mapped directly from the operating system instead of taken from the heap.
+
+Zero means that the data of all arrays comes from the heap.
+@seealso{__large_array_pool_size__}
+@end deftypefn */)
+{
+  int nargin = args.length ();
+
+  if (nargin > 1)
+    print_usage ();
+
+  if (nargin == 0)
+    return ovl (static_cast<double> (large_array_threshold ()));
+
+  double bytes = args(0).xdouble_value ("__large_array_threshold__: BYTES must be a nonnegative integer");
+
+  if (bytes < 0 || math::x_nint (bytes) != bytes)
+    error ("__large_array_threshold__: BYTES must be a nonnegative integer");
+
+  return ovl (static_cast<double> (set_large_array_threshold (bytes)));
+}
+
+DEFUN (__large_array_pool_size__, args, ,
+       doc: /* -*- texinfo -*-
+@deftypefn  {} {@var{bytes} =} __large_array_pool_size__ ()
+@deftypefnx {} {@var{old_bytes} =} __large_array_pool_size__ (@var{bytes})
+Query or set the maximum total size in bytes of the freed large array
+buffers that are kept for reuse by later arrays of the same size.
+@seealso{__large_array_threshold__}
+@end deftypefn */)
+{
+  int nargin = args.length ();
+
+  if (nargin > 1)
+    print_usage ();
+
+  if (nargin == 0)
+    return ovl (static_cast<double> (large_array_pool_size ()));
+
+  double bytes = args(0).xdouble_value ("__large_array_pool_size__: BYTES must be a nonnegative integer");
+
+  if (bytes < 0 || math::x_nint (bytes) != bytes)
+    error ("__large_array_pool_size__: BYTES must be a nonnegative integer");
+
+  return ovl (static_cast<double> (set_large_array_pool_size (bytes)));
+}
+
+/*
+## Freed large arrays are reused by later arrays of the same size
+%!test
+%! old_threshold = __large_array_threshold__ (1e6);
+%! old_pool_size = __large_array_pool_size__ (64e6);
+%! unwind_protect
+%!   assert (__large_array_threshold__ (), 1e6);
+%!   x = rand (1e6, 1);
+%!   y = x + 1;
+%!   s0 = __array_stats__ ();
+%!   for i = 1:3
+%!     z = x .* 2 + 1;
+%!     w = zeros (size (x));
+%!     v = ones (1e3);
+%!   endfor
+%!   s1 = __array_stats__ ();
+%!   assert (z, 2*x + 1);
+%!   assert (y, x + 1);
+%!   assert (all (w == 0));
+%!   assert (all (v(:) == 1));
+%!   assert (s1.pooled > s0.pooled);
+%!   a = zeros (2e5, 1, "int8");
+%!   a(end) = 1;
+%!   assert (nnz (a), 1);
+%!   c = complex (x, x);
+%!   assert (real (c), x);
+%! unwind_protect_cleanup
+%!   __large_array_threshold__ (old_threshold);
+%!   __large_array_pool_size__ (old_pool_size);
+%! end_unwind_protect
+
+%!error <BYTES must be a nonnegative integer> __large_array_threshold__ (-1)
+%!error <BYTES must be a nonnegative integer> __large_array_pool_size__ (0.5)
+*/
+
 OCTAVE_END_NAMESPACE(octave)
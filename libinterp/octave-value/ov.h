@@ -1456,7 +1456,7 @@ public:
 #define MAPPER_FORWARD(F) \
   octave_value F () const                           \
   {                                                     \
-    return m_rep->map (octave_base_value::umap_ ## F);    \
+    return map (octave_base_value::umap_ ## F);           \
   }
 
   MAPPER_FORWARD (abs)
@@ -1525,8 +1525,8 @@ public:
 
 #undef MAPPER_FORWARD
 
-  octave_value map (octave_base_value::unary_mapper_t umap) const
-  { return m_rep->map (umap); }
+  OCTINTERP_API octave_value
+  map (octave_base_value::unary_mapper_t umap) const;
 
   //! Extract the n-th element, aka 'val(n)'.
   //!
@@ -1625,6 +1625,58 @@ colon_op (const octave_value& base, const octave_value& limit,
   return colon_op (base, octave_value (), limit, is_for_cmd_expr);
 }
 
+// The elements of a colon expression, computed one at a time.  This
+// allows FOR loops over integer and single precision ranges without
+// first creating the array of all values.
+
+class OCTINTERP_API colon_range
+{
+public:
+
+  colon_range () = default;
+
+  OCTAVE_DISABLE_COPY_MOVE (colon_range)
+
+  virtual ~colon_range () = default;
+
+  virtual octave_idx_type numel () const = 0;
+
+  virtual octave_value elem (octave_idx_type i) const = 0;
+
+  // TRUE if the base or limit is infinite.
+  virtual bool is_infinite () const { return false; }
+};
+
+// Return nullptr if BASE:INCREMENT:LIMIT is empty or if its value must
+// be computed by colon_op.
+
+extern OCTINTERP_API std::unique_ptr<colon_range>
+make_colon_range (const octave_value& base, const octave_value& increment,
+                  const octave_value& limit);
+
+// While an object of this class exists, a mapper function applied to
+// VAL in the same thread may store its result in the data of VAL if
+// nothing else refers to it.  The evaluator uses this for the argument
+// of a built-in mapper function, as in sin (x + 1), that it discards
+// after the call.
+
+class OCTINTERP_API reusable_argument
+{
+public:
+
+  reusable_argument (const octave_value& val);
+
+  OCTAVE_DISABLE_CONSTRUCT_COPY_MOVE (reusable_argument)
+
+  ~reusable_argument ();
+
+  static bool is_reusable (const octave_value& val);
+
+private:
+
+  const octave_base_value *m_saved;
+};
+
 OCTAVE_END_NAMESPACE(octave)
 
 #define OV_UNOP_FN(name)                                \
@@ -282,7 +282,7 @@ cmdline_options::as_octave_value () const
   return m;
 }
 
-application *application::s_instance = nullptr;
+OCTAVE_THREAD_LOCAL application *application::s_instance = nullptr;
 
 application::application (int argc, char **argv)
   : m_options (argc, argv)
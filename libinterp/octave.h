@@ -346,8 +346,9 @@ public:
 
 private:
 
-  // The application instance;  There should be only one.
-  static application *s_instance;
+  // The application instance;  There should be only one per thread
+  // that runs an interpreter.  See interpreter::s_instance.
+  OCTAVE_THREAD_LOCAL static application *s_instance;
 
   void init ();
 
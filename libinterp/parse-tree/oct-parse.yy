@@ -72,6 +72,7 @@
 #include "pager.h"
 #include "parse.h"
 #include "pt-all.h"
+#include "pt-cache.h"
 #include "pt-eval.h"
 #include "separator-list.h"
 #include "symtab.h"
@@ -5312,6 +5313,9 @@ parse_fcn_file (interpreter& interp, const std::string& full_file, const std::st
 
   FILE *ffile = nullptr;
 
+  // Class methods, scripts, and autoloaded functions are not cached.
+  bool use_cache = dispatch_type.empty () && ! force_script && ! autoload;
+
   if (! full_file.empty ())
     {
       // Check that m-file is not overly large which can segfault interpreter.
@@ -5325,6 +5329,16 @@ parse_fcn_file (interpreter& interp, const std::string& full_file, const std::st
           return octave_value ();
         }
 
+      if (use_cache)
+        {
+          octave_value ov_fcn
+            = load_cached_fcn_file (interp, full_file, dir_name,
+                                    package_name, relative_lookup);
+
+          if (ov_fcn.is_defined ())
+            return ov_fcn;
+        }
+
       ffile = sys::fopen (full_file, "rb");
     }
 
@@ -5356,6 +5370,20 @@ parse_fcn_file (interpreter& interp, const std::string& full_file, const std::st
   parser.m_lexer.m_dir_name = dir_name;
   parser.m_lexer.m_package_name = package_name;
 
+  // Functions for which the parser issues warnings are not cached so
+  // that the warnings are repeated each time the file is read.
+
+  error_system& es = interp.get_error_system ();
+
+  std::string last_warning_message = es.last_warning_message ("");
+
+  unwind_action restore_last_warning_message
+    ([&es, last_warning_message] ()
+     {
+       if (es.last_warning_message ().empty ())
+         es.set_last_warning_message (last_warning_message);
+     });
+
   int err = parser.run ();
 
   if (err)
@@ -5392,6 +5420,9 @@ parse_fcn_file (interpreter& interp, const std::string& full_file, const std::st
           fcn->stash_subfunction_names (parser.m_subfunction_names);
         }
 
+      if (use_cache && es.last_warning_message ().empty ())
+        save_cached_fcn_file (interp, full_file, ov_fcn);
+
       return ov_fcn;
     }
 
@@ -172,7 +172,8 @@ profiler::tree_node::get_hierarchical (double *total) const
 profiler::profiler ()
   : m_known_functions (), m_fcn_index (),
     m_enabled (false), m_call_tree (new tree_node (nullptr, 0)),
-    m_active_fcn (nullptr), m_last_time (-1.0)
+    m_active_fcn (nullptr), m_last_time (-1.0), m_frame_stats_start (),
+    m_frame_stats ()
 { }
 
 profiler::~profiler ()
@@ -183,6 +184,21 @@ profiler::~profiler ()
 void
 profiler::set_active (bool value)
 {
+  const stack_frame::allocation_stats& cur
+    = stack_frame::get_allocation_stats ();
+
+  if (value && ! m_enabled)
+    m_frame_stats_start = cur;
+  else if (! value && m_enabled)
+    {
+      m_frame_stats.m_frames += cur.m_frames - m_frame_stats_start.m_frames;
+      m_frame_stats.m_reused += cur.m_reused - m_frame_stats_start.m_reused;
+      m_frame_stats.m_allocated
+        += cur.m_allocated - m_frame_stats_start.m_allocated;
+      m_frame_stats.m_value_arrays
+        += cur.m_value_arrays - m_frame_stats_start.m_value_arrays;
+    }
+
   m_enabled = value;
 }
 
@@ -263,6 +279,8 @@ profiler::reset ()
     }
 
   m_last_time = -1.0;
+
+  m_frame_stats = stack_frame::allocation_stats ();
 }
 
 octave_value
@@ -353,6 +371,33 @@ profiler::get_hierarchical () const
   return retval;
 }
 
+octave_value
+profiler::get_frame_stats () const
+{
+  stack_frame::allocation_stats st = m_frame_stats;
+
+  if (m_enabled)
+    {
+      const stack_frame::allocation_stats& cur
+        = stack_frame::get_allocation_stats ();
+
+      st.m_frames += cur.m_frames - m_frame_stats_start.m_frames;
+      st.m_reused += cur.m_reused - m_frame_stats_start.m_reused;
+      st.m_allocated += cur.m_allocated - m_frame_stats_start.m_allocated;
+      st.m_value_arrays
+        += cur.m_value_arrays - m_frame_stats_start.m_value_arrays;
+    }
+
+  octave_scalar_map m;
+
+  m.assign ("FramesCreated", octave_value (st.m_frames));
+  m.assign ("FramesReused", octave_value (st.m_reused));
+  m.assign ("FramesAllocated", octave_value (st.m_allocated));
+  m.assign ("ValueArraysAllocated", octave_value (st.m_value_arrays));
+
+  return m;
+}
+
 double
 profiler::query_time () const
 {
@@ -430,7 +475,10 @@ Undocumented internal function.
 
   profiler& profiler = interp.get_profiler ();
 
-  if (nargout > 1)
+  if (nargout > 2)
+    return ovl (profiler.get_flat (), profiler.get_hierarchical (),
+                profiler.get_frame_stats ());
+  else if (nargout > 1)
     return ovl (profiler.get_flat (), profiler.get_hierarchical ());
   else
     return ovl (profiler.get_flat ());
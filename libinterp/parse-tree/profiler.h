@@ -34,6 +34,8 @@
 #include <string>
 #include <vector>
 
+#include "stack-frame.h"
+
 class octave_value;
 
 OCTAVE_BEGIN_NAMESPACE(octave)
@@ -96,6 +98,7 @@ public:
 
   octave_value get_flat () const;
   octave_value get_hierarchical () const;
+  octave_value get_frame_stats () const;
 
 private:
 
@@ -192,6 +195,11 @@ private:
   // called.
   double m_last_time;
 
+  // Stack frame allocation counts when the profiler was last enabled,
+  // and the counts accumulated while it was enabled before that.
+  stack_frame::allocation_stats m_frame_stats_start;
+  stack_frame::allocation_stats m_frame_stats;
+
   // These are private as only the unwind-protecting inner class enter
   // should be allowed to call them.
   void enter_function (const std::string&);
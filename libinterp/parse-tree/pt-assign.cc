@@ -28,6 +28,7 @@
 #endif
 
 #include <string>
+#include <typeinfo>
 
 #include "error.h"
 #include "interpreter.h"
@@ -35,6 +36,11 @@
 #include "ov.h"
 #include "pt-arg-list.h"
 #include "pt-assign.h"
+#include "pt-binop.h"
+#include "pt-eval.h"
+#include "pt-id.h"
+#include "pt-idx.h"
+#include "stack-frame.h"
 
 OCTAVE_BEGIN_NAMESPACE(octave)
 
@@ -94,27 +100,32 @@ tree_simple_assignment::evaluate (tree_evaluator& tw, int)
           if (ult.numel () != 1)
             err_invalid_structure_assignment ();
 
-          octave_value rhs_val = m_rhs->evaluate (tw);
+          if (assign_in_place (tw, ult))
+            val = ult.value ();
+          else
+            {
+              octave_value rhs_val = evaluate_rhs (tw);
 
-          if (rhs_val.is_undefined ())
-            error ("value on right hand side of assignment is undefined");
+              if (rhs_val.is_undefined ())
+                error ("value on right hand side of assignment is undefined");
 
-          if (rhs_val.is_cs_list ())
-            {
-              const octave_value_list lst = rhs_val.list_value ();
+              if (rhs_val.is_cs_list ())
+                {
+                  const octave_value_list lst = rhs_val.list_value ();
 
-              if (lst.empty ())
-                error ("invalid number of elements on RHS of assignment");
+                  if (lst.empty ())
+                    error ("invalid number of elements on RHS of assignment");
 
-              rhs_val = lst(0);
-            }
+                  rhs_val = lst(0);
+                }
 
-          ult.assign (m_etype, rhs_val);
+              ult.assign (m_etype, rhs_val);
 
-          if (m_etype == octave_value::op_asn_eq)
-            val = rhs_val;
-          else
-            val = ult.value ();
+              if (m_etype == octave_value::op_asn_eq)
+                val = rhs_val;
+              else
+                val = ult.value ();
+            }
 
           if (print_result () && tw.statement_printing_enabled ())
             {
@@ -147,6 +158,78 @@ tree_simple_assignment::evaluate (tree_evaluator& tw, int)
   return val;
 }
 
+// Evaluate the assignment X = X OP Y, where Y is a variable or a
+// constant and OP is an element-wise operator, as X OP= Y.  That
+// applies OP to the value of X in place if nothing else refers to it,
+// and gives the same result as X OP Y otherwise.  Return false if the
+// assignment does not have that form.
+
+bool
+tree_simple_assignment::assign_in_place (tree_evaluator& tw,
+                                         octave_lvalue& ult)
+{
+  if (m_etype != octave_value::op_asn_eq || ! m_lhs->is_identifier ()
+      || ! m_rhs->is_binary_expression ()
+      || typeid (*m_rhs) != typeid (tree_binary_expression)
+      || tw.get_profiler ().enabled ())
+    return false;
+
+  tree_binary_expression *be = static_cast<tree_binary_expression *> (m_rhs);
+
+  octave_value::assign_op op
+    = octave_value::binary_op_to_assign_op (be->op_type ());
+
+  tree_expression *x = be->lhs ();
+  tree_expression *y = be->rhs ();
+
+  if (op == octave_value::unknown_assign_op || ! x || ! y
+      || ! x->is_identifier () || x->name () != m_lhs->name ()
+      || ! tw.is_variable (x))
+    return false;
+
+  octave_value yval;
+
+  if (y->is_constant ())
+    yval = y->evaluate (tw);
+  else if (y->is_identifier () && tw.is_variable (y))
+    yval = tw.varval (dynamic_cast<tree_identifier *> (y)->symbol ());
+  else
+    return false;
+
+  // Look at the value of X without copying it.
+  std::shared_ptr<stack_frame> frame = tw.get_current_stack_frame ();
+
+  const octave_value& xval
+    = frame->varref (dynamic_cast<tree_identifier *> (x)->symbol ());
+
+  // Only numeric and logical values, so that no user code is called.
+  // The in-place operators broadcast too, but report dimension errors
+  // for OP= instead of OP.
+  if (! (xval.isnumeric () || xval.islogical ())
+      || ! (yval.isnumeric () || yval.islogical ())
+      || (yval.numel () != 1 && xval.dims () != yval.dims ()))
+    return false;
+
+  ult.assign (op, yval);
+
+  return true;
+}
+
+// In an assignment Y = F (Y), the old value of Y may be reused for the
+// result of a built-in mapper function F (see
+// tree_index_expression::evaluate_assignment_rhs).
+
+octave_value
+tree_simple_assignment::evaluate_rhs (tree_evaluator& tw)
+{
+  if (m_etype == octave_value::op_asn_eq && m_lhs->is_identifier ()
+      && m_rhs->is_index_expression ())
+    return dynamic_cast<tree_index_expression *> (m_rhs)->evaluate_assignment_rhs
+             (tw, dynamic_cast<tree_identifier *> (m_lhs));
+
+  return m_rhs->evaluate (tw);
+}
+
 // Multi-valued assignment expressions.
 
 tree_multi_assignment::tree_multi_assignment (tree_argument_list *lst, tree_expression *r, bool plhs)
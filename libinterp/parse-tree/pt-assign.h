@@ -97,6 +97,10 @@ private:
 
   void do_assign (octave_lvalue& ult, const octave_value& rhs_val);
 
+  bool assign_in_place (tree_evaluator& tw, octave_lvalue& ult);
+
+  octave_value evaluate_rhs (tree_evaluator& tw);
+
   // The left hand side of the assignment.
   tree_expression *m_lhs;
 
@@ -27,16 +27,436 @@
 #  include "config.h"
 #endif
 
+#include <typeinfo>
+#include <vector>
+
+#include "mx-inlines.cc"
+#include "oct-parallel.h"
+
 #include "error.h"
 #include "interpreter.h"
 #include "ov.h"
+#include "ov-flt-re-mat.h"
+#include "ov-float.h"
+#include "ov-re-mat.h"
+#include "ov-scalar.h"
 #include "profiler.h"
 #include "pt-binop.h"
+#include "pt-const.h"
 #include "pt-eval.h"
+#include "pt-id.h"
 #include "variables.h"
 
 OCTAVE_BEGIN_NAMESPACE(octave)
 
+// If nothing else refers to A, which is the value of a subexpression
+// such as x .* y in x .* y + z, and an operator that modifies A in
+// place is defined for the operand types, apply OP to A and B in place
+// and return true.  The in-place operators broadcast too, but report
+// dimension errors for OP= instead of OP.
+
+static bool
+binary_op_in_place (type_info& ti, octave_value::binary_op op,
+                    octave_value& a, const octave_value& b)
+{
+  if (a.get_count () != 1)
+    return false;
+
+  octave_value::assign_op aop = octave_value::binary_op_to_assign_op (op);
+
+  if (aop == octave_value::unknown_assign_op
+      || ! ti.lookup_assign_op (aop, a.type_id (), b.type_id ())
+      || (b.numel () != 1 && a.dims () != b.dims ()))
+    return false;
+
+  a.assign (aop, b);
+
+  return true;
+}
+
+// Fused evaluation of element-wise expressions.  An expression such as
+// a.*b + c.*d - e is translated once to a postfix program whose
+// operands are the variables and constants of the expression.  If the
+// operands are arrays and scalars of the same floating point class,
+// the program is run on blocks of elements, so intermediate results
+// only need buffers of one block instead of full size arrays.  Each
+// operation is performed in the same order and precision as with
+// separate operators, so the result is identical.  Otherwise, the
+// operators are applied to the operand values one at a time, as they
+// would be without fusion.
+
+class fused_program
+{
+public:
+
+  struct instr
+  {
+    // Index of the operand, or -1 for an operation.
+    int operand;
+
+    // The expression that performs the operation.
+    tree_binary_expression *node;
+  };
+
+  static const int max_operands = 16;
+
+  fused_program () = default;
+
+  OCTAVE_DISABLE_COPY_MOVE (fused_program)
+
+  ~fused_program () = default;
+
+  // Append the program for EXPR.  Return false if EXPR is not a chain
+  // of element-wise operations on identifiers and constants.
+  bool compile (tree_expression *expr)
+  {
+    if (expr->is_binary_expression ()
+        && typeid (*expr) == typeid (tree_binary_expression))
+      {
+        tree_binary_expression *be
+          = static_cast<tree_binary_expression *> (expr);
+
+        if (! is_elementwise (be->op_type ()) || ! be->lhs () || ! be->rhs ()
+            || ! compile (be->lhs ()) || ! compile (be->rhs ()))
+          return false;
+
+        m_code.push_back ({-1, be});
+        m_depth--;
+        m_nops++;
+
+        return true;
+      }
+
+    if (! (expr->is_constant () || expr->is_identifier ())
+        || m_operands.size () == max_operands)
+      return false;
+
+    m_code.push_back ({static_cast<int> (m_operands.size ()), nullptr});
+    m_operands.push_back (expr);
+    m_max_depth = std::max (m_max_depth, ++m_depth);
+
+    return true;
+  }
+
+  int num_ops () const { return m_nops; }
+
+  int max_depth () const { return m_max_depth; }
+
+  const std::vector<instr>& code () const { return m_code; }
+
+  // Store the values of the operands in VALS.  Return false if an
+  // identifier is not a variable, so evaluating it might have side
+  // effects.
+  bool operand_values (tree_evaluator& tw, octave_value *vals) const
+  {
+    for (std::size_t i = 0; i < m_operands.size (); i++)
+      {
+        tree_expression *expr = m_operands[i];
+
+        if (expr->is_constant ())
+          vals[i] = static_cast<tree_constant *> (expr)->value ();
+        else if (tw.is_variable (expr))
+          {
+            vals[i] = tw.varval (static_cast<tree_identifier *> (expr)->symbol ());
+
+            // Evaluating a variable whose value is a function calls it.
+            if (vals[i].is_function ())
+              return false;
+          }
+        else
+          return false;
+      }
+
+    return true;
+  }
+
+  // Evaluate the program for the operand values VALS and store the
+  // result in RETVAL.  Return false if the operands are not arrays and
+  // scalars of class T with the same dimensions, or if * or / would
+  // not be element-wise.
+
+  template <typename T, typename A>
+  bool evaluate (const octave_value *vals, octave_value& retval,
+                 int scalar_type_id, int matrix_type_id) const
+  {
+    std::size_t nopnds = m_operands.size ();
+    T scalars[max_operands];
+    const T *data[max_operands];
+    bool is_scalar[max_operands];
+    dim_vector dims;
+    bool have_array = false;
+
+    for (std::size_t i = 0; i < nopnds; i++)
+      {
+        int t = vals[i].type_id ();
+
+        is_scalar[i] = (t == scalar_type_id);
+        data[i] = nullptr;
+        scalars[i] = T ();
+
+        if (is_scalar[i])
+          scalars[i] = octave_value_extract<T> (vals[i]);
+        else if (t == matrix_type_id)
+          {
+            // The operand values are kept alive by VALS, so the data
+            // can be accessed without a copy of the array.
+            const A& a = octave_value_extract<A> (vals[i]);
+
+            if (! have_array)
+              {
+                dims = a.dims ();
+                have_array = true;
+              }
+            else if (a.dims () != dims)
+              return false;
+
+            data[i] = a.data ();
+          }
+        else
+          return false;
+      }
+
+    if (! have_array || ! check_matrix_ops (is_scalar))
+      return false;
+
+    A result (dims);
+
+    const octave_idx_type n = result.numel ();
+    const octave_idx_type nblocks = (n + s_block_size - 1) / s_block_size;
+    T *r = result.rwdata ();
+
+    maybe_parallel_for (nblocks, [&] (octave_idx_type b0, octave_idx_type b1)
+    {
+      run_blocks (b0, b1, n, r, data, scalars);
+    }, s_block_size * m_nops);
+
+    retval = result;
+
+    return true;
+  }
+
+private:
+
+  static const octave_idx_type s_block_size = 1024;
+
+  static bool is_elementwise (octave_value::binary_op op)
+  {
+    switch (op)
+      {
+      case octave_value::op_add:
+      case octave_value::op_sub:
+      case octave_value::op_el_mul:
+      case octave_value::op_el_div:
+      // Element-wise if the operands allow it (see check_matrix_ops).
+      case octave_value::op_mul:
+      case octave_value::op_div:
+        return true;
+
+      default:
+        return false;
+      }
+  }
+
+  // Matrix multiplication is only element-wise if one operand is a
+  // scalar, and matrix division only if the divisor is a scalar.
+
+  bool check_matrix_ops (const bool *is_scalar) const
+  {
+    bool stack[max_operands];
+    int sp = 0;
+
+    for (const auto& ins : m_code)
+      {
+        if (ins.operand >= 0)
+          {
+            stack[sp++] = is_scalar[ins.operand];
+            continue;
+          }
+
+        bool b = stack[--sp];
+        bool a = stack[sp-1];
+        octave_value::binary_op op = ins.node->op_type ();
+
+        if ((op == octave_value::op_mul && ! a && ! b)
+            || (op == octave_value::op_div && ! b))
+          return false;
+
+        stack[sp-1] = a && b;
+      }
+
+    return true;
+  }
+
+  template <typename T>
+  static T scalar_op (octave_value::binary_op op, T x, T y)
+  {
+    switch (op)
+      {
+      case octave_value::op_add:
+        return x + y;
+      case octave_value::op_sub:
+        return x - y;
+      case octave_value::op_el_mul:
+      case octave_value::op_mul:
+        return x * y;
+      default:
+        return x / y;
+      }
+  }
+
+  template <typename T, typename X, typename Y>
+  static void array_op (octave_value::binary_op op, std::size_t len,
+                        T *r, X x, Y y)
+  {
+    switch (op)
+      {
+      case octave_value::op_add:
+        mx_inline_add (len, r, x, y);
+        break;
+      case octave_value::op_sub:
+        mx_inline_sub (len, r, x, y);
+        break;
+      case octave_value::op_el_mul:
+      case octave_value::op_mul:
+        mx_inline_mul (len, r, x, y);
+        break;
+      default:
+        mx_inline_div (len, r, x, y);
+        break;
+      }
+  }
+
+  template <typename T>
+  void run_blocks (octave_idx_type b0, octave_idx_type b1,
+                   octave_idx_type n, T *r, const T *const *data,
+                   const T *scalars) const
+  {
+    struct value
+    {
+      // Null for a scalar.
+      const T *p;
+      T s;
+    };
+
+    std::vector<T> buf (m_max_depth * s_block_size);
+    value stack[max_operands];
+
+    for (octave_idx_type b = b0; b < b1; b++)
+      {
+        const octave_idx_type i0 = b * s_block_size;
+        const std::size_t len = std::min (s_block_size, n - i0);
+        int sp = 0;
+
+        for (std::size_t k = 0; k < m_code.size (); k++)
+          {
+            const instr& ins = m_code[k];
+
+            if (ins.operand >= 0)
+              {
+                const T *p = data[ins.operand];
+                stack[sp++] = {p ? p + i0 : nullptr, scalars[ins.operand]};
+                continue;
+              }
+
+            octave_value::binary_op op = ins.node->op_type ();
+            value y = stack[--sp];
+            value x = stack[sp-1];
+
+            if (! x.p && ! y.p)
+              {
+                stack[sp-1] = {nullptr, scalar_op (op, x.s, y.s)};
+                continue;
+              }
+
+            // The last operation stores directly into the result.
+            T *out = (k + 1 == m_code.size ()
+                      ? r + i0 : buf.data () + (sp-1) * s_block_size);
+
+            if (! x.p)
+              array_op (op, len, out, x.s, y.p);
+            else if (! y.p)
+              array_op (op, len, out, x.p, y.s);
+            else
+              array_op (op, len, out, x.p, y.p);
+
+            stack[sp-1] = {out, T ()};
+          }
+      }
+  }
+
+  std::vector<instr> m_code;
+
+  std::vector<tree_expression *> m_operands;
+
+  int m_depth = 0;
+
+  int m_max_depth = 0;
+
+  int m_nops = 0;
+};
+
+bool
+tree_binary_expression::evaluate_fused (tree_evaluator& tw,
+                                        octave_value& retval)
+{
+  if (m_fused_state == fused_unknown)
+    {
+      auto prog = std::make_shared<fused_program> ();
+
+      // A single operation does not create any intermediate array.
+      if (prog->compile (this) && prog->num_ops () > 1)
+        {
+          m_fused = prog;
+          m_fused_state = fused_yes;
+        }
+      else
+        m_fused_state = fused_no;
+    }
+
+  if (m_fused_state != fused_yes)
+    return false;
+
+  octave_value vals[fused_program::max_operands];
+
+  if (! m_fused->operand_values (tw, vals))
+    return false;
+
+  if (m_fused->evaluate<double, NDArray> (vals, retval,
+                                          octave_scalar::static_type_id (),
+                                          octave_matrix::static_type_id ())
+      || (m_fused->evaluate<float, FloatNDArray>
+          (vals, retval, octave_float_scalar::static_type_id (),
+           octave_float_matrix::static_type_id ())))
+    return true;
+
+  // Apply the operators one at a time.  The operands are variables and
+  // constants, so this is the same as evaluating the subexpressions.
+
+  type_info& ti = tw.get_interpreter ().get_type_info ();
+
+  octave_value stack[fused_program::max_operands];
+  int sp = 0;
+
+  for (const auto& ins : m_fused->code ())
+    {
+      if (ins.operand >= 0)
+        stack[sp++] = vals[ins.operand];
+      else
+        {
+          octave_value::binary_op op = ins.node->op_type ();
+          octave_value b = std::move (stack[--sp]);
+          octave_value& a = stack[sp-1];
+
+          if (! binary_op_in_place (ti, op, a, b))
+            a = ins.node->cached_binary_op (ti, op, a, b);
+        }
+    }
+
+  retval = stack[0];
+
+  return true;
+}
+
 // Binary expressions.
 
 void
@@ -70,6 +490,15 @@ tree_binary_expression::dup (symbol_scope& scope) const
 octave_value
 tree_binary_expression::evaluate (tree_evaluator& tw, int)
 {
+  // The profiler reports each operator separately.
+  if (tw.fuse_elementwise_ops () && ! tw.get_profiler ().enabled ())
+    {
+      octave_value retval;
+
+      if (evaluate_fused (tw, retval))
+        return retval;
+    }
+
   if (m_lhs)
     {
       // Evaluate with unknown number of output arguments
@@ -95,7 +524,10 @@ tree_binary_expression::evaluate (tree_evaluator& tw, int)
 
               type_info& ti = interp.get_type_info ();
 
-              return binary_op (ti, m_etype, a, b);
+              if (binary_op_in_place (ti, m_etype, a, b))
+                return a;
+
+              return cached_binary_op (ti, m_etype, a, b);
             }
         }
     }
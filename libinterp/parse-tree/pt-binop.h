@@ -28,17 +28,20 @@
 
 #include "octave-config.h"
 
+#include <memory>
 #include <string>
 
 class octave_value;
 class octave_value_list;
 
 #include "ov.h"
+#include "ov-typeinfo.h"
 #include "pt-exp.h"
 #include "pt-walk.h"
 
 OCTAVE_BEGIN_NAMESPACE(octave)
 
+class fused_program;
 class symbol_scope;
 
 // Binary expressions.
@@ -109,6 +112,51 @@ public:
 
 protected:
 
+  // If this expression is a chain of element-wise operations on
+  // variables and constants of the same floating point class, compute
+  // the result in a single pass over the elements without creating
+  // intermediate arrays, store it in RETVAL, and return true.
+  bool evaluate_fused (tree_evaluator& tw, octave_value& retval);
+
+  // Apply the operator OP to A and B.  The operator function found for
+  // the operand types is remembered, so repeated evaluation of this
+  // expression with operands of the same types (the common case in
+  // loops) skips the lookup in the operator table.
+
+  template <typename OP>
+  octave_value
+  cached_binary_op (type_info& ti, OP op, const octave_value& a,
+                    const octave_value& b)
+  {
+    int t1 = a.type_id ();
+    int t2 = b.type_id ();
+
+    if (t1 == m_cache_t1 && t2 == m_cache_t2
+        && m_cache_generation == ti.binary_ops_generation ())
+      return m_cache_fcn (a.get_rep (), b.get_rep ());
+
+    // Operators for class objects may be overloaded and operands that
+    // need a type conversion first are handled by binary_op.
+
+    if (! (a.isobject () || b.isobject ()
+           || a.is_classdef_object () || b.is_classdef_object ()))
+      {
+        type_info::binary_op_fcn f = ti.lookup_binary_op (op, t1, t2);
+
+        if (f)
+          {
+            m_cache_t1 = t1;
+            m_cache_t2 = t2;
+            m_cache_fcn = f;
+            m_cache_generation = ti.binary_ops_generation ();
+
+            return f (a.get_rep (), b.get_rep ());
+          }
+      }
+
+    return binary_op (ti, op, a, b);
+  }
+
   // The operands and operator for the expression.
   tree_expression *m_lhs;
 
@@ -123,6 +171,17 @@ private:
 
   // If TRUE, don't delete m_lhs and m_rhs in destructor;
   bool m_preserve_operands;
+
+  // Operand types and operator function of the last evaluation.
+  int m_cache_t1 {-1};
+  int m_cache_t2 {-1};
+  type_info::binary_op_fcn m_cache_fcn {nullptr};
+  std::size_t m_cache_generation {0};
+
+  // Whether evaluate_fused can compute this expression, and the
+  // program that does it.
+  enum { fused_unknown, fused_no, fused_yes } m_fused_state {fused_unknown};
+  std::shared_ptr<fused_program> m_fused;
 };
 
 class tree_braindead_shortcircuit_binary_expression
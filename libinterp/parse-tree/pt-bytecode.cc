@@ -0,0 +1,1334 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#include <iomanip>
+#include <new>
+#include <ostream>
+
+#include "lo-mappers.h"
+#include "quit.h"
+#include "Range.h"
+
+#include "defun.h"
+#include "error.h"
+#include "errwarn.h"
+#include "interpreter.h"
+#include "ov-scalar.h"
+#include "ov-usr-fcn.h"
+#include "ov.h"
+#include "ovl.h"
+#include "pager.h"
+#include "pt-all.h"
+#include "pt-bytecode.h"
+#include "pt-eval.h"
+#include "stack-frame.h"
+#include "symtab.h"
+#include "unwind-prot.h"
+#include "utils.h"
+#include "variables.h"
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+class bytecode_compiler
+{
+public:
+
+  bytecode_compiler (bytecode& code)
+    : m_code (code), m_next_register (0), m_loops ()
+  { }
+
+  OCTAVE_DISABLE_CONSTRUCT_COPY_MOVE (bytecode_compiler)
+
+  ~bytecode_compiler () = default;
+
+  bool compile_function_body (tree_statement_list *lst);
+
+private:
+
+  struct loop_context
+  {
+    std::vector<int> m_breaks;
+    std::vector<int> m_continues;
+
+    // Statements in the loop body that are executed by the tree
+    // evaluator.  They may break out of or continue the loop.
+    std::vector<int> m_execs;
+  };
+
+  // Errors that can not be handled by the compiler.  Compilation of
+  // the whole function is abandoned and the tree evaluator is used
+  // instead.
+
+  class unsupported { };
+
+  int emit (bytecode::opcode op, int a = 0, int b = 0, int c = 0, int d = 0)
+  {
+    m_code.m_code.push_back ({op, a, b, c, d});
+
+    return m_code.m_code.size () - 1;
+  }
+
+  int next_pc () const { return m_code.m_code.size (); }
+
+  void patch (int pc, int target);
+
+  int new_register ()
+  {
+    int reg = m_next_register++;
+
+    if (m_next_register > m_code.m_num_registers)
+      m_code.m_num_registers = m_next_register;
+
+    return reg;
+  }
+
+  int add_constant (const octave_value& val)
+  {
+    m_code.m_constants.push_back (val);
+    return m_code.m_constants.size () - 1;
+  }
+
+  int add_symbol (const symbol_record& sym)
+  {
+    m_code.m_symbols.push_back (sym);
+    return m_code.m_symbols.size () - 1;
+  }
+
+  int add_expression (tree_expression *expr)
+  {
+    m_code.m_exprs.push_back (expr);
+    return m_code.m_exprs.size () - 1;
+  }
+
+  void emit_location (const tree& t)
+  {
+    emit (bytecode::OP_LOCATION, t.line (), t.column ());
+  }
+
+  void compile_statement_list (tree_statement_list *lst);
+
+  void compile_statement (tree_statement *stmt);
+
+  bool compile_assignment (tree_statement *stmt, tree_expression *expr);
+
+  void compile_if_command (tree_if_command& cmd);
+
+  void compile_while_command (tree_while_command& cmd);
+
+  void compile_do_until_command (tree_do_until_command& cmd);
+
+  bool compile_simple_for_command (tree_statement& stmt,
+                                   tree_simple_for_command& cmd);
+
+  void finish_loop (int continue_target, int break_target);
+
+  void compile_exec (tree_statement *stmt);
+
+  int compile_expression (tree_expression *expr, int nargout);
+
+  int compile_binary_expression (tree_binary_expression& expr);
+
+  int compile_boolean_expression (tree_boolean_expression& expr);
+
+  int compile_unary_expression (tree_unary_expression& expr);
+
+  int compile_eval (tree_expression *expr, int nargout);
+
+  //--------
+
+  bytecode& m_code;
+
+  int m_next_register;
+
+  std::vector<loop_context> m_loops;
+};
+
+void
+bytecode_compiler::patch (int pc, int target)
+{
+  bytecode::instruction& ins = m_code.m_code[pc];
+
+  switch (ins.op)
+    {
+    case bytecode::OP_JUMP:
+      ins.a = target;
+      break;
+
+    case bytecode::OP_JUMP_IF_UNDEFINED:
+    case bytecode::OP_JUMP_IF_TRUE:
+    case bytecode::OP_JUMP_IF_FALSE:
+    case bytecode::OP_BRANCH:
+      ins.b = target;
+      break;
+
+    case bytecode::OP_FOR_NEXT:
+      ins.c = target;
+      break;
+
+    case bytecode::OP_FOR_INIT:
+      ins.d = target;
+      break;
+
+    default:
+      error ("unexpected: invalid jump instruction - please report this bug");
+    }
+}
+
+bool
+bytecode_compiler::compile_function_body (tree_statement_list *lst)
+{
+  try
+    {
+      compile_statement_list (lst);
+
+      emit (bytecode::OP_RETURN);
+    }
+  catch (const unsupported&)
+    {
+      return false;
+    }
+
+  return true;
+}
+
+void
+bytecode_compiler::compile_statement_list (tree_statement_list *lst)
+{
+  if (! lst)
+    return;
+
+  for (tree_statement *stmt : *lst)
+    {
+      if (! stmt)
+        throw unsupported ();
+
+      // Registers never hold values across statements.
+
+      m_next_register = 0;
+
+      compile_statement (stmt);
+    }
+}
+
+void
+bytecode_compiler::compile_statement (tree_statement *stmt)
+{
+  tree_command *cmd = stmt->command ();
+  tree_expression *expr = stmt->expression ();
+
+  if (expr)
+    {
+      if (! compile_assignment (stmt, expr))
+        compile_exec (stmt);
+
+      return;
+    }
+
+  if (! cmd || dynamic_cast<tree_no_op_command *> (cmd))
+    return;
+
+  if (tree_if_command *if_cmd = dynamic_cast<tree_if_command *> (cmd))
+    {
+      emit_location (*stmt);
+      compile_if_command (*if_cmd);
+    }
+  else if (tree_while_command *while_cmd
+           = dynamic_cast<tree_while_command *> (cmd))
+    {
+      emit_location (*stmt);
+      compile_while_command (*while_cmd);
+    }
+  else if (tree_do_until_command *do_cmd
+           = dynamic_cast<tree_do_until_command *> (cmd))
+    {
+      emit_location (*stmt);
+      compile_do_until_command (*do_cmd);
+    }
+  else if (tree_simple_for_command *for_cmd
+           = dynamic_cast<tree_simple_for_command *> (cmd))
+    {
+      if (! compile_simple_for_command (*stmt, *for_cmd))
+        compile_exec (stmt);
+    }
+  else if (dynamic_cast<tree_return_command *> (cmd))
+    {
+      emit_location (*stmt);
+      emit (bytecode::OP_RETURN);
+    }
+  else if (! m_loops.empty ()
+           && dynamic_cast<tree_break_command *> (cmd))
+    {
+      emit_location (*stmt);
+      m_loops.back ().m_breaks.push_back (emit (bytecode::OP_JUMP));
+    }
+  else if (! m_loops.empty ()
+           && dynamic_cast<tree_continue_command *> (cmd))
+    {
+      emit_location (*stmt);
+      m_loops.back ().m_continues.push_back (emit (bytecode::OP_JUMP));
+    }
+  else
+    compile_exec (stmt);
+}
+
+// Compile assignments of the form "X = EXPR" or "X OP= EXPR" that
+// don't print their result.  All other assignments are evaluated by
+// the tree evaluator.
+
+bool
+bytecode_compiler::compile_assignment (tree_statement *stmt,
+                                       tree_expression *expr)
+{
+  if (! expr->is_assignment_expression () || expr->print_result ())
+    return false;
+
+  tree_simple_assignment *asgn = dynamic_cast<tree_simple_assignment *> (expr);
+
+  if (! asgn)
+    return false;
+
+  tree_expression *lhs = asgn->left_hand_side ();
+  tree_expression *rhs = asgn->right_hand_side ();
+
+  if (! lhs || ! rhs || ! lhs->is_identifier ())
+    return false;
+
+  tree_identifier *id = dynamic_cast<tree_identifier *> (lhs);
+
+  if (id->is_black_hole ())
+    return false;
+
+  emit_location (*stmt);
+
+  int src = compile_expression (rhs, 1);
+
+  emit (bytecode::OP_STORE, add_symbol (id->symbol ()), src,
+        asgn->op_type ());
+
+  return true;
+}
+
+void
+bytecode_compiler::compile_if_command (tree_if_command& cmd)
+{
+  tree_if_command_list *lst = cmd.cmd_list ();
+
+  if (! lst)
+    return;
+
+  std::vector<int> end_jumps;
+
+  for (tree_if_clause *tic : *lst)
+    {
+      emit_location (*tic);
+
+      int branch = -1;
+
+      if (! tic->is_else_clause ())
+        {
+          tree_expression *expr = tic->condition ();
+
+          emit_location (*expr);
+
+          int reg = compile_expression (expr, 1);
+
+          branch = emit (bytecode::OP_BRANCH, reg, 0, bytecode::COND_IF);
+        }
+
+      compile_statement_list (tic->commands ());
+
+      if (branch < 0)
+        break;
+
+      end_jumps.push_back (emit (bytecode::OP_JUMP));
+
+      patch (branch, next_pc ());
+    }
+
+  for (int pc : end_jumps)
+    patch (pc, next_pc ());
+}
+
+void
+bytecode_compiler::compile_while_command (tree_while_command& cmd)
+{
+  tree_expression *expr = cmd.condition ();
+
+  if (! expr)
+    throw unsupported ();
+
+  int top = next_pc ();
+
+  emit_location (*expr);
+
+  m_next_register = 0;
+
+  int reg = compile_expression (expr, 1);
+
+  int branch = emit (bytecode::OP_BRANCH, reg, 0, bytecode::COND_WHILE);
+
+  m_loops.push_back (loop_context ());
+
+  compile_statement_list (cmd.body ());
+
+  emit (bytecode::OP_JUMP, top);
+
+  finish_loop (top, next_pc ());
+
+  patch (branch, next_pc ());
+}
+
+void
+bytecode_compiler::compile_do_until_command (tree_do_until_command& cmd)
+{
+  tree_expression *expr = cmd.condition ();
+
+  if (! expr)
+    throw unsupported ();
+
+  int top = next_pc ();
+
+  m_loops.push_back (loop_context ());
+
+  compile_statement_list (cmd.body ());
+
+  int cond = next_pc ();
+
+  emit_location (*expr);
+
+  m_next_register = 0;
+
+  int reg = compile_expression (expr, 1);
+
+  emit (bytecode::OP_BRANCH, reg, top, bytecode::COND_DO_UNTIL);
+
+  finish_loop (cond, next_pc ());
+}
+
+bool
+bytecode_compiler::compile_simple_for_command (tree_statement& stmt,
+                                               tree_simple_for_command& cmd)
+{
+  // Parallel loops have their own evaluation strategy.
+
+  if (cmd.in_parallel ())
+    return false;
+
+  tree_expression *lhs = cmd.left_hand_side ();
+  tree_expression *expr = cmd.control_expr ();
+
+  if (! lhs || ! expr || ! lhs->is_identifier ())
+    return false;
+
+  tree_identifier *id = dynamic_cast<tree_identifier *> (lhs);
+
+  if (id->is_black_hole ())
+    return false;
+
+  emit_location (stmt);
+
+  int loop = m_code.m_loops.size ();
+  m_code.m_loops.push_back (&cmd);
+
+  int sym = add_symbol (id->symbol ());
+
+  // Colon expressions are evaluated by FOR_INIT so that integer and
+  // single precision ranges need not be stored as arrays.
+  int reg = expr->is_colon_expression () ? -1 : compile_expression (expr, 1);
+
+  int init = emit (bytecode::OP_FOR_INIT, loop, reg, sym);
+
+  int next = emit (bytecode::OP_FOR_NEXT, loop, sym);
+
+  m_loops.push_back (loop_context ());
+
+  compile_statement_list (cmd.body ());
+
+  emit (bytecode::OP_JUMP, next);
+
+  int end = next_pc ();
+
+  finish_loop (next, end);
+
+  emit (bytecode::OP_FOR_END, loop);
+
+  patch (init, end);
+  patch (next, end);
+
+  return true;
+}
+
+// Resolve the break and continue jumps of the innermost loop and pop
+// its context.
+
+void
+bytecode_compiler::finish_loop (int continue_target, int break_target)
+{
+  loop_context& ctx = m_loops.back ();
+
+  for (int pc : ctx.m_continues)
+    patch (pc, continue_target);
+
+  for (int pc : ctx.m_breaks)
+    patch (pc, break_target);
+
+  for (int pc : ctx.m_execs)
+    {
+      bytecode::instruction& ins = m_code.m_code[pc];
+
+      ins.b = break_target;
+      ins.c = continue_target;
+    }
+
+  m_loops.pop_back ();
+}
+
+void
+bytecode_compiler::compile_exec (tree_statement *stmt)
+{
+  m_code.m_stmts.push_back (stmt);
+
+  int stmt_idx = m_code.m_stmts.size () - 1;
+
+  if (m_loops.empty ())
+    emit (bytecode::OP_EXEC, stmt_idx);
+  else
+    m_loops.back ().m_execs.push_back (emit (bytecode::OP_EXEC, stmt_idx,
+                                             0, 0, 1));
+}
+
+int
+bytecode_compiler::compile_expression (tree_expression *expr, int nargout)
+{
+  if (expr->is_constant ())
+    {
+      tree_constant *c = dynamic_cast<tree_constant *> (expr);
+
+      int dest = new_register ();
+
+      emit (bytecode::OP_CONST, dest, add_constant (c->value ()));
+
+      return dest;
+    }
+  else if (expr->is_identifier ())
+    {
+      tree_identifier *id = dynamic_cast<tree_identifier *> (expr);
+
+      if (id->is_black_hole ())
+        return compile_eval (expr, nargout);
+
+      int dest = new_register ();
+
+      emit (bytecode::OP_LOAD, dest, add_symbol (id->symbol ()),
+            add_expression (expr), nargout);
+
+      return dest;
+    }
+  else if (expr->is_boolean_expression ())
+    return compile_boolean_expression (dynamic_cast<tree_boolean_expression&> (*expr));
+  else if (expr->is_binary_expression ())
+    {
+      tree_binary_expression& be
+        = dynamic_cast<tree_binary_expression&> (*expr);
+
+      if (be.is_braindead ()
+          || dynamic_cast<tree_compound_binary_expression *> (expr))
+        return compile_eval (expr, nargout);
+
+      return compile_binary_expression (be);
+    }
+  else if (expr->is_unary_expression ())
+    {
+      tree_unary_expression& ue
+        = dynamic_cast<tree_unary_expression&> (*expr);
+
+      octave_value::unary_op op = ue.op_type ();
+
+      if (op == octave_value::op_incr || op == octave_value::op_decr)
+        return compile_eval (expr, nargout);
+
+      return compile_unary_expression (ue);
+    }
+
+  return compile_eval (expr, nargout);
+}
+
+int
+bytecode_compiler::compile_binary_expression (tree_binary_expression& expr)
+{
+  tree_expression *lhs = expr.lhs ();
+  tree_expression *rhs = expr.rhs ();
+
+  if (! lhs || ! rhs)
+    throw unsupported ();
+
+  int dest = new_register ();
+
+  int a = compile_expression (lhs, -1);
+
+  // The right operand is not evaluated if the left is undefined.
+
+  int skip = -1;
+
+  if (! lhs->is_constant ())
+    skip = emit (bytecode::OP_JUMP_IF_UNDEFINED, a, 0, dest);
+
+  int b = compile_expression (rhs, -1);
+
+  emit (bytecode::OP_BINARY, dest, a, b, expr.op_type ());
+
+  if (skip >= 0)
+    patch (skip, next_pc ());
+
+  return dest;
+}
+
+int
+bytecode_compiler::compile_boolean_expression (tree_boolean_expression& expr)
+{
+  tree_expression *lhs = expr.lhs ();
+  tree_expression *rhs = expr.rhs ();
+
+  if (! lhs || ! rhs)
+    throw unsupported ();
+
+  int dest = new_register ();
+
+  int a = compile_expression (lhs, 1);
+
+  int jump = emit (expr.op_type () == tree_boolean_expression::bool_or
+                   ? bytecode::OP_JUMP_IF_TRUE : bytecode::OP_JUMP_IF_FALSE,
+                   a, 0, dest);
+
+  int b = compile_expression (rhs, 1);
+
+  emit (bytecode::OP_TRUTH, dest, b);
+
+  patch (jump, next_pc ());
+
+  return dest;
+}
+
+int
+bytecode_compiler::compile_unary_expression (tree_unary_expression& expr)
+{
+  tree_expression *operand = expr.operand ();
+
+  if (! operand)
+    throw unsupported ();
+
+  int dest = new_register ();
+
+  int a = compile_expression (operand, -1);
+
+  emit (bytecode::OP_UNARY, dest, a, expr.op_type (),
+        expr.is_prefix_expression ());
+
+  return dest;
+}
+
+int
+bytecode_compiler::compile_eval (tree_expression *expr, int nargout)
+{
+  int dest = new_register ();
+
+  emit (bytecode::OP_EVAL, dest, add_expression (expr), nargout);
+
+  return dest;
+}
+
+std::shared_ptr<bytecode>
+bytecode::compile (octave_user_function& fcn)
+{
+  // Anonymous functions are a single expression and nested functions
+  // share variables with their parent, so there is nothing to gain
+  // (and some risk) in compiling them.
+
+  if (fcn.is_user_script () || fcn.is_anonymous_function ()
+      || fcn.is_special_expr () || fcn.is_nested_function ()
+      || fcn.is_parent_function ())
+    return std::shared_ptr<bytecode> ();
+
+  tree_statement_list *body = fcn.body ();
+
+  if (! body)
+    return std::shared_ptr<bytecode> ();
+
+  std::shared_ptr<bytecode> code (new bytecode ());
+
+  bytecode_compiler compiler (*code);
+
+  if (! compiler.compile_function_body (body))
+    return std::shared_ptr<bytecode> ();
+
+  return code;
+}
+
+// State of an active for loop.
+
+struct bytecode_loop_state
+{
+  octave_value m_arg;
+
+  range<double> m_range;
+
+  bool m_is_range {false};
+
+  std::unique_ptr<colon_range> m_colon_range;
+
+  bool m_extract_elem {false};
+
+  octave_value_list m_idx;
+
+  octave_idx_type m_iidx {0};
+
+  octave_idx_type m_steps {0};
+
+  octave_idx_type m_count {0};
+};
+
+static inline bool
+is_double_scalar (const octave_value& val)
+{
+  return val.type_id () == octave_scalar::static_type_id ();
+}
+
+// Arithmetic and comparison operators on two real double scalars
+// without going through the operator lookup tables.
+
+static inline bool
+scalar_binary_op (octave_value::binary_op op, double a, double b,
+                  octave_value& result)
+{
+  switch (op)
+    {
+    case octave_value::op_add:
+      result = octave_value (a + b);
+      return true;
+
+    case octave_value::op_sub:
+      result = octave_value (a - b);
+      return true;
+
+    case octave_value::op_mul:
+    case octave_value::op_el_mul:
+      result = octave_value (a * b);
+      return true;
+
+    case octave_value::op_div:
+    case octave_value::op_el_div:
+      result = octave_value (a / b);
+      return true;
+
+    case octave_value::op_lt:
+      result = octave_value (a < b);
+      return true;
+
+    case octave_value::op_le:
+      result = octave_value (a <= b);
+      return true;
+
+    case octave_value::op_eq:
+      result = octave_value (a == b);
+      return true;
+
+    case octave_value::op_ge:
+      result = octave_value (a >= b);
+      return true;
+
+    case octave_value::op_gt:
+      result = octave_value (a > b);
+      return true;
+
+    case octave_value::op_ne:
+      result = octave_value (a != b);
+      return true;
+
+    default:
+      return false;
+    }
+}
+
+void
+bytecode::execute (tree_evaluator& tw) const
+{
+  std::shared_ptr<stack_frame> frame = tw.get_current_stack_frame ();
+
+  type_info& ti = tw.get_interpreter ().get_type_info ();
+
+  std::vector<octave_value> regs (m_num_registers);
+
+  std::vector<bytecode_loop_state> loops (m_loops.size ());
+
+  std::size_t pc = 0;
+
+  try
+    {
+      for (;;)
+        {
+          const instruction& ins = m_code[pc++];
+
+          switch (ins.op)
+            {
+            case OP_LOCATION:
+              frame->line (ins.a);
+              frame->column (ins.b);
+              octave_quit ();
+              break;
+
+            case OP_CONST:
+              regs[ins.a] = m_constants[ins.b];
+              break;
+
+            case OP_LOAD:
+              {
+                octave_value val = frame->varval (m_symbols[ins.b]);
+
+                if (val.is_defined () && ! val.is_function ())
+                  regs[ins.a] = val;
+                else
+                  regs[ins.a] = m_exprs[ins.c]->evaluate (tw, ins.d);
+              }
+              break;
+
+            case OP_EVAL:
+              regs[ins.a] = m_exprs[ins.b]->evaluate (tw, ins.c);
+              break;
+
+            case OP_STORE:
+              {
+                const symbol_record& sym = m_symbols[ins.a];
+
+                octave_value rhs_val = regs[ins.b];
+                regs[ins.b] = octave_value ();
+
+                if (rhs_val.is_undefined ())
+                  error ("value on right hand side of assignment is undefined");
+
+                if (rhs_val.is_cs_list ())
+                  {
+                    const octave_value_list lst = rhs_val.list_value ();
+
+                    if (lst.empty ())
+                      error ("invalid number of elements on RHS of assignment");
+
+                    rhs_val = lst(0);
+                  }
+
+                octave_value::assign_op op
+                  = static_cast<octave_value::assign_op> (ins.c);
+
+                try
+                  {
+                    if (op == octave_value::op_asn_eq)
+                      frame->assign (sym, rhs_val);
+                    else
+                      frame->varref (sym).assign (op, rhs_val);
+                  }
+                catch (index_exception& ie)
+                  {
+                    ie.set_var (sym.name ());
+                    std::string msg = ie.message ();
+                    error_with_id (ie.err_id (), "%s", msg.c_str ());
+                  }
+              }
+              break;
+
+            case OP_JUMP_IF_UNDEFINED:
+              if (regs[ins.a].is_undefined ())
+                {
+                  regs[ins.c] = octave_value ();
+                  pc = ins.b;
+                }
+              break;
+
+            case OP_BINARY:
+              {
+                octave_value& a = regs[ins.b];
+                octave_value& b = regs[ins.c];
+
+                octave_value::binary_op op
+                  = static_cast<octave_value::binary_op> (ins.d);
+
+                octave_value result;
+
+                if (a.is_undefined () || b.is_undefined ())
+                  ;
+                else if (! (is_double_scalar (a) && is_double_scalar (b)
+                            && scalar_binary_op (op, a.double_value (),
+                                                 b.double_value (), result)))
+                  result = binary_op (ti, op, a, b);
+
+                a = octave_value ();
+                b = octave_value ();
+
+                regs[ins.a] = result;
+              }
+              break;
+
+            case OP_UNARY:
+              {
+                octave_value op_val = regs[ins.b];
+                regs[ins.b] = octave_value ();
+
+                octave_value::unary_op op
+                  = static_cast<octave_value::unary_op> (ins.c);
+
+                octave_value result;
+
+                if (op_val.is_defined ())
+                  {
+                    // Attempt to do the operation in-place if it is
+                    // unshared (a temporary expression).
+                    if (ins.d && op_val.get_count () == 1)
+                      result = op_val.non_const_unary_op (op);
+                    else
+                      result = unary_op (ti, op, op_val);
+                  }
+
+                regs[ins.a] = result;
+              }
+              break;
+
+            case OP_TRUTH:
+              {
+                bool t = regs[ins.b].is_true ();
+                regs[ins.b] = octave_value ();
+                regs[ins.a] = octave_value (t);
+              }
+              break;
+
+            case OP_JUMP:
+              pc = ins.a;
+              break;
+
+            case OP_JUMP_IF_TRUE:
+            case OP_JUMP_IF_FALSE:
+              {
+                bool t = regs[ins.a].is_true ();
+                regs[ins.a] = octave_value ();
+                regs[ins.c] = octave_value (t);
+
+                if (t == (ins.op == OP_JUMP_IF_TRUE))
+                  pc = ins.b;
+              }
+              break;
+
+            case OP_BRANCH:
+              {
+                octave_value& cond = regs[ins.a];
+
+                if (cond.is_undefined ())
+                  {
+                    static const char *kind[] = { "if", "while", "do-until" };
+
+                    error ("%s: undefined value used in conditional expression",
+                           kind[ins.c]);
+                  }
+
+                bool t = cond.is_true ();
+                cond = octave_value ();
+
+                if (! t)
+                  pc = ins.b;
+              }
+              break;
+
+            case OP_FOR_INIT:
+              {
+                bytecode_loop_state& st = loops[ins.a];
+
+                st = bytecode_loop_state ();
+
+                octave_value rhs;
+
+                if (ins.b < 0)
+                  rhs = tw.evaluate_for_loop_expression (*m_loops[ins.a],
+                                                         st.m_colon_range);
+                else
+                  {
+                    rhs = regs[ins.b];
+                    regs[ins.b] = octave_value ();
+                  }
+
+                if (st.m_colon_range)
+                  {
+                    st.m_steps = st.m_colon_range->numel ();
+
+                    if (st.m_colon_range->is_infinite ())
+                      warning_with_id ("Octave:infinite-loop",
+                                       "FOR loop limit is infinite, will stop after %"
+                                       OCTAVE_IDX_TYPE_FORMAT " steps",
+                                       st.m_steps);
+                    break;
+                  }
+
+                if (rhs.is_undefined ())
+                  {
+                    pc = ins.d;
+                    break;
+                  }
+
+                if (rhs.is_range () && rhs.is_double_type ())
+                  {
+                    st.m_range = rhs.range_value ();
+                    st.m_is_range = true;
+                    st.m_steps = st.m_range.numel ();
+
+                    if (math::isinf (st.m_range.limit ())
+                        || math::isinf (st.m_range.base ()))
+                      warning_with_id ("Octave:infinite-loop",
+                                       "FOR loop limit is infinite, will stop after %"
+                                       OCTAVE_IDX_TYPE_FORMAT " steps",
+                                       st.m_steps);
+                  }
+                else if (rhs.is_scalar_type ())
+                  {
+                    st.m_arg = rhs;
+                    st.m_steps = 1;
+                  }
+                else if (rhs.is_range () || rhs.is_matrix_type ()
+                         || rhs.iscell () || rhs.is_string ()
+                         || rhs.isstruct ())
+                  {
+                    // A matrix or cell is reshaped to 2 dimensions and
+                    // iterated by columns.
+
+                    const dim_vector& dv = rhs.dims ().redim (2);
+
+                    octave_idx_type nrows = dv(0);
+
+                    st.m_steps = dv(1);
+
+                    st.m_arg = rhs;
+                    if (rhs.ndims () > 2)
+                      st.m_arg = st.m_arg.reshape (dv);
+
+                    if (st.m_steps == 0)
+                      {
+                        // Handle empty cases, while still assigning to
+                        // loop var.
+                        frame->assign (m_symbols[ins.c], st.m_arg);
+
+                        pc = ins.d;
+                        break;
+                      }
+
+                    // For row vectors, use single index to speed
+                    // things up.
+                    if (nrows == 1)
+                      {
+                        st.m_idx.resize (1);
+                        st.m_iidx = 0;
+                      }
+                    else
+                      {
+                        st.m_idx.resize (2);
+                        st.m_idx(0) = octave_value::magic_colon_t;
+                        st.m_iidx = 1;
+                      }
+
+                    st.m_extract_elem
+                      = tree_evaluator::for_loop_extracts_elements (st.m_arg);
+                  }
+                else
+                  {
+                    tree_simple_for_command *cmd = m_loops[ins.a];
+
+                    error ("invalid type in for loop expression near line %d, column %d",
+                           cmd->line (), cmd->column ());
+                  }
+              }
+              break;
+
+            case OP_FOR_NEXT:
+              {
+                bytecode_loop_state& st = loops[ins.a];
+
+                octave_quit ();
+
+                if (st.m_count >= st.m_steps)
+                  {
+                    pc = ins.c;
+                    break;
+                  }
+
+                octave_idx_type i = st.m_count++;
+
+                octave_value val;
+
+                if (st.m_is_range)
+                  val = st.m_range.elem (i);
+                else if (st.m_colon_range)
+                  val = st.m_colon_range->elem (i);
+                else if (st.m_idx.empty ())
+                  val = st.m_arg;
+                else
+                  {
+                    if (st.m_extract_elem)
+                      val = st.m_arg.fast_elem_extract (i);
+
+                    if (val.is_undefined ())
+                      {
+                        // index_op expects one-based indices.
+                        st.m_idx(st.m_iidx) = i + 1;
+                        val = st.m_arg.index_op (st.m_idx);
+                      }
+                  }
+
+                frame->assign (m_symbols[ins.b], val);
+              }
+              break;
+
+            case OP_FOR_END:
+              loops[ins.a] = bytecode_loop_state ();
+              break;
+
+            case OP_EXEC:
+              {
+                tree_statement *stmt = m_stmts[ins.a];
+
+                bool in_loop = ins.d != 0;
+
+                if (in_loop)
+                  {
+                    bool in_loop_command = tw.in_loop_command (true);
+
+                    unwind_action act ([&tw, in_loop_command] ()
+                                       {
+                                         tw.in_loop_command (in_loop_command);
+                                       });
+
+                    stmt->accept (tw);
+                  }
+                else
+                  stmt->accept (tw);
+
+                if (tw.returning ())
+                  return;
+
+                if (tw.breaking () || tw.continuing ())
+                  {
+                    // Break and continue outside of a loop in this
+                    // function end the function, just as they do for
+                    // the tree evaluator.
+
+                    if (! in_loop)
+                      return;
+
+                    if (tw.continuing ())
+                      {
+                        tw.continuing (tw.continuing () - 1);
+                        pc = ins.c;
+                      }
+                    else
+                      {
+                        tw.breaking (tw.breaking () - 1);
+                        pc = ins.b;
+                      }
+                  }
+              }
+              break;
+
+            case OP_RETURN:
+              return;
+            }
+        }
+    }
+  catch (const std::bad_alloc&)
+    {
+      error_with_id ("Octave:bad-alloc",
+                     "out of memory or dimension too large for Octave's index type");
+    }
+}
+
+static const char *
+opcode_name (bytecode::opcode op)
+{
+  switch (op)
+    {
+    case bytecode::OP_LOCATION:
+      return "LOCATION";
+    case bytecode::OP_CONST:
+      return "CONST";
+    case bytecode::OP_LOAD:
+      return "LOAD";
+    case bytecode::OP_EVAL:
+      return "EVAL";
+    case bytecode::OP_STORE:
+      return "STORE";
+    case bytecode::OP_JUMP_IF_UNDEFINED:
+      return "JUMP_IF_UNDEFINED";
+    case bytecode::OP_BINARY:
+      return "BINARY";
+    case bytecode::OP_UNARY:
+      return "UNARY";
+    case bytecode::OP_TRUTH:
+      return "TRUTH";
+    case bytecode::OP_JUMP:
+      return "JUMP";
+    case bytecode::OP_JUMP_IF_TRUE:
+      return "JUMP_IF_TRUE";
+    case bytecode::OP_JUMP_IF_FALSE:
+      return "JUMP_IF_FALSE";
+    case bytecode::OP_BRANCH:
+      return "BRANCH";
+    case bytecode::OP_FOR_INIT:
+      return "FOR_INIT";
+    case bytecode::OP_FOR_NEXT:
+      return "FOR_NEXT";
+    case bytecode::OP_FOR_END:
+      return "FOR_END";
+    case bytecode::OP_EXEC:
+      return "EXEC";
+    case bytecode::OP_RETURN:
+      return "RETURN";
+    }
+
+  return "<unknown>";
+}
+
+void
+bytecode::disassemble (std::ostream& os) const
+{
+  for (std::size_t pc = 0; pc < m_code.size (); pc++)
+    {
+      const instruction& ins = m_code[pc];
+
+      os << std::setw (5) << pc << "  " << std::left << std::setw (18)
+         << opcode_name (ins.op) << std::right
+         << ins.a << ", " << ins.b << ", " << ins.c << ", " << ins.d;
+
+      switch (ins.op)
+        {
+        case OP_LOAD:
+        case OP_FOR_NEXT:
+          os << "  # " << m_symbols[ins.b].name ();
+          break;
+
+        case OP_STORE:
+          os << "  # " << m_symbols[ins.a].name ();
+          break;
+
+        case OP_FOR_INIT:
+          os << "  # " << m_symbols[ins.c].name ();
+          break;
+
+        case OP_BINARY:
+          os << "  # "
+             << octave_value::binary_op_as_string (static_cast<octave_value::binary_op> (ins.d));
+          break;
+
+        case OP_UNARY:
+          os << "  # "
+             << octave_value::unary_op_as_string (static_cast<octave_value::unary_op> (ins.c));
+          break;
+
+        case OP_EXEC:
+          os << "  # line " << m_stmts[ins.a]->line ();
+          break;
+
+        default:
+          break;
+        }
+
+      os << "\n";
+    }
+}
+
+DEFMETHOD (__vm_compile__, interp, args, nargout,
+           doc: /* -*- texinfo -*-
+@deftypefn  {} {@var{tf} =} __vm_compile__ (@var{fcn_name})
+@deftypefnx {} {@var{tf} =} __vm_compile__ (@var{fcn_name}, "print")
+Compile the function @var{fcn_name} for the bytecode interpreter.
+
+Return true if the body of the function could be compiled.  The compiled
+form is cached with the function and used for all calls while the
+bytecode interpreter is enabled.  With the option @qcode{"print"}, display
+a listing of the generated instructions.
+
+Undocumented internal function.
+@seealso{__vm_enable__}
+@end deftypefn */)
+{
+  int nargin = args.length ();
+
+  if (nargin < 1 || nargin > 2)
+    print_usage ();
+
+  std::string name = args(0).xstring_value ("__vm_compile__: FCN_NAME must be a string");
+
+  bool print = false;
+
+  if (nargin == 2)
+    {
+      std::string opt = args(1).xstring_value ("__vm_compile__: option must be a string");
+
+      if (opt != "print")
+        error (R"(__vm_compile__: unrecognized option "%s")", opt.c_str ());
+
+      print = true;
+    }
+
+  symbol_table& symtab = interp.get_symbol_table ();
+
+  octave_value fcn = symtab.find_function (name);
+
+  if (! fcn.is_defined ())
+    error ("__vm_compile__: function '%s' not found", name.c_str ());
+
+  octave_user_function *ufcn = fcn.user_function_value (true);
+
+  if (! ufcn)
+    error ("__vm_compile__: '%s' is not a user-defined function",
+           name.c_str ());
+
+  std::shared_ptr<bytecode> code = ufcn->bytecode ();
+
+  if (! code)
+    {
+      code = bytecode::compile (*ufcn);
+      ufcn->bytecode (code);
+    }
+
+  if (code && (print || nargout == 0))
+    code->disassemble (octave_stdout);
+
+  return ovl (static_cast<bool> (code));
+}
+
+/*
+%!assert (__vm_compile__ ("fliplr"))
+
+%!error <not a user-defined function> __vm_compile__ ("sin")
+%!error <not found> __vm_compile__ ("__no_such_function__")
+%!error <unrecognized option> __vm_compile__ ("fliplr", "foo")
+*/
+
+OCTAVE_END_NAMESPACE(octave)
@@ -0,0 +1,177 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if ! defined (octave_pt_bytecode_h)
+#define octave_pt_bytecode_h 1
+
+#include "octave-config.h"
+
+#include <iosfwd>
+#include <memory>
+#include <vector>
+
+#include "ov.h"
+#include "symrec.h"
+
+class octave_user_function;
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+class tree_evaluator;
+class tree_expression;
+class tree_simple_for_command;
+class tree_statement;
+
+// A compact, register based form of the body of a user function.
+//
+// Control flow, assignments to local variables, and arithmetic and
+// comparison operators are executed directly by a small virtual
+// machine that addresses local variables through the symbol records
+// of the function scope.  Everything else (function calls, indexing,
+// matrix lists, switch and try blocks, ...) is delegated to the tree
+// evaluator one expression or statement at a time, so both operate on
+// the same stack frame.
+
+class bytecode
+{
+public:
+
+  enum opcode
+  {
+    // A: line, B: column.  Also checks for interrupts.
+    OP_LOCATION,
+
+    // A: dest register, B: constant.
+    OP_CONST,
+
+    // A: dest register, B: symbol, C: identifier expression, D: nargout.
+    OP_LOAD,
+
+    // A: dest register, B: expression, C: nargout.
+    OP_EVAL,
+
+    // A: symbol, B: source register, C: assign_op.
+    OP_STORE,
+
+    // Clear the dest register and jump if an operand is undefined.
+    // A: register, B: target, C: dest register.
+    OP_JUMP_IF_UNDEFINED,
+
+    // A: dest register, B: lhs register, C: rhs register, D: binary_op.
+    OP_BINARY,
+
+    // A: dest register, B: operand register, C: unary_op, D: nonzero
+    // for prefix operators.
+    OP_UNARY,
+
+    // A: dest register, B: operand register.
+    OP_TRUTH,
+
+    // A: target.
+    OP_JUMP,
+
+    // Store the truth value of a register in the dest register and
+    // jump if it is true.  A: register, B: target, C: dest register.
+    OP_JUMP_IF_TRUE,
+
+    // Likewise, but jump if the value is false.
+    OP_JUMP_IF_FALSE,
+
+    // Jump if a condition is false, with the error checking of if,
+    // while and do-until conditions.  A: register, B: target,
+    // C: kind of condition.
+    OP_BRANCH,
+
+    // A: loop, B: control register, or -1 if the control expression
+    // is evaluated by the instruction itself, C: symbol, D: target
+    // after loop.
+    OP_FOR_INIT,
+
+    // A: loop, B: symbol, C: target after loop.
+    OP_FOR_NEXT,
+
+    // A: loop.  Releases the value of the loop expression.
+    OP_FOR_END,
+
+    // A: statement, B: break target, C: continue target, D: nonzero if
+    // the statement is inside a loop.
+    OP_EXEC,
+
+    OP_RETURN
+  };
+
+  // Kinds of conditions for OP_BRANCH.
+
+  enum condition_kind
+  {
+    COND_IF,
+    COND_WHILE,
+    COND_DO_UNTIL
+  };
+
+  struct instruction
+  {
+    opcode op;
+    int a;
+    int b;
+    int c;
+    int d;
+  };
+
+  bytecode () = default;
+
+  OCTAVE_DISABLE_COPY_MOVE (bytecode)
+
+  ~bytecode () = default;
+
+  // Return nullptr if the body of FCN can not be compiled.
+  static std::shared_ptr<bytecode> compile (octave_user_function& fcn);
+
+  void execute (tree_evaluator& tw) const;
+
+  void disassemble (std::ostream& os) const;
+
+private:
+
+  friend class bytecode_compiler;
+
+  std::vector<instruction> m_code;
+
+  std::vector<octave_value> m_constants;
+
+  std::vector<symbol_record> m_symbols;
+
+  std::vector<tree_expression *> m_exprs;
+
+  std::vector<tree_statement *> m_stmts;
+
+  std::vector<tree_simple_for_command *> m_loops;
+
+  int m_num_registers {0};
+};
+
+OCTAVE_END_NAMESPACE(octave)
+
+#endif
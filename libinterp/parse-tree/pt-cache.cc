@@ -0,0 +1,1982 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#include <cstdint>
+#include <fstream>
+#include <istream>
+#include <list>
+#include <map>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "file-ops.h"
+#include "file-stat.h"
+#include "lo-hash.h"
+#include "lo-sysdep.h"
+#include "mach-info.h"
+#include "oct-syscalls.h"
+#include "oct-time.h"
+
+#include "defun.h"
+#include "error.h"
+#include "interpreter.h"
+#include "ls-oct-binary.h"
+#include "ov-null-mat.h"
+#include "ov-usr-fcn.h"
+#include "ov.h"
+#include "pt-all.h"
+#include "pt-cache.h"
+#include "pt-eval.h"
+#include "symrec.h"
+#include "symscope.h"
+#include "version.h"
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+// Increment the format version whenever the layout of the serialized
+// tree changes.
+
+static const char *cache_magic = "Octave parse tree cache";
+
+static const int32_t cache_format_version = 1;
+
+enum tree_node_type : unsigned char
+{
+  nt_null,
+
+  // Expressions.
+  nt_identifier,
+  nt_black_hole,
+  nt_constant,
+  nt_fcn_handle,
+  nt_anon_fcn_handle,
+  nt_binary_expression,
+  nt_braindead_binary_expression,
+  nt_boolean_expression,
+  nt_prefix_expression,
+  nt_postfix_expression,
+  nt_colon_expression,
+  nt_index_expression,
+  nt_matrix,
+  nt_cell,
+  nt_simple_assignment,
+  nt_multi_assignment,
+
+  // Commands.
+  nt_no_op_command,
+  nt_decl_command,
+  nt_if_command,
+  nt_switch_command,
+  nt_while_command,
+  nt_do_until_command,
+  nt_simple_for_command,
+  nt_complex_for_command,
+  nt_try_catch_command,
+  nt_unwind_protect_command,
+  nt_break_command,
+  nt_continue_command,
+  nt_return_command
+};
+
+// Values of constants that can not be saved with save_binary_data.
+
+enum tree_constant_type : unsigned char
+{
+  ct_value,
+  ct_magic_colon,
+  ct_null_matrix,
+  ct_null_str,
+  ct_null_sq_str
+};
+
+// Write the parse trees of a function file and all of its
+// subfunctions.  Any node that can not be cached makes the whole file
+// uncacheable.
+
+class tree_cache_writer : public tree_walker
+{
+public:
+
+  tree_cache_writer (std::ostream& os) : m_os (os), m_ok (true) { }
+
+  OCTAVE_DISABLE_CONSTRUCT_COPY_MOVE (tree_cache_writer)
+
+  ~tree_cache_writer () = default;
+
+  bool write_fcn_file (octave_user_function& fcn);
+
+  void visit_anon_fcn_handle (tree_anon_fcn_handle&);
+
+  void visit_arguments_block (tree_arguments_block&) { m_ok = false; }
+
+  void visit_binary_expression (tree_binary_expression&);
+
+  void visit_boolean_expression (tree_boolean_expression&);
+
+  void visit_compound_binary_expression (tree_compound_binary_expression&);
+
+  void visit_break_command (tree_break_command&);
+
+  void visit_colon_expression (tree_colon_expression&);
+
+  void visit_continue_command (tree_continue_command&);
+
+  void visit_decl_command (tree_decl_command&);
+
+  void visit_simple_for_command (tree_simple_for_command&);
+
+  void visit_complex_for_command (tree_complex_for_command&);
+
+  void visit_spmd_command (tree_spmd_command&) { m_ok = false; }
+
+  void visit_octave_user_script (octave_user_script&) { m_ok = false; }
+
+  void visit_octave_user_function (octave_user_function&) { m_ok = false; }
+
+  void visit_function_def (tree_function_def&) { m_ok = false; }
+
+  void visit_identifier (tree_identifier&);
+
+  void visit_if_command (tree_if_command&);
+
+  void visit_switch_command (tree_switch_command&);
+
+  void visit_index_expression (tree_index_expression&);
+
+  void visit_matrix (tree_matrix&);
+
+  void visit_cell (tree_cell&);
+
+  void visit_multi_assignment (tree_multi_assignment&);
+
+  void visit_no_op_command (tree_no_op_command&);
+
+  void visit_constant (tree_constant&);
+
+  void visit_fcn_handle (tree_fcn_handle&);
+
+  void visit_postfix_expression (tree_postfix_expression&);
+
+  void visit_prefix_expression (tree_prefix_expression&);
+
+  void visit_return_command (tree_return_command&);
+
+  void visit_simple_assignment (tree_simple_assignment&);
+
+  void visit_try_catch_command (tree_try_catch_command&);
+
+  void visit_unwind_protect_command (tree_unwind_protect_command&);
+
+  void visit_while_command (tree_while_command&);
+
+  void visit_do_until_command (tree_do_until_command&);
+
+  void visit_superclass_ref (tree_superclass_ref&) { m_ok = false; }
+
+  void visit_metaclass_query (tree_metaclass_query&) { m_ok = false; }
+
+  void visit_classdef (tree_classdef&) { m_ok = false; }
+
+private:
+
+  template <typename T>
+  void write_value (T val)
+  {
+    m_os.write (reinterpret_cast<const char *> (&val), sizeof (T));
+  }
+
+  void write_type (tree_node_type type) { write_value<unsigned char> (type); }
+
+  void write_string (const std::string& s);
+
+  void write_pos (const filepos& pos);
+
+  void write_function (octave_user_function& fcn);
+
+  void write_scope (const symbol_scope& scope);
+
+  void write_expression_base (tree_expression& expr, tree_node_type type);
+
+  void write_binary_expression (tree_binary_expression& expr,
+                                tree_node_type type);
+
+  void write_command_base (tree_command& cmd, tree_node_type type);
+
+  void write_expression (tree_expression *expr);
+
+  void write_argument_list (tree_argument_list *lst);
+
+  void write_parameter_list (tree_parameter_list *lst);
+
+  void write_decl_elt (tree_decl_elt *elt);
+
+  void write_statement_list (tree_statement_list *lst);
+
+  //--------
+
+  std::ostream& m_os;
+
+  bool m_ok;
+};
+
+bool
+tree_cache_writer::write_fcn_file (octave_user_function& fcn)
+{
+  if (fcn.is_nested_function () || fcn.is_parent_function ()
+      || fcn.is_legacy_constructor () || fcn.is_classdef_constructor ()
+      || fcn.is_legacy_method () || fcn.is_classdef_method ()
+      || ! fcn.dispatch_class ().empty ())
+    return false;
+
+  std::list<std::string> subfcn_names = fcn.subfunction_names ();
+  std::map<std::string, octave_value> subfcns = fcn.subfunctions ();
+
+  if (subfcn_names.size () != subfcns.size ())
+    return false;
+
+  std::list<octave_user_function *> fcn_list;
+
+  for (const auto& nm : subfcn_names)
+    {
+      auto p = subfcns.find (nm);
+
+      if (p == subfcns.end ())
+        return false;
+
+      octave_user_function *subfcn = p->second.user_function_value (true);
+
+      if (! subfcn || ! subfcn->is_subfunction ()
+          || subfcn->is_nested_function () || subfcn->is_parent_function ())
+        return false;
+
+      fcn_list.push_back (subfcn);
+    }
+
+  write_function (fcn);
+
+  write_value<int32_t> (fcn_list.size ());
+
+  for (octave_user_function *subfcn : fcn_list)
+    write_function (*subfcn);
+
+  return m_ok && m_os;
+}
+
+void
+tree_cache_writer::write_string (const std::string& s)
+{
+  write_value<int32_t> (s.length ());
+  m_os.write (s.data (), s.length ());
+}
+
+void
+tree_cache_writer::write_pos (const filepos& pos)
+{
+  write_value<int32_t> (pos.line ());
+  write_value<int32_t> (pos.column ());
+}
+
+void
+tree_cache_writer::write_function (octave_user_function& fcn)
+{
+  write_string (fcn.name ());
+  write_string (fcn.doc_string ());
+  write_pos (fcn.beg_pos ());
+
+  write_scope (fcn.scope ());
+
+  write_parameter_list (fcn.parameter_list ());
+  write_parameter_list (fcn.return_list ());
+
+  write_statement_list (fcn.body ());
+}
+
+// Symbols are written in the order of their offsets in the stack
+// frame so that inserting them into a new scope in the same order
+// reproduces the same layout.
+
+void
+tree_cache_writer::write_scope (const symbol_scope& scope)
+{
+  std::list<symbol_record> symbols = scope.symbol_list ();
+
+  std::vector<symbol_record> by_offset (symbols.size ());
+
+  for (const auto& sym : symbols)
+    {
+      std::size_t offset = sym.data_offset ();
+
+      if (offset >= by_offset.size () || sym.frame_offset () != 0
+          || by_offset[offset].is_valid ())
+        {
+          m_ok = false;
+          return;
+        }
+
+      by_offset[offset] = sym;
+    }
+
+  write_string (scope.name ());
+  write_value<bool> (scope.is_static ());
+  write_value<bool> (scope.is_primary_fcn_scope ());
+
+  write_value<int32_t> (by_offset.size ());
+
+  for (const auto& sym : by_offset)
+    {
+      write_string (sym.name ());
+      write_value<unsigned char> (sym.storage_class ());
+    }
+}
+
+void
+tree_cache_writer::write_expression_base (tree_expression& expr,
+                                          tree_node_type type)
+{
+  write_type (type);
+
+  write_value<char> (expr.postfix_index ());
+  write_value<bool> (expr.print_result ());
+  write_value<bool> (expr.is_for_cmd_expr ());
+  write_value<int32_t> (expr.delim_count ());
+
+  write_pos (expr.beg_pos ());
+  write_pos (expr.end_pos ());
+}
+
+void
+tree_cache_writer::write_command_base (tree_command& cmd, tree_node_type type)
+{
+  write_type (type);
+
+  write_pos (cmd.beg_pos ());
+  write_pos (cmd.end_pos ());
+}
+
+void
+tree_cache_writer::write_expression (tree_expression *expr)
+{
+  if (expr)
+    expr->accept (*this);
+  else
+    write_type (nt_null);
+}
+
+void
+tree_cache_writer::write_argument_list (tree_argument_list *lst)
+{
+  if (! lst)
+    {
+      write_value<int32_t> (-1);
+      return;
+    }
+
+  write_value<int32_t> (lst->size ());
+
+  for (tree_expression *elt : *lst)
+    write_expression (elt);
+
+  write_value<bool> (lst->is_simple_assign_lhs ());
+}
+
+void
+tree_cache_writer::write_parameter_list (tree_parameter_list *lst)
+{
+  if (! lst)
+    {
+      write_value<int32_t> (-1);
+      return;
+    }
+
+  write_value<int32_t> (lst->size ());
+
+  for (tree_decl_elt *elt : *lst)
+    write_decl_elt (elt);
+
+  write_value<bool> (lst->is_input_list ());
+  write_value<signed char> (lst->takes_varargs ()
+                            ? (lst->varargs_only () ? -1 : 1) : 0);
+
+  write_pos (lst->beg_pos ());
+  write_pos (lst->end_pos ());
+}
+
+void
+tree_cache_writer::write_decl_elt (tree_decl_elt *elt)
+{
+  write_expression (elt->ident ());
+  write_expression (elt->expression ());
+}
+
+void
+tree_cache_writer::write_statement_list (tree_statement_list *lst)
+{
+  if (! lst)
+    {
+      write_value<int32_t> (-1);
+      return;
+    }
+
+  write_value<int32_t> (lst->size ());
+
+  for (tree_statement *stmt : *lst)
+    {
+      if (stmt->is_command ())
+        stmt->command ()->accept (*this);
+      else
+        write_expression (stmt->expression ());
+    }
+}
+
+void
+tree_cache_writer::visit_anon_fcn_handle (tree_anon_fcn_handle& afh)
+{
+  write_expression_base (afh, nt_anon_fcn_handle);
+
+  write_scope (afh.scope ());
+
+  write_parameter_list (afh.parameter_list ());
+  write_expression (afh.expression ());
+}
+
+void
+tree_cache_writer::write_binary_expression (tree_binary_expression& expr,
+                                            tree_node_type type)
+{
+  write_expression_base (expr, type);
+
+  token op_tok = expr.operator_token ();
+
+  write_pos (op_tok.beg_pos ());
+  write_pos (op_tok.end_pos ());
+
+  write_value<int32_t> (expr.op_type ());
+
+  write_expression (expr.lhs ());
+  write_expression (expr.rhs ());
+}
+
+void
+tree_cache_writer::visit_binary_expression (tree_binary_expression& expr)
+{
+  write_binary_expression (expr, (expr.is_braindead ()
+                                  ? nt_braindead_binary_expression
+                                  : nt_binary_expression));
+}
+
+void
+tree_cache_writer::visit_boolean_expression (tree_boolean_expression& expr)
+{
+  write_expression_base (expr, nt_boolean_expression);
+
+  token op_tok = expr.operator_token ();
+
+  write_pos (op_tok.beg_pos ());
+  write_pos (op_tok.end_pos ());
+
+  write_value<int32_t> (expr.op_type ());
+
+  write_expression (expr.lhs ());
+  write_expression (expr.rhs ());
+}
+
+// Compound expressions are written as the binary expressions they were
+// made from and converted again when the tree is read.
+
+void
+tree_cache_writer::visit_compound_binary_expression
+  (tree_compound_binary_expression& expr)
+{
+  write_binary_expression (expr, nt_binary_expression);
+}
+
+void
+tree_cache_writer::visit_break_command (tree_break_command& cmd)
+{
+  write_command_base (cmd, nt_break_command);
+}
+
+void
+tree_cache_writer::visit_colon_expression (tree_colon_expression& expr)
+{
+  write_expression_base (expr, nt_colon_expression);
+
+  write_expression (expr.base ());
+  write_expression (expr.increment ());
+  write_expression (expr.limit ());
+}
+
+void
+tree_cache_writer::visit_continue_command (tree_continue_command& cmd)
+{
+  write_command_base (cmd, nt_continue_command);
+}
+
+void
+tree_cache_writer::visit_decl_command (tree_decl_command& cmd)
+{
+  write_command_base (cmd, nt_decl_command);
+
+  write_string (cmd.name ());
+
+  tree_decl_init_list *init_list = cmd.initializer_list ();
+
+  if (! init_list)
+    {
+      write_value<int32_t> (-1);
+      return;
+    }
+
+  write_value<int32_t> (init_list->size ());
+
+  for (tree_decl_elt *elt : *init_list)
+    write_decl_elt (elt);
+}
+
+void
+tree_cache_writer::visit_simple_for_command (tree_simple_for_command& cmd)
+{
+  write_command_base (cmd, nt_simple_for_command);
+
+  write_value<bool> (cmd.in_parallel ());
+
+  write_expression (cmd.left_hand_side ());
+  write_expression (cmd.control_expr ());
+  write_expression (cmd.maxproc_expr ());
+
+  write_statement_list (cmd.body ());
+}
+
+void
+tree_cache_writer::visit_complex_for_command (tree_complex_for_command& cmd)
+{
+  write_command_base (cmd, nt_complex_for_command);
+
+  write_argument_list (cmd.left_hand_side ());
+  write_expression (cmd.control_expr ());
+
+  write_statement_list (cmd.body ());
+}
+
+void
+tree_cache_writer::visit_identifier (tree_identifier& id)
+{
+  write_expression_base (id, (id.is_black_hole ()
+                              ? nt_black_hole : nt_identifier));
+
+  write_string (id.name ());
+}
+
+void
+tree_cache_writer::visit_if_command (tree_if_command& cmd)
+{
+  write_command_base (cmd, nt_if_command);
+
+  tree_if_command_list *lst = cmd.cmd_list ();
+
+  if (! lst)
+    {
+      write_value<int32_t> (-1);
+      return;
+    }
+
+  write_value<int32_t> (lst->size ());
+
+  for (tree_if_clause *elt : *lst)
+    {
+      write_pos (elt->beg_pos ());
+      write_expression (elt->condition ());
+      write_statement_list (elt->commands ());
+    }
+}
+
+void
+tree_cache_writer::visit_switch_command (tree_switch_command& cmd)
+{
+  write_command_base (cmd, nt_switch_command);
+
+  write_expression (cmd.switch_value ());
+
+  tree_switch_case_list *lst = cmd.case_list ();
+
+  if (! lst)
+    {
+      write_value<int32_t> (-1);
+      return;
+    }
+
+  write_value<int32_t> (lst->size ());
+
+  for (tree_switch_case *elt : *lst)
+    {
+      write_pos (elt->beg_pos ());
+      write_expression (elt->case_label ());
+      write_statement_list (elt->commands ());
+    }
+}
+
+void
+tree_cache_writer::visit_index_expression (tree_index_expression& expr)
+{
+  write_expression_base (expr, nt_index_expression);
+
+  write_expression (expr.expression ());
+
+  write_value<bool> (expr.is_word_list_cmd ());
+
+  std::string type_tags = expr.type_tags ();
+
+  write_string (type_tags);
+
+  std::list<tree_argument_list *> arg_lists = expr.arg_lists ();
+  std::list<string_vector> arg_names = expr.arg_names ();
+  std::list<tree_expression *> dyn_fields = expr.dyn_fields ();
+
+  auto p_arg_list = arg_lists.begin ();
+  auto p_arg_names = arg_names.begin ();
+  auto p_dyn_field = dyn_fields.begin ();
+
+  for (char type : type_tags)
+    {
+      if (type == '.')
+        {
+          tree_expression *df = *p_dyn_field;
+
+          if (df)
+            write_expression (df);
+          else
+            {
+              write_type (nt_null);
+              write_string ((*p_arg_names)(0));
+            }
+        }
+      else
+        {
+          tree_argument_list *lst = *p_arg_list;
+
+          write_pos (lst->beg_pos ());
+          write_pos (lst->end_pos ());
+
+          write_argument_list (lst);
+        }
+
+      p_arg_list++;
+      p_arg_names++;
+      p_dyn_field++;
+    }
+}
+
+void
+tree_cache_writer::visit_matrix (tree_matrix& lst)
+{
+  write_expression_base (lst, nt_matrix);
+
+  write_value<int32_t> (lst.size ());
+
+  for (tree_argument_list *row : lst)
+    write_argument_list (row);
+}
+
+void
+tree_cache_writer::visit_cell (tree_cell& lst)
+{
+  write_expression_base (lst, nt_cell);
+
+  write_value<int32_t> (lst.size ());
+
+  for (tree_argument_list *row : lst)
+    write_argument_list (row);
+}
+
+void
+tree_cache_writer::visit_multi_assignment (tree_multi_assignment& expr)
+{
+  write_expression_base (expr, nt_multi_assignment);
+
+  write_argument_list (expr.left_hand_side ());
+  write_expression (expr.right_hand_side ());
+}
+
+void
+tree_cache_writer::visit_no_op_command (tree_no_op_command& cmd)
+{
+  write_command_base (cmd, nt_no_op_command);
+
+  write_string (cmd.original_command ());
+  write_value<bool> (cmd.is_end_of_file ());
+}
+
+void
+tree_cache_writer::visit_constant (tree_constant& val)
+{
+  write_expression_base (val, nt_constant);
+
+  write_string (val.original_text ());
+
+  octave_value tmp = val.value ();
+
+  if (tmp.is_magic_colon ())
+    write_value<unsigned char> (ct_magic_colon);
+  else if (tmp.isnull ())
+    write_value<unsigned char> (tmp.is_sq_string () ? ct_null_sq_str
+                                : (tmp.is_string () ? ct_null_str
+                                   : ct_null_matrix));
+  else
+    {
+      write_value<unsigned char> (ct_value);
+
+      if (! save_binary_data (m_os, tmp, "constant", "", false, false))
+        m_ok = false;
+    }
+}
+
+void
+tree_cache_writer::visit_fcn_handle (tree_fcn_handle& fh)
+{
+  write_expression_base (fh, nt_fcn_handle);
+
+  write_string (fh.name ());
+}
+
+void
+tree_cache_writer::visit_postfix_expression (tree_postfix_expression& expr)
+{
+  write_expression_base (expr, nt_postfix_expression);
+
+  write_value<int32_t> (expr.op_type ());
+
+  write_expression (expr.operand ());
+}
+
+void
+tree_cache_writer::visit_prefix_expression (tree_prefix_expression& expr)
+{
+  write_expression_base (expr, nt_prefix_expression);
+
+  write_value<int32_t> (expr.op_type ());
+
+  write_expression (expr.operand ());
+}
+
+void
+tree_cache_writer::visit_return_command (tree_return_command& cmd)
+{
+  write_command_base (cmd, nt_return_command);
+}
+
+void
+tree_cache_writer::visit_simple_assignment (tree_simple_assignment& expr)
+{
+  write_expression_base (expr, nt_simple_assignment);
+
+  write_value<int32_t> (expr.op_type ());
+
+  write_expression (expr.left_hand_side ());
+  write_expression (expr.right_hand_side ());
+}
+
+void
+tree_cache_writer::visit_try_catch_command (tree_try_catch_command& cmd)
+{
+  write_command_base (cmd, nt_try_catch_command);
+
+  write_statement_list (cmd.body ());
+  write_expression (cmd.identifier ());
+  write_statement_list (cmd.cleanup ());
+}
+
+void
+tree_cache_writer::visit_unwind_protect_command
+  (tree_unwind_protect_command& cmd)
+{
+  write_command_base (cmd, nt_unwind_protect_command);
+
+  write_statement_list (cmd.body ());
+  write_statement_list (cmd.cleanup ());
+}
+
+void
+tree_cache_writer::visit_while_command (tree_while_command& cmd)
+{
+  write_command_base (cmd, nt_while_command);
+
+  write_expression (cmd.condition ());
+  write_statement_list (cmd.body ());
+}
+
+void
+tree_cache_writer::visit_do_until_command (tree_do_until_command& cmd)
+{
+  write_command_base (cmd, nt_do_until_command);
+
+  write_statement_list (cmd.body ());
+  write_expression (cmd.condition ());
+}
+
+// Rebuild the functions defined in a function file from the data
+// written by tree_cache_writer.  The input has been verified against
+// its checksum, so it is assumed to be well formed.
+
+class tree_cache_reader
+{
+public:
+
+  tree_cache_reader (std::istream& is)
+    : m_is (is), m_scope (symbol_scope::invalid ())
+  { }
+
+  OCTAVE_DISABLE_CONSTRUCT_COPY_MOVE (tree_cache_reader)
+
+  ~tree_cache_reader () = default;
+
+  octave_value read_fcn_file (const std::string& full_file,
+                              const std::string& dir_name,
+                              const std::string& package_name,
+                              bool relative_lookup);
+
+private:
+
+  template <typename T>
+  T read_value ()
+  {
+    T val {};
+    m_is.read (reinterpret_cast<char *> (&val), sizeof (T));
+    return val;
+  }
+
+  tree_node_type read_type ()
+  {
+    return static_cast<tree_node_type> (read_value<unsigned char> ());
+  }
+
+  std::string read_string ();
+
+  filepos read_pos ();
+
+  octave_user_function * read_function ();
+
+  symbol_scope read_scope ();
+
+  tree_expression * read_expression (int skip_delims = 0);
+
+  tree_expression * read_expression (tree_node_type type, int skip_delims);
+
+  tree_expression * read_expression_node (tree_node_type type,
+                                          const filepos& beg_pos,
+                                          const filepos& end_pos);
+
+  tree_command * read_command (tree_node_type type);
+
+  tree_identifier * read_identifier ();
+
+  tree_argument_list * read_argument_list ();
+
+  tree_parameter_list * read_parameter_list ();
+
+  tree_decl_elt * read_decl_elt ();
+
+  tree_statement_list * read_statement_list ();
+
+  tree_index_expression * read_index_expression (const filepos& end_pos);
+
+  tree_expression * read_array_list (tree_array_list *lst);
+
+  //--------
+
+  std::istream& m_is;
+
+  // The scope in which identifiers are created.
+  symbol_scope m_scope;
+};
+
+octave_value
+tree_cache_reader::read_fcn_file (const std::string& full_file,
+                                  const std::string& dir_name,
+                                  const std::string& package_name,
+                                  bool relative_lookup)
+{
+  std::list<octave_user_function *> fcn_list;
+
+  fcn_list.push_back (read_function ());
+
+  int32_t num_subfcns = read_value<int32_t> ();
+
+  for (int32_t i = 0; i < num_subfcns; i++)
+    fcn_list.push_back (read_function ());
+
+  // Complete the definitions the same way the parser does in
+  // base_parser::start_function and base_parser::finish_function.
+
+  sys::time now;
+
+  octave_value ov_primary;
+  symbol_scope primary_scope = symbol_scope::invalid ();
+  std::list<std::string> subfcn_names;
+
+  for (octave_user_function *fcn : fcn_list)
+    {
+      octave_value ov_fcn (fcn);
+
+      fcn->stash_fcn_file_name (full_file);
+      fcn->stash_fcn_file_time (now);
+      fcn->stash_dir_name (dir_name);
+      fcn->stash_package_name (package_name);
+      fcn->mark_as_system_fcn_file ();
+
+      if (relative_lookup)
+        fcn->mark_relative ();
+
+      std::string fcn_nm = fcn->name ();
+
+      symbol_scope fcn_scope = fcn->scope ();
+      fcn_scope.cache_name (fcn_nm + ": " + full_file);
+      fcn_scope.cache_fcn_name (fcn_nm);
+      fcn_scope.cache_fcn_file_name (full_file);
+      fcn_scope.cache_dir_name (dir_name);
+
+      if (ov_primary.is_defined ())
+        {
+          fcn->mark_as_subfunction ();
+          subfcn_names.push_back (fcn_nm);
+
+          fcn_scope.set_parent (primary_scope);
+          fcn_scope.set_primary_parent (primary_scope);
+
+          primary_scope.install_subfunction (fcn_nm, ov_fcn);
+        }
+      else
+        {
+          ov_primary = ov_fcn;
+          primary_scope = fcn_scope;
+        }
+
+      fcn_scope.update_nest ();
+    }
+
+  octave_function *primary = ov_primary.function_value ();
+
+  primary->stash_subfunction_names (subfcn_names);
+
+  return ov_primary;
+}
+
+std::string
+tree_cache_reader::read_string ()
+{
+  int32_t len = read_value<int32_t> ();
+
+  std::string s (len, '\0');
+  m_is.read (&s[0], len);
+
+  return s;
+}
+
+filepos
+tree_cache_reader::read_pos ()
+{
+  int32_t line = read_value<int32_t> ();
+  int32_t column = read_value<int32_t> ();
+
+  return filepos (line, column);
+}
+
+octave_user_function *
+tree_cache_reader::read_function ()
+{
+  std::string name = read_string ();
+  std::string doc_string = read_string ();
+  filepos beg_pos = read_pos ();
+
+  m_scope = read_scope ();
+
+  tree_parameter_list *param_list = read_parameter_list ();
+  tree_parameter_list *ret_list = read_parameter_list ();
+
+  tree_statement_list *body = read_statement_list ();
+
+  if (! body)
+    body = new tree_statement_list ();
+
+  tree_identifier *id
+    = new tree_identifier (m_scope, token (0, name, beg_pos, beg_pos));
+
+  octave_user_function *fcn
+    = new octave_user_function (m_scope, id, param_list, nullptr, body);
+
+  fcn->stash_function_name (name);
+
+  if (! doc_string.empty ())
+    fcn->document (doc_string);
+
+  fcn->set_fcn_tok (token (0, beg_pos, beg_pos));
+
+  if (! ret_list)
+    ret_list = new tree_parameter_list (tree_parameter_list::out);
+
+  fcn->define_ret_list (ret_list);
+
+  return fcn;
+}
+
+symbol_scope
+tree_cache_reader::read_scope ()
+{
+  std::string name = read_string ();
+  bool is_static = read_value<bool> ();
+  bool is_primary_fcn_scope = read_value<bool> ();
+
+  symbol_scope scope (name);
+
+  int32_t num_symbols = read_value<int32_t> ();
+
+  for (int32_t i = 0; i < num_symbols; i++)
+    {
+      std::string sym_name = read_string ();
+      unsigned char storage_class = read_value<unsigned char> ();
+
+      symbol_record sym = scope.insert (sym_name);
+
+      if (! (storage_class & symbol_record::LOCAL))
+        sym.unmark_local ();
+      if (storage_class & symbol_record::FORMAL)
+        sym.mark_formal ();
+      if (storage_class & symbol_record::ADDED_STATIC)
+        sym.mark_added_static ();
+      if (storage_class & symbol_record::VARIABLE)
+        sym.mark_variable ();
+    }
+
+  // Mark the scope after inserting the symbols so they are not tagged
+  // as added to a static workspace.
+
+  if (is_static)
+    scope.mark_static ();
+
+  if (is_primary_fcn_scope)
+    scope.mark_primary_fcn_scope ();
+
+  return scope;
+}
+
+tree_expression *
+tree_cache_reader::read_expression (int skip_delims)
+{
+  tree_node_type type = read_type ();
+
+  return type == nt_null ? nullptr : read_expression (type, skip_delims);
+}
+
+tree_expression *
+tree_cache_reader::read_expression (tree_node_type type, int skip_delims)
+{
+  char postfix_index = read_value<char> ();
+  bool print_result = read_value<bool> ();
+  bool for_cmd_expr = read_value<bool> ();
+  int32_t delim_count = read_value<int32_t> ();
+
+  filepos beg_pos = read_pos ();
+  filepos end_pos = read_pos ();
+
+  tree_expression *expr = read_expression_node (type, beg_pos, end_pos);
+
+  expr->set_postfix_index (postfix_index);
+  expr->set_print_flag (print_result);
+
+  if (for_cmd_expr)
+    expr->mark_as_for_cmd_expr ();
+
+  // Only the outermost delimiters are used to find the position of an
+  // expression, so all of them are given the same position.
+
+  token delim_tok (0, beg_pos, end_pos);
+
+  for (int32_t i = skip_delims; i < delim_count; i++)
+    expr->mark_in_delims (delim_tok, delim_tok);
+
+  return expr;
+}
+
+tree_expression *
+tree_cache_reader::read_expression_node (tree_node_type type,
+                                         const filepos& beg_pos,
+                                         const filepos& end_pos)
+{
+  switch (type)
+    {
+    case nt_identifier:
+      return new tree_identifier (m_scope, token (0, read_string (),
+                                                  beg_pos, end_pos));
+
+    case nt_black_hole:
+      read_string ();
+      return new tree_black_hole (token (0, beg_pos, end_pos));
+
+    case nt_constant:
+      {
+        std::string orig_text = read_string ();
+
+        octave_value val;
+
+        switch (read_value<unsigned char> ())
+          {
+          case ct_magic_colon:
+            val = octave_value (octave_value::magic_colon_t);
+            break;
+
+          case ct_null_matrix:
+            val = octave_null_matrix::instance;
+            break;
+
+          case ct_null_str:
+            val = octave_null_str::instance;
+            break;
+
+          case ct_null_sq_str:
+            val = octave_null_sq_str::instance;
+            break;
+
+          default:
+            {
+              bool global;
+              std::string doc;
+
+              read_binary_data (m_is, false, mach_info::native_float_format (),
+                                "", global, val, doc);
+            }
+            break;
+          }
+
+        return new tree_constant (val, orig_text,
+                                  token (0, beg_pos, end_pos));
+      }
+
+    case nt_fcn_handle:
+      return new tree_fcn_handle (token (0, read_string (),
+                                         beg_pos, end_pos));
+
+    case nt_anon_fcn_handle:
+      {
+        symbol_scope parent_scope = m_scope;
+
+        m_scope = read_scope ();
+
+        tree_parameter_list *param_list = read_parameter_list ();
+        tree_expression *expr = read_expression ();
+
+        symbol_scope fcn_scope = m_scope;
+
+        m_scope = parent_scope;
+
+        return new tree_anon_fcn_handle (token (0, beg_pos, beg_pos),
+                                         param_list, expr, fcn_scope,
+                                         parent_scope);
+      }
+
+    case nt_binary_expression:
+    case nt_braindead_binary_expression:
+    case nt_boolean_expression:
+      {
+        filepos op_beg_pos = read_pos ();
+        filepos op_end_pos = read_pos ();
+        token op_tok (0, op_beg_pos, op_end_pos);
+
+        int32_t op_type = read_value<int32_t> ();
+
+        tree_expression *lhs = read_expression ();
+        tree_expression *rhs = read_expression ();
+
+        if (type == nt_boolean_expression)
+          return new tree_boolean_expression
+                   (lhs, op_tok, rhs,
+                    static_cast<tree_boolean_expression::type> (op_type));
+        else if (type == nt_braindead_binary_expression)
+          return new tree_braindead_shortcircuit_binary_expression
+                   (lhs, op_tok, rhs,
+                    static_cast<octave_value::binary_op> (op_type));
+        else
+          return maybe_compound_binary_expression
+                   (lhs, op_tok, rhs,
+                    static_cast<octave_value::binary_op> (op_type));
+      }
+
+    case nt_prefix_expression:
+      {
+        int32_t op_type = read_value<int32_t> ();
+        tree_expression *op = read_expression ();
+
+        return new tree_prefix_expression
+                 (token (0, beg_pos, beg_pos), op,
+                  static_cast<octave_value::unary_op> (op_type));
+      }
+
+    case nt_postfix_expression:
+      {
+        int32_t op_type = read_value<int32_t> ();
+        tree_expression *op = read_expression ();
+
+        return new tree_postfix_expression
+                 (op, token (0, end_pos, end_pos),
+                  static_cast<octave_value::unary_op> (op_type));
+      }
+
+    case nt_colon_expression:
+      {
+        tree_expression *base = read_expression ();
+        tree_expression *increment = read_expression ();
+        tree_expression *limit = read_expression ();
+
+        token colon_tok (0, base->end_pos (), limit->beg_pos ());
+
+        if (increment)
+          return new tree_colon_expression (base, colon_tok, increment,
+                                            colon_tok, limit);
+        else
+          return new tree_colon_expression (base, colon_tok, limit);
+      }
+
+    case nt_index_expression:
+      return read_index_expression (end_pos);
+
+    case nt_matrix:
+      return read_array_list (new tree_matrix ());
+
+    case nt_cell:
+      return read_array_list (new tree_cell ());
+
+    case nt_simple_assignment:
+      {
+        int32_t op_type = read_value<int32_t> ();
+
+        tree_expression *lhs = read_expression ();
+        tree_expression *rhs = read_expression ();
+
+        return new tree_simple_assignment
+                 (lhs, rhs, false,
+                  static_cast<octave_value::assign_op> (op_type));
+      }
+
+    case nt_multi_assignment:
+      {
+        tree_argument_list *lhs = read_argument_list ();
+        tree_expression *rhs = read_expression ();
+
+        return new tree_multi_assignment (lhs, rhs);
+      }
+
+    default:
+      error ("unexpected node type %d in parse tree cache - please report this bug",
+             type);
+    }
+}
+
+tree_index_expression *
+tree_cache_reader::read_index_expression (const filepos& end_pos)
+{
+  tree_expression *expr = read_expression ();
+
+  bool word_list_cmd = read_value<bool> ();
+
+  std::string type_tags = read_string ();
+
+  tree_index_expression *retval = nullptr;
+
+  for (char type : type_tags)
+    {
+      if (type == '.')
+        {
+          token dot_tok (0, end_pos, end_pos);
+
+          // The dynamic field already includes the delimiters that
+          // tree_index_expression::append adds.
+
+          tree_expression *df = read_expression (1);
+
+          if (df)
+            {
+              token delim_tok (0, df->beg_pos (), df->end_pos ());
+
+              if (retval)
+                retval->append (dot_tok, delim_tok, df, delim_tok);
+              else
+                retval = new tree_index_expression (expr, dot_tok, delim_tok,
+                                                    df, delim_tok);
+            }
+          else
+            {
+              token elt_tok (0, read_string (), end_pos, end_pos);
+
+              if (retval)
+                retval->append (dot_tok, elt_tok);
+              else
+                retval = new tree_index_expression (expr, dot_tok, elt_tok);
+            }
+        }
+      else
+        {
+          filepos open_pos = read_pos ();
+          filepos close_pos = read_pos ();
+
+          token open_delim (0, open_pos, open_pos);
+          token close_delim (0, close_pos, close_pos);
+
+          tree_argument_list *lst = read_argument_list ();
+
+          if (retval)
+            retval->append (open_delim, lst, close_delim, type);
+          else
+            retval = new tree_index_expression (expr, open_delim, lst,
+                                                close_delim, type);
+        }
+    }
+
+  if (word_list_cmd)
+    retval->mark_word_list_cmd ();
+
+  return retval;
+}
+
+tree_expression *
+tree_cache_reader::read_array_list (tree_array_list *lst)
+{
+  int32_t num_rows = read_value<int32_t> ();
+
+  for (int32_t i = 0; i < num_rows; i++)
+    lst->push_back (read_argument_list ());
+
+  return lst;
+}
+
+tree_command *
+tree_cache_reader::read_command (tree_node_type type)
+{
+  filepos beg_pos = read_pos ();
+  filepos end_pos = read_pos ();
+
+  token beg_tok (0, beg_pos, beg_pos);
+  token end_tok (0, end_pos, end_pos);
+
+  switch (type)
+    {
+    case nt_no_op_command:
+      {
+        std::string orig_cmd = read_string ();
+        bool eof = read_value<bool> ();
+
+        return new tree_no_op_command (orig_cmd, eof,
+                                       token (0, beg_pos, end_pos));
+      }
+
+    case nt_decl_command:
+      {
+        std::string cmd_name = read_string ();
+
+        int32_t len = read_value<int32_t> ();
+
+        tree_decl_init_list *init_list = nullptr;
+
+        if (len >= 0)
+          {
+            init_list = new tree_decl_init_list ();
+
+            for (int32_t i = 0; i < len; i++)
+              init_list->push_back (read_decl_elt ());
+          }
+
+        return new tree_decl_command (cmd_name, beg_tok, init_list);
+      }
+
+    case nt_if_command:
+      {
+        int32_t len = read_value<int32_t> ();
+
+        if (len < 0)
+          return new tree_if_command (beg_tok, end_tok);
+
+        tree_if_command_list *lst = new tree_if_command_list ();
+
+        for (int32_t i = 0; i < len; i++)
+          {
+            filepos clause_pos = read_pos ();
+
+            tree_expression *expr = read_expression ();
+            tree_statement_list *body = read_statement_list ();
+
+            lst->push_back (new tree_if_clause (token (0, clause_pos,
+                                                       clause_pos),
+                                                expr, body));
+          }
+
+        return new tree_if_command (beg_tok, lst, end_tok);
+      }
+
+    case nt_switch_command:
+      {
+        tree_expression *expr = read_expression ();
+
+        int32_t len = read_value<int32_t> ();
+
+        tree_switch_case_list *lst = nullptr;
+
+        if (len >= 0)
+          {
+            lst = new tree_switch_case_list ();
+
+            for (int32_t i = 0; i < len; i++)
+              {
+                filepos case_pos = read_pos ();
+                token case_tok (0, case_pos, case_pos);
+
+                tree_expression *label = read_expression ();
+                tree_statement_list *body = read_statement_list ();
+
+                if (label)
+                  lst->push_back (new tree_switch_case (case_tok, label,
+                                                        body));
+                else
+                  lst->push_back (new tree_switch_case (case_tok, body));
+              }
+          }
+
+        return new tree_switch_command (beg_tok, expr, lst, end_tok);
+      }
+
+    case nt_while_command:
+      {
+        tree_expression *expr = read_expression ();
+        tree_statement_list *body = read_statement_list ();
+
+        return new tree_while_command (beg_tok, expr, body, end_tok);
+      }
+
+    case nt_do_until_command:
+      {
+        tree_statement_list *body = read_statement_list ();
+        tree_expression *expr = read_expression ();
+
+        filepos until_pos = expr->beg_pos ();
+
+        return new tree_do_until_command (beg_tok, body,
+                                          token (0, until_pos, until_pos),
+                                          expr);
+      }
+
+    case nt_simple_for_command:
+      {
+        bool parfor = read_value<bool> ();
+
+        tree_expression *lhs = read_expression ();
+        tree_expression *expr = read_expression ();
+        tree_expression *maxproc = read_expression ();
+
+        tree_statement_list *body = read_statement_list ();
+
+        return new tree_simple_for_command (parfor, beg_tok, token (), lhs,
+                                            token (), expr, token (), maxproc,
+                                            token (), body, end_tok);
+      }
+
+    case nt_complex_for_command:
+      {
+        tree_argument_list *lhs = read_argument_list ();
+        tree_expression *expr = read_expression ();
+
+        tree_statement_list *body = read_statement_list ();
+
+        return new tree_complex_for_command (beg_tok, lhs, token (), expr,
+                                             body, end_tok);
+      }
+
+    case nt_try_catch_command:
+      {
+        tree_statement_list *body = read_statement_list ();
+        tree_identifier *id = read_identifier ();
+        tree_statement_list *cleanup = read_statement_list ();
+
+        return new tree_try_catch_command (beg_tok, body, token (), id,
+                                           cleanup, end_tok);
+      }
+
+    case nt_unwind_protect_command:
+      {
+        tree_statement_list *body = read_statement_list ();
+        tree_statement_list *cleanup = read_statement_list ();
+
+        return new tree_unwind_protect_command (beg_tok, body, token (),
+                                                cleanup, end_tok);
+      }
+
+    case nt_break_command:
+      return new tree_break_command (token (0, beg_pos, end_pos));
+
+    case nt_continue_command:
+      return new tree_continue_command (token (0, beg_pos, end_pos));
+
+    case nt_return_command:
+      return new tree_return_command (token (0, beg_pos, end_pos));
+
+    default:
+      error ("unexpected node type %d in parse tree cache - please report this bug",
+             type);
+    }
+}
+
+tree_identifier *
+tree_cache_reader::read_identifier ()
+{
+  return dynamic_cast<tree_identifier *> (read_expression ());
+}
+
+tree_argument_list *
+tree_cache_reader::read_argument_list ()
+{
+  int32_t len = read_value<int32_t> ();
+
+  if (len < 0)
+    return nullptr;
+
+  tree_argument_list *lst = new tree_argument_list ();
+
+  for (int32_t i = 0; i < len; i++)
+    lst->push_back (read_expression ());
+
+  if (read_value<bool> ())
+    lst->mark_as_simple_assign_lhs ();
+
+  return lst;
+}
+
+tree_parameter_list *
+tree_cache_reader::read_parameter_list ()
+{
+  int32_t len = read_value<int32_t> ();
+
+  if (len < 0)
+    return nullptr;
+
+  std::list<tree_decl_elt *> elts;
+
+  for (int32_t i = 0; i < len; i++)
+    elts.push_back (read_decl_elt ());
+
+  bool is_input_list = read_value<bool> ();
+  signed char varargs = read_value<signed char> ();
+
+  filepos beg_pos = read_pos ();
+  filepos end_pos = read_pos ();
+
+  tree_parameter_list *lst
+    = new tree_parameter_list (is_input_list ? tree_parameter_list::in
+                               : tree_parameter_list::out);
+
+  for (tree_decl_elt *elt : elts)
+    lst->push_back (elt);
+
+  if (varargs < 0)
+    lst->mark_varargs_only ();
+  else if (varargs > 0)
+    lst->mark_varargs ();
+
+  lst->mark_in_delims (token (0, beg_pos, beg_pos),
+                       token (0, end_pos, end_pos));
+
+  return lst;
+}
+
+tree_decl_elt *
+tree_cache_reader::read_decl_elt ()
+{
+  tree_identifier *id = read_identifier ();
+  tree_expression *expr = read_expression ();
+
+  return new tree_decl_elt (id, expr);
+}
+
+tree_statement_list *
+tree_cache_reader::read_statement_list ()
+{
+  int32_t len = read_value<int32_t> ();
+
+  if (len < 0)
+    return nullptr;
+
+  tree_statement_list *lst = new tree_statement_list ();
+
+  for (int32_t i = 0; i < len; i++)
+    {
+      tree_node_type type = read_type ();
+
+      if (type == nt_null)
+        lst->push_back (new tree_statement ());
+      else if (type >= nt_no_op_command)
+        lst->push_back (new tree_statement (read_command (type)));
+      else
+        lst->push_back (new tree_statement (read_expression (type, 0)));
+    }
+
+  return lst;
+}
+
+// Cache files are named after the MD5 hash of the full name of the
+// function file.  Each file starts with a header that identifies the
+// function file and the version of Octave that wrote it, followed by a
+// checksum and the serialized trees.
+
+static std::string
+cache_file_name (interpreter& interp, const std::string& full_file)
+{
+  tree_evaluator& tw = interp.get_evaluator ();
+
+  std::string dir = tw.parse_tree_cache_dir ();
+
+  if (dir.empty () || full_file.empty ())
+    return "";
+
+  return sys::file_ops::concat (dir, crypto::md5_hash (full_file));
+}
+
+static void
+write_cache_string (std::ostream& os, const std::string& s)
+{
+  int32_t len = s.length ();
+
+  os.write (reinterpret_cast<const char *> (&len), sizeof (len));
+  os.write (s.data (), len);
+}
+
+static bool
+read_cache_string (std::istream& is, std::string& s)
+{
+  int32_t len = 0;
+
+  is.read (reinterpret_cast<char *> (&len), sizeof (len));
+
+  if (! is || len < 0)
+    return false;
+
+  // Guard against truncated or damaged files before allocating.
+
+  std::streampos pos = is.tellg ();
+  is.seekg (0, std::ios::end);
+  std::streampos end = is.tellg ();
+  is.seekg (pos);
+
+  if (! is || end - pos < len)
+    return false;
+
+  s.resize (len);
+  is.read (&s[0], len);
+
+  return static_cast<bool> (is);
+}
+
+static void
+write_cache_header (std::ostream& os, const std::string& full_file,
+                    const sys::file_stat& fs)
+{
+  int64_t data[4] = { cache_format_version,
+                      static_cast<int64_t> (fs.mtime ().unix_time ()),
+                      static_cast<int64_t> (fs.mtime ().usec ()),
+                      static_cast<int64_t> (fs.size ()) };
+
+  write_cache_string (os, cache_magic);
+  write_cache_string (os, OCTAVE_VERSION);
+  write_cache_string (os, full_file);
+
+  os.write (reinterpret_cast<const char *> (data), sizeof (data));
+}
+
+static bool
+read_cache_header (std::istream& is, const std::string& full_file,
+                   const sys::file_stat& fs)
+{
+  std::string magic;
+  std::string version;
+  std::string file;
+
+  if (! (read_cache_string (is, magic) && magic == cache_magic
+         && read_cache_string (is, version) && version == OCTAVE_VERSION
+         && read_cache_string (is, file) && file == full_file))
+    return false;
+
+  int64_t data[4];
+
+  is.read (reinterpret_cast<char *> (data), sizeof (data));
+
+  return (is && data[0] == cache_format_version
+          && data[1] == static_cast<int64_t> (fs.mtime ().unix_time ())
+          && data[2] == static_cast<int64_t> (fs.mtime ().usec ())
+          && data[3] == static_cast<int64_t> (fs.size ()));
+}
+
+octave_value
+load_cached_fcn_file (interpreter& interp, const std::string& full_file,
+                      const std::string& dir_name,
+                      const std::string& package_name, bool relative_lookup)
+{
+  std::string cache_file = cache_file_name (interp, full_file);
+
+  if (cache_file.empty ())
+    return octave_value ();
+
+  sys::file_stat fs (full_file);
+
+  if (! fs)
+    return octave_value ();
+
+  std::ifstream is = sys::ifstream (cache_file,
+                                    std::ios::in | std::ios::binary);
+
+  if (! is)
+    return octave_value ();
+
+  std::string checksum;
+  std::string data;
+
+  if (! (read_cache_header (is, full_file, fs)
+         && read_cache_string (is, checksum)
+         && read_cache_string (is, data)
+         && checksum == crypto::md5_hash (data)))
+    return octave_value ();
+
+  std::istringstream buf (data);
+
+  tree_cache_reader reader (buf);
+
+  try
+    {
+      return reader.read_fcn_file (full_file, dir_name, package_name,
+                                   relative_lookup);
+    }
+  catch (const execution_exception&)
+    {
+      // Fall back to parsing the file.
+
+      interp.recover_from_exception ();
+    }
+
+  return octave_value ();
+}
+
+void
+save_cached_fcn_file (interpreter& interp, const std::string& full_file,
+                      const octave_value& ov_fcn)
+{
+  std::string cache_file = cache_file_name (interp, full_file);
+
+  if (cache_file.empty ())
+    return;
+
+  octave_user_function *fcn = ov_fcn.user_function_value (true);
+
+  if (! fcn)
+    return;
+
+  sys::file_stat fs (full_file);
+
+  if (! fs)
+    return;
+
+  std::ostringstream buf;
+
+  tree_cache_writer writer (buf);
+
+  try
+    {
+      if (! writer.write_fcn_file (*fcn))
+        return;
+    }
+  catch (const execution_exception&)
+    {
+      interp.recover_from_exception ();
+
+      return;
+    }
+
+  std::string data = buf.str ();
+
+  std::string msg;
+
+  sys::recursive_mkdir (interp.get_evaluator ().parse_tree_cache_dir (),
+                        0777, msg);
+
+  // Write to a temporary file first so that other sessions never see
+  // a partially written cache file.
+
+  std::string tmp_file = cache_file + '.' + std::to_string (sys::getpid ());
+
+  std::ofstream os = sys::ofstream (tmp_file,
+                                    std::ios::out | std::ios::binary);
+
+  if (! os)
+    return;
+
+  write_cache_header (os, full_file, fs);
+  write_cache_string (os, crypto::md5_hash (data));
+  write_cache_string (os, data);
+
+  os.close ();
+
+  if (! os || sys::rename (tmp_file, cache_file, msg) < 0)
+    sys::unlink (tmp_file, msg);
+}
+
+DEFMETHOD (parse_tree_cache_dir, interp, args, nargout,
+           doc: /* -*- texinfo -*-
+@deftypefn  {} {@var{val} =} parse_tree_cache_dir ()
+@deftypefnx {} {@var{old_val} =} parse_tree_cache_dir (@var{new_val})
+@deftypefnx {} {@var{old_val} =} parse_tree_cache_dir (@var{new_val}, "local")
+Query or set the internal variable that names the directory in which the
+parse trees of function files are cached.
+
+If the directory name is not empty, the parse tree of each function file
+that Octave reads is also saved in this directory.  Later requests for the
+same file, in the current or any other Octave session, rebuild the function
+from the cache instead of parsing the file again.  An entry is only used if
+the time stamp and size of the function file are the same as when the entry
+was written and it was written by the same version of Octave.  Scripts,
+classdef files, class methods, and function files that define nested
+functions or contain @code{arguments} blocks are always parsed.  Comments
+other than the help text are not stored, so they are missing from code
+that is printed from a function that was loaded from the cache.
+
+The initial value is taken from the environment variable
+@w{@env{OCTAVE_PARSE_TREE_CACHE_DIR}}.  If it is not set, the value is
+empty and no cache is used.
+
+When called from inside a function with the @qcode{"local"} option, the
+variable is changed locally for the function and any subroutines it calls.
+The original variable value is restored when exiting the function.
+@seealso{ignore_function_time_stamp}
+@end deftypefn */)
+{
+  tree_evaluator& tw = interp.get_evaluator ();
+
+  return tw.parse_tree_cache_dir (args, nargout);
+}
+
+/*
+%!test
+%! cache_dir = tempname ();
+%! fcn_dir = tempname ();
+%! fcn_file = fullfile (fcn_dir, "__pt_cache_fcn__.m");
+%! code = {"function [r, s] = __pt_cache_fcn__ (x, varargin)",
+%!         "  ## PT_CACHE_HELP_TEXT",
+%!         "  persistent n",
+%!         "  if (isempty (n))",
+%!         "    n = 0;",
+%!         "  endif",
+%!         "  n++;",
+%!         "  r = zeros (1, 0);",
+%!         "  for i = 1:x",
+%!         "    switch (mod (i, 3))",
+%!         "      case 0",
+%!         "        r(end+1) = i^2;",
+%!         "      case {1, 2}",
+%!         "        r(end+1) = -i;",
+%!         "      otherwise",
+%!         "        error ('unexpected');",
+%!         "    endswitch",
+%!         "  endfor",
+%!         "  f = @(y) y + numel (varargin);",
+%!         "  s.a = f(x);",
+%!         "  s.b = {'it''s', ""dq"", '', """", [], {}, [1, 2; 3, 4]'};",
+%!         "  s.c = __pt_cache_sub__ (x)(2:end);",
+%!         "  try",
+%!         "    error ('pt:cache', 'message');",
+%!         "  catch err",
+%!         "    s.d = err.identifier;",
+%!         "  end_try_catch",
+%!         "  [~, s.k] = max ([3, 9, 1]);",
+%!         "  s.w = 0;",
+%!         "  while (s.w < 3 && true)",
+%!         "    s.w += 1;",
+%!         "  endwhile",
+%!         "  s.(sprintf ('f%d', 1)) = {1:3, 'x', x(:)'};",
+%!         "  s.g = ! (x > 1) || x == 3;",
+%!         "  s.h = func2str (f);",
+%!         "  s.n = n;",
+%!         "endfunction",
+%!         "",
+%!         "function r = __pt_cache_sub__ (x)",
+%!         "  r = [x, x.^2, -x];",
+%!         "endfunction"};
+%! old_dir = parse_tree_cache_dir (cache_dir);
+%! unwind_protect
+%!   mkdir (fcn_dir);
+%!   fid = fopen (fcn_file, "w");
+%!   fprintf (fid, "%s\n", code{:});
+%!   fclose (fid);
+%!   addpath (fcn_dir);
+%!   [r1, s1] = __pt_cache_fcn__ (5, 1, 2);
+%!   assert (numel (glob (fullfile (cache_dir, "*"))), 1);
+%!   clear __pt_cache_fcn__;
+%!   [r2, s2] = __pt_cache_fcn__ (5, 1, 2);
+%!   assert (r2, r1);
+%!   assert (s2, s1);
+%!   assert (r2, [-1, -2, 9, -4, -5]);
+%!   assert (s2.a, 7);
+%!   assert (s2.c, [25, -5]);
+%!   assert (s2.d, "pt:cache");
+%!   assert (s2.k, 2);
+%!   assert (s2.h, "@(y) y + numel (varargin)");
+%!   assert (any (strfind (get_help_text ("__pt_cache_fcn__"),
+%!                         "PT_CACHE_HELP_TEXT")));
+%!   ## A modified function file must not be taken from the cache.
+%!   fid = fopen (fcn_file, "w");
+%!   fprintf (fid, "function r = __pt_cache_fcn__ (x)\n  r = x + 100;\nendfunction\n");
+%!   fclose (fid);
+%!   clear __pt_cache_fcn__;
+%!   assert (__pt_cache_fcn__ (5), 105);
+%! unwind_protect_cleanup
+%!   parse_tree_cache_dir (old_dir);
+%!   rmpath (fcn_dir);
+%!   confirm_recursive_rmdir (false, "local");
+%!   if (exist (fcn_dir, "dir"))
+%!     rmdir (fcn_dir, "s");
+%!   endif
+%!   if (exist (cache_dir, "dir"))
+%!     rmdir (cache_dir, "s");
+%!   endif
+%! end_unwind_protect
+
+%!test
+%! old_val = parse_tree_cache_dir ();
+%! unwind_protect
+%!   parse_tree_cache_dir ("/some/dir");
+%!   assert (parse_tree_cache_dir (), "/some/dir");
+%! unwind_protect_cleanup
+%!   parse_tree_cache_dir (old_val);
+%! end_unwind_protect
+
+%!error parse_tree_cache_dir (1, 2)
+*/
+
+OCTAVE_END_NAMESPACE(octave)
@@ -0,0 +1,73 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if ! defined (octave_pt_cache_h)
+#define octave_pt_cache_h 1
+
+#include "octave-config.h"
+
+#include <string>
+
+class octave_value;
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+class interpreter;
+
+// Persistent cache of the parse trees of function files.
+//
+// If the internal variable parse_tree_cache_dir names a directory, the
+// parse tree of each function file that is read by parse_fcn_file is
+// written to a file in that directory.  The entry is keyed by the full
+// name of the source file and records the time stamp and size of the
+// source file and the version of Octave that wrote it.  The next time
+// the function file is loaded, even in another session, the tree is
+// rebuilt from the cache entry instead of parsing the source file
+// again.
+//
+// Only plain function files are cached.  Scripts, classdef files,
+// class methods, and files defining nested functions or arguments
+// blocks are always parsed.
+
+// Return the function defined in FULL_FILE from the cache, or an
+// undefined value if caching is disabled or there is no up to date
+// entry for the file.
+
+extern OCTINTERP_API octave_value
+load_cached_fcn_file (interpreter& interp, const std::string& full_file,
+                      const std::string& dir_name,
+                      const std::string& package_name, bool relative_lookup);
+
+// Store the parse tree of the function OV_FCN defined in FULL_FILE in
+// the cache.  Functions that can not be cached and errors writing the
+// cache file are silently ignored.
+
+extern OCTINTERP_API void
+save_cached_fcn_file (interpreter& interp, const std::string& full_file,
+                      const octave_value& ov_fcn);
+
+OCTAVE_END_NAMESPACE(octave)
+
+#endif
@@ -56,7 +56,7 @@ tree_compound_binary_expression::evaluate (tree_evaluator& tw, int)
 
               type_info& ti = interp.get_type_info ();
 
-              val = binary_op (ti, m_etype, a, b);
+              val = cached_binary_op (ti, m_etype, a, b);
             }
         }
     }
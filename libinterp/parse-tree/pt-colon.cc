@@ -51,29 +51,34 @@ tree_colon_expression::dup (symbol_scope& scope) const
   return new_ce;
 }
 
-octave_value
-tree_colon_expression::evaluate (tree_evaluator& tw, int)
+bool
+tree_colon_expression::evaluate_operands (tree_evaluator& tw,
+                                          octave_value& ov_base,
+                                          octave_value& ov_increment,
+                                          octave_value& ov_limit)
 {
-  octave_value val;
-
   if (! m_base || ! m_limit)
-    return val;
+    return false;
+
+  ov_base = m_base->evaluate (tw);
+
+  if (m_increment)
+    ov_increment = m_increment->evaluate (tw);
+
+  ov_limit = m_limit->evaluate (tw);
 
+  return true;
+}
+
+octave_value
+tree_colon_expression::evaluate (tree_evaluator& tw, int)
+{
   octave_value ov_base;
   octave_value ov_increment;
   octave_value ov_limit;
 
-  if (m_increment)
-    {
-      ov_base = m_base->evaluate (tw);
-      ov_increment = m_increment->evaluate (tw);
-      ov_limit = m_limit->evaluate (tw);
-    }
-  else
-    {
-      ov_base = m_base->evaluate (tw);
-      ov_limit = m_limit->evaluate (tw);
-    }
+  if (! evaluate_operands (tw, ov_base, ov_increment, ov_limit))
+    return octave_value ();
 
   return colon_op (ov_base, ov_increment, ov_limit, is_for_cmd_expr ());
 }
@@ -84,6 +84,12 @@ public:
 
   bool is_colon_expression () const { return true; }
 
+  // Evaluate the base, increment, and limit.  The increment is
+  // undefined if it was omitted.  Return false if the base or limit
+  // is missing.
+  bool evaluate_operands (tree_evaluator& tw, octave_value& ov_base,
+                          octave_value& ov_increment, octave_value& ov_limit);
+
   octave_value evaluate (tree_evaluator&, int nargout = 1);
 
   octave_value_list evaluate_n (tree_evaluator& tw, int nargout = 1)
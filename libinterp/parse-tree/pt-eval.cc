@@ -27,21 +27,34 @@
 #  include "config.h"
 #endif
 
+#include <algorithm>
 #include <cctype>
+#include <cerrno>
+#include <cstdlib>
 
 #include <condition_variable>
+#include <fstream>
 #include <iostream>
 #include <list>
+#include <map>
 #include <mutex>
+#include <set>
 #include <string>
 #include <thread>
+#include <vector>
 
 #include "cmd-edit.h"
 #include "file-ops.h"
 #include "file-stat.h"
 #include "lo-array-errwarn.h"
 #include "lo-ieee.h"
+#include "lo-sysdep.h"
+#include "mach-info.h"
+#include "nproc-wrapper.h"
 #include "oct-env.h"
+#include "oct-rand.h"
+#include "oct-syscalls.h"
+#include "unistd-wrappers.h"
 
 #include "bp-table.h"
 #include "call-stack.h"
@@ -53,6 +66,7 @@
 #include "input.h"
 #include "interpreter-private.h"
 #include "interpreter.h"
+#include "ls-oct-binary.h"
 #include "mex-private.h"
 #include "octave.h"
 #include "ov-classdef.h"
@@ -65,6 +79,7 @@
 #include "profiler.h"
 #include "pt-all.h"
 #include "pt-anon-scopes.h"
+#include "pt-bytecode.h"
 #include "pt-eval.h"
 #include "pt-tm-const.h"
 #include "stack-frame.h"
@@ -606,6 +621,7 @@ tree_evaluator::parse_and_execute (const std::string& input,
   // time stamp to limit the checks for file modification times.
 
   Vlast_prompt_time.stamp ();
+  fcn_lookup_cache::new_generation ();
 
   bool eof = false;
 
@@ -3187,6 +3203,644 @@ tree_evaluator::visit_decl_elt (tree_decl_elt& elt)
     }
 }
 
+// Decide whether the body of a parfor loop can be executed by forked
+// worker processes and, if so, classify the variables it assigns.
+//
+// Every variable assigned in the loop body must be one of
+//
+//   * a sliced output, assigned only as X(..., I, ...) = EXPR in a
+//     statement at the top level of the loop body, where I is the loop
+//     variable and the other indices do not depend on other variables
+//     assigned in the loop;
+//
+//   * a reduction, only updated as X = X OP EXPR, X = EXPR OP X or
+//     X OP= EXPR with OP one of +, -, *, or .*, and not otherwise used
+//     in the loop body;
+//
+//   * a temporary, which is assigned before it is used in each
+//     iteration and whose value is discarded after the loop.
+//
+// Variables that are only read are broadcast to the workers for free
+// because each worker is a copy of the current process.  Any construct
+// that could carry state between iterations or reach outside of the
+// loop body (break, return, global declarations, eval, ...) makes the
+// loop execute serially.
+
+class parfor_analyzer : public tree_walker
+{
+public:
+
+  parfor_analyzer (const std::string& loop_var)
+    : m_loop_var (loop_var)
+  { }
+
+  OCTAVE_DISABLE_CONSTRUCT_COPY_MOVE (parfor_analyzer)
+
+  ~parfor_analyzer () = default;
+
+  bool analyze (tree_statement_list& body);
+
+  const std::list<tree_index_expression *>& sliced_outputs () const
+  {
+    return m_sliced_exprs;
+  }
+
+  const std::map<std::string, octave_value::binary_op>& reductions () const
+  {
+    return m_reductions;
+  }
+
+  void visit_anon_fcn_handle (tree_anon_fcn_handle&);
+
+  void visit_break_command (tree_break_command&);
+
+  void visit_continue_command (tree_continue_command&);
+
+  void visit_decl_command (tree_decl_command&) { m_ok = false; }
+
+  void visit_simple_for_command (tree_simple_for_command&);
+
+  void visit_complex_for_command (tree_complex_for_command&);
+
+  void visit_spmd_command (tree_spmd_command&) { m_ok = false; }
+
+  void visit_function_def (tree_function_def&) { m_ok = false; }
+
+  void visit_identifier (tree_identifier&);
+
+  void visit_multi_assignment (tree_multi_assignment&);
+
+  void visit_postfix_expression (tree_postfix_expression&);
+
+  void visit_prefix_expression (tree_prefix_expression&);
+
+  void visit_return_command (tree_return_command&) { m_ok = false; }
+
+  void visit_simple_assignment (tree_simple_assignment&);
+
+  void visit_statement_list (tree_statement_list&);
+
+  void visit_try_catch_command (tree_try_catch_command&);
+
+  void visit_while_command (tree_while_command&);
+
+  void visit_do_until_command (tree_do_until_command&);
+
+private:
+
+  static bool
+  reduction_op (tree_simple_assignment& expr, const std::string& name,
+                octave_value::binary_op& op, tree_expression *& operand);
+
+  bool is_defined (const std::string& name) const;
+
+  void define (const std::string& name);
+
+  void check_read (const std::string& name);
+
+  void visit_incr_decr (tree_expression *operand);
+
+  std::string m_loop_var;
+
+  // FALSE if the loop must be executed serially.
+  bool m_ok {true};
+
+  // TRUE while collecting the names of assigned variables.
+  bool m_collecting {true};
+
+  // TRUE while checking the index of a sliced output.
+  bool m_in_slice_index {false};
+
+  // Nesting level of loops inside the parfor loop body.
+  int m_loop_depth {0};
+
+  bool m_has_continue {false};
+
+  std::set<std::string> m_temporaries;
+
+  std::set<std::string> m_sliced;
+
+  std::map<std::string, octave_value::binary_op> m_reductions;
+
+  std::set<std::string> m_non_reductions;
+
+  // Temporaries defined so far in each nested statement list.
+  std::list<std::set<std::string>> m_scopes;
+
+  std::list<tree_index_expression *> m_sliced_exprs;
+};
+
+bool
+parfor_analyzer::analyze (tree_statement_list& body)
+{
+  // First pass: find the names of all variables that are assigned in
+  // the loop body.
+
+  body.accept (*this);
+
+  if (! m_ok || (m_has_continue && ! m_sliced.empty ()))
+    return false;
+
+  // A variable that is assigned in any other way is a temporary.
+
+  for (auto p = m_reductions.begin (); p != m_reductions.end (); )
+    {
+      if (m_non_reductions.count (p->first)
+          || m_temporaries.count (p->first))
+        p = m_reductions.erase (p);
+      else
+        p++;
+    }
+
+  m_temporaries.insert (m_non_reductions.begin (), m_non_reductions.end ());
+
+  if (m_temporaries.count (m_loop_var) || m_sliced.count (m_loop_var)
+      || m_reductions.count (m_loop_var))
+    return false;
+
+  for (const auto& nm : m_sliced)
+    {
+      if (m_temporaries.count (nm) || m_reductions.count (nm))
+        return false;
+    }
+
+  // Second pass: check that sliced outputs and reductions are not
+  // otherwise used and that temporaries are defined before use.
+
+  m_collecting = false;
+
+  body.accept (*this);
+
+  return m_ok;
+}
+
+bool
+parfor_analyzer::reduction_op (tree_simple_assignment& expr,
+                               const std::string& name,
+                               octave_value::binary_op& op,
+                               tree_expression *& operand)
+{
+  tree_expression *rhs = expr.right_hand_side ();
+
+  switch (expr.op_type ())
+    {
+    case octave_value::op_add_eq:
+    case octave_value::op_sub_eq:
+      op = octave_value::op_add;
+      operand = rhs;
+      return true;
+
+    case octave_value::op_mul_eq:
+      op = octave_value::op_mul;
+      operand = rhs;
+      return true;
+
+    case octave_value::op_el_mul_eq:
+      op = octave_value::op_el_mul;
+      operand = rhs;
+      return true;
+
+    case octave_value::op_asn_eq:
+      break;
+
+    default:
+      return false;
+    }
+
+  if (! rhs->is_binary_expression () || rhs->is_boolean_expression ())
+    return false;
+
+  tree_binary_expression *binexp = dynamic_cast<tree_binary_expression *> (rhs);
+
+  if (! binexp || binexp->is_braindead ())
+    return false;
+
+  tree_expression *a = binexp->lhs ();
+  tree_expression *b = binexp->rhs ();
+
+  bool a_is_var = a && a->is_identifier () && a->name () == name;
+  bool b_is_var = b && b->is_identifier () && b->name () == name;
+
+  if (a_is_var == b_is_var)
+    return false;
+
+  switch (binexp->op_type ())
+    {
+    case octave_value::op_add:
+    case octave_value::op_el_mul:
+      op = binexp->op_type ();
+      operand = a_is_var ? b : a;
+      return true;
+
+    case octave_value::op_sub:
+      // X - EXPR is accumulated as a sum of negated terms.
+      op = octave_value::op_add;
+      operand = b;
+      return a_is_var;
+
+    case octave_value::op_mul:
+      // Matrix products are not commutative, so only accept X * EXPR.
+      op = octave_value::op_mul;
+      operand = b;
+      return a_is_var;
+
+    default:
+      return false;
+    }
+}
+
+bool
+parfor_analyzer::is_defined (const std::string& name) const
+{
+  for (const auto& scope : m_scopes)
+    {
+      if (scope.count (name))
+        return true;
+    }
+
+  return false;
+}
+
+void
+parfor_analyzer::define (const std::string& name)
+{
+  if (m_collecting)
+    m_temporaries.insert (name);
+  else if (! m_scopes.empty ())
+    m_scopes.back ().insert (name);
+}
+
+void
+parfor_analyzer::check_read (const std::string& name)
+{
+  if (m_collecting)
+    return;
+
+  if (m_sliced.count (name) || m_reductions.count (name))
+    m_ok = false;
+  else if (m_temporaries.count (name))
+    {
+      if (m_in_slice_index || ! is_defined (name))
+        m_ok = false;
+    }
+}
+
+void
+parfor_analyzer::visit_anon_fcn_handle (tree_anon_fcn_handle& afh)
+{
+  std::set<std::string> params;
+
+  tree_parameter_list *param_list = afh.parameter_list ();
+
+  if (param_list)
+    {
+      for (tree_decl_elt *elt : *param_list)
+        params.insert (elt->name ());
+    }
+
+  m_scopes.push_back (params);
+
+  tree_expression *expr = afh.expression ();
+
+  if (expr)
+    expr->accept (*this);
+
+  m_scopes.pop_back ();
+}
+
+void
+parfor_analyzer::visit_break_command (tree_break_command&)
+{
+  if (m_loop_depth == 0)
+    m_ok = false;
+}
+
+void
+parfor_analyzer::visit_continue_command (tree_continue_command&)
+{
+  if (m_loop_depth == 0)
+    m_has_continue = true;
+}
+
+void
+parfor_analyzer::visit_simple_for_command (tree_simple_for_command& cmd)
+{
+  tree_expression *lhs = cmd.left_hand_side ();
+
+  if (! lhs->is_identifier ())
+    {
+      m_ok = false;
+      return;
+    }
+
+  tree_expression *expr = cmd.control_expr ();
+
+  if (expr)
+    expr->accept (*this);
+
+  tree_expression *maxproc = cmd.maxproc_expr ();
+
+  if (maxproc)
+    maxproc->accept (*this);
+
+  define (lhs->name ());
+
+  tree_statement_list *body = cmd.body ();
+
+  m_loop_depth++;
+
+  if (body)
+    body->accept (*this);
+
+  m_loop_depth--;
+}
+
+void
+parfor_analyzer::visit_complex_for_command (tree_complex_for_command& cmd)
+{
+  tree_expression *expr = cmd.control_expr ();
+
+  if (expr)
+    expr->accept (*this);
+
+  tree_argument_list *lhs = cmd.left_hand_side ();
+
+  for (tree_expression *elt : *lhs)
+    {
+      if (! elt->is_identifier ())
+        {
+          m_ok = false;
+          return;
+        }
+
+      define (elt->name ());
+    }
+
+  tree_statement_list *body = cmd.body ();
+
+  m_loop_depth++;
+
+  if (body)
+    body->accept (*this);
+
+  m_loop_depth--;
+}
+
+void
+parfor_analyzer::visit_identifier (tree_identifier& id)
+{
+  std::string nm = id.name ();
+
+  // Functions that may access the workspace of the loop directly.
+
+  if (nm == "eval" || nm == "evalin" || nm == "evalc" || nm == "assignin"
+      || nm == "load" || nm == "clear" || nm == "clearvars"
+      || nm == "inputname")
+    m_ok = false;
+  else if (m_in_slice_index && nm == "end")
+    m_ok = false;
+  else if (nm != m_loop_var)
+    check_read (nm);
+}
+
+void
+parfor_analyzer::visit_multi_assignment (tree_multi_assignment& expr)
+{
+  tree_expression *rhs = expr.right_hand_side ();
+
+  if (rhs)
+    rhs->accept (*this);
+
+  tree_argument_list *lhs = expr.left_hand_side ();
+
+  for (tree_expression *elt : *lhs)
+    {
+      if (! elt->is_identifier ())
+        {
+          m_ok = false;
+          return;
+        }
+
+      tree_identifier *id = dynamic_cast<tree_identifier *> (elt);
+
+      if (! id->is_black_hole ())
+        define (id->name ());
+    }
+}
+
+void
+parfor_analyzer::visit_incr_decr (tree_expression *operand)
+{
+  if (! operand->is_identifier ())
+    {
+      m_ok = false;
+      return;
+    }
+
+  std::string nm = operand->name ();
+
+  check_read (nm);
+  define (nm);
+}
+
+void
+parfor_analyzer::visit_postfix_expression (tree_postfix_expression& expr)
+{
+  octave_value::unary_op op = expr.op_type ();
+
+  if (op == octave_value::op_incr || op == octave_value::op_decr)
+    visit_incr_decr (expr.operand ());
+  else
+    tree_walker::visit_postfix_expression (expr);
+}
+
+void
+parfor_analyzer::visit_prefix_expression (tree_prefix_expression& expr)
+{
+  octave_value::unary_op op = expr.op_type ();
+
+  if (op == octave_value::op_incr || op == octave_value::op_decr)
+    visit_incr_decr (expr.operand ());
+  else
+    tree_walker::visit_prefix_expression (expr);
+}
+
+void
+parfor_analyzer::visit_simple_assignment (tree_simple_assignment& expr)
+{
+  tree_expression *lhs = expr.left_hand_side ();
+  tree_expression *rhs = expr.right_hand_side ();
+
+  if (! lhs || ! rhs)
+    {
+      m_ok = false;
+      return;
+    }
+
+  if (lhs->is_identifier ())
+    {
+      std::string nm = lhs->name ();
+
+      octave_value::binary_op op = octave_value::unknown_binary_op;
+      tree_expression *operand = nullptr;
+
+      bool is_reduction = reduction_op (expr, nm, op, operand);
+
+      if (m_collecting)
+        {
+          if (! is_reduction)
+            m_non_reductions.insert (nm);
+          else
+            {
+              auto p = m_reductions.find (nm);
+
+              if (p == m_reductions.end ())
+                m_reductions[nm] = op;
+              else if (p->second != op)
+                m_non_reductions.insert (nm);
+            }
+
+          rhs->accept (*this);
+        }
+      else if (m_reductions.count (nm))
+        operand->accept (*this);
+      else
+        {
+          if (expr.op_type () != octave_value::op_asn_eq)
+            check_read (nm);
+
+          rhs->accept (*this);
+
+          define (nm);
+        }
+
+      return;
+    }
+
+  if (! lhs->is_index_expression ())
+    {
+      m_ok = false;
+      return;
+    }
+
+  tree_index_expression *idx_expr = dynamic_cast<tree_index_expression *> (lhs);
+
+  tree_expression *base = idx_expr->expression ();
+
+  if (! base->is_identifier () || idx_expr->type_tags () != "("
+      || expr.op_type () != octave_value::op_asn_eq)
+    {
+      m_ok = false;
+      return;
+    }
+
+  // Reject deletion of elements.
+  if (rhs->is_matrix () && dynamic_cast<tree_matrix *> (rhs)->empty ())
+    {
+      m_ok = false;
+      return;
+    }
+
+  std::string nm = base->name ();
+
+  tree_argument_list *args = idx_expr->arg_lists ().front ();
+
+  bool sliced_by_loop_var = false;
+
+  if (args)
+    {
+      for (tree_expression *arg : *args)
+        {
+          if (arg && arg->is_identifier () && arg->name () == m_loop_var)
+            sliced_by_loop_var = true;
+        }
+    }
+
+  if (! sliced_by_loop_var)
+    {
+      m_ok = false;
+      return;
+    }
+
+  if (m_collecting)
+    m_sliced.insert (nm);
+  else
+    {
+      // Sliced outputs must be assigned in every iteration.
+      if (m_scopes.size () != 1 || m_loop_depth != 0)
+        {
+          m_ok = false;
+          return;
+        }
+
+      m_in_slice_index = true;
+
+      args->accept (*this);
+
+      m_in_slice_index = false;
+
+      m_sliced_exprs.push_back (idx_expr);
+    }
+
+  rhs->accept (*this);
+}
+
+void
+parfor_analyzer::visit_statement_list (tree_statement_list& lst)
+{
+  m_scopes.push_back (std::set<std::string> ());
+
+  for (tree_statement *elt : lst)
+    {
+      if (! m_ok)
+        break;
+
+      if (elt)
+        elt->accept (*this);
+    }
+
+  m_scopes.pop_back ();
+}
+
+void
+parfor_analyzer::visit_try_catch_command (tree_try_catch_command& cmd)
+{
+  tree_statement_list *try_code = cmd.body ();
+
+  if (try_code)
+    try_code->accept (*this);
+
+  tree_identifier *expr_id = cmd.identifier ();
+
+  if (expr_id)
+    define (expr_id->name ());
+
+  tree_statement_list *catch_code = cmd.cleanup ();
+
+  if (catch_code)
+    catch_code->accept (*this);
+}
+
+void
+parfor_analyzer::visit_while_command (tree_while_command& cmd)
+{
+  m_loop_depth++;
+
+  tree_walker::visit_while_command (cmd);
+
+  m_loop_depth--;
+}
+
+void
+parfor_analyzer::visit_do_until_command (tree_do_until_command& cmd)
+{
+  m_loop_depth++;
+
+  tree_walker::visit_do_until_command (cmd);
+
+  m_loop_depth--;
+}
+
 template <typename T>
 void
 tree_evaluator::execute_range_loop (const range<T>& rng, int line,
@@ -3205,9 +3859,36 @@ tree_evaluator::execute_range_loop (const range<T>& rng, int line,
       if (m_echo_state)
         m_echo_file_pos = line;
 
-      octave_value val (rng.elem (i));
-
-      ult.assign (octave_value::op_asn_eq, val);
+      octave_value val (rng.elem (i));
+
+      ult.assign (octave_value::op_asn_eq, val);
+
+      if (loop_body)
+        loop_body->accept (*this);
+
+      if (quit_loop_now ())
+        break;
+    }
+}
+
+void
+tree_evaluator::execute_range_loop (const colon_range& rng, int line,
+                                    octave_lvalue& ult,
+                                    tree_statement_list *loop_body)
+{
+  octave_idx_type steps = rng.numel ();
+
+  if (rng.is_infinite ())
+    warning_with_id ("Octave:infinite-loop",
+                     "FOR loop limit is infinite, will stop after %"
+                     OCTAVE_IDX_TYPE_FORMAT " steps", steps);
+
+  for (octave_idx_type i = 0; i < steps; i++)
+    {
+      if (m_echo_state)
+        m_echo_file_pos = line;
+
+      ult.assign (octave_value::op_asn_eq, rng.elem (i));
 
       if (loop_body)
         loop_body->accept (*this);
@@ -3217,6 +3898,383 @@ tree_evaluator::execute_range_loop (const range<T>& rng, int line,
     }
 }
 
+// Return the value of the loop variable for iteration I (zero-based)
+// of a for loop over the columns of ARG.
+
+static octave_value
+for_loop_value (octave_value arg, octave_idx_type i)
+{
+  octave_value_list idx;
+
+  // index_op expects one-based indices.
+  if (arg.rows () == 1)
+    idx = ovl (i + 1);
+  else
+    idx = ovl (octave_value::magic_colon_t, i + 1);
+
+  return arg.index_op (idx);
+}
+
+// Forked workers inherit the generator states of the parent.  Append
+// the worker number to each state so that the workers draw different,
+// but reproducible, sequences.
+
+static void
+reseed_parfor_worker (octave_idx_type worker)
+{
+  static const char *dists[]
+    = { "uniform", "normal", "exponential", "poisson", "gamma" };
+
+  for (const char *d : dists)
+    {
+      uint32NDArray s = rand::state (d);
+
+      octave_idx_type n = s.numel ();
+
+      uint32NDArray key (dim_vector (n + 1, 1));
+
+      std::copy_n (s.data (), n, key.fortran_vec ());
+      key(n) = static_cast<uint32_t> (worker + 1);
+
+      rand::state (key, d);
+    }
+}
+
+static octave_value
+read_parfor_value (std::istream& is, const std::string& file)
+{
+  bool global;
+  octave_value val;
+  std::string doc;
+
+  std::string name = read_binary_data (is, false,
+                                       mach_info::native_float_format (),
+                                       file, global, val, doc);
+
+  if (name.empty () || ! is)
+    error ("parfor: unable to read results from worker process");
+
+  return val;
+}
+
+bool
+tree_evaluator::execute_parfor_loop (tree_simple_for_command& cmd,
+                                     const octave_value& rhs,
+                                     octave_lvalue& ult)
+{
+  tree_expression *maxproc_expr = cmd.maxproc_expr ();
+
+  // Without an explicit number of workers, a parfor loop behaves
+  // exactly like a for loop.
+
+  if (! maxproc_expr)
+    return false;
+
+  octave_value maxproc_val = maxproc_expr->evaluate (*this);
+
+  double maxproc
+    = maxproc_val.xdouble_value ("parfor: MAXPROC must be a numeric scalar");
+
+  if (math::isnan (maxproc) || maxproc < 0)
+    error ("parfor: MAXPROC must be a non-negative number");
+
+  if (m_in_parfor_worker || m_debug_mode || m_echo_state
+      || m_profiler.enabled () || application::is_gui_running ()
+      || ! octave_have_fork ())
+    return false;
+
+  if (! (rhs.is_range () || rhs.is_matrix_type ()))
+    return false;
+
+  const dim_vector& dv = rhs.dims ().redim (2);
+
+  octave_idx_type steps = dv(1);
+
+  octave_idx_type nworkers;
+
+  if (math::isinf (maxproc))
+    nworkers = octave_num_processors_wrapper (OCTAVE_NPROC_CURRENT_OVERRIDABLE);
+  else
+    nworkers = static_cast<octave_idx_type> (maxproc);
+
+  nworkers = std::min (nworkers, steps);
+
+  if (nworkers < 2)
+    return false;
+
+  tree_expression *lhs = cmd.left_hand_side ();
+
+  tree_statement_list *loop_body = cmd.body ();
+
+  if (! lhs->is_identifier () || ! loop_body)
+    return false;
+
+  parfor_analyzer analyzer (lhs->name ());
+
+  if (! analyzer.analyze (*loop_body))
+    return false;
+
+  const std::list<tree_index_expression *>& sliced
+    = analyzer.sliced_outputs ();
+
+  const std::map<std::string, octave_value::binary_op>& reductions
+    = analyzer.reductions ();
+
+  octave_value arg = rhs;
+  if (rhs.ndims () > 2)
+    arg = arg.reshape (dv);
+
+  // Iterations are split into contiguous blocks, one per worker.
+  std::vector<octave_idx_type> first (nworkers + 1);
+  for (octave_idx_type w = 0; w <= nworkers; w++)
+    first[w] = (steps * w) / nworkers;
+
+  std::vector<pid_t> pids (nworkers, -1);
+  std::vector<std::string> files (nworkers);
+
+  unwind_action cleanup ([&pids, &files] ()
+                         {
+                           for (std::size_t w = 0; w < pids.size (); w++)
+                             {
+                               if (pids[w] > 0)
+                                 {
+                                   int status;
+                                   sys::waitpid (pids[w], &status, 0);
+                                 }
+
+                               if (! files[w].empty ())
+                                 sys::unlink (files[w]);
+                             }
+                         });
+
+  // Don't let the workers repeat output that is still buffered.
+  flush_stdout ();
+
+  for (octave_idx_type w = 0; w < nworkers; w++)
+    {
+      files[w] = sys::tempnam ("", "oct-parfor-");
+
+      std::string msg;
+
+      pid_t pid = sys::fork (msg);
+
+      if (pid < 0)
+        error ("parfor: unable to start worker process: %s", msg.c_str ());
+
+      if (pid == 0)
+        run_parfor_worker (files[w], w, first[w], first[w+1], arg, ult,
+                           loop_body, sliced, reductions);
+
+      pids[w] = pid;
+    }
+
+  std::vector<int> status (nworkers, 0);
+
+  for (octave_idx_type w = 0; w < nworkers; w++)
+    {
+      pid_t pid;
+
+      do
+        pid = sys::waitpid (pids[w], &status[w], 0);
+      while (pid < 0 && errno == EINTR);
+
+      pids[w] = -1;
+    }
+
+  octave_quit ();
+
+  // Report the error from the first worker that failed.
+
+  for (octave_idx_type w = 0; w < nworkers; w++)
+    {
+      if (sys::wifexited (status[w]) && sys::wexitstatus (status[w]) == 0)
+        continue;
+
+      if (sys::wifexited (status[w]) && sys::wexitstatus (status[w]) == 1)
+        {
+          std::ifstream is = sys::ifstream (files[w], std::ios::in
+                                            | std::ios::binary);
+
+          std::string id = read_parfor_value (is, files[w]).string_value ();
+          std::string msg = read_parfor_value (is, files[w]).string_value ();
+
+          if (id.empty ())
+            error ("%s", msg.c_str ());
+          else
+            error_with_id (id.c_str (), "%s", msg.c_str ());
+        }
+
+      error ("parfor: worker process %" OCTAVE_IDX_TYPE_FORMAT
+             " terminated abnormally", w + 1);
+    }
+
+  // Collect the results in iteration order so that the final state is
+  // the same as if the loop had been executed serially.
+
+  for (octave_idx_type w = 0; w < nworkers; w++)
+    {
+      std::ifstream is = sys::ifstream (files[w], std::ios::in
+                                        | std::ios::binary);
+
+      for (octave_idx_type i = first[w]; i < first[w+1]; i++)
+        {
+          ult.assign (octave_value::op_asn_eq, for_loop_value (arg, i));
+
+          for (tree_index_expression *expr : sliced)
+            {
+              octave_value val = read_parfor_value (is, files[w]);
+
+              octave_lvalue slice_ref = expr->lvalue (*this);
+
+              slice_ref.assign (octave_value::op_asn_eq, val);
+            }
+        }
+
+      for (const auto& nm_op : reductions)
+        {
+          const std::string& nm = nm_op.first;
+
+          octave_value val = read_parfor_value (is, files[w]);
+
+          if (w == 0)
+            assign (nm, val);
+          else
+            assign (nm, binary_op (nm_op.second, varval (nm), val));
+        }
+    }
+
+  return true;
+}
+
+void
+tree_evaluator::run_parfor_worker (const std::string& file,
+                                   octave_idx_type worker,
+                                   octave_idx_type first,
+                                   octave_idx_type last,
+                                   const octave_value& arg,
+                                   octave_lvalue& ult,
+                                   tree_statement_list *loop_body,
+                                   const std::list<tree_index_expression *>& sliced,
+                                   const std::map<std::string, octave_value::binary_op>& reductions)
+{
+  int exit_status = 0;
+
+  m_in_parfor_worker = true;
+
+  try
+    {
+      reseed_parfor_worker (worker);
+
+      // Only the first worker starts from the current value of a
+      // reduction variable.  The others start from the identity and
+      // their partial results are combined by the parent.
+
+      if (worker > 0)
+        {
+          for (const auto& nm_op : reductions)
+            assign (nm_op.first, octave_value (nm_op.second == octave_value::op_add
+                                               ? 0.0 : 1.0));
+        }
+
+      for (octave_idx_type i = first; i < last; i++)
+        {
+          ult.assign (octave_value::op_asn_eq, for_loop_value (arg, i));
+
+          loop_body->accept (*this);
+
+          // Maybe reset continue state.
+          quit_loop_now ();
+        }
+
+      std::ofstream os = sys::ofstream (file, std::ios::out
+                                        | std::ios::binary);
+
+      for (octave_idx_type i = first; i < last; i++)
+        {
+          ult.assign (octave_value::op_asn_eq, for_loop_value (arg, i));
+
+          for (tree_index_expression *expr : sliced)
+            {
+              if (! save_binary_data (os, expr->evaluate (*this), "slice",
+                                      "", false, false))
+                error ("parfor: unable to return value of '%s' from worker",
+                       expr->name ().c_str ());
+            }
+        }
+
+      for (const auto& nm_op : reductions)
+        {
+          const std::string& nm = nm_op.first;
+
+          if (! save_binary_data (os, varval (nm), nm, "", false, false))
+            error ("parfor: unable to return value of '%s' from worker",
+                   nm.c_str ());
+        }
+
+      os.close ();
+
+      if (! os)
+        error ("parfor: unable to write results of worker process");
+    }
+  catch (const execution_exception& ee)
+    {
+      std::ofstream os = sys::ofstream (file, std::ios::out
+                                        | std::ios::binary);
+
+      save_binary_data (os, ee.identifier (), "identifier", "", false, false);
+      save_binary_data (os, ee.message (), "message", "", false, false);
+
+      exit_status = 1;
+    }
+  catch (...)
+    {
+      exit_status = 2;
+    }
+
+  flush_stdout ();
+
+  // Skip all exit handlers and destructors.  They belong to the parent
+  // process.
+  std::_Exit (exit_status);
+}
+
+octave_value
+tree_evaluator::evaluate_for_loop_expression (tree_simple_for_command& cmd,
+                                              std::unique_ptr<colon_range>& rng)
+{
+  tree_expression *expr = cmd.control_expr ();
+
+  // The values of a parfor loop are sent to worker processes, so they
+  // must be computed in any case.
+
+  if (! expr->is_colon_expression () || cmd.in_parallel ())
+    return expr->evaluate (*this);
+
+  tree_colon_expression *colon_expr
+    = dynamic_cast<tree_colon_expression *> (expr);
+
+  octave_value base;
+  octave_value increment;
+  octave_value limit;
+
+  if (! colon_expr->evaluate_operands (*this, base, increment, limit))
+    return octave_value ();
+
+  rng = make_colon_range (base, increment, limit);
+
+  if (rng)
+    return octave_value ();
+
+  return colon_op (base, increment, limit, colon_expr->is_for_cmd_expr ());
+}
+
+bool
+tree_evaluator::for_loop_extracts_elements (const octave_value& arg)
+{
+  return (arg.rows () == 1 && ! arg.issparse ()
+          && (arg.isnumeric () || arg.islogical ()));
+}
+
 void
 tree_evaluator::visit_simple_for_command (tree_simple_for_command& cmd)
 {
@@ -3233,24 +4291,30 @@ tree_evaluator::visit_simple_for_command (tree_simple_for_command& cmd)
   if (m_debug_mode)
     do_breakpoint (cmd.is_active_breakpoint (*this));
 
-  // FIXME: need to handle PARFOR loops here using cmd.in_parallel ()
-  // and cmd.maxproc_expr ();
-
   unwind_protect_var<bool> upv (m_in_loop_command, true);
 
-  tree_expression *expr = cmd.control_expr ();
+  std::unique_ptr<colon_range> rng;
 
-  octave_value rhs = expr->evaluate (*this);
+  octave_value rhs = evaluate_for_loop_expression (cmd, rng);
 
-  if (rhs.is_undefined ())
+  if (! rng && rhs.is_undefined ())
     return;
 
   tree_expression *lhs = cmd.left_hand_side ();
 
   octave_lvalue ult = lhs->lvalue (*this);
 
+  if (cmd.in_parallel () && execute_parfor_loop (cmd, rhs, ult))
+    return;
+
   tree_statement_list *loop_body = cmd.body ();
 
+  if (rng)
+    {
+      execute_range_loop (*rng, line, ult, loop_body);
+      return;
+    }
+
   if (rhs.is_range ())
     {
       // FIXME: is there a better way to dispatch here?
@@ -3316,14 +4380,26 @@ tree_evaluator::visit_simple_for_command (tree_simple_for_command& cmd)
               iidx = 1;
             }
 
+          // Columns of full arrays are shallow slices, but the elements
+          // of numeric row vectors can be extracted even more cheaply.
+          bool extract_elem = for_loop_extracts_elements (arg);
+
           for (octave_idx_type i = 1; i <= steps; i++)
             {
               if (m_echo_state)
                 m_echo_file_pos = line;
 
-              // index_op expects one-based indices.
-              idx(iidx) = i;
-              octave_value val = arg.index_op (idx);
+              octave_value val;
+
+              if (extract_elem)
+                val = arg.fast_elem_extract (i-1);
+
+              if (val.is_undefined ())
+                {
+                  // index_op expects one-based indices.
+                  idx(iidx) = i;
+                  val = arg.index_op (idx);
+                }
 
               ult.assign (octave_value::op_asn_eq, val);
 
@@ -3795,7 +4871,14 @@ tree_evaluator::execute_user_function (octave_user_function& user_function,
             }
         }
       else
-        cmd_list->accept (*this);
+        {
+          std::shared_ptr<bytecode> code = function_bytecode (user_function);
+
+          if (code)
+            code->execute (*this);
+          else
+            cmd_list->accept (*this);
+        }
 
       if (m_returning)
         m_returning = 0;
@@ -3824,6 +4907,39 @@ tree_evaluator::execute_user_function (octave_user_function& user_function,
   return retval;
 }
 
+// Return the compiled body of USER_FUNCTION, compiling it on first
+// use, or nullptr if the function must be evaluated by walking the
+// parse tree.  Debugging, echoing, and profiling all rely on the tree
+// evaluator visiting each statement.
+
+std::shared_ptr<bytecode>
+tree_evaluator::function_bytecode (octave_user_function& user_function)
+{
+  if (! m_vm_enabled || m_debug_mode || m_echo_state
+      || m_profiler.enabled ())
+    return std::shared_ptr<bytecode> ();
+
+  // Entering the debugger on errors also requires statement level
+  // bookkeeping.
+
+  error_system& es = m_interpreter.get_error_system ();
+
+  if ((m_interpreter.interactive () || application::forced_interactive ())
+      && (es.debug_on_error () || es.debug_on_caught ()))
+    return std::shared_ptr<bytecode> ();
+
+  std::shared_ptr<bytecode> code = user_function.bytecode ();
+
+  if (! code && ! user_function.bytecode_unsupported ())
+    {
+      code = bytecode::compile (user_function);
+
+      user_function.bytecode (code);
+    }
+
+  return code;
+}
+
 void
 tree_evaluator::visit_octave_user_function (octave_user_function&)
 {
@@ -4779,6 +5895,8 @@ tree_evaluator::add_autoload (const std::string& fcn,
                               const std::string& nm)
 {
   m_autoload_map[fcn] = check_autoload_file (nm);
+
+  fcn_lookup_cache::new_generation ();
 }
 
 void
@@ -4809,6 +5927,21 @@ tree_evaluator::silent_functions (const octave_value_list& args, int nargout)
                                 "silent_functions");
 }
 
+octave_value
+tree_evaluator::vm_enabled (const octave_value_list& args, int nargout)
+{
+  return set_internal_variable (m_vm_enabled, args, nargout,
+                                "__vm_enable__");
+}
+
+octave_value
+tree_evaluator::fuse_elementwise_ops (const octave_value_list& args,
+                                      int nargout)
+{
+  return set_internal_variable (m_fuse_elementwise_ops, args, nargout,
+                                "__fuse_elementwise_ops__");
+}
+
 octave_value
 tree_evaluator::string_fill_char (const octave_value_list& args, int nargout)
 {
@@ -5263,6 +6396,14 @@ tree_evaluator::PS4 (const octave_value_list& args, int nargout)
   return set_internal_variable (m_PS4, args, nargout, "PS4");
 }
 
+octave_value
+tree_evaluator::parse_tree_cache_dir (const octave_value_list& args,
+                                      int nargout)
+{
+  return set_internal_variable (m_parse_tree_cache_dir, args, nargout,
+                                "parse_tree_cache_dir");
+}
+
 bool
 tree_evaluator::echo_this_file (const std::string& file, int type) const
 {
@@ -5543,6 +6684,128 @@ The original variable value is restored when exiting the function.
 %!error silent_functions (1, 2)
 */
 
+DEFMETHOD (__vm_enable__, interp, args, nargout,
+           doc: /* -*- texinfo -*-
+@deftypefn  {} {@var{val} =} __vm_enable__ ()
+@deftypefnx {} {@var{old_val} =} __vm_enable__ (@var{new_val})
+@deftypefnx {} {@var{old_val} =} __vm_enable__ (@var{new_val}, "local")
+Query or set the internal variable that controls whether user functions
+are executed by the bytecode interpreter.
+
+When enabled, the body of each user function is compiled on its first call
+and the compiled form is cached with the function.  Loops, conditionals,
+assignments to local variables, and scalar arithmetic run in a register
+based virtual machine; all other statements and expressions are evaluated
+by the tree evaluator.  Functions that can not be compiled, and all
+functions while debugging, echoing, or profiling, are evaluated by the
+tree evaluator as usual.  The default is false.
+
+When called from inside a function with the @qcode{"local"} option, the
+variable is changed locally for the function and any subroutines it calls.
+The original variable value is restored when exiting the function.
+
+Undocumented internal function.
+@seealso{__vm_compile__}
+@end deftypefn */)
+{
+  tree_evaluator& tw = interp.get_evaluator ();
+
+  return tw.vm_enabled (args, nargout);
+}
+
+/*
+%!test
+%! orig_val = __vm_enable__ ();
+%! old_val = __vm_enable__ (! orig_val);
+%! assert (orig_val, old_val);
+%! assert (__vm_enable__ (), ! orig_val);
+%! __vm_enable__ (orig_val);
+%! assert (__vm_enable__ (), orig_val);
+
+%!error __vm_enable__ (1, 2)
+*/
+
+DEFMETHOD (__fuse_elementwise_ops__, interp, args, nargout,
+           doc: /* -*- texinfo -*-
+@deftypefn  {} {@var{val} =} __fuse_elementwise_ops__ ()
+@deftypefnx {} {@var{old_val} =} __fuse_elementwise_ops__ (@var{new_val})
+@deftypefnx {} {@var{old_val} =} __fuse_elementwise_ops__ (@var{new_val}, "local")
+Query or set the internal variable that controls whether chains of
+element-wise operations are evaluated in a single pass.
+
+When enabled, an expression such as @code{a.*b + c.*d - e} whose operands
+are variables and constants is evaluated block by block if all operands are
+full real double arrays and scalars, or all are single.  No intermediate
+arrays of the full size are created, and the result is identical to the
+result of applying the operators one at a time.  Expressions with other
+operand types, and all expressions while profiling, are evaluated as usual.
+The default is true.
+
+When called from inside a function with the @qcode{"local"} option, the
+variable is changed locally for the function and any subroutines it calls.
+The original variable value is restored when exiting the function.
+
+Undocumented internal function.
+@end deftypefn */)
+{
+  tree_evaluator& tw = interp.get_evaluator ();
+
+  return tw.fuse_elementwise_ops (args, nargout);
+}
+
+/*
+%!test
+%! orig_val = __fuse_elementwise_ops__ ();
+%! old_val = __fuse_elementwise_ops__ (! orig_val);
+%! assert (orig_val, old_val);
+%! assert (__fuse_elementwise_ops__ (), ! orig_val);
+%! __fuse_elementwise_ops__ (orig_val);
+%! assert (__fuse_elementwise_ops__ (), orig_val);
+
+%!error __fuse_elementwise_ops__ (1, 2)
+
+%!function r = fused_ops (a, b, c, d, e)
+%!  r = {a.*b + c.*d - e, 2*a + b, a/2 - b.*c, (a - b) ./ (c + 1), ...
+%!       a*3 - b/c(1) + 0.5};
+%!endfunction
+
+%!function check_fused_ops (varargin)
+%!  orig_val = __fuse_elementwise_ops__ (false);
+%!  unwind_protect
+%!    expected = fused_ops (varargin{:});
+%!  unwind_protect_cleanup
+%!    __fuse_elementwise_ops__ (orig_val);
+%!  end_unwind_protect
+%!  result = fused_ops (varargin{:});
+%!  for i = 1:numel (result)
+%!    assert (class (result{i}), class (expected{i}));
+%!    assert (result{i}, expected{i}, 0);
+%!  endfor
+%!endfunction
+
+%!test
+%! x = rand (1, 5000) - 0.5;
+%! check_fused_ops (x, rand (1, 5000), x.^2, 3, rand (1, 5000) + 1);
+%! check_fused_ops (single (x), single (2), single (x+1), single (x), ...
+%!                  single (7));
+%! check_fused_ops ([], [], 1, [], []);
+%! check_fused_ops ([1, NaN, Inf], [-Inf, 0, 1], [0, 0, 0], [1, 2, 3], NaN);
+
+## Operands that are not fused
+%!test
+%! check_fused_ops (int8 (1:10), int8 (3), int8 (4), int8 (10:-1:1), int8 (2));
+%! check_fused_ops (single (1:3), 2, 3, [4, 5, 6], 1);
+%! check_fused_ops ((1:3)', 1:3, 2, 3, [1; 2; 3]);
+%! check_fused_ops (1+2i, [1, 2], 3, 4, 5);
+
+%!error <operator \+: nonconformant arguments>
+%! a = ones (2, 3);  b = ones (3, 2);
+%! c = a .* 2 + b;
+%!error <nonconformant arguments>
+%! a = ones (2, 3);  b = ones (2, 3);
+%! c = a * b + 1;
+*/
+
 DEFMETHOD (string_fill_char, interp, args, nargout,
            doc: /* -*- texinfo -*-
 @deftypefn  {} {@var{val} =} string_fill_char ()
@@ -30,6 +30,7 @@
 
 #include <iosfwd>
 #include <list>
+#include <map>
 #include <memory>
 #include <set>
 #include <stack>
@@ -37,6 +38,7 @@
 
 #include "bp-table.h"
 #include "call-stack.h"
+#include "oct-env.h"
 #include "oct-lvalue.h"
 #include "ov.h"
 #include "ovl.h"
@@ -52,10 +54,12 @@ class octave_user_script;
 
 OCTAVE_BEGIN_NAMESPACE(octave)
 
+class bytecode;
 class symbol_info_list;
 class symbol_scope;
 class tree_decl_elt;
 class tree_expression;
+class tree_index_expression;
 
 class debugger;
 class interpreter;
@@ -132,12 +136,16 @@ public:
       m_debug_mode (false), m_quiet_breakpoint_flag (false),
       m_debugger_stack (), m_exit_status (0), m_max_recursion_depth (256),
       m_whos_line_format ("  %la:5; %ln:6; %cs:16:6:1;  %rb:12;  %lc:-1;\n"),
-      m_silent_functions (false), m_string_fill_char (' '), m_PS4 ("+ "),
+      m_silent_functions (false), m_vm_enabled (false),
+      m_fuse_elementwise_ops (true),
+      m_string_fill_char (' '), m_PS4 ("+ "),
+      m_parse_tree_cache_dir (sys::env::getenv ("OCTAVE_PARSE_TREE_CACHE_DIR")),
       m_dbstep_flag (0), m_break_on_next_stmt (false), m_echo (ECHO_OFF),
       m_echo_state (false), m_echo_file_name (),
       m_echo_file_pos (1),
       m_echo_files (), m_in_top_level_repl (false),
       m_server_mode (false), m_in_loop_command (false),
+      m_in_parfor_worker (false),
       m_breaking (0), m_continuing (0), m_returning (0),
       m_indexed_object (), m_index_list (), m_index_type (),
       m_index_position (0), m_num_indices (0)
@@ -628,6 +636,30 @@ public:
   octave_value
   silent_functions (const octave_value_list& args, int nargout);
 
+  bool vm_enabled () const { return m_vm_enabled; }
+
+  bool vm_enabled (bool b)
+  {
+    bool val = m_vm_enabled;
+    m_vm_enabled = b;
+    return val;
+  }
+
+  octave_value
+  vm_enabled (const octave_value_list& args, int nargout);
+
+  bool fuse_elementwise_ops () const { return m_fuse_elementwise_ops; }
+
+  bool fuse_elementwise_ops (bool b)
+  {
+    bool val = m_fuse_elementwise_ops;
+    m_fuse_elementwise_ops = b;
+    return val;
+  }
+
+  octave_value
+  fuse_elementwise_ops (const octave_value_list& args, int nargout);
+
   std::size_t debug_frame () const { return m_debug_frame; }
 
   std::size_t debug_frame (std::size_t n)
@@ -714,6 +746,18 @@ public:
 
   void set_PS4 (const std::string& s) { m_PS4 = s; }
 
+  octave_value parse_tree_cache_dir (const octave_value_list& args,
+                                     int nargout);
+
+  std::string parse_tree_cache_dir () const { return m_parse_tree_cache_dir; }
+
+  std::string parse_tree_cache_dir (const std::string& dir)
+  {
+    std::string val = m_parse_tree_cache_dir;
+    m_parse_tree_cache_dir = dir;
+    return val;
+  }
+
   octave_value indexed_object () const
   {
     return m_indexed_object;
@@ -787,6 +831,26 @@ public:
     return val;
   }
 
+  bool in_loop_command () const { return m_in_loop_command; }
+
+  bool in_loop_command (bool b)
+  {
+    bool val = m_in_loop_command;
+    m_in_loop_command = b;
+    return val;
+  }
+
+  // Evaluate the control expression of a FOR loop.  The elements of
+  // integer and single precision colon expressions are returned in RNG
+  // instead of being stored in an array.
+  octave_value
+  evaluate_for_loop_expression (tree_simple_for_command& cmd,
+                                std::unique_ptr<colon_range>& rng);
+
+  // TRUE if the loop values for ARG may be obtained with
+  // fast_elem_extract instead of index_op.
+  static bool for_loop_extracts_elements (const octave_value& arg);
+
   int returning () const { return m_returning; }
 
   int returning (int n)
@@ -867,6 +931,24 @@ private:
                            octave_lvalue& ult,
                            tree_statement_list *loop_body);
 
+  void execute_range_loop (const colon_range& rng, int line,
+                           octave_lvalue& ult,
+                           tree_statement_list *loop_body);
+
+  std::shared_ptr<bytecode>
+  function_bytecode (octave_user_function& user_function);
+
+  bool execute_parfor_loop (tree_simple_for_command& cmd,
+                            const octave_value& rhs, octave_lvalue& ult);
+
+  OCTAVE_NORETURN void
+  run_parfor_worker (const std::string& file, octave_idx_type worker,
+                     octave_idx_type first, octave_idx_type last,
+                     const octave_value& arg, octave_lvalue& ult,
+                     tree_statement_list *loop_body,
+                     const std::list<tree_index_expression *>& sliced,
+                     const std::map<std::string, octave_value::binary_op>& reductions);
+
   void set_echo_state (int type, const std::string& file_name, int pos);
 
   void maybe_set_echo_state ();
@@ -945,12 +1027,24 @@ private:
   // semicolon has been appended to each statement).
   bool m_silent_functions;
 
+  // If TRUE, execute user functions with the bytecode interpreter
+  // whenever possible.
+  bool m_vm_enabled;
+
+  // If TRUE, evaluate chains of element-wise operations on arrays in a
+  // single pass, without intermediate arrays.
+  bool m_fuse_elementwise_ops;
+
   // The character to fill with when creating string arrays.
   char m_string_fill_char;
 
   // String printed before echoed commands (enabled by --echo-commands).
   std::string m_PS4;
 
+  // Directory for the persistent cache of function file parse trees.
+  // If empty, function files are always parsed.
+  std::string m_parse_tree_cache_dir;
+
   // If > 0, stop executing at the (N-1)th stopping point, counting
   //         from the the current execution point in the current frame.
   //
@@ -996,6 +1090,9 @@ private:
   // TRUE means we are evaluating some kind of looping construct.
   bool m_in_loop_command;
 
+  // TRUE means we are a forked process executing part of a parfor loop.
+  bool m_in_parfor_worker;
+
   // Nonzero means we're breaking out of a loop or function body.
   int m_breaking;
 
@@ -96,13 +96,7 @@ tree_identifier::evaluate_n (tree_evaluator& tw, int nargout)
   octave_value val = tw.varval (m_sym);
 
   if (val.is_undefined ())
-    {
-      interpreter& interp = tw.get_interpreter ();
-
-      symbol_table& symtab = interp.get_symbol_table ();
-
-      val = symtab.find_function (m_sym.name ());
-    }
+    val = m_fcn_cache.find (m_sym.name ());
 
   if (val.is_defined ())
     {
@@ -36,6 +36,7 @@ class octave_value_list;
 class octave_function;
 
 #include "comment-list.h"
+#include "fcn-info.h"
 #include "oct-lvalue.h"
 #include "pt-bp.h"
 #include "pt-exp.h"
@@ -135,6 +136,9 @@ protected:
 
   // The IDENT token from the lexer.
   token m_token;
+
+  // The function last called by this identifier.
+  fcn_lookup_cache m_fcn_cache;
 };
 
 class tree_black_hole : public tree_identifier
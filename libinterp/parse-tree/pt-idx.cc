@@ -27,6 +27,8 @@
 #  include "config.h"
 #endif
 
+#include <set>
+
 #include "Cell.h"
 #include "error.h"
 #include "interpreter-private.h"
@@ -38,6 +40,8 @@
 #include "pt-eval.h"
 #include "pt-id.h"
 #include "pt-idx.h"
+#include "stack-frame.h"
+#include "unwind-prot.h"
 #include "utils.h"
 #include "variables.h"
 #include "errwarn.h"
@@ -384,6 +388,84 @@ tree_index_expression::dup (symbol_scope& scope) const
 //    In the last two steps, the partial value computed in the
 //    previous step is used to determine the value of END.
 
+// True if FCN is a built-in function such as sin or exp that applies a
+// mapper function to its only argument and does nothing else with it.
+
+static bool
+is_builtin_mapper (octave_function *fcn)
+{
+  static const std::set<std::string> names = [] ()
+  {
+    std::set<std::string> retval;
+
+    for (int i = 0; i < octave_base_value::num_unary_mappers; i++)
+      retval.insert (octave_base_value::get_umap_name
+                     (static_cast<octave_base_value::unary_mapper_t> (i)));
+
+    return retval;
+  } ();
+
+  return fcn->is_builtin_function () && names.count (fcn->name ()) > 0;
+}
+
+// The mapper function may store its result in the data of the only
+// element of ARGS if nothing else refers to it.  That is the case for
+// a temporary value such as the argument of sin (x + 1).  In an
+// assignment y = sin (y), the old value of y is not needed after the
+// call, so the variable releases it while the function is called and
+// gets it back only if the call fails.  That is not done if further
+// indices follow the call, as in y = sin (y)(k), because indexing the
+// result may still fail and y must then keep its value.
+
+octave_value_list
+tree_index_expression::call_builtin_mapper (tree_evaluator& tw,
+                                            octave_function *fcn,
+                                            int nargout,
+                                            const octave_value_list& args)
+{
+  std::shared_ptr<stack_frame> frame;
+
+  if (m_assigned_var && m_args.size () == 1 && args(0).get_count () == 2)
+    {
+      tree_expression *arg = m_args.front ()->front ();
+
+      if (arg->is_identifier () && arg->name () == m_assigned_var->name ())
+        {
+          frame = tw.get_current_stack_frame ();
+
+          octave_value& val = frame->varref (m_assigned_var->symbol ());
+
+          if (&val.get_rep () == &args(0).get_rep ())
+            val = octave_value ();
+          else
+            frame = nullptr;
+        }
+    }
+
+  try
+    {
+      reusable_argument reuse (args(0));
+
+      return fcn->call (tw, nargout, args);
+    }
+  catch (...)
+    {
+      if (frame)
+        frame->varref (m_assigned_var->symbol ()) = args(0);
+
+      throw;
+    }
+}
+
+octave_value
+tree_index_expression::evaluate_assignment_rhs (tree_evaluator& tw,
+                                                tree_identifier *lhs)
+{
+  unwind_protect_var<tree_identifier *> upv (m_assigned_var, lhs);
+
+  return evaluate (tw);
+}
+
 octave_value_list
 tree_index_expression::evaluate_n (tree_evaluator& tw, int nargout)
 {
@@ -452,11 +534,7 @@ tree_index_expression::evaluate_n (tree_evaluator& tw, int nargout)
               first_args.stash_name_tags (anm);
             }
 
-          interpreter& interp = tw.get_interpreter ();
-
-          symbol_table& symtab = interp.get_symbol_table ();
-
-          octave_value val = symtab.find_function (nm, first_args);
+          octave_value val = m_fcn_cache.find (nm, first_args);
 
           octave_function *fcn = nullptr;
 
@@ -467,7 +545,11 @@ tree_index_expression::evaluate_n (tree_evaluator& tw, int nargout)
             {
               try
                 {
-                  retval = fcn->call (tw, nargout, first_args);
+                  if (first_args.length () == 1 && is_builtin_mapper (fcn))
+                    retval = call_builtin_mapper (tw, fcn, nargout,
+                                                  first_args);
+                  else
+                    retval = fcn->call (tw, nargout, first_args);
                 }
               catch (index_exception& ie)
                 {
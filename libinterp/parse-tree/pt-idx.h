@@ -30,12 +30,14 @@
 
 #include <list>
 
+class octave_function;
 class octave_map;
 class octave_value;
 class octave_value_list;
 
 #include "str-vec.h"
 
+#include "fcn-info.h"
 #include "pt-exp.h"
 #include "pt-walk.h"
 
@@ -45,6 +47,7 @@ class octave_lvalue;
 class symbol_scope;
 class tree_argument_list;
 class tree_evaluator;
+class tree_identifier;
 
 // Index expressions.
 
@@ -109,6 +112,11 @@ public:
 
   octave_value_list evaluate_n (tree_evaluator& tw, int nargout = 1);
 
+  // Evaluate this expression as the right hand side of an assignment
+  // to the variable LHS.
+  octave_value evaluate_assignment_rhs (tree_evaluator& tw,
+                                        tree_identifier *lhs);
+
   void accept (tree_walker& tw)
   {
     tw.visit_index_expression (*this);
@@ -146,9 +154,20 @@ private:
   // TRUE if this expression was parsed as a word list command.
   bool m_word_list_cmd {false};
 
+  // The function last called by this expression.
+  fcn_lookup_cache m_fcn_cache;
+
+  // The variable that is assigned the value of this expression while
+  // it is evaluated by evaluate_assignment_rhs.
+  tree_identifier *m_assigned_var {nullptr};
+
   tree_index_expression () = default;
 
   octave_map make_arg_struct () const;
+
+  octave_value_list
+  call_builtin_mapper (tree_evaluator& tw, octave_function *fcn,
+                       int nargout, const octave_value_list& args);
 };
 
 OCTAVE_END_NAMESPACE(octave)
@@ -0,0 +1,316 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#include <cstdint>
+#include <cstring>
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Array-alloc.h"
+#include "Array-stats.h"
+#include "mman-wrappers.h"
+#include "oct-parallel.h"
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+// Mapped blocks are multiples of the size of a huge page on x86 and
+// ARM processors.
+static const std::size_t huge_page_size = 2 << 20;
+
+static std::atomic<std::size_t> s_threshold (2 * huge_page_size);
+
+// The size of the smallest block that has been mapped.  Blocks of
+// smaller arrays always come from the heap, so free_large_array can
+// return without a lookup.
+static std::atomic<std::size_t>
+s_min_mapped (std::numeric_limits<std::size_t>::max ());
+
+class large_block_pool
+{
+public:
+
+  large_block_pool ()
+    : m_live (), m_free (), m_free_bytes (0), m_max_free_bytes (256 << 20)
+  { }
+
+  OCTAVE_DISABLE_COPY_MOVE (large_block_pool)
+
+  ~large_block_pool () = default;
+
+  // Like the thread pool, the pool is never destroyed, because arrays
+  // may still be freed while static objects are destroyed.
+
+  static large_block_pool& instance ()
+  {
+    static large_block_pool *s_instance = new large_block_pool ();
+
+    return *s_instance;
+  }
+
+  void * allocate (std::size_t bytes)
+  {
+    std::size_t len = (bytes + huge_page_size - 1) / huge_page_size
+                      * huge_page_size;
+
+    void *p = take_free_block (len);
+
+    if (p)
+      {
+        count_array_pool_reuse ();
+
+        // The block still holds the elements of a freed array.
+        zero (p, bytes);
+      }
+    else
+      {
+        p = map (len);
+
+        if (! p)
+          return nullptr;
+      }
+
+    std::size_t min_mapped = s_min_mapped.load ();
+    while (bytes < min_mapped
+           && ! s_min_mapped.compare_exchange_weak (min_mapped, bytes))
+      ;
+
+    std::lock_guard<std::mutex> lock (m_mutex);
+
+    m_live[p] = len;
+
+    return p;
+  }
+
+  bool free (void *p)
+  {
+    std::vector<std::pair<void *, std::size_t>> unmap_blocks;
+
+    {
+      std::lock_guard<std::mutex> lock (m_mutex);
+
+      auto it = m_live.find (p);
+
+      if (it == m_live.end ())
+        return false;
+
+      std::size_t len = it->second;
+      m_live.erase (it);
+
+      if (len > m_max_free_bytes)
+        unmap_blocks.emplace_back (p, len);
+      else
+        {
+          m_free.emplace_back (p, len);
+          m_free_bytes += len;
+
+          trim (unmap_blocks);
+        }
+    }
+
+    unmap (unmap_blocks);
+
+    return true;
+  }
+
+  std::size_t max_free_bytes ()
+  {
+    std::lock_guard<std::mutex> lock (m_mutex);
+
+    return m_max_free_bytes;
+  }
+
+  std::size_t set_max_free_bytes (std::size_t bytes)
+  {
+    std::vector<std::pair<void *, std::size_t>> unmap_blocks;
+    std::size_t old_bytes;
+
+    {
+      std::lock_guard<std::mutex> lock (m_mutex);
+
+      old_bytes = m_max_free_bytes;
+      m_max_free_bytes = bytes;
+
+      trim (unmap_blocks);
+    }
+
+    unmap (unmap_blocks);
+
+    return old_bytes;
+  }
+
+private:
+
+  void * take_free_block (std::size_t len)
+  {
+    std::lock_guard<std::mutex> lock (m_mutex);
+
+    // Prefer the most recently freed block, whose pages are more
+    // likely to still be in the caches.
+    for (auto it = m_free.rbegin (); it != m_free.rend (); it++)
+      {
+        if (it->second == len)
+          {
+            void *p = it->first;
+            m_free.erase (std::next (it).base ());
+            m_free_bytes -= len;
+            return p;
+          }
+      }
+
+    return nullptr;
+  }
+
+  // Release the oldest free blocks until the pool is small enough.
+  // Must be called with the mutex locked.
+  void trim (std::vector<std::pair<void *, std::size_t>>& unmap_blocks)
+  {
+    while (m_free_bytes > m_max_free_bytes)
+      {
+        unmap_blocks.push_back (m_free.front ());
+        m_free_bytes -= m_free.front ().second;
+        m_free.pop_front ();
+      }
+  }
+
+  static void * map (std::size_t len)
+  {
+    // Map an extra huge page so that the block can be aligned to one.
+    void *base = octave_mmap_anonymous_wrapper (len + huge_page_size);
+
+    if (! base)
+      return nullptr;
+
+    std::uintptr_t addr = reinterpret_cast<std::uintptr_t> (base);
+    std::uintptr_t aligned
+      = (addr + huge_page_size - 1) & ~(huge_page_size - 1);
+
+    std::size_t head = aligned - addr;
+    std::size_t tail = huge_page_size - head;
+
+    char *p = reinterpret_cast<char *> (aligned);
+
+    if (head > 0)
+      octave_munmap_wrapper (base, head);
+    if (tail > 0)
+      octave_munmap_wrapper (p + len, tail);
+
+    octave_madvise_hugepage_wrapper (p, len);
+
+    return p;
+  }
+
+  static void
+  unmap (const std::vector<std::pair<void *, std::size_t>>& blocks)
+  {
+    for (const auto& b : blocks)
+      octave_munmap_wrapper (b.first, b.second);
+  }
+
+  static void zero (void *p, std::size_t bytes)
+  {
+    char *data = static_cast<char *> (p);
+
+    const std::size_t chunk = 1 << 16;
+
+    octave_idx_type nchunks = (bytes + chunk - 1) / chunk;
+
+    maybe_parallel_for (nchunks, [=] (octave_idx_type i0, octave_idx_type i1)
+    {
+      std::size_t begin = i0 * chunk;
+      std::size_t end = std::min (i1 * chunk, bytes);
+
+      std::memset (data + begin, 0, end - begin);
+    }, chunk / sizeof (double));
+  }
+
+  std::mutex m_mutex;
+
+  // Blocks in use and their mapped sizes.
+  std::unordered_map<void *, std::size_t> m_live;
+
+  // Freed blocks, oldest first.
+  std::deque<std::pair<void *, std::size_t>> m_free;
+
+  std::size_t m_free_bytes;
+
+  std::size_t m_max_free_bytes;
+};
+
+void *
+allocate_large_array (std::size_t bytes)
+{
+  std::size_t threshold = s_threshold.load (std::memory_order_relaxed);
+
+  if (threshold == 0 || bytes < threshold)
+    return nullptr;
+
+  return large_block_pool::instance ().allocate (bytes);
+}
+
+bool
+free_large_array (void *p, std::size_t bytes)
+{
+  if (bytes < s_min_mapped.load (std::memory_order_relaxed))
+    return false;
+
+  return large_block_pool::instance ().free (p);
+}
+
+std::size_t
+large_array_threshold ()
+{
+  return s_threshold.load ();
+}
+
+std::size_t
+set_large_array_threshold (std::size_t bytes)
+{
+  return s_threshold.exchange (bytes);
+}
+
+std::size_t
+large_array_pool_size ()
+{
+  return large_block_pool::instance ().max_free_bytes ();
+}
+
+std::size_t
+set_large_array_pool_size (std::size_t bytes)
+{
+  return large_block_pool::instance ().set_max_free_bytes (bytes);
+}
+
+OCTAVE_END_NAMESPACE(octave)
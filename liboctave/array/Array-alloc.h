@@ -0,0 +1,89 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if ! defined (octave_Array_alloc_h)
+#define octave_Array_alloc_h 1
+
+#include "octave-config.h"
+
+#include <cstddef>
+
+#include <complex>
+#include <type_traits>
+
+#include "oct-inttypes-fwd.h"
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+// The data of large arrays of numbers is mapped directly from the
+// operating system instead of being taken from the heap.  The blocks
+// are aligned to and backed by huge pages where the system supports
+// them, and their pages are only touched when the elements are first
+// written, usually by the threads of a parallel loop, so that each
+// page ends up in the memory of the processor that uses it.  Recently
+// freed blocks are kept in a pool for reuse, so that temporary results
+// of the same size do not map and unmap memory each time.
+
+// True for the element types whose value-initialized value has all
+// bits zero, so that fresh blocks need not be initialized.
+
+template <typename T>
+struct is_zero_initialized : std::is_arithmetic<T>
+{ };
+
+template <typename T>
+struct is_zero_initialized<std::complex<T>> : std::is_arithmetic<T>
+{ };
+
+template <typename T>
+struct is_zero_initialized<octave_int<T>> : std::true_type
+{ };
+
+// Return a block of at least BYTES bytes, all zero, or nullptr if
+// blocks of that size should come from the heap.
+extern OCTAVE_API void * allocate_large_array (std::size_t bytes);
+
+// Release P and return true if it was returned by allocate_large_array
+// for a block of BYTES bytes.  Otherwise, return false.
+extern OCTAVE_API bool free_large_array (void *p, std::size_t bytes);
+
+// Return the minimum size in bytes of the blocks that are mapped.
+// Zero means that all blocks come from the heap.
+extern OCTAVE_API std::size_t large_array_threshold ();
+
+// Set the minimum size of mapped blocks and return the previous value.
+extern OCTAVE_API std::size_t set_large_array_threshold (std::size_t bytes);
+
+// Return the maximum total size in bytes of the freed blocks that are
+// kept for reuse.
+extern OCTAVE_API std::size_t large_array_pool_size ();
+
+// Set the maximum size of the pool of freed blocks, releasing blocks
+// as needed, and return the previous value.
+extern OCTAVE_API std::size_t set_large_array_pool_size (std::size_t bytes);
+
+OCTAVE_END_NAMESPACE(octave)
+
+#endif
@@ -32,12 +32,14 @@
 // this file.
 
 #include <ostream>
+#include <type_traits>
 
 #include "Array-util.h"
 #include "Array.h"
 #include "lo-error.h"
 #include "lo-mappers.h"
 #include "oct-locbuf.h"
+#include "oct-parallel.h"
 
 // One dimensional array class.  Handles the reference counting for
 // all the derived classes.
@@ -511,6 +513,21 @@ Array<T, Alloc>::permute (const Array<octave_idx_type>& perm_vec_arg, bool inv)
   for (int i = 0; i < perm_vec_len; i++)
     dv_new(i) = dv(perm_vec(i));
 
+  // If only singleton dimensions are moved, the elements stay in the
+  // same order and the result can share the data, like a reshape.
+  bool same_order = true;
+  for (int i = 0, last = -1; i < perm_vec_len && same_order; i++)
+    {
+      if (dv_new(i) != 1)
+        {
+          same_order = perm_vec(i) > last;
+          last = perm_vec(i);
+        }
+    }
+
+  if (same_order)
+    return Array<T, Alloc> (*this, dv_new);
+
   retval = Array<T, Alloc> (dv_new);
 
   if (numel () > 0)
@@ -565,14 +582,85 @@ public:
 
   ~rec_index_helper () { delete [] m_idx; delete [] m_dim; }
 
+  // The slabs of the result that belong to the indices in the last
+  // dimension are independent, so large ones are processed in
+  // parallel.  Assignments are only split if no slab is selected more
+  // than once.
+
   template <typename T>
-  void index (const T *src, T *dest) const { do_index (src, dest, m_top); }
+  void index (const T *src, T *dest) const
+  {
+    if (m_top > 0 && std::is_trivially_copyable<T>::value)
+      {
+        unmask_levels ();
+
+        const octave::idx_vector& top = m_idx[m_top];
+        octave_idx_type nn = top.length (m_dim[m_top]);
+        octave_idx_type d = m_cdim[m_top];
+        octave_idx_type len = slab_length ();
+
+        octave::maybe_parallel_for (nn, [=, &top] (octave_idx_type i0,
+                                                   octave_idx_type i1)
+        {
+          for (octave_idx_type i = i0; i < i1; i++)
+            do_index (src + d*top.xelem (i), dest + i*len, m_top-1);
+        }, len);
+      }
+    else
+      do_index (src, dest, m_top);
+  }
 
   template <typename T>
-  void assign (const T *src, T *dest) const { do_assign (src, dest, m_top); }
+  void assign (const T *src, T *dest) const
+  {
+    octave_idx_type len = slab_length ();
+
+    if (m_top > 0 && std::is_trivially_copyable<T>::value
+        && octave::use_parallel_loop (m_idx[m_top].length (m_dim[m_top]), len)
+        && ! m_idx[m_top].has_duplicates (m_dim[m_top]))
+      {
+        unmask_levels ();
+
+        const octave::idx_vector& top = m_idx[m_top];
+        octave_idx_type nn = top.length (m_dim[m_top]);
+        octave_idx_type d = m_cdim[m_top];
+
+        octave::parallel_for (nn, [=, &top] (octave_idx_type i0,
+                                             octave_idx_type i1)
+        {
+          for (octave_idx_type i = i0; i < i1; i++)
+            do_assign (src + i*len, dest + d*top.xelem (i), m_top-1);
+        }, len);
+      }
+    else
+      do_assign (src, dest, m_top);
+  }
 
   template <typename T>
-  void fill (const T& val, T *dest) const { do_fill (val, dest, m_top); }
+  void fill (const T& val, T *dest) const
+  {
+    octave_idx_type len = slab_length ();
+
+    if (m_top > 0 && std::is_trivially_copyable<T>::value
+        && octave::use_parallel_loop (m_idx[m_top].length (m_dim[m_top]), len)
+        && ! m_idx[m_top].has_duplicates (m_dim[m_top]))
+      {
+        unmask_levels ();
+
+        const octave::idx_vector& top = m_idx[m_top];
+        octave_idx_type nn = top.length (m_dim[m_top]);
+        octave_idx_type d = m_cdim[m_top];
+
+        octave::parallel_for (nn, [=, &val, &top] (octave_idx_type i0,
+                                                   octave_idx_type i1)
+        {
+          for (octave_idx_type i = i0; i < i1; i++)
+            do_fill (val, dest + d*top.xelem (i), m_top-1);
+        }, len);
+      }
+    else
+      do_fill (val, dest, m_top);
+  }
 
   bool is_cont_range (octave_idx_type& l, octave_idx_type& u) const
   {
@@ -581,6 +669,26 @@ public:
 
 private:
 
+  // xelem of a mask index moves a cursor and must not be called
+  // concurrently, so the masks of all levels that are iterated with
+  // xelem are replaced by the positions of their true elements before a
+  // loop is split.  The first level is indexed as a whole.
+
+  void unmask_levels () const
+  {
+    for (octave_idx_type lev = 1; lev <= m_top; lev++)
+      m_idx[lev] = m_idx[lev].unmask ();
+  }
+
+  // The number of elements selected by the indices below the last one.
+  octave_idx_type slab_length () const
+  {
+    octave_idx_type len = 1;
+    for (octave_idx_type lev = 0; lev < m_top; lev++)
+      len *= m_idx[lev].length (m_dim[lev]);
+    return len;
+  }
+
   // Recursive N-D indexing
   template <typename T>
   T * do_index (const T *src, T *dest, octave_idx_type lev) const
@@ -830,8 +938,25 @@ Array<T, Alloc>::index (const octave::idx_vector& i, const octave::idx_vector& j
           const T *src = data ();
           T *dest = retval.rwdata ();
 
-          for (octave_idx_type k = 0; k < jl; k++)
-            dest += i.index (src + r * j.xelem (k), r, dest);
+          // Each column of the result is gathered independently, so
+          // columns may be processed in parallel, as in A(:,idx).
+          if (std::is_trivially_copyable<T>::value)
+            {
+              // xelem of a mask index must not be called concurrently.
+              octave::idx_vector jj = j.unmask ();
+
+              octave::maybe_parallel_for (jl, [=, &i, &jj] (octave_idx_type k0,
+                                                            octave_idx_type k1)
+              {
+                for (octave_idx_type k = k0; k < k1; k++)
+                  i.index (src + r * jj.xelem (k), r, dest + k * il);
+              }, il);
+            }
+          else
+            {
+              for (octave_idx_type k = 0; k < jl; k++)
+                dest += i.index (src + r * j.xelem (k), r, dest);
+            }
         }
     }
 
@@ -1275,6 +1400,21 @@ Array<T, Alloc>::assign (const octave::idx_vector& i, const octave::idx_vector&
                   for (octave_idx_type k = 0; k < jl; k++)
                     i.fill (*src, r, dest + r * j.xelem (k));
                 }
+              else if (std::is_trivially_copyable<T>::value
+                       && octave::use_parallel_loop (jl, il)
+                       && ! j.has_duplicates (c))
+                {
+                  // No column is assigned twice, so the order of the
+                  // assignments does not matter.
+                  octave::idx_vector jj = j.unmask ();
+
+                  octave::parallel_for (jl, [=, &i, &jj] (octave_idx_type k0,
+                                                          octave_idx_type k1)
+                  {
+                    for (octave_idx_type k = k0; k < k1; k++)
+                      i.assign (src + k * il, r, dest + r * jj.xelem (k));
+                  }, il);
+                }
               else
                 {
                   for (octave_idx_type k = 0; k < jl; k++)
@@ -1829,90 +1969,101 @@ Array<T, Alloc>::sort (int dim, sortmode mode) const
   for (int i = 0; i < dim; i++)
     stride *= dv(i);
 
-  T *v = m.rwdata ();
-  const T *ov = data ();
+  if (mode == UNSORTED)
+    return m;
 
-  octave_sort<T> lsort;
+  T *dest = m.rwdata ();
+  const T *src = data ();
+
+  // Vectors are sorted in parallel, each range of them with its own
+  // sorter and buffer.
+
+  octave::parallel_for_slices (stride, ns, iter / stride,
+                               [=] (octave_idx_type l0, octave_idx_type l1,
+                                    octave_idx_type u0, octave_idx_type u1)
+  {
+    octave_sort<T> lsort;
 
-  if (mode != UNSORTED)
     lsort.set_compare (mode);
-  else
-    return m;
 
-  if (stride == 1)
-    {
-      // Special case along first dimension avoids gather/scatter AND directly
-      // sorts into destination buffer for an 11% performance boost.
-      for (octave_idx_type j = 0; j < iter; j++)
-        {
-          // Copy and partition out NaNs.
-          // No need to special case integer types <T> from floating point
-          // types <T> to avoid sort_isnan() test as it makes no discernible
-          // performance impact.
-          octave_idx_type kl = 0;
-          octave_idx_type ku = ns;
-          for (octave_idx_type i = 0; i < ns; i++)
-            {
-              T tmp = ov[i];
-              if (sort_isnan<T> (tmp))
-                v[--ku] = tmp;
-              else
-                v[kl++] = tmp;
-            }
+    if (stride == 1)
+      {
+        // Special case along first dimension avoids gather/scatter AND
+        // directly sorts into destination buffer for an 11% performance
+        // boost.
+        T *v = dest + u0 * ns;
+        const T *ov = src + u0 * ns;
 
-          // sort.
-          lsort.sort (v, kl);
+        for (octave_idx_type j = u0; j < u1; j++)
+          {
+            // Copy and partition out NaNs.
+            // No need to special case integer types <T> from floating point
+            // types <T> to avoid sort_isnan() test as it makes no discernible
+            // performance impact.
+            octave_idx_type kl = 0;
+            octave_idx_type ku = ns;
+            for (octave_idx_type i = 0; i < ns; i++)
+              {
+                T tmp = ov[i];
+                if (sort_isnan<T> (tmp))
+                  v[--ku] = tmp;
+                else
+                  v[kl++] = tmp;
+              }
 
-          if (ku < ns)
-            {
-              // NaNs are in reverse order
-              std::reverse (v + ku, v + ns);
-              if (mode == DESCENDING)
-                std::rotate (v, v + ku, v + ns);
-            }
+            // sort.
+            lsort.sort (v, kl);
 
-          v += ns;
-          ov += ns;
-        }
-    }
-  else
-    {
-      OCTAVE_LOCAL_BUFFER (T, buf, ns);
+            if (ku < ns)
+              {
+                // NaNs are in reverse order
+                std::reverse (v + ku, v + ns);
+                if (mode == DESCENDING)
+                  std::rotate (v, v + ku, v + ns);
+              }
 
-      for (octave_idx_type j = 0; j < iter; j++)
-        {
-          octave_idx_type offset = j;
-          octave_idx_type n_strides = j / stride;
-          offset += n_strides * stride * (ns - 1);
+            v += ns;
+            ov += ns;
+          }
+      }
+    else
+      {
+        OCTAVE_LOCAL_BUFFER (T, buf, ns);
 
-          // gather and partition out NaNs.
-          octave_idx_type kl = 0;
-          octave_idx_type ku = ns;
-          for (octave_idx_type i = 0; i < ns; i++)
+        for (octave_idx_type k = u0; k < u1; k++)
+          for (octave_idx_type j = l0; j < l1; j++)
             {
-              T tmp = ov[i*stride + offset];
-              if (sort_isnan<T> (tmp))
-                buf[--ku] = tmp;
-              else
-                buf[kl++] = tmp;
-            }
+              octave_idx_type offset = k * stride * ns + j;
 
-          // sort.
-          lsort.sort (buf, kl);
+              // gather and partition out NaNs.
+              octave_idx_type kl = 0;
+              octave_idx_type ku = ns;
+              for (octave_idx_type i = 0; i < ns; i++)
+                {
+                  T tmp = src[i*stride + offset];
+                  if (sort_isnan<T> (tmp))
+                    buf[--ku] = tmp;
+                  else
+                    buf[kl++] = tmp;
+                }
 
-          if (ku < ns)
-            {
-              // NaNs are in reverse order
-              std::reverse (buf + ku, buf + ns);
-              if (mode == DESCENDING)
-                std::rotate (buf, buf + ku, buf + ns);
-            }
+              // sort.
+              lsort.sort (buf, kl);
 
-          // scatter.
-          for (octave_idx_type i = 0; i < ns; i++)
-            v[i*stride + offset] = buf[i];
-        }
-    }
+              if (ku < ns)
+                {
+                  // NaNs are in reverse order
+                  std::reverse (buf + ku, buf + ns);
+                  if (mode == DESCENDING)
+                    std::rotate (buf, buf + ku, buf + ns);
+                }
+
+              // scatter.
+              for (octave_idx_type i = 0; i < ns; i++)
+                dest[i*stride + offset] = buf[i];
+            }
+      }
+  });
 
   return m;
 }
@@ -1941,117 +2092,127 @@ Array<T, Alloc>::sort (Array<octave_idx_type>& sidx, int dim,
   for (int i = 0; i < dim; i++)
     stride *= dv(i);
 
-  T *v = m.rwdata ();
-  const T *ov = data ();
+  if (mode == UNSORTED)
+    return m;
 
-  octave_sort<T> lsort;
+  T *dest = m.rwdata ();
+  const T *src = data ();
 
-  octave_idx_type *vi = sidx.rwdata ();
+  octave_idx_type *dest_idx = sidx.rwdata ();
+
+  // See comments in Array::sort (dim, mode).
+
+  octave::parallel_for_slices (stride, ns, iter / stride,
+                               [=] (octave_idx_type l0, octave_idx_type l1,
+                                    octave_idx_type u0, octave_idx_type u1)
+  {
+    octave_sort<T> lsort;
 
-  if (mode != UNSORTED)
     lsort.set_compare (mode);
-  else
-    return m;
 
-  if (stride == 1)
-    {
-      // Special case for dim 1 avoids gather/scatter for performance boost.
-      // See comments in Array::sort (dim, mode).
-      for (octave_idx_type j = 0; j < iter; j++)
-        {
-          // copy and partition out NaNs.
-          octave_idx_type kl = 0;
-          octave_idx_type ku = ns;
-          for (octave_idx_type i = 0; i < ns; i++)
-            {
-              T tmp = ov[i];
-              if (sort_isnan<T> (tmp))
-                {
-                  --ku;
-                  v[ku] = tmp;
-                  vi[ku] = i;
-                }
-              else
-                {
-                  v[kl] = tmp;
-                  vi[kl] = i;
-                  kl++;
-                }
-            }
+    if (stride == 1)
+      {
+        // Special case for dim 1 avoids gather/scatter for performance
+        // boost.
+        T *v = dest + u0 * ns;
+        octave_idx_type *vi = dest_idx + u0 * ns;
+        const T *ov = src + u0 * ns;
 
-          // sort.
-          lsort.sort (v, vi, kl);
+        for (octave_idx_type j = u0; j < u1; j++)
+          {
+            // copy and partition out NaNs.
+            octave_idx_type kl = 0;
+            octave_idx_type ku = ns;
+            for (octave_idx_type i = 0; i < ns; i++)
+              {
+                T tmp = ov[i];
+                if (sort_isnan<T> (tmp))
+                  {
+                    --ku;
+                    v[ku] = tmp;
+                    vi[ku] = i;
+                  }
+                else
+                  {
+                    v[kl] = tmp;
+                    vi[kl] = i;
+                    kl++;
+                  }
+              }
 
-          if (ku < ns)
-            {
-              // NaNs are in reverse order
-              std::reverse (v + ku, v + ns);
-              std::reverse (vi + ku, vi + ns);
-              if (mode == DESCENDING)
-                {
-                  std::rotate (v, v + ku, v + ns);
-                  std::rotate (vi, vi + ku, vi + ns);
-                }
-            }
+            // sort.
+            lsort.sort (v, vi, kl);
 
-          v += ns;
-          vi += ns;
-          ov += ns;
-        }
-    }
-  else
-    {
-      OCTAVE_LOCAL_BUFFER (T, buf, ns);
-      OCTAVE_LOCAL_BUFFER (octave_idx_type, bufi, ns);
+            if (ku < ns)
+              {
+                // NaNs are in reverse order
+                std::reverse (v + ku, v + ns);
+                std::reverse (vi + ku, vi + ns);
+                if (mode == DESCENDING)
+                  {
+                    std::rotate (v, v + ku, v + ns);
+                    std::rotate (vi, vi + ku, vi + ns);
+                  }
+              }
 
-      for (octave_idx_type j = 0; j < iter; j++)
-        {
-          octave_idx_type offset = j;
-          octave_idx_type n_strides = j / stride;
-          offset += n_strides * stride * (ns - 1);
+            v += ns;
+            vi += ns;
+            ov += ns;
+          }
+      }
+    else
+      {
+        OCTAVE_LOCAL_BUFFER (T, buf, ns);
+        OCTAVE_LOCAL_BUFFER (octave_idx_type, bufi, ns);
 
-          // gather and partition out NaNs.
-          octave_idx_type kl = 0;
-          octave_idx_type ku = ns;
-          for (octave_idx_type i = 0; i < ns; i++)
+        for (octave_idx_type k = u0; k < u1; k++)
+          for (octave_idx_type j = l0; j < l1; j++)
             {
-              T tmp = ov[i*stride + offset];
-              if (sort_isnan<T> (tmp))
-                {
-                  --ku;
-                  buf[ku] = tmp;
-                  bufi[ku] = i;
-                }
-              else
+              octave_idx_type offset = k * stride * ns + j;
+
+              // gather and partition out NaNs.
+              octave_idx_type kl = 0;
+              octave_idx_type ku = ns;
+              for (octave_idx_type i = 0; i < ns; i++)
                 {
-                  buf[kl] = tmp;
-                  bufi[kl] = i;
-                  kl++;
+                  T tmp = src[i*stride + offset];
+                  if (sort_isnan<T> (tmp))
+                    {
+                      --ku;
+                      buf[ku] = tmp;
+                      bufi[ku] = i;
+                    }
+                  else
+                    {
+                      buf[kl] = tmp;
+                      bufi[kl] = i;
+                      kl++;
+                    }
                 }
-            }
 
-          // sort.
-          lsort.sort (buf, bufi, kl);
+              // sort.
+              lsort.sort (buf, bufi, kl);
 
-          if (ku < ns)
-            {
-              // NaNs are in reverse order
-              std::reverse (buf + ku, buf + ns);
-              std::reverse (bufi + ku, bufi + ns);
-              if (mode == DESCENDING)
+              if (ku < ns)
                 {
-                  std::rotate (buf, buf + ku, buf + ns);
-                  std::rotate (bufi, bufi + ku, bufi + ns);
+                  // NaNs are in reverse order
+                  std::reverse (buf + ku, buf + ns);
+                  std::reverse (bufi + ku, bufi + ns);
+                  if (mode == DESCENDING)
+                    {
+                      std::rotate (buf, buf + ku, buf + ns);
+                      std::rotate (bufi, bufi + ku, bufi + ns);
+                    }
                 }
-            }
 
-          // scatter.
-          for (octave_idx_type i = 0; i < ns; i++)
-            v[i*stride + offset] = buf[i];
-          for (octave_idx_type i = 0; i < ns; i++)
-            vi[i*stride + offset] = bufi[i];
-        }
-    }
+              // scatter.
+              for (octave_idx_type i = 0; i < ns; i++)
+                dest[i*stride + offset] = buf[i];
+              for (octave_idx_type i = 0; i < ns; i++)
+                dest_idx[i*stride + offset] = bufi[i];
+            }
+      }
+  });
 
   return m;
 }
@@ -0,0 +1,93 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#include <atomic>
+
+#include "Array-stats.h"
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+static std::atomic<bool> s_enabled (false);
+
+static std::atomic<std::size_t> s_allocations (0);
+
+static std::atomic<std::size_t> s_bytes (0);
+
+static std::atomic<std::size_t> s_reused (0);
+
+static std::atomic<std::size_t> s_pooled (0);
+
+bool
+array_stats_enabled ()
+{
+  return s_enabled.load (std::memory_order_relaxed);
+}
+
+bool
+enable_array_stats (bool enable)
+{
+  return s_enabled.exchange (enable);
+}
+
+void
+count_array_allocation (std::size_t bytes)
+{
+  if (! array_stats_enabled ())
+    return;
+
+  s_allocations.fetch_add (1, std::memory_order_relaxed);
+  s_bytes.fetch_add (bytes, std::memory_order_relaxed);
+}
+
+void
+count_array_reuse ()
+{
+  if (! array_stats_enabled ())
+    return;
+
+  s_reused.fetch_add (1, std::memory_order_relaxed);
+}
+
+void
+count_array_pool_reuse ()
+{
+  if (! array_stats_enabled ())
+    return;
+
+  s_pooled.fetch_add (1, std::memory_order_relaxed);
+}
+
+array_stats
+get_array_stats ()
+{
+  return {s_allocations.load (), s_bytes.load (), s_reused.load (),
+          s_pooled.load ()};
+}
+
+OCTAVE_END_NAMESPACE(octave)
@@ -0,0 +1,74 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if ! defined (octave_Array_stats_h)
+#define octave_Array_stats_h 1
+
+#include "octave-config.h"
+
+#include <cstddef>
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+// Counts of the data blocks allocated for arrays, and of the
+// operations that stored their result in the data of an operand that
+// nothing else referred to instead of allocating a new block.  The
+// counts are kept for the whole process and never reset.  Counting is
+// off by default, so that the counters, which are shared by all
+// threads, are not updated for every array that is allocated.
+
+struct array_stats
+{
+  // Number of nonempty data blocks allocated.
+  std::size_t allocations;
+
+  // Total size of those blocks in bytes.
+  std::size_t bytes;
+
+  // Number of results stored in the data of an operand.
+  std::size_t reused;
+
+  // Number of large data blocks taken from the pool of freed blocks
+  // instead of being mapped.
+  std::size_t pooled;
+};
+
+extern OCTAVE_API bool array_stats_enabled ();
+
+// Turn counting on or off and return the previous state.
+
+extern OCTAVE_API bool enable_array_stats (bool enable);
+
+extern OCTAVE_API void count_array_allocation (std::size_t bytes);
+
+extern OCTAVE_API void count_array_reuse ();
+
+extern OCTAVE_API void count_array_pool_reuse ();
+
+extern OCTAVE_API array_stats get_array_stats ();
+
+OCTAVE_END_NAMESPACE(octave)
+
+#endif
@@ -32,14 +32,19 @@
 
 #include <algorithm>
 #include <iosfwd>
+#include <memory>
 #include <string>
+#include <type_traits>
 
+#include "Array-alloc.h"
 #include "Array-fwd.h"
+#include "Array-stats.h"
 #include "dim-vector.h"
 #include "idx-vector.h"
 #include "lo-error.h"
 #include "lo-traits.h"
 #include "lo-utils.h"
+#include "oct-parallel.h"
 #include "oct-refcount.h"
 #include "oct-sort.h"
 #include "quit.h"
@@ -148,14 +153,14 @@ protected:
     ArrayRep (pointer d, octave_idx_type len)
       : Alloc (), m_data (allocate (len)), m_len (len), m_count (1)
     {
-      std::copy_n (d, len, m_data);
+      copy_data (d, len, m_data);
     }
 
     template <typename U>
     ArrayRep (U *d, octave_idx_type len)
       : Alloc (), m_data (allocate (len)), m_len (len), m_count (1)
     {
-      std::copy_n (d, len, m_data);
+      copy_data (d, len, m_data);
     }
 
     // Use new instead of setting data to 0 so that rwdata() and data()
@@ -170,7 +175,14 @@ protected:
     explicit ArrayRep (octave_idx_type len, const T& val)
       : Alloc (), m_data (allocate (len)), m_len (len), m_count (1)
     {
-      std::fill_n (m_data, len, val);
+      if (s_large_blocks)
+        octave::maybe_parallel_for (len, [=] (octave_idx_type i0,
+                                              octave_idx_type i1)
+        {
+          std::fill (m_data + i0, m_data + i1, val);
+        });
+      else
+        std::fill_n (m_data, len, val);
     }
 
     explicit ArrayRep (pointer ptr, const dim_vector& dv,
@@ -183,7 +195,7 @@ protected:
       : Alloc (), m_data (allocate (a.m_len)), m_len (a.m_len),
         m_count (1)
     {
-      std::copy_n (a.m_data, a.m_len, m_data);
+      copy_data (a.m_data, a.m_len, m_data);
     }
 
     ~ArrayRep () { deallocate (m_data, m_len); }
@@ -199,6 +211,17 @@ protected:
 
     OCTARRAY_OVERRIDABLE_FUNC_API pointer allocate (size_t len)
     {
+      if (len > 0)
+        octave::count_array_allocation (len * sizeof (T));
+
+      if constexpr (s_large_blocks)
+        {
+          // Mapped blocks are already filled with zeros.
+          void *p = octave::allocate_large_array (len * sizeof (T));
+          if (p)
+            return static_cast<pointer> (p);
+        }
+
       pointer data = Alloc_traits::allocate (*this, len);
       for (size_t i = 0; i < len; i++)
         T_Alloc_traits::construct (*this, data+i);
@@ -207,10 +230,39 @@ protected:
 
     OCTARRAY_OVERRIDABLE_FUNC_API void deallocate (pointer data, size_t len)
     {
+      if constexpr (s_large_blocks)
+        {
+          if (octave::free_large_array (data, len * sizeof (T)))
+            return;
+        }
+
       for (size_t i = 0; i < len; i++)
         T_Alloc_traits::destroy (*this, data+i);
       Alloc_traits::deallocate (*this, data, len);
     }
+
+  private:
+
+    // The data of large arrays of numbers with the default allocator
+    // may be mapped directly, see Array-alloc.h.  Such arrays are also
+    // filled and copied in parallel, so that their pages are spread
+    // over the memory of all processors that work on them.
+    static constexpr bool s_large_blocks
+      = (std::is_same<Alloc, std::allocator<T>>::value
+         && octave::is_zero_initialized<T>::value);
+
+    template <typename U>
+    static void copy_data (const U *src, octave_idx_type len, pointer dest)
+    {
+      if (s_large_blocks && octave::is_zero_initialized<U>::value)
+        octave::maybe_parallel_for (len, [=] (octave_idx_type i0,
+                                              octave_idx_type i1)
+        {
+          std::copy (src + i0, src + i1, dest + i0);
+        });
+      else
+        std::copy_n (src, len, dest);
+    }
   };
 
   //--------------------------------------------------------------------
@@ -575,7 +575,7 @@ NDArray::abs () const
 boolNDArray
 NDArray::isnan () const
 {
-  return do_mx_unary_map<bool, double, octave::math::isnan> (*this);
+  return do_mx_unary_op<bool, double> (*this, mx_inline_isnan);
 }
 
 boolNDArray
@@ -543,7 +543,7 @@ FloatNDArray::abs () const
 boolNDArray
 FloatNDArray::isnan () const
 {
-  return do_mx_unary_map<bool, float, octave::math::isnan> (*this);
+  return do_mx_unary_op<bool, float> (*this, mx_inline_isnan);
 }
 
 boolNDArray
@@ -30,7 +30,10 @@
 #include <cinttypes>
 #include <cstdlib>
 
+#include <algorithm>
+#include <numeric>
 #include <ostream>
+#include <vector>
 
 #include "idx-vector.h"
 #include "Array.h"
@@ -41,6 +44,7 @@
 #include "oct-locbuf.h"
 #include "lo-error.h"
 #include "lo-mappers.h"
+#include "oct-parallel.h"
 
 OCTAVE_BEGIN_NAMESPACE(octave)
 
@@ -631,7 +635,8 @@ idx_vector::idx_vector_rep::as_array ()
 
 idx_vector::idx_mask_rep::idx_mask_rep (bool b)
   : idx_base_rep (), m_data (nullptr), m_len (b ? 1 : 0), m_ext (0),
-    m_lsti (-1), m_lste (-1), m_aowner (nullptr), m_orig_dims (m_len, m_len)
+    m_lsti (-1), m_lste (-1), m_aowner (nullptr), m_orig_dims (m_len, m_len),
+    m_block_offsets (), m_unmasked (nullptr)
 {
   if (m_len != 0)
     {
@@ -645,7 +650,8 @@ idx_vector::idx_mask_rep::idx_mask_rep (bool b)
 idx_vector::idx_mask_rep::idx_mask_rep (const Array<bool>& bnda,
                                         octave_idx_type nnz)
   : idx_base_rep (), m_data (nullptr), m_len (nnz), m_ext (bnda.numel ()),
-    m_lsti (-1), m_lste (-1), m_aowner (nullptr), m_orig_dims ()
+    m_lsti (-1), m_lste (-1), m_aowner (nullptr), m_orig_dims (),
+    m_block_offsets (), m_unmasked (nullptr)
 {
   if (nnz < 0)
     m_len = bnda.nnz ();
@@ -669,6 +675,59 @@ idx_vector::idx_mask_rep::~idx_mask_rep ()
     delete m_aowner;
   else
     delete [] m_data;
+
+  if (m_unmasked && --m_unmasked->m_count == 0)
+    delete m_unmasked;
+}
+
+const octave_idx_type *
+idx_vector::idx_mask_rep::block_offsets () const
+{
+  if (m_block_offsets.empty ())
+    {
+      octave_idx_type nblocks = (m_ext + block_size - 1) / block_size;
+
+      std::vector<octave_idx_type> offsets (nblocks + 1, 0);
+
+      maybe_parallel_for (nblocks, [this, &offsets] (octave_idx_type b0,
+                                                     octave_idx_type b1)
+      {
+        for (octave_idx_type b = b0; b < b1; b++)
+          {
+            octave_idx_type i0 = b * block_size;
+            octave_idx_type i1 = std::min (i0 + block_size, m_ext);
+            offsets[b+1] = std::count (m_data + i0, m_data + i1, true);
+          }
+      }, block_size);
+
+      std::partial_sum (offsets.begin (), offsets.end (), offsets.begin ());
+
+      m_block_offsets = std::move (offsets);
+    }
+
+  return m_block_offsets.data ();
+}
+
+idx_vector::idx_vector_rep *
+idx_vector::idx_mask_rep::unmasked () const
+{
+  if (! m_unmasked)
+    {
+      octave_idx_type *idata = new octave_idx_type [m_len];
+
+      for (octave_idx_type i = 0, j = 0; i < m_ext; i++)
+        if (m_data[i])
+          idata[j++] = i;
+
+      octave_idx_type ext = (m_len > 0 ? idata[m_len - 1] + 1 : 0);
+
+      m_unmasked = new idx_vector_rep (idata, m_len, ext, m_orig_dims,
+                                       DIRECT);
+    }
+
+  m_unmasked->m_count++;
+
+  return m_unmasked;
 }
 
 octave_idx_type
@@ -1157,6 +1216,38 @@ idx_vector::is_permutation (octave_idx_type n) const
   return retval;
 }
 
+bool
+idx_vector::has_duplicates (octave_idx_type n) const
+{
+  switch (m_rep->idx_class ())
+    {
+    case class_colon:
+    case class_scalar:
+    case class_mask:
+      return false;
+
+    case class_range:
+      return increment () == 0 && length (n) > 1;
+
+    default:
+      break;
+    }
+
+  octave_idx_type ext = extent (n);
+
+  OCTAVE_LOCAL_BUFFER_INIT (bool, seen, ext, false);
+
+  for (octave_idx_type i = 0, len = length (n); i < len; i++)
+    {
+      octave_idx_type k = xelem (i);
+      if (seen[k])
+        return true;
+      seen[k] = true;
+    }
+
+  return false;
+}
+
 idx_vector
 idx_vector::inverse_permutation (octave_idx_type n) const
 {
@@ -1198,19 +1289,8 @@ idx_vector::unmask () const
   if (idx_class () == class_mask)
     {
       idx_mask_rep *r = dynamic_cast<idx_mask_rep *> (m_rep);
-      const bool *m_data = r->get_data ();
-      octave_idx_type m_ext = r->extent (0);
-      octave_idx_type m_len = r->length (0);
-      octave_idx_type *idata = new octave_idx_type [m_len];
-
-      for (octave_idx_type i = 0, j = 0; i < m_ext; i++)
-        if (m_data[i])
-          idata[j++] = i;
-
-      m_ext = (m_len > 0 ? idata[m_len - 1] + 1 : 0);
 
-      return new idx_vector_rep (idata, m_len, m_ext, r->orig_dimensions (),
-                                 DIRECT);
+      return r->unmasked ();
     }
   else
     return *this;
@@ -33,11 +33,14 @@
 #include <algorithm>
 #include <iosfwd>
 #include <memory>
+#include <type_traits>
+#include <vector>
 
 #include "Array-fwd.h"
 #include "dim-vector.h"
 #include "lo-error.h"
 #include "oct-inttypes.h"
+#include "oct-parallel.h"
 #include "oct-refcount.h"
 #include "Sparse-fwd.h"
 #include "range-fwd.h"
@@ -354,7 +357,8 @@ private:
     idx_mask_rep (bool *data, octave_idx_type len,
                   octave_idx_type ext, const dim_vector& od, direct)
       : idx_base_rep (), m_data (data), m_len (len), m_ext (ext),
-        m_lsti (-1), m_lste (-1), m_aowner (nullptr), m_orig_dims (od)
+        m_lsti (-1), m_lste (-1), m_aowner (nullptr), m_orig_dims (od),
+        m_block_offsets (), m_unmasked (nullptr)
     { }
 
     OCTAVE_API idx_mask_rep (bool);
@@ -388,6 +392,18 @@ private:
 
     const bool * get_data () const { return m_data; }
 
+    // The number of mask elements in each block counted by
+    // block_offsets.
+    static constexpr octave_idx_type block_size = 4096;
+
+    // Return the number of true elements before each block of
+    // block_size elements of the mask, followed by the total number.
+    OCTAVE_API const octave_idx_type * block_offsets () const;
+
+    // Return the positions of the true elements as an index vector
+    // representation whose reference count has been incremented.
+    OCTAVE_API idx_vector_rep * unmasked () const;
+
     OCTAVE_API std::ostream& print (std::ostream& os) const;
 
     OCTAVE_API Array<bool> unconvert () const;
@@ -415,6 +431,15 @@ private:
     Array<bool> *m_aowner;
 
     dim_vector m_orig_dims;
+
+    // The results of block_offsets and unmasked are computed the first
+    // time they are needed.  Masks are usually cached by the values
+    // that they are created from, so using the same mask again, as in
+    // A(m) = x; B(m), does not scan it again.
+
+    mutable std::vector<octave_idx_type> m_block_offsets;
+
+    mutable idx_vector_rep *m_unmasked;
   };
 
   idx_vector (idx_base_rep *r) : m_rep (r) { }
@@ -626,8 +651,18 @@ public:
         {
           idx_vector_rep *r = dynamic_cast<idx_vector_rep *> (m_rep);
           const octave_idx_type *data = r->get_data ();
-          for (octave_idx_type i = 0; i < len; i++)
-            dest[i] = src[data[i]];
+          if (std::is_trivially_copyable<T>::value)
+            maybe_parallel_for (len, [=] (octave_idx_type i0,
+                                          octave_idx_type i1)
+            {
+              for (octave_idx_type i = i0; i < i1; i++)
+                dest[i] = src[data[i]];
+            });
+          else
+            {
+              for (octave_idx_type i = 0; i < len; i++)
+                dest[i] = src[data[i]];
+            }
         }
         break;
 
@@ -636,8 +671,26 @@ public:
           idx_mask_rep *r = dynamic_cast<idx_mask_rep *> (m_rep);
           const bool *data = r->get_data ();
           octave_idx_type ext = r->extent (0);
-          for (octave_idx_type i = 0; i < ext; i++)
-            if (data[i]) *dest++ = src[i];
+          if (std::is_trivially_copyable<T>::value)
+            mask_loop (r, [=] (octave_idx_type i0,
+                               octave_idx_type,
+                               octave_idx_type k0,
+                               octave_idx_type k1)
+            {
+              // Store every element and advance the output only for
+              // true elements, so that there is no branch that
+              // depends on the mask.
+              for (octave_idx_type i = i0, k = k0; k < k1; i++)
+                {
+                  dest[k] = src[i];
+                  k += data[i];
+                }
+            });
+          else
+            {
+              for (octave_idx_type i = 0; i < ext; i++)
+                if (data[i]) *dest++ = src[i];
+            }
         }
         break;
 
@@ -713,8 +766,21 @@ public:
           idx_mask_rep *r = dynamic_cast<idx_mask_rep *> (m_rep);
           const bool *data = r->get_data ();
           octave_idx_type ext = r->extent (0);
-          for (octave_idx_type i = 0; i < ext; i++)
-            if (data[i]) dest[i] = *src++;
+          if (std::is_trivially_copyable<T>::value)
+            mask_loop (r, [=] (octave_idx_type i0,
+                               octave_idx_type i1,
+                               octave_idx_type k0,
+                               octave_idx_type)
+            {
+              const T *s = src + k0;
+              for (octave_idx_type i = i0; i < i1; i++)
+                if (data[i]) dest[i] = *s++;
+            });
+          else
+            {
+              for (octave_idx_type i = 0; i < ext; i++)
+                if (data[i]) dest[i] = *src++;
+            }
         }
         break;
 
@@ -790,8 +856,23 @@ public:
           idx_mask_rep *r = dynamic_cast<idx_mask_rep *> (m_rep);
           const bool *data = r->get_data ();
           octave_idx_type ext = r->extent (0);
-          for (octave_idx_type i = 0; i < ext; i++)
-            if (data[i]) dest[i] = val;
+          if (std::is_trivially_copyable<T>::value)
+            {
+              // Rewriting the elements that are not selected allows
+              // the loop to be vectorized.
+              T v = val;
+              maybe_parallel_for (ext, [=] (octave_idx_type i0,
+                                            octave_idx_type i1)
+              {
+                for (octave_idx_type i = i0; i < i1; i++)
+                  dest[i] = (data[i] ? v : dest[i]);
+              });
+            }
+          else
+            {
+              for (octave_idx_type i = 0; i < ext; i++)
+                if (data[i]) dest[i] = val;
+            }
         }
         break;
 
@@ -989,6 +1070,10 @@ public:
 
   OCTAVE_API bool is_permutation (octave_idx_type n) const;
 
+  // Returns true if any index into an array of N elements occurs more
+  // than once.
+  OCTAVE_API bool has_duplicates (octave_idx_type n) const;
+
   // Returns the inverse permutation.  If this is not a permutation on 1:n, the
   // result is undefined (but no error unless extent () != n).
   OCTAVE_API idx_vector inverse_permutation (octave_idx_type n) const;
@@ -1033,6 +1118,37 @@ public:
 
 private:
 
+  // Call FCN (I0, I1, K0, K1) for consecutive ranges [I0, I1) that
+  // cover the extent of the mask R.  The true elements in a range are
+  // those numbered K0 to K1-1.  Large masks are processed in parallel
+  // by ranges of blocks, using the counts of true elements that R
+  // keeps for each block.
+
+  template <typename F>
+  static void
+  mask_loop (const idx_mask_rep *r, F fcn)
+  {
+    octave_idx_type ext = r->extent (0);
+
+    if (! use_parallel_loop (ext))
+      {
+        fcn (0, ext, 0, r->length (0));
+        return;
+      }
+
+    const octave_idx_type block = idx_mask_rep::block_size;
+
+    octave_idx_type nblocks = (ext + block - 1) / block;
+
+    const octave_idx_type *offsets = r->block_offsets ();
+
+    parallel_for (nblocks, [=, &fcn] (octave_idx_type b0,
+                                      octave_idx_type b1)
+    {
+      fcn (b0 * block, std::min (b1 * block, ext), offsets[b0], offsets[b1]);
+    }, block);
+  }
+
   idx_base_rep *m_rep;
 
 };
@@ -1,5 +1,7 @@
 ARRAY_INC = \
+  %reldir%/Array-alloc.h \
   %reldir%/Array-fwd.h \
+  %reldir%/Array-stats.h \
   %reldir%/Array-util.h \
   %reldir%/Array.h \
   %reldir%/CColVector.h \
@@ -57,6 +59,7 @@ ARRAY_INC = \
 
 ARRAY_SRC = \
   %reldir%/Array-C.cc \
+  %reldir%/Array-alloc.cc \
   %reldir%/Array-b.cc \
   %reldir%/Array-ch.cc \
   %reldir%/Array-d.cc \
@@ -65,6 +68,7 @@ ARRAY_SRC = \
   %reldir%/Array-i.cc \
   %reldir%/Array-idx-vec.cc \
   %reldir%/Array-s.cc \
+  %reldir%/Array-stats.cc \
   %reldir%/Array-str.cc \
   %reldir%/Array-util.cc \
   %reldir%/Array-voidp.cc \
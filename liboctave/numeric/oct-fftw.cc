@@ -34,6 +34,7 @@
 #include "lo-error.h"
 #include "oct-fftw.h"
 #include "oct-locbuf.h"
+#include "oct-mutex.h"
 #include "quit.h"
 #include "singleton-cleanup.h"
 
@@ -43,9 +44,17 @@
 
 OCTAVE_BEGIN_NAMESPACE(octave)
 
+mutex&
+fftw_planner::planner_mutex ()
+{
+  static mutex s_planner_mutex;
+
+  return s_planner_mutex;
+}
+
 #if defined (HAVE_FFTW)
 
-fftw_planner *fftw_planner::s_instance = nullptr;
+OCTAVE_THREAD_LOCAL fftw_planner *fftw_planner::s_instance = nullptr;
 
 // Helper class to create and cache FFTW plans for both 1D and
 // 2D.  This implementation defaults to using FFTW_ESTIMATE to create
@@ -75,6 +84,8 @@ fftw_planner::fftw_planner ()
   m_inplace[0] = m_inplace[1] = false;
   m_n[0] = m_n[1] = dim_vector ();
 
+  autolock guard (fftw_planner::planner_mutex ());
+
 #if defined (HAVE_FFTW3_THREADS)
   int init_ret = fftw_init_threads ();
   if (! init_ret)
@@ -99,6 +110,8 @@ fftw_planner::fftw_planner ()
 
 fftw_planner::~fftw_planner ()
 {
+  autolock guard (fftw_planner::planner_mutex ());
+
   fftw_plan *plan_p;
 
   plan_p = reinterpret_cast<fftw_plan *> (&m_rplan);
@@ -134,6 +147,8 @@ fftw_planner::threads (int nt)
 #if defined (HAVE_FFTW3_THREADS)
   if (instance_ok () && nt != threads ())
     {
+      autolock guard (fftw_planner::planner_mutex ());
+
       s_instance->m_nthreads = nt;
       fftw_plan_with_nthreads (nt);
       // Clear the current plans.
@@ -241,6 +256,13 @@ fftw_planner::do_create_plan (int dir, const int rank,
       else
         plan_flags |= FFTW_UNALIGNED;
 
+      // The FFTW planner is shared by all threads.
+      autolock guard (fftw_planner::planner_mutex ());
+
+#if defined (HAVE_FFTW3_THREADS)
+      fftw_plan_with_nthreads (m_nthreads);
+#endif
+
       if (*cur_plan_p)
         fftw_destroy_plan (*cur_plan_p);
 
@@ -358,6 +380,13 @@ fftw_planner::do_create_plan (const int rank, const dim_vector& dims,
       else
         plan_flags |= FFTW_UNALIGNED;
 
+      // The FFTW planner is shared by all threads.
+      autolock guard (fftw_planner::planner_mutex ());
+
+#if defined (HAVE_FFTW3_THREADS)
+      fftw_plan_with_nthreads (m_nthreads);
+#endif
+
       if (*cur_plan_p)
         fftw_destroy_plan (*cur_plan_p);
 
@@ -408,6 +437,8 @@ fftw_planner::do_method (FftwMethod _meth)
     {
       if (m_meth != _meth)
         {
+          autolock guard (fftw_planner::planner_mutex ());
+
           m_meth = _meth;
           if (m_rplan)
             fftw_destroy_plan (reinterpret_cast<fftw_plan> (m_rplan));
@@ -423,7 +454,8 @@ fftw_planner::do_method (FftwMethod _meth)
   return ret;
 }
 
-float_fftw_planner *float_fftw_planner::s_instance = nullptr;
+OCTAVE_THREAD_LOCAL float_fftw_planner *
+float_fftw_planner::s_instance = nullptr;
 
 float_fftw_planner::float_fftw_planner ()
   : m_meth (ESTIMATE), m_rplan (nullptr), m_rd (0), m_rs (0), m_rr (0),
@@ -435,6 +467,8 @@ float_fftw_planner::float_fftw_planner ()
   m_inplace[0] = m_inplace[1] = false;
   m_n[0] = m_n[1] = dim_vector ();
 
+  autolock guard (fftw_planner::planner_mutex ());
+
 #if defined (HAVE_FFTW3F_THREADS)
   int init_ret = fftwf_init_threads ();
   if (! init_ret)
@@ -454,6 +488,8 @@ float_fftw_planner::float_fftw_planner ()
 
 float_fftw_planner::~float_fftw_planner ()
 {
+  autolock guard (fftw_planner::planner_mutex ());
+
   fftwf_plan *plan_p;
 
   plan_p = reinterpret_cast<fftwf_plan *> (&m_rplan);
@@ -489,6 +525,8 @@ float_fftw_planner::threads (int nt)
 #if defined (HAVE_FFTW3F_THREADS)
   if (instance_ok () && nt != threads ())
     {
+      autolock guard (fftw_planner::planner_mutex ());
+
       s_instance->m_nthreads = nt;
       fftwf_plan_with_nthreads (nt);
       // Clear the current plans.
@@ -594,6 +632,13 @@ float_fftw_planner::do_create_plan (int dir, const int rank,
       else
         plan_flags |= FFTW_UNALIGNED;
 
+      // The FFTW planner is shared by all threads.
+      autolock guard (fftw_planner::planner_mutex ());
+
+#if defined (HAVE_FFTW3F_THREADS)
+      fftwf_plan_with_nthreads (m_nthreads);
+#endif
+
       if (*cur_plan_p)
         fftwf_destroy_plan (*cur_plan_p);
 
@@ -711,6 +756,13 @@ float_fftw_planner::do_create_plan (const int rank, const dim_vector& dims,
       else
         plan_flags |= FFTW_UNALIGNED;
 
+      // The FFTW planner is shared by all threads.
+      autolock guard (fftw_planner::planner_mutex ());
+
+#if defined (HAVE_FFTW3F_THREADS)
+      fftwf_plan_with_nthreads (m_nthreads);
+#endif
+
       if (*cur_plan_p)
         fftwf_destroy_plan (*cur_plan_p);
 
@@ -761,6 +813,8 @@ float_fftw_planner::do_method (FftwMethod _meth)
     {
       if (m_meth != _meth)
         {
+          autolock guard (fftw_planner::planner_mutex ());
+
           m_meth = _meth;
           if (m_rplan)
             fftwf_destroy_plan (reinterpret_cast<fftwf_plan> (m_rplan));
@@ -37,6 +37,8 @@
 
 OCTAVE_BEGIN_NAMESPACE(octave)
 
+class mutex;
+
 class OCTAVE_API fftw_planner
 {
 protected:
@@ -105,9 +107,16 @@ public:
     return instance_ok () ? s_instance->m_nthreads : 0;
   }
 
+  // Plans are cached per thread, but the FFTW planner and its wisdom
+  // are shared by the whole process.  This lock must be held while
+  // creating or destroying plans and while accessing the wisdom of
+  // either the double or the single precision library.
+
+  static mutex& planner_mutex ();
+
 private:
 
-  static fftw_planner *s_instance;
+  OCTAVE_THREAD_LOCAL static fftw_planner *s_instance;
 
   static void cleanup_instance ()
   { delete s_instance; s_instance = nullptr; }
@@ -247,7 +256,7 @@ public:
 
 private:
 
-  static float_fftw_planner *s_instance;
+  OCTAVE_THREAD_LOCAL static float_fftw_planner *s_instance;
 
   static void cleanup_instance ()
   { delete s_instance; s_instance = nullptr; }
@@ -30,6 +30,7 @@
 #include <cstdint>
 
 #include <limits>
+#include <mutex>
 
 #include "lo-error.h"
 #include "lo-ieee.h"
@@ -37,6 +38,7 @@
 #include "lo-ranlib-proto.h"
 #include "mach-info.h"
 #include "oct-locbuf.h"
+#include "oct-mutex.h"
 #include "oct-rand.h"
 #include "oct-time.h"
 #include "quit.h"
@@ -47,13 +49,58 @@
 
 OCTAVE_BEGIN_NAMESPACE(octave)
 
-rand *rand::s_instance = nullptr;
+OCTAVE_THREAD_LOCAL rand *rand::s_instance = nullptr;
+
+// The old randlib generators keep their seeds and the number of the
+// current generator in Fortran COMMON blocks that are shared by all
+// threads.  Only one thread at a time may use them, and it must select
+// the generator for its own current distribution first.
+
+static mutex&
+ranlib_mutex ()
+{
+  static mutex s_ranlib_mutex;
+
+  return s_ranlib_mutex;
+}
+
+class ranlib_lock
+{
+public:
+
+  ranlib_lock (int dist, bool active = true)
+    : m_active (active)
+  {
+    if (m_active)
+      {
+        ranlib_mutex ().lock ();
+
+        F77_FUNC (setcgn, SETCGN) (dist);
+      }
+  }
+
+  OCTAVE_DISABLE_CONSTRUCT_COPY_MOVE (ranlib_lock)
+
+  ~ranlib_lock ()
+  {
+    if (m_active)
+      ranlib_mutex ().unlock ();
+  }
+
+private:
+
+  bool m_active;
+};
 
 rand::rand ()
   : m_current_distribution (uniform_dist), m_use_old_generators (false),
     m_rand_states ()
 {
-  initialize_ranlib_generators ();
+  // The shared randlib generators are only seeded once per process.
+  static std::once_flag ranlib_initialized;
+
+  std::call_once (ranlib_initialized,
+                  [this] () { initialize_ranlib_generators (); });
 
   initialize_mersenne_twister ();
 }
@@ -80,6 +127,8 @@ rand::do_seed ()
 
   mach_info::float_format ff = mach_info::native_float_format ();
 
+  ranlib_lock lock (m_current_distribution);
+
   switch (ff)
     {
     case mach_info::flt_fmt_ieee_big_endian:
@@ -134,6 +183,8 @@ rand::do_seed (double s)
       break;
     }
 
+  ranlib_lock lock (m_current_distribution);
+
   F77_FUNC (setsd, SETSD) (i0, i1);
 }
 
@@ -267,40 +318,30 @@ void
 rand::do_uniform_distribution ()
 {
   switch_to_generator (uniform_dist);
-
-  F77_FUNC (setcgn, SETCGN) (uniform_dist);
 }
 
 void
 rand::do_normal_distribution ()
 {
   switch_to_generator (normal_dist);
-
-  F77_FUNC (setcgn, SETCGN) (normal_dist);
 }
 
 void
 rand::do_exponential_distribution ()
 {
   switch_to_generator (expon_dist);
-
-  F77_FUNC (setcgn, SETCGN) (expon_dist);
 }
 
 void
 rand::do_poisson_distribution ()
 {
   switch_to_generator (poisson_dist);
-
-  F77_FUNC (setcgn, SETCGN) (poisson_dist);
 }
 
 void
 rand::do_gamma_distribution ()
 {
   switch_to_generator (gamma_dist);
-
-  F77_FUNC (setcgn, SETCGN) (gamma_dist);
 }
 
 template <>
@@ -475,6 +516,8 @@ rand::do_scalar (T a)
 {
   T retval = 0;
 
+  ranlib_lock lock (m_current_distribution, m_use_old_generators);
+
   switch (m_current_distribution)
     {
     case uniform_dist:
@@ -574,8 +617,8 @@ void
 rand::initialize_ranlib_generators ()
 {
   sys::localtime tm;
-  int stored_distribution = m_current_distribution;
-  F77_FUNC (setcgn, SETCGN) (uniform_dist);
+
+  ranlib_lock lock (uniform_dist);
 
   int hour = tm.hour () + 1;
   int minute = tm.min () + 1;
@@ -588,7 +631,6 @@ rand::initialize_ranlib_generators ()
   s1 = force_to_fit_range (s1, 1, 2147483399);
 
   F77_FUNC (setall, SETALL) (s0, s1);
-  F77_FUNC (setcgn, SETCGN) (stored_distribution);
 }
 
 void
@@ -689,6 +731,8 @@ rand::fill (octave_idx_type len, double *v, double a)
   if (len < 1)
     return;
 
+  ranlib_lock lock (m_current_distribution, m_use_old_generators);
+
   switch (m_current_distribution)
     {
     case uniform_dist:
@@ -758,6 +802,8 @@ rand::fill (octave_idx_type len, float *v, float a)
   if (len < 1)
     return;
 
+  ranlib_lock lock (m_current_distribution, m_use_old_generators);
+
   switch (m_current_distribution)
     {
     case uniform_dist:
@@ -184,7 +184,7 @@ public:
 
 private:
 
-  static rand *s_instance;
+  OCTAVE_THREAD_LOCAL static rand *s_instance;
 
   static void cleanup_instance ()
   { delete s_instance; s_instance = nullptr; }
@@ -37,7 +37,7 @@
 
 OCTAVE_BEGIN_NAMESPACE(octave)
 
-sparse_params *sparse_params::s_instance = nullptr;
+OCTAVE_THREAD_LOCAL sparse_params *sparse_params::s_instance = nullptr;
 
 bool
 sparse_params::instance_ok ()
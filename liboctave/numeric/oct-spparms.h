@@ -85,7 +85,7 @@ private:
 
   string_vector m_keys;
 
-  static sparse_params *s_instance;
+  OCTAVE_THREAD_LOCAL static sparse_params *s_instance;
 
   static void cleanup_instance ()
   {
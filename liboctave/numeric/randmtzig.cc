@@ -189,12 +189,13 @@ OCTAVE_BEGIN_NAMESPACE(octave)
 #define MIXBITS(u,v) ( ((u) & UMASK) | ((v) & LMASK) )
 #define TWIST(u,v) ((MIXBITS(u,v) >> 1) ^ ((v)&1UL ? MATRIX_A : 0UL))
 
-static uint32_t *next;
-static uint32_t state[MT_N]; /* the array for the state vector  */
-static int left = 1;
-static int initf = 0;
-static int initt = 1;
-static int inittf = 1;
+static OCTAVE_THREAD_LOCAL uint32_t *next;
+/* the array for the state vector  */
+static OCTAVE_THREAD_LOCAL uint32_t state[MT_N];
+static OCTAVE_THREAD_LOCAL int left = 1;
+static OCTAVE_THREAD_LOCAL int initf = 0;
+static OCTAVE_THREAD_LOCAL int initt = 1;
+static OCTAVE_THREAD_LOCAL int inittf = 1;
 
 /* initializes state[MT_N] with a seed */
 void
@@ -471,10 +472,12 @@ rand_uniform<float> ()
 #define NRANDI randi54() /* 53 bits for mantissa + 1 bit sign */
 #define RANDU randu53()
 
-static ZIGINT ki[ZIGGURAT_TABLE_SIZE];
-static double wi[ZIGGURAT_TABLE_SIZE], fi[ZIGGURAT_TABLE_SIZE];
-static ZIGINT ke[ZIGGURAT_TABLE_SIZE];
-static double we[ZIGGURAT_TABLE_SIZE], fe[ZIGGURAT_TABLE_SIZE];
+static OCTAVE_THREAD_LOCAL ZIGINT ki[ZIGGURAT_TABLE_SIZE];
+static OCTAVE_THREAD_LOCAL double wi[ZIGGURAT_TABLE_SIZE];
+static OCTAVE_THREAD_LOCAL double fi[ZIGGURAT_TABLE_SIZE];
+static OCTAVE_THREAD_LOCAL ZIGINT ke[ZIGGURAT_TABLE_SIZE];
+static OCTAVE_THREAD_LOCAL double we[ZIGGURAT_TABLE_SIZE];
+static OCTAVE_THREAD_LOCAL double fe[ZIGGURAT_TABLE_SIZE];
 
 /*
   This code is based on the paper Marsaglia and Tsang, "The ziggurat method
@@ -717,10 +720,12 @@ template <> OCTAVE_API void rand_exponential (octave_idx_type n, double *p)
 #define NRANDI randi32() /* 31 bits for mantissa + 1 bit sign */
 #define RANDU randu24()
 
-static ZIGINT fki[ZIGGURAT_TABLE_SIZE];
-static float fwi[ZIGGURAT_TABLE_SIZE], ffi[ZIGGURAT_TABLE_SIZE];
-static ZIGINT fke[ZIGGURAT_TABLE_SIZE];
-static float fwe[ZIGGURAT_TABLE_SIZE], ffe[ZIGGURAT_TABLE_SIZE];
+static OCTAVE_THREAD_LOCAL ZIGINT fki[ZIGGURAT_TABLE_SIZE];
+static OCTAVE_THREAD_LOCAL float fwi[ZIGGURAT_TABLE_SIZE];
+static OCTAVE_THREAD_LOCAL float ffi[ZIGGURAT_TABLE_SIZE];
+static OCTAVE_THREAD_LOCAL ZIGINT fke[ZIGGURAT_TABLE_SIZE];
+static OCTAVE_THREAD_LOCAL float fwe[ZIGGURAT_TABLE_SIZE];
+static OCTAVE_THREAD_LOCAL float ffe[ZIGGURAT_TABLE_SIZE];
 
 static void
 create_ziggurat_float_tables ()
@@ -33,13 +33,17 @@
 #include <cmath>
 
 #include <algorithm>
+#include <atomic>
+#include <type_traits>
 
 #include "Array-util.h"
 #include "Array.h"
 #include "bsxfun.h"
+#include "mx-simd.h"
 #include "oct-cmplx.h"
-#include "oct-inttypes-fwd.h"
+#include "oct-inttypes.h"
 #include "oct-locbuf.h"
+#include "oct-parallel.h"
 
 // Provides some commonly repeated, basic loop templates.
 
@@ -129,6 +133,62 @@ DEFMXBINOPEQ (mx_inline_sub2, -=)
 DEFMXBINOPEQ (mx_inline_mul2, *=)
 DEFMXBINOPEQ (mx_inline_div2, /=)
 
+// Specialize operations on the element types for which mx-simd.h
+// provides SIMD kernels.  The kernels take the underlying built-in
+// types, which have the same representation.
+
+#define DEFMXSIMDBINOPSPEC(F, SIMDF, T, ST)                             \
+  template <>                                                           \
+  inline void F<T, T, T> (std::size_t n, T *r, const T *x, const T *y)  \
+  {                                                                     \
+    SIMDF (n, reinterpret_cast<ST *> (r),                               \
+           reinterpret_cast<const ST *> (x),                            \
+           reinterpret_cast<const ST *> (y));                           \
+  }                                                                     \
+  template <>                                                           \
+  inline void F<T, T, T> (std::size_t n, T *r, const T *x, T y)         \
+  {                                                                     \
+    SIMDF (n, reinterpret_cast<ST *> (r),                               \
+           reinterpret_cast<const ST *> (x),                            \
+           reinterpret_cast<const ST&> (y));                            \
+  }                                                                     \
+  template <>                                                           \
+  inline void F<T, T, T> (std::size_t n, T *r, T x, const T *y)         \
+  {                                                                     \
+    SIMDF (n, reinterpret_cast<ST *> (r),                               \
+           reinterpret_cast<const ST&> (x),                             \
+           reinterpret_cast<const ST *> (y));                           \
+  }
+
+#define DEFMXSIMDBINOPEQSPEC(F, SIMDF, T, ST)                           \
+  template <>                                                           \
+  inline void F<T, T> (std::size_t n, T *r, const T *x)                 \
+  {                                                                     \
+    SIMDF (n, reinterpret_cast<ST *> (r),                               \
+           reinterpret_cast<const ST *> (r),                            \
+           reinterpret_cast<const ST *> (x));                           \
+  }                                                                     \
+  template <>                                                           \
+  inline void F<T, T> (std::size_t n, T *r, T x)                        \
+  {                                                                     \
+    SIMDF (n, reinterpret_cast<ST *> (r),                               \
+           reinterpret_cast<const ST *> (r),                            \
+           reinterpret_cast<const ST&> (x));                            \
+  }
+
+#define DEFMXSIMDINTSPEC(T, ST)                                         \
+  DEFMXSIMDBINOPSPEC (mx_inline_add, mx_simd_add, T, ST)                \
+  DEFMXSIMDBINOPSPEC (mx_inline_sub, mx_simd_sub, T, ST)                \
+  DEFMXSIMDBINOPSPEC (mx_inline_mul, mx_simd_mul, T, ST)                \
+  DEFMXSIMDBINOPEQSPEC (mx_inline_add2, mx_simd_add, T, ST)             \
+  DEFMXSIMDBINOPEQSPEC (mx_inline_sub2, mx_simd_sub, T, ST)             \
+  DEFMXSIMDBINOPEQSPEC (mx_inline_mul2, mx_simd_mul, T, ST)
+
+DEFMXSIMDINTSPEC (octave_int8, int8_t)
+DEFMXSIMDINTSPEC (octave_uint8, uint8_t)
+DEFMXSIMDINTSPEC (octave_int16, int16_t)
+DEFMXSIMDINTSPEC (octave_uint16, uint16_t)
+
 #define DEFMXCMPOP(F, OP)                                               \
   template <typename X, typename Y>                                     \
   inline void F (std::size_t n, bool *r, const X *x, const Y *y)        \
@@ -156,6 +216,34 @@ DEFMXCMPOP (mx_inline_ge, >=)
 DEFMXCMPOP (mx_inline_eq, ==)
 DEFMXCMPOP (mx_inline_ne, !=)
 
+#define DEFMXSIMDCMPSPEC(F, SIMDF, T)                                   \
+  template <>                                                           \
+  inline void F<T, T> (std::size_t n, bool *r, const T *x, const T *y)  \
+  {                                                                     \
+    SIMDF (n, r, x, y);                                                 \
+  }                                                                     \
+  template <>                                                           \
+  inline void F<T, T> (std::size_t n, bool *r, const T *x, T y)         \
+  {                                                                     \
+    SIMDF (n, r, x, y);                                                 \
+  }                                                                     \
+  template <>                                                           \
+  inline void F<T, T> (std::size_t n, bool *r, T x, const T *y)         \
+  {                                                                     \
+    SIMDF (n, r, x, y);                                                 \
+  }
+
+#define DEFMXSIMDFLOATCMPSPEC(T)                                        \
+  DEFMXSIMDCMPSPEC (mx_inline_lt, mx_simd_lt, T)                        \
+  DEFMXSIMDCMPSPEC (mx_inline_le, mx_simd_le, T)                        \
+  DEFMXSIMDCMPSPEC (mx_inline_gt, mx_simd_gt, T)                        \
+  DEFMXSIMDCMPSPEC (mx_inline_ge, mx_simd_ge, T)                        \
+  DEFMXSIMDCMPSPEC (mx_inline_eq, mx_simd_eq, T)                        \
+  DEFMXSIMDCMPSPEC (mx_inline_ne, mx_simd_ne, T)
+
+DEFMXSIMDFLOATCMPSPEC (double)
+DEFMXSIMDFLOATCMPSPEC (float)
+
 // Convert to logical value, for logical op purposes.
 template <typename T>
 inline bool
@@ -268,6 +356,42 @@ mx_inline_any_nan (std::size_t n, const T *x)
   return false;
 }
 
+template <>
+inline bool
+mx_inline_any_nan<double> (std::size_t n, const double *x)
+{
+  return mx_simd_any_nan (n, x);
+}
+
+template <>
+inline bool
+mx_inline_any_nan<float> (std::size_t n, const float *x)
+{
+  return mx_simd_any_nan (n, x);
+}
+
+template <typename T>
+inline void
+mx_inline_isnan (std::size_t n, bool *r, const T *x)
+{
+  for (std::size_t i = 0; i < n; i++)
+    r[i] = octave::math::isnan (x[i]);
+}
+
+template <>
+inline void
+mx_inline_isnan<double> (std::size_t n, bool *r, const double *x)
+{
+  mx_simd_isnan (n, r, x);
+}
+
+template <>
+inline void
+mx_inline_isnan<float> (std::size_t n, bool *r, const float *x)
+{
+  mx_simd_isnan (n, r, x);
+}
+
 template <typename T>
 inline bool
 mx_inline_all_finite (std::size_t n, const T *x)
@@ -410,6 +534,19 @@ DEFMINMAXSPEC (double, mx_inline_xmax, >=)
 DEFMINMAXSPEC (float, mx_inline_xmin, <=)
 DEFMINMAXSPEC (float, mx_inline_xmax, >=)
 
+// Specialize array-array max/min
+#define DEFMINMAXSIMDSPEC(T, F, SIMDF)                                  \
+  template <>                                                           \
+  inline void F<T> (std::size_t n, T *r, const T *x, const T *y)        \
+  {                                                                     \
+    SIMDF (n, r, x, y);                                                 \
+  }
+
+DEFMINMAXSIMDSPEC (double, mx_inline_xmin, mx_simd_min)
+DEFMINMAXSIMDSPEC (double, mx_inline_xmax, mx_simd_max)
+DEFMINMAXSIMDSPEC (float, mx_inline_xmin, mx_simd_min)
+DEFMINMAXSIMDSPEC (float, mx_inline_xmax, mx_simd_max)
+
 // FIXME: Is this comment correct anymore?  It seems like std::pow is chosen.
 // Let the compiler decide which pow to use, whichever best matches the
 // arguments provided.
@@ -464,6 +601,9 @@ mx_inline_map (std::size_t n, R *r, const X *x)
 
 // Appliers.  Since these call the operation just once, we pass it as
 // a pointer, to allow the compiler reduce number of instances.
+//
+// Operations on large arrays are split into ranges of elements that
+// are processed by several threads (see oct-parallel.h).
 
 template <typename R, typename X>
 inline Array<R>
@@ -471,7 +611,13 @@ do_mx_unary_op (const Array<X>& x,
                 void (*op) (std::size_t, R *, const X *))
 {
   Array<R> r (x.dims ());
-  op (r.numel (), r.rwdata (), x.data ());
+  R *rp = r.rwdata ();
+  const X *xp = x.data ();
+  octave::maybe_parallel_for (r.numel (), [=] (octave_idx_type i0,
+                                               octave_idx_type i1)
+  {
+    op (i1 - i0, rp + i0, xp + i0);
+  });
   return r;
 }
 
@@ -491,12 +637,25 @@ do_mx_unary_map (const Array<X>& x)
   return do_mx_unary_op<R, X> (x, mx_inline_map<R, X, fcn>);
 }
 
+// The in-place appliers are used when R is not shared, so its data is
+// reused for the result.  The reuse is counted only if rwdata did not
+// have to copy the data after all.
+
 template <typename R>
 inline Array<R>&
 do_mx_inplace_op (Array<R>& r,
                   void (*op) (std::size_t, R *))
 {
-  op (r.numel (), r.rwdata ());
+  const R *old_data = r.data ();
+  R *rp = r.rwdata ();
+  if (rp == old_data)
+    octave::count_array_reuse ();
+
+  octave::maybe_parallel_for (r.numel (), [=] (octave_idx_type i0,
+                                               octave_idx_type i1)
+  {
+    op (i1 - i0, rp + i0);
+  });
   return r;
 }
 
@@ -513,7 +672,14 @@ do_mm_binary_op (const Array<X>& x, const Array<Y>& y,
   if (dx == dy)
     {
       Array<R> r (dx);
-      op (r.numel (), r.rwdata (), x.data (), y.data ());
+      R *rp = r.rwdata ();
+      const X *xp = x.data ();
+      const Y *yp = y.data ();
+      octave::maybe_parallel_for (r.numel (), [=] (octave_idx_type i0,
+                                                   octave_idx_type i1)
+      {
+        op (i1 - i0, rp + i0, xp + i0, yp + i0);
+      });
       return r;
     }
   else if (is_valid_bsxfun (opname, dx, dy))
@@ -530,7 +696,13 @@ do_ms_binary_op (const Array<X>& x, const Y& y,
                  void (*op) (std::size_t, R *, const X *, Y))
 {
   Array<R> r (x.dims ());
-  op (r.numel (), r.rwdata (), x.data (), y);
+  R *rp = r.rwdata ();
+  const X *xp = x.data ();
+  octave::maybe_parallel_for (r.numel (), [=, &y] (octave_idx_type i0,
+                                                   octave_idx_type i1)
+  {
+    op (i1 - i0, rp + i0, xp + i0, y);
+  });
   return r;
 }
 
@@ -540,7 +712,13 @@ do_sm_binary_op (const X& x, const Array<Y>& y,
                  void (*op) (std::size_t, R *, X, const Y *))
 {
   Array<R> r (y.dims ());
-  op (r.numel (), r.rwdata (), x, y.data ());
+  R *rp = r.rwdata ();
+  const Y *yp = y.data ();
+  octave::maybe_parallel_for (r.numel (), [=, &x] (octave_idx_type i0,
+                                                   octave_idx_type i1)
+  {
+    op (i1 - i0, rp + i0, x, yp + i0);
+  });
   return r;
 }
 
@@ -554,9 +732,26 @@ do_mm_inplace_op (Array<R>& r, const Array<X>& x,
   const dim_vector &dr = r.dims ();
   const dim_vector &dx = x.dims ();
   if (dr == dx)
-    op (r.numel (), r.rwdata (), x.data ());
+    {
+      const R *old_data = r.data ();
+      R *rp = r.rwdata ();
+      if (rp == old_data)
+        octave::count_array_reuse ();
+
+      const X *xp = x.data ();
+      octave::maybe_parallel_for (r.numel (), [=] (octave_idx_type i0,
+                                                   octave_idx_type i1)
+      {
+        op (i1 - i0, rp + i0, xp + i0);
+      });
+    }
   else if (is_valid_inplace_bsxfun (opname, dr, dx))
-    do_inplace_bsxfun_op (r, x, op, op1);
+    {
+      const R *old_data = r.data ();
+      do_inplace_bsxfun_op (r, x, op, op1);
+      if (r.data () == old_data)
+        octave::count_array_reuse ();
+    }
   else
     octave::err_nonconformant (opname, dr, dx);
 
@@ -568,7 +763,16 @@ inline Array<R>&
 do_ms_inplace_op (Array<R>& r, const X& x,
                   void (*op) (std::size_t, R *, X))
 {
-  op (r.numel (), r.rwdata (), x);
+  const R *old_data = r.data ();
+  R *rp = r.rwdata ();
+  if (rp == old_data)
+    octave::count_array_reuse ();
+
+  octave::maybe_parallel_for (r.numel (), [=, &x] (octave_idx_type i0,
+                                                   octave_idx_type i1)
+  {
+    op (i1 - i0, rp + i0, x);
+  });
   return r;
 }
 
@@ -582,12 +786,48 @@ mx_inline_equal (std::size_t n, const T1 *x, const T2 *y)
   return true;
 }
 
+// The checks return the same value for an empty array as for an array
+// in which no element decides the result, so a large array can be
+// checked in blocks, and the other threads stop as soon as one block
+// decides the result.
+
 template <typename T>
 inline bool
 do_mx_check (const Array<T>& a,
              bool (*op) (std::size_t, const T *))
 {
-  return op (a.numel (), a.data ());
+  octave_idx_type n = a.numel ();
+  const T *ap = a.data ();
+
+  if (! octave::use_parallel_loop (n))
+    return op (n, ap);
+
+  const bool empty_result = op (0, ap);
+  const octave_idx_type block_size = 4096;
+  octave_idx_type nblocks = (n + block_size - 1) / block_size;
+
+  std::atomic<bool> decided (false);
+
+  octave::parallel_for (nblocks, [=, &decided] (octave_idx_type b0,
+                                                octave_idx_type b1)
+  {
+    for (octave_idx_type b = b0; b < b1; b++)
+      {
+        if (decided.load (std::memory_order_relaxed))
+          return;
+
+        octave_idx_type i0 = b * block_size;
+        octave_idx_type len = std::min (block_size, n - i0);
+
+        if (op (len, ap + i0) != empty_result)
+          {
+            decided = true;
+            return;
+          }
+      }
+  }, block_size);
+
+  return decided ? ! empty_result : empty_result;
 }
 
 // NOTE: we don't use std::norm because it typically does some heavyweight
@@ -754,16 +994,83 @@ op_dble_sum (double& ac, const octave_int<T>& el)
     return ac;                                  \
   }
 
+// Sums and products of long floating-point vectors are computed in
+// blocks of a fixed number of elements, possibly in parallel, and the
+// results of the blocks are combined in order.  The result therefore
+// does not depend on the number of threads.  Integer results are
+// always accumulated in one pass because saturation makes their
+// arithmetic non-associative.
+
+const octave_idx_type mx_inline_red_block_size = 32768;
+
+template <typename T>
+struct mx_inline_red_blocked : public std::is_floating_point<T>
+{ };
+
+template <typename T>
+struct mx_inline_red_blocked<std::complex<T>> : public std::true_type
+{ };
+
+template <typename TRES, typename TSRC, typename COMBINE>
+inline TRES
+mx_inline_blocked_red (const TSRC *v, octave_idx_type n, TRES zero,
+                       TRES (*red) (const TSRC *, octave_idx_type),
+                       COMBINE combine)
+{
+  if (! mx_inline_red_blocked<TRES>::value
+      || n <= mx_inline_red_block_size)
+    return red (v, n);
+
+  const octave_idx_type bs = mx_inline_red_block_size;
+  octave_idx_type nblocks = (n + bs - 1) / bs;
+
+  OCTAVE_LOCAL_BUFFER (TRES, part, nblocks);
+
+  octave::maybe_parallel_for (nblocks, [=] (octave_idx_type b0,
+                                            octave_idx_type b1)
+  {
+    for (octave_idx_type b = b0; b < b1; b++)
+      part[b] = red (v + b*bs, std::min (bs, n - b*bs));
+  }, bs);
+
+  TRES ac = zero;
+  for (octave_idx_type b = 0; b < nblocks; b++)
+    combine (ac, part[b]);
+  return ac;
+}
+
+#define OP_RED_FCN_BLOCKED(F, TSRC, TRES, OP, ZERO, COMBINE)            \
+  template <typename T>                                                 \
+  inline TRES                                                           \
+  F ## _block (const TSRC *v, octave_idx_type n)                        \
+  {                                                                     \
+    TRES ac = ZERO;                                                     \
+    for (octave_idx_type i = 0; i < n; i++)                             \
+      OP(ac, v[i]);                                                     \
+    return ac;                                                          \
+  }                                                                     \
+  template <typename T>                                                 \
+  inline TRES                                                           \
+  F (const TSRC *v, octave_idx_type n)                                  \
+  {                                                                     \
+    return mx_inline_blocked_red<TRES>                                  \
+           (v, n, ZERO, F ## _block<T>,                                 \
+            [] (TRES& ac, const TRES& el) { COMBINE (ac, el); });       \
+  }
+
 #define PROMOTE_DOUBLE(T)                                       \
   typename subst_template_param<std::complex, T, double>::type
 
-OP_RED_FCN (mx_inline_sum, T, T, OP_RED_SUM, 0)
-OP_RED_FCN (mx_inline_dsum, T, PROMOTE_DOUBLE(T), op_dble_sum, 0.0)
-OP_RED_FCN (mx_inline_count, bool, T, OP_RED_SUM, 0)
-OP_RED_FCN (mx_inline_prod, T, T, OP_RED_PROD, 1)
-OP_RED_FCN (mx_inline_dprod, T, PROMOTE_DOUBLE(T), op_dble_prod, 1)
-OP_RED_FCN (mx_inline_sumsq, T, T, OP_RED_SUMSQ, 0)
-OP_RED_FCN (mx_inline_sumsq, std::complex<T>, T, OP_RED_SUMSQC, 0)
+OP_RED_FCN_BLOCKED (mx_inline_sum, T, T, OP_RED_SUM, 0, OP_RED_SUM)
+OP_RED_FCN_BLOCKED (mx_inline_dsum, T, PROMOTE_DOUBLE(T), op_dble_sum, 0.0,
+                    OP_RED_SUM)
+OP_RED_FCN_BLOCKED (mx_inline_count, bool, T, OP_RED_SUM, 0, OP_RED_SUM)
+OP_RED_FCN_BLOCKED (mx_inline_prod, T, T, OP_RED_PROD, 1, OP_RED_PROD)
+OP_RED_FCN_BLOCKED (mx_inline_dprod, T, PROMOTE_DOUBLE(T), op_dble_prod, 1,
+                    OP_RED_PROD)
+OP_RED_FCN_BLOCKED (mx_inline_sumsq, T, T, OP_RED_SUMSQ, 0, OP_RED_SUM)
+OP_RED_FCN_BLOCKED (mx_inline_sumsq, std::complex<T>, T, OP_RED_SUMSQC, 0,
+                    OP_RED_SUM)
 OP_RED_FCN (mx_inline_any, T, bool, OP_RED_ANYC, false)
 OP_RED_FCN (mx_inline_all, T, bool, OP_RED_ALLC, true)
 
@@ -887,7 +1194,8 @@ OP_CUM_FCN (mx_inline_cumcount, bool, T, +)
 #define OP_CUM_FCN2(F, TSRC, TRES, OP)                                  \
   template <typename T>                                                 \
   inline void                                                           \
-  F (const TSRC *v, TRES *r, octave_idx_type m, octave_idx_type n)      \
+  F (const TSRC *v, TRES *r, octave_idx_type m, octave_idx_type n,      \
+     octave_idx_type s)                                                 \
   {                                                                     \
     if (n)                                                              \
       {                                                                 \
@@ -896,10 +1204,10 @@ OP_CUM_FCN (mx_inline_cumcount, bool, T, +)
         const T *r0 = r;                                                \
         for (octave_idx_type j = 1; j < n; j++)                         \
           {                                                             \
-            r += m; v += m;                                             \
+            r += s; v += s;                                             \
             for (octave_idx_type i = 0; i < m; i++)                     \
               r[i] = r0[i] OP v[i];                                     \
-            r0 += m;                                                    \
+            r0 += s;                                                    \
           }                                                             \
       }                                                                 \
   }
@@ -908,30 +1216,31 @@ OP_CUM_FCN2 (mx_inline_cumsum, T, T, +)
 OP_CUM_FCN2 (mx_inline_cumprod, T, T, *)
 OP_CUM_FCN2 (mx_inline_cumcount, bool, T, +)
 
-#define OP_CUM_FCNN(F, TSRC, TRES)              \
-  template <typename T>                         \
-  inline void                                   \
-  F (const TSRC *v, TRES *r, octave_idx_type l, \
-     octave_idx_type n, octave_idx_type u)      \
-  {                                             \
-    if (l == 1)                                 \
-      {                                         \
-        for (octave_idx_type i = 0; i < u; i++) \
-          {                                     \
-            F (v, r, n);                        \
-            v += n;                             \
-            r += n;                             \
-          }                                     \
-      }                                         \
-    else                                        \
-      {                                         \
-        for (octave_idx_type i = 0; i < u; i++) \
-          {                                     \
-            F (v, r, l, n);                     \
-            v += l*n;                           \
-            r += l*n;                           \
-          }                                     \
-      }                                         \
+#define OP_CUM_FCNN(F, TSRC, TRES)                              \
+  template <typename T>                                         \
+  inline void                                                   \
+  F (const TSRC *v, TRES *r, octave_idx_type l,                 \
+     octave_idx_type n, octave_idx_type u,                      \
+     octave_idx_type l0, octave_idx_type l1)                    \
+  {                                                             \
+    if (l == 1)                                                 \
+      {                                                         \
+        for (octave_idx_type i = 0; i < u; i++)                 \
+          {                                                     \
+            F (v, r, n);                                        \
+            v += n;                                             \
+            r += n;                                             \
+          }                                                     \
+      }                                                         \
+    else                                                        \
+      {                                                         \
+        for (octave_idx_type i = 0; i < u; i++)                 \
+          {                                                     \
+            F (v + l0, r + l0, l1 - l0, n, l);                  \
+            v += l*n;                                           \
+            r += l*n;                                           \
+          }                                                     \
+      }                                                         \
   }
 
 OP_CUM_FCNN (mx_inline_cumsum, T, T)
@@ -1216,7 +1525,8 @@ OP_CUMMINMAX_FCN (mx_inline_cummax, >)
 #define OP_CUMMINMAX_FCN2(F, OP)                                        \
   template <typename T>                                                 \
   inline void                                                           \
-  F (const T *v, T *r, octave_idx_type m, octave_idx_type n)            \
+  F (const T *v, T *r, octave_idx_type m, octave_idx_type n,            \
+     octave_idx_type s)                                                 \
   {                                                                     \
     if (! n)                                                            \
       return;                                                           \
@@ -1230,9 +1540,9 @@ OP_CUMMINMAX_FCN (mx_inline_cummax, >)
           nan = true;                                                   \
       }                                                                 \
     j++;                                                                \
-    v += m;                                                             \
+    v += s;                                                             \
     r0 = r;                                                             \
-    r += m;                                                             \
+    r += s;                                                             \
     while (nan && j < n)                                                \
       {                                                                 \
         nan = false;                                                    \
@@ -1249,9 +1559,9 @@ OP_CUMMINMAX_FCN (mx_inline_cummax, >)
               r[i] = r0[i];                                             \
           }                                                             \
         j++;                                                            \
-        v += m;                                                         \
+        v += s;                                                         \
         r0 = r;                                                         \
-        r += m;                                                         \
+        r += s;                                                         \
       }                                                                 \
     while (j < n)                                                       \
       {                                                                 \
@@ -1261,15 +1571,15 @@ OP_CUMMINMAX_FCN (mx_inline_cummax, >)
           else                                                          \
             r[i] = r0[i];                                               \
         j++;                                                            \
-        v += m;                                                         \
+        v += s;                                                         \
         r0 = r;                                                         \
-        r += m;                                                         \
+        r += s;                                                         \
       }                                                                 \
   }                                                                     \
   template <typename T>                                                 \
   inline void                                                           \
   F (const T *v, T *r, octave_idx_type *ri,                             \
-     octave_idx_type m, octave_idx_type n)                              \
+     octave_idx_type m, octave_idx_type n, octave_idx_type s)           \
   {                                                                     \
     if (! n)                                                            \
       return;                                                           \
@@ -1284,11 +1594,11 @@ OP_CUMMINMAX_FCN (mx_inline_cummax, >)
           nan = true;                                                   \
       }                                                                 \
     j++;                                                                \
-    v += m;                                                             \
+    v += s;                                                             \
     r0 = r;                                                             \
-    r += m;                                                             \
+    r += s;                                                             \
     r0i = ri;                                                           \
-    ri += m;                                                            \
+    ri += s;                                                            \
     while (nan && j < n)                                                \
       {                                                                 \
         nan = false;                                                    \
@@ -1312,11 +1622,11 @@ OP_CUMMINMAX_FCN (mx_inline_cummax, >)
               }                                                         \
           }                                                             \
         j++;                                                            \
-        v += m;                                                         \
+        v += s;                                                         \
         r0 = r;                                                         \
-        r += m;                                                         \
+        r += s;                                                         \
         r0i = ri;                                                       \
-        ri += m;                                                        \
+        ri += s;                                                        \
       }                                                                 \
     while (j < n)                                                       \
       {                                                                 \
@@ -1332,11 +1642,11 @@ OP_CUMMINMAX_FCN (mx_inline_cummax, >)
               ri[i] = r0i[i];                                           \
             }                                                           \
         j++;                                                            \
-        v += m;                                                         \
+        v += s;                                                         \
         r0 = r;                                                         \
-        r += m;                                                         \
+        r += s;                                                         \
         r0i = ri;                                                       \
-        ri += m;                                                        \
+        ri += s;                                                        \
       }                                                                 \
   }
 
@@ -1347,7 +1657,8 @@ OP_CUMMINMAX_FCN2 (mx_inline_cummax, >)
   template <typename T>                                         \
   inline void                                                   \
   F (const T *v, T *r, octave_idx_type l,                       \
-     octave_idx_type n, octave_idx_type u)                      \
+     octave_idx_type n, octave_idx_type u,                      \
+     octave_idx_type l0, octave_idx_type l1)                    \
   {                                                             \
     if (! n)                                                    \
       return;                                                   \
@@ -1364,7 +1675,7 @@ OP_CUMMINMAX_FCN2 (mx_inline_cummax, >)
       {                                                         \
         for (octave_idx_type i = 0; i < u; i++)                 \
           {                                                     \
-            F (v, r, l, n);                                     \
+            F (v + l0, r + l0, l1 - l0, n, l);                  \
             v += l*n;                                           \
             r += l*n;                                           \
           }                                                     \
@@ -1373,7 +1684,8 @@ OP_CUMMINMAX_FCN2 (mx_inline_cummax, >)
   template <typename T>                                         \
   inline void                                                   \
   F (const T *v, T *r, octave_idx_type *ri,                     \
-     octave_idx_type l, octave_idx_type n, octave_idx_type u)   \
+     octave_idx_type l, octave_idx_type n, octave_idx_type u,   \
+     octave_idx_type l0, octave_idx_type l1)                    \
   {                                                             \
     if (! n)                                                    \
       return;                                                   \
@@ -1391,7 +1703,7 @@ OP_CUMMINMAX_FCN2 (mx_inline_cummax, >)
       {                                                         \
         for (octave_idx_type i = 0; i < u; i++)                 \
           {                                                     \
-            F (v, r, ri, l, n);                                 \
+            F (v + l0, r + l0, ri + l0, l1 - l0, n, l);         \
             v += l*n;                                           \
             r += l*n;                                           \
             ri += l*n;                                          \
@@ -1446,20 +1758,23 @@ void mx_inline_diff (const T *v, T *r, octave_idx_type n,
 template <typename T>
 void
 mx_inline_diff (const T *v, T *r,
-                octave_idx_type m, octave_idx_type n,
+                octave_idx_type m, octave_idx_type n, octave_idx_type s,
                 octave_idx_type order)
 {
   switch (order)
     {
     case 1:
-      for (octave_idx_type i = 0; i < m*(n-1); i++)
-        r[i] = v[i+m] - v[i];
+      for (octave_idx_type i = 0; i < n-1; i++)
+        {
+          for (octave_idx_type j = i*s; j < i*s+m; j++)
+            r[j] = v[j+s] - v[j];
+        }
       break;
     case 2:
       for (octave_idx_type i = 0; i < n-2; i++)
         {
-          for (octave_idx_type j = i*m; j < i*m+m; j++)
-            r[j] = (v[j+m+m] - v[j+m]) - (v[j+m] - v[j]);
+          for (octave_idx_type j = i*s; j < i*s+m; j++)
+            r[j] = (v[j+s+s] - v[j+s]) - (v[j+s] - v[j]);
         }
       break;
     default:
@@ -1469,7 +1784,7 @@ mx_inline_diff (const T *v, T *r,
         for (octave_idx_type j = 0; j < m; j++)
           {
             for (octave_idx_type i = 0; i < n-1; i++)
-              buf[i] = v[i*m+j+m] - v[i*m+j];
+              buf[i] = v[i*s+j+s] - v[i*s+j];
 
             for (octave_idx_type o = 2; o <= order; o++)
               {
@@ -1478,7 +1793,7 @@ mx_inline_diff (const T *v, T *r,
               }
 
             for (octave_idx_type i = 0; i < n-order; i++)
-              r[i*m+j] = buf[i];
+              r[i*s+j] = buf[i];
           }
       }
     }
@@ -1488,7 +1803,7 @@ template <typename T>
 inline void
 mx_inline_diff (const T *v, T *r,
                 octave_idx_type l, octave_idx_type n, octave_idx_type u,
-                octave_idx_type order)
+                octave_idx_type order, octave_idx_type l0, octave_idx_type l1)
 {
   if (! n) return;
   if (l == 1)
@@ -1503,7 +1818,7 @@ mx_inline_diff (const T *v, T *r,
     {
       for (octave_idx_type i = 0; i < u; i++)
         {
-          mx_inline_diff (v, r, l, n, order);
+          mx_inline_diff (v + l0, r + l0, l1 - l0, n, l, order);
           v += l*n;
           r += l*(n-order);
         }
@@ -1561,7 +1876,14 @@ do_mx_red_op (const Array<T>& src, int dim,
   dims.chop_trailing_singletons ();
 
   Array<R> ret (dims);
-  mx_red_op (src.data (), ret.rwdata (), l, n, u);
+  const T *sp = src.data ();
+  R *rp = ret.rwdata ();
+
+  // Slices are independent, so they may be reduced in parallel.
+  octave::maybe_parallel_for (u, [=] (octave_idx_type i0, octave_idx_type i1)
+  {
+    mx_red_op (sp + i0*l*n, rp + i0*l, l, n, i1 - i0);
+  }, l*n);
 
   return ret;
 }
@@ -1570,6 +1892,7 @@ template <typename R, typename T>
 inline Array<R>
 do_mx_cum_op (const Array<T>& src, int dim,
               void (*mx_cum_op) (const T *, R *, octave_idx_type,
+                                 octave_idx_type, octave_idx_type,
                                  octave_idx_type, octave_idx_type))
 {
   octave_idx_type l, n, u;
@@ -1578,7 +1901,16 @@ do_mx_cum_op (const Array<T>& src, int dim,
 
   // Cumulative operation doesn't reduce the array size.
   Array<R> ret (dims);
-  mx_cum_op (src.data (), ret.rwdata (), l, n, u);
+  const T *sp = src.data ();
+  R *rp = ret.rwdata ();
+
+  octave::parallel_for_slices (l, n, u, [=] (octave_idx_type l0,
+                                             octave_idx_type l1,
+                                             octave_idx_type u0,
+                                             octave_idx_type u1)
+  {
+    mx_cum_op (sp + u0*l*n, rp + u0*l*n, l, n, u1 - u0, l0, l1);
+  });
 
   return ret;
 }
@@ -1598,7 +1930,13 @@ do_mx_minmax_op (const Array<R>& src, int dim,
   dims.chop_trailing_singletons ();
 
   Array<R> ret (dims);
-  mx_minmax_op (src.data (), ret.rwdata (), l, n, u);
+  const R *sp = src.data ();
+  R *rp = ret.rwdata ();
+
+  octave::maybe_parallel_for (u, [=] (octave_idx_type i0, octave_idx_type i1)
+  {
+    mx_minmax_op (sp + i0*l*n, rp + i0*l, l, n, i1 - i0);
+  }, l*n);
 
   return ret;
 }
@@ -1620,8 +1958,14 @@ do_mx_minmax_op (const Array<R>& src, Array<octave_idx_type>& idx, int dim,
   Array<R> ret (dims);
   if (idx.dims () != dims) idx = Array<octave_idx_type> (dims);
 
-  mx_minmax_op (src.data (), ret.rwdata (), idx.rwdata (),
-                l, n, u);
+  const R *sp = src.data ();
+  R *rp = ret.rwdata ();
+  octave_idx_type *ip = idx.rwdata ();
+
+  octave::maybe_parallel_for (u, [=] (octave_idx_type i0, octave_idx_type i1)
+  {
+    mx_minmax_op (sp + i0*l*n, rp + i0*l, ip + i0*l, l, n, i1 - i0);
+  }, l*n);
 
   return ret;
 }
@@ -1630,6 +1974,7 @@ template <typename R>
 inline Array<R>
 do_mx_cumminmax_op (const Array<R>& src, int dim,
                     void (*mx_cumminmax_op) (const R *, R *, octave_idx_type,
+                                             octave_idx_type, octave_idx_type,
                                              octave_idx_type, octave_idx_type))
 {
   octave_idx_type l, n, u;
@@ -1637,7 +1982,16 @@ do_mx_cumminmax_op (const Array<R>& src, int dim,
   get_extent_triplet (dims, dim, l, n, u);
 
   Array<R> ret (dims);
-  mx_cumminmax_op (src.data (), ret.rwdata (), l, n, u);
+  const R *sp = src.data ();
+  R *rp = ret.rwdata ();
+
+  octave::parallel_for_slices (l, n, u, [=] (octave_idx_type l0,
+                                             octave_idx_type l1,
+                                             octave_idx_type u0,
+                                             octave_idx_type u1)
+  {
+    mx_cumminmax_op (sp + u0*l*n, rp + u0*l*n, l, n, u1 - u0, l0, l1);
+  });
 
   return ret;
 }
@@ -1646,7 +2000,8 @@ template <typename R>
 inline Array<R>
 do_mx_cumminmax_op (const Array<R>& src, Array<octave_idx_type>& idx, int dim,
                     void (*mx_cumminmax_op) (const R *, R *, octave_idx_type *,
-                                             octave_idx_type, octave_idx_type, octave_idx_type))
+                                             octave_idx_type, octave_idx_type, octave_idx_type,
+                                             octave_idx_type, octave_idx_type))
 {
   octave_idx_type l, n, u;
   const dim_vector& dims = src.dims ();
@@ -1655,8 +2010,18 @@ do_mx_cumminmax_op (const Array<R>& src, Array<octave_idx_type>& idx, int dim,
   Array<R> ret (dims);
   if (idx.dims () != dims) idx = Array<octave_idx_type> (dims);
 
-  mx_cumminmax_op (src.data (), ret.rwdata (), idx.rwdata (),
-                   l, n, u);
+  const R *sp = src.data ();
+  R *rp = ret.rwdata ();
+  octave_idx_type *ip = idx.rwdata ();
+
+  octave::parallel_for_slices (l, n, u, [=] (octave_idx_type l0,
+                                             octave_idx_type l1,
+                                             octave_idx_type u0,
+                                             octave_idx_type u1)
+  {
+    mx_cumminmax_op (sp + u0*l*n, rp + u0*l*n, ip + u0*l*n, l, n, u1 - u0,
+                     l0, l1);
+  });
 
   return ret;
 }
@@ -1665,6 +2030,7 @@ template <typename R>
 inline Array<R>
 do_mx_diff_op (const Array<R>& src, int dim, octave_idx_type order,
                void (*mx_diff_op) (const R *, R *,
+                                   octave_idx_type, octave_idx_type,
                                    octave_idx_type, octave_idx_type,
                                    octave_idx_type, octave_idx_type))
 {
@@ -1689,7 +2055,17 @@ do_mx_diff_op (const Array<R>& src, int dim, octave_idx_type order,
     }
 
   Array<R> ret (dims);
-  mx_diff_op (src.data (), ret.rwdata (), l, n, u, order);
+  const R *sp = src.data ();
+  R *rp = ret.rwdata ();
+
+  octave::parallel_for_slices (l, n, u, [=] (octave_idx_type l0,
+                                             octave_idx_type l1,
+                                             octave_idx_type u0,
+                                             octave_idx_type u1)
+  {
+    mx_diff_op (sp + u0*l*n, rp + u0*l*(n-order), l, n, u1 - u0, order,
+                l0, l1);
+  });
 
   return ret;
 }
@@ -0,0 +1,668 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "mx-simd.h"
+
+// The kernels for each instruction set are compiled with the target
+// attribute, so the rest of Octave does not need to be compiled for a
+// particular processor.
+
+#if (defined (__x86_64__) || defined (__i386__)) \
+    && (defined (__GNUC__) || defined (__clang__))
+#  define OCTAVE_MX_SIMD_X86 1
+#  include <immintrin.h>
+#  define OCTAVE_AVX2 __attribute__ ((target ("avx2")))
+#  define OCTAVE_AVX512 __attribute__ ((target ("avx512f,avx512bw")))
+#endif
+
+static_assert (sizeof (bool) == 1, "mx-simd.cc: bool must be one byte");
+
+static mx_simd_level
+detect_level ()
+{
+#if defined (OCTAVE_MX_SIMD_X86)
+  __builtin_cpu_init ();
+
+  if (__builtin_cpu_supports ("avx512f") && __builtin_cpu_supports ("avx512bw"))
+    return MX_SIMD_AVX512;
+
+  if (__builtin_cpu_supports ("avx2"))
+    return MX_SIMD_AVX2;
+#endif
+
+  return MX_SIMD_NONE;
+}
+
+static std::atomic<mx_simd_level>&
+current_level ()
+{
+  static std::atomic<mx_simd_level> s_level (mx_simd_max_level ());
+
+  return s_level;
+}
+
+mx_simd_level
+mx_simd_max_level ()
+{
+  static const mx_simd_level s_max_level = detect_level ();
+
+  return s_max_level;
+}
+
+mx_simd_level
+mx_simd_current_level ()
+{
+  return current_level ().load (std::memory_order_relaxed);
+}
+
+mx_simd_level
+mx_simd_set_level (mx_simd_level level)
+{
+  return current_level ().exchange (std::min (level, mx_simd_max_level ()));
+}
+
+// Scalar operations.  They are used for processors without SIMD
+// instructions and for the elements that do not fill a whole vector.
+
+template <typename T, typename W>
+static inline T
+saturate (W t)
+{
+  return (t < std::numeric_limits<T>::min () ? std::numeric_limits<T>::min ()
+          : t > std::numeric_limits<T>::max () ? std::numeric_limits<T>::max ()
+          : static_cast<T> (t));
+}
+
+template <typename T>
+static inline T
+op_add (T x, T y)
+{
+  return saturate<T> (static_cast<int32_t> (x) + y);
+}
+
+template <typename T>
+static inline T
+op_sub (T x, T y)
+{
+  return saturate<T> (static_cast<int32_t> (x) - y);
+}
+
+template <typename T>
+static inline T
+op_mul (T x, T y)
+{
+  return saturate<T> (static_cast<int64_t> (x) * y);
+}
+
+template <typename T> static inline bool op_lt (T x, T y) { return x < y; }
+template <typename T> static inline bool op_le (T x, T y) { return x <= y; }
+template <typename T> static inline bool op_gt (T x, T y) { return x > y; }
+template <typename T> static inline bool op_ge (T x, T y) { return x >= y; }
+template <typename T> static inline bool op_eq (T x, T y) { return x == y; }
+template <typename T> static inline bool op_ne (T x, T y) { return x != y; }
+
+// Same as octave::math::max and octave::math::min.
+
+template <typename T>
+static inline T
+op_max (T x, T y)
+{
+  return std::isnan (y) ? x : (x >= y ? x : y);
+}
+
+template <typename T>
+static inline T
+op_min (T x, T y)
+{
+  return std::isnan (y) ? x : (x <= y ? x : y);
+}
+
+template <typename R, typename T, R (*OP) (T, T)>
+static inline void
+generic_op (std::size_t n, R *r, const T *x, const T *y)
+{
+  for (std::size_t i = 0; i < n; i++)
+    r[i] = OP (x[i], y[i]);
+}
+
+template <typename R, typename T, R (*OP) (T, T)>
+static inline void
+generic_op (std::size_t n, R *r, const T *x, T y)
+{
+  for (std::size_t i = 0; i < n; i++)
+    r[i] = OP (x[i], y);
+}
+
+template <typename R, typename T, R (*OP) (T, T)>
+static inline void
+generic_op (std::size_t n, R *r, T x, const T *y)
+{
+  for (std::size_t i = 0; i < n; i++)
+    r[i] = OP (x, y[i]);
+}
+
+#if defined (OCTAVE_MX_SIMD_X86)
+
+// Integer kernels.  The vector operation VOP is applied to whole
+// vectors of elements and the scalar operation SOP to the remaining
+// elements.
+
+#define SIMD_INT_BINOP(F, ATTR, V, LOAD, STORE, T, SET1, VOP, SOP)      \
+  static ATTR void                                                      \
+  F (std::size_t n, T *r, const T *x, const T *y)                       \
+  {                                                                     \
+    const std::size_t w = sizeof (V) / sizeof (T);                      \
+    std::size_t i = 0;                                                  \
+    for (; i + w <= n; i += w)                                          \
+      STORE (r + i, VOP (LOAD (x + i), LOAD (y + i)));                  \
+    for (; i < n; i++)                                                  \
+      r[i] = SOP (x[i], y[i]);                                          \
+  }                                                                     \
+  static ATTR void                                                      \
+  F (std::size_t n, T *r, const T *x, T y)                              \
+  {                                                                     \
+    const std::size_t w = sizeof (V) / sizeof (T);                      \
+    const V yv = SET1 (y);                                              \
+    std::size_t i = 0;                                                  \
+    for (; i + w <= n; i += w)                                          \
+      STORE (r + i, VOP (LOAD (x + i), yv));                            \
+    for (; i < n; i++)                                                  \
+      r[i] = SOP (x[i], y);                                             \
+  }                                                                     \
+  static ATTR void                                                      \
+  F (std::size_t n, T *r, T x, const T *y)                              \
+  {                                                                     \
+    const std::size_t w = sizeof (V) / sizeof (T);                      \
+    const V xv = SET1 (x);                                              \
+    std::size_t i = 0;                                                  \
+    for (; i + w <= n; i += w)                                          \
+      STORE (r + i, VOP (xv, LOAD (y + i)));                            \
+    for (; i < n; i++)                                                  \
+      r[i] = SOP (x, y[i]);                                             \
+  }
+
+static OCTAVE_AVX2 inline __m256i
+avx2_load (const void *p)
+{
+  return _mm256_loadu_si256 (static_cast<const __m256i *> (p));
+}
+
+static OCTAVE_AVX2 inline void
+avx2_store (void *p, __m256i v)
+{
+  _mm256_storeu_si256 (static_cast<__m256i *> (p), v);
+}
+
+static OCTAVE_AVX2 inline __m256i
+avx2_set1_8 (char x)
+{
+  return _mm256_set1_epi8 (x);
+}
+
+static OCTAVE_AVX2 inline __m256i
+avx2_set1_16 (short x)
+{
+  return _mm256_set1_epi16 (x);
+}
+
+// Saturating products.  The exact products are computed in wider
+// elements and packed again with saturation.  The pack instructions
+// work within 128-bit lanes, so the order of the 8-bit results has to
+// be restored by a permutation.
+
+static OCTAVE_AVX2 inline __m256i
+avx2_mul_i16 (__m256i a, __m256i b)
+{
+  __m256i lo = _mm256_mullo_epi16 (a, b);
+  __m256i hi = _mm256_mulhi_epi16 (a, b);
+
+  return _mm256_packs_epi32 (_mm256_unpacklo_epi16 (lo, hi),
+                             _mm256_unpackhi_epi16 (lo, hi));
+}
+
+static OCTAVE_AVX2 inline __m256i
+avx2_mul_u16 (__m256i a, __m256i b)
+{
+  __m256i lo = _mm256_mullo_epi16 (a, b);
+  __m256i hi = _mm256_mulhi_epu16 (a, b);
+  __m256i max = _mm256_set1_epi32 (0xFFFF);
+
+  return _mm256_packus_epi32
+    (_mm256_min_epu32 (_mm256_unpacklo_epi16 (lo, hi), max),
+     _mm256_min_epu32 (_mm256_unpackhi_epi16 (lo, hi), max));
+}
+
+static OCTAVE_AVX2 inline __m256i
+avx2_mul_i8 (__m256i a, __m256i b)
+{
+  __m256i p0 = _mm256_mullo_epi16
+    (_mm256_cvtepi8_epi16 (_mm256_castsi256_si128 (a)),
+     _mm256_cvtepi8_epi16 (_mm256_castsi256_si128 (b)));
+  __m256i p1 = _mm256_mullo_epi16
+    (_mm256_cvtepi8_epi16 (_mm256_extracti128_si256 (a, 1)),
+     _mm256_cvtepi8_epi16 (_mm256_extracti128_si256 (b, 1)));
+
+  return _mm256_permute4x64_epi64 (_mm256_packs_epi16 (p0, p1), 0xD8);
+}
+
+static OCTAVE_AVX2 inline __m256i
+avx2_mul_u8 (__m256i a, __m256i b)
+{
+  __m256i max = _mm256_set1_epi16 (0xFF);
+  __m256i p0 = _mm256_mullo_epi16
+    (_mm256_cvtepu8_epi16 (_mm256_castsi256_si128 (a)),
+     _mm256_cvtepu8_epi16 (_mm256_castsi256_si128 (b)));
+  __m256i p1 = _mm256_mullo_epi16
+    (_mm256_cvtepu8_epi16 (_mm256_extracti128_si256 (a, 1)),
+     _mm256_cvtepu8_epi16 (_mm256_extracti128_si256 (b, 1)));
+
+  return _mm256_permute4x64_epi64
+    (_mm256_packus_epi16 (_mm256_min_epu16 (p0, max),
+                          _mm256_min_epu16 (p1, max)), 0xD8);
+}
+
+#define AVX2_INT_BINOP(F, T, SET1, VOP, SOP)                            \
+  SIMD_INT_BINOP (F, OCTAVE_AVX2, __m256i, avx2_load, avx2_store,       \
+                  T, SET1, VOP, SOP)
+
+AVX2_INT_BINOP (avx2_add, int8_t, avx2_set1_8, _mm256_adds_epi8, op_add)
+AVX2_INT_BINOP (avx2_add, uint8_t, avx2_set1_8, _mm256_adds_epu8, op_add)
+AVX2_INT_BINOP (avx2_add, int16_t, avx2_set1_16, _mm256_adds_epi16, op_add)
+AVX2_INT_BINOP (avx2_add, uint16_t, avx2_set1_16, _mm256_adds_epu16, op_add)
+
+AVX2_INT_BINOP (avx2_sub, int8_t, avx2_set1_8, _mm256_subs_epi8, op_sub)
+AVX2_INT_BINOP (avx2_sub, uint8_t, avx2_set1_8, _mm256_subs_epu8, op_sub)
+AVX2_INT_BINOP (avx2_sub, int16_t, avx2_set1_16, _mm256_subs_epi16, op_sub)
+AVX2_INT_BINOP (avx2_sub, uint16_t, avx2_set1_16, _mm256_subs_epu16, op_sub)
+
+AVX2_INT_BINOP (avx2_mul, int8_t, avx2_set1_8, avx2_mul_i8, op_mul)
+AVX2_INT_BINOP (avx2_mul, uint8_t, avx2_set1_8, avx2_mul_u8, op_mul)
+AVX2_INT_BINOP (avx2_mul, int16_t, avx2_set1_16, avx2_mul_i16, op_mul)
+AVX2_INT_BINOP (avx2_mul, uint16_t, avx2_set1_16, avx2_mul_u16, op_mul)
+
+static OCTAVE_AVX512 inline __m512i
+avx512_load (const void *p)
+{
+  return _mm512_loadu_si512 (p);
+}
+
+static OCTAVE_AVX512 inline void
+avx512_store (void *p, __m512i v)
+{
+  _mm512_storeu_si512 (p, v);
+}
+
+static OCTAVE_AVX512 inline __m512i
+avx512_set1_8 (char x)
+{
+  return _mm512_set1_epi8 (x);
+}
+
+static OCTAVE_AVX512 inline __m512i
+avx512_set1_16 (short x)
+{
+  return _mm512_set1_epi16 (x);
+}
+
+#define AVX512_INT_BINOP(F, T, SET1, VOP, SOP)                          \
+  SIMD_INT_BINOP (F, OCTAVE_AVX512, __m512i, avx512_load, avx512_store, \
+                  T, SET1, VOP, SOP)
+
+AVX512_INT_BINOP (avx512_add, int8_t, avx512_set1_8, _mm512_adds_epi8, op_add)
+AVX512_INT_BINOP (avx512_add, uint8_t, avx512_set1_8, _mm512_adds_epu8, op_add)
+AVX512_INT_BINOP (avx512_add, int16_t, avx512_set1_16, _mm512_adds_epi16,
+                  op_add)
+AVX512_INT_BINOP (avx512_add, uint16_t, avx512_set1_16, _mm512_adds_epu16,
+                  op_add)
+
+AVX512_INT_BINOP (avx512_sub, int8_t, avx512_set1_8, _mm512_subs_epi8, op_sub)
+AVX512_INT_BINOP (avx512_sub, uint8_t, avx512_set1_8, _mm512_subs_epu8, op_sub)
+AVX512_INT_BINOP (avx512_sub, int16_t, avx512_set1_16, _mm512_subs_epi16,
+                  op_sub)
+AVX512_INT_BINOP (avx512_sub, uint16_t, avx512_set1_16, _mm512_subs_epu16,
+                  op_sub)
+
+// Floating point kernels.  Comparisons produce a bit mask that is
+// expanded to one bool per element.  The remaining elements are copied
+// to a full vector, so the scalar code does not need to repeat each
+// comparison.
+
+static OCTAVE_AVX2 inline __m256d
+avx2_load (const double *p)
+{
+  return _mm256_loadu_pd (p);
+}
+
+static OCTAVE_AVX2 inline __m256
+avx2_load (const float *p)
+{
+  return _mm256_loadu_ps (p);
+}
+
+static OCTAVE_AVX2 inline void
+avx2_store (double *p, __m256d v)
+{
+  _mm256_storeu_pd (p, v);
+}
+
+static OCTAVE_AVX2 inline void
+avx2_store (float *p, __m256 v)
+{
+  _mm256_storeu_ps (p, v);
+}
+
+static OCTAVE_AVX2 inline __m256d
+avx2_set1 (double x)
+{
+  return _mm256_set1_pd (x);
+}
+
+static OCTAVE_AVX2 inline __m256
+avx2_set1 (float x)
+{
+  return _mm256_set1_ps (x);
+}
+
+template <int CMP>
+static OCTAVE_AVX2 inline int
+avx2_cmp (__m256d a, __m256d b)
+{
+  return _mm256_movemask_pd (_mm256_cmp_pd (a, b, CMP));
+}
+
+template <int CMP>
+static OCTAVE_AVX2 inline int
+avx2_cmp (__m256 a, __m256 b)
+{
+  return _mm256_movemask_ps (_mm256_cmp_ps (a, b, CMP));
+}
+
+static OCTAVE_AVX2 inline __m256d
+avx2_blend (__m256d a, __m256d b, __m256d mask)
+{
+  return _mm256_blendv_pd (a, b, mask);
+}
+
+static OCTAVE_AVX2 inline __m256
+avx2_blend (__m256 a, __m256 b, __m256 mask)
+{
+  return _mm256_blendv_ps (a, b, mask);
+}
+
+template <int CMP>
+static OCTAVE_AVX2 inline __m256d
+avx2_cmp_mask (__m256d a, __m256d b)
+{
+  return _mm256_cmp_pd (a, b, CMP);
+}
+
+template <int CMP>
+static OCTAVE_AVX2 inline __m256
+avx2_cmp_mask (__m256 a, __m256 b)
+{
+  return _mm256_cmp_ps (a, b, CMP);
+}
+
+// Store the lowest W bits of MASK as bool values.
+
+template <std::size_t W>
+static inline void
+store_mask (bool *r, int mask, std::size_t nel = W)
+{
+  bool b[W];
+
+  for (std::size_t j = 0; j < W; j++)
+    b[j] = (mask >> j) & 1;
+
+  std::memcpy (r, b, nel);
+}
+
+template <int CMP, typename T>
+static OCTAVE_AVX2 void
+avx2_cmp (std::size_t n, bool *r, const T *x, const T *y)
+{
+  const std::size_t w = 32 / sizeof (T);
+  std::size_t i = 0;
+
+  for (; i + w <= n; i += w)
+    store_mask<w> (r + i, avx2_cmp<CMP> (avx2_load (x + i),
+                                          avx2_load (y + i)));
+  if (i < n)
+    {
+      T xb[w] = { }, yb[w] = { };
+      std::copy (x + i, x + n, xb);
+      std::copy (y + i, y + n, yb);
+      store_mask<w> (r + i, avx2_cmp<CMP> (avx2_load (xb), avx2_load (yb)),
+                     n - i);
+    }
+}
+
+template <int CMP, typename T>
+static OCTAVE_AVX2 void
+avx2_cmp (std::size_t n, bool *r, const T *x, T y)
+{
+  const std::size_t w = 32 / sizeof (T);
+  const auto yv = avx2_set1 (y);
+  std::size_t i = 0;
+
+  for (; i + w <= n; i += w)
+    store_mask<w> (r + i, avx2_cmp<CMP> (avx2_load (x + i), yv));
+  if (i < n)
+    {
+      T xb[w] = { };
+      std::copy (x + i, x + n, xb);
+      store_mask<w> (r + i, avx2_cmp<CMP> (avx2_load (xb), yv), n - i);
+    }
+}
+
+template <int CMP, typename T>
+static OCTAVE_AVX2 void
+avx2_cmp (std::size_t n, bool *r, T x, const T *y)
+{
+  const std::size_t w = 32 / sizeof (T);
+  const auto xv = avx2_set1 (x);
+  std::size_t i = 0;
+
+  for (; i + w <= n; i += w)
+    store_mask<w> (r + i, avx2_cmp<CMP> (xv, avx2_load (y + i)));
+  if (i < n)
+    {
+      T yb[w] = { };
+      std::copy (y + i, y + n, yb);
+      store_mask<w> (r + i, avx2_cmp<CMP> (xv, avx2_load (yb)), n - i);
+    }
+}
+
+// Element-wise max (CMP = _CMP_GE_OQ) or min (CMP = _CMP_LE_OQ).  As
+// in the scalar code, X is chosen if Y is NaN.
+
+template <int CMP, typename T>
+static OCTAVE_AVX2 void
+avx2_minmax (std::size_t n, T *r, const T *x, const T *y)
+{
+  const std::size_t w = 32 / sizeof (T);
+  std::size_t i = 0;
+
+  for (; i + w <= n; i += w)
+    {
+      auto a = avx2_load (x + i);
+      auto b = avx2_load (y + i);
+      auto t = avx2_blend (b, a, avx2_cmp_mask<CMP> (a, b));
+      avx2_store (r + i, avx2_blend (t, a, avx2_cmp_mask<_CMP_UNORD_Q> (b, b)));
+    }
+  for (; i < n; i++)
+    r[i] = (CMP == _CMP_GE_OQ ? op_max (x[i], y[i]) : op_min (x[i], y[i]));
+}
+
+template <typename T>
+static OCTAVE_AVX2 void
+avx2_isnan (std::size_t n, bool *r, const T *x)
+{
+  const std::size_t w = 32 / sizeof (T);
+  std::size_t i = 0;
+
+  for (; i + w <= n; i += w)
+    {
+      auto a = avx2_load (x + i);
+      store_mask<w> (r + i, avx2_cmp<_CMP_UNORD_Q> (a, a));
+    }
+  for (; i < n; i++)
+    r[i] = std::isnan (x[i]);
+}
+
+template <typename T>
+static OCTAVE_AVX2 bool
+avx2_any_nan (std::size_t n, const T *x)
+{
+  const std::size_t w = 32 / sizeof (T);
+  std::size_t i = 0;
+
+  for (; i + 4*w <= n; i += 4*w)
+    {
+      auto a0 = avx2_load (x + i);
+      auto a1 = avx2_load (x + i + w);
+      auto a2 = avx2_load (x + i + 2*w);
+      auto a3 = avx2_load (x + i + 3*w);
+      if (avx2_cmp<_CMP_UNORD_Q> (a0, a1) | avx2_cmp<_CMP_UNORD_Q> (a2, a3))
+        return true;
+    }
+  for (; i < n; i++)
+    if (std::isnan (x[i]))
+      return true;
+
+  return false;
+}
+
+#  define MX_SIMD_DISPATCH(AVX512_CALL, AVX2_CALL, GENERIC_CALL)        \
+  switch (mx_simd_current_level ())                                     \
+    {                                                                   \
+    case MX_SIMD_AVX512:                                                \
+      AVX512_CALL;                                                      \
+      break;                                                            \
+    case MX_SIMD_AVX2:                                                  \
+      AVX2_CALL;                                                        \
+      break;                                                            \
+    default:                                                            \
+      GENERIC_CALL;                                                     \
+      break;                                                            \
+    }
+
+#else
+
+#  define MX_SIMD_DISPATCH(AVX512_CALL, AVX2_CALL, GENERIC_CALL)        \
+  GENERIC_CALL;
+
+#endif
+
+// Public kernels.
+
+#define DEFINE_BINOP(F, R, T, AVX512_FCN, AVX2_FCN, GENERIC_FCN)        \
+  void                                                                  \
+  F (std::size_t n, R *r, const T *x, const T *y)                       \
+  {                                                                     \
+    MX_SIMD_DISPATCH (AVX512_FCN (n, r, x, y), AVX2_FCN (n, r, x, y),   \
+                      GENERIC_FCN (n, r, x, y))                         \
+  }                                                                     \
+  void                                                                  \
+  F (std::size_t n, R *r, const T *x, T y)                              \
+  {                                                                     \
+    MX_SIMD_DISPATCH (AVX512_FCN (n, r, x, y), AVX2_FCN (n, r, x, y),   \
+                      GENERIC_FCN (n, r, x, y))                         \
+  }                                                                     \
+  void                                                                  \
+  F (std::size_t n, R *r, T x, const T *y)                              \
+  {                                                                     \
+    MX_SIMD_DISPATCH (AVX512_FCN (n, r, x, y), AVX2_FCN (n, r, x, y),   \
+                      GENERIC_FCN (n, r, x, y))                         \
+  }
+
+#define DEFINE_INT_BINOPS(T)                                            \
+  DEFINE_BINOP (mx_simd_add, T, T, avx512_add, avx2_add,                \
+                (generic_op<T, T, op_add<T>>))                          \
+  DEFINE_BINOP (mx_simd_sub, T, T, avx512_sub, avx2_sub,                \
+                (generic_op<T, T, op_sub<T>>))                          \
+  DEFINE_BINOP (mx_simd_mul, T, T, avx2_mul, avx2_mul,                  \
+                (generic_op<T, T, op_mul<T>>))
+
+DEFINE_INT_BINOPS (int8_t)
+DEFINE_INT_BINOPS (uint8_t)
+DEFINE_INT_BINOPS (int16_t)
+DEFINE_INT_BINOPS (uint16_t)
+
+#define DEFINE_FLOAT_CMP(F, T, CMP, OP)                                 \
+  DEFINE_BINOP (F, bool, T, avx2_cmp<CMP>, avx2_cmp<CMP>,               \
+                (generic_op<bool, T, OP<T>>))
+
+#define DEFINE_FLOAT_OPS(T)                                             \
+  DEFINE_FLOAT_CMP (mx_simd_lt, T, _CMP_LT_OQ, op_lt)                   \
+  DEFINE_FLOAT_CMP (mx_simd_le, T, _CMP_LE_OQ, op_le)                   \
+  DEFINE_FLOAT_CMP (mx_simd_gt, T, _CMP_GT_OQ, op_gt)                   \
+  DEFINE_FLOAT_CMP (mx_simd_ge, T, _CMP_GE_OQ, op_ge)                   \
+  DEFINE_FLOAT_CMP (mx_simd_eq, T, _CMP_EQ_OQ, op_eq)                   \
+  DEFINE_FLOAT_CMP (mx_simd_ne, T, _CMP_NEQ_UQ, op_ne)                  \
+  void                                                                  \
+  mx_simd_max (std::size_t n, T *r, const T *x, const T *y)             \
+  {                                                                     \
+    MX_SIMD_DISPATCH (avx2_minmax<_CMP_GE_OQ> (n, r, x, y),             \
+                      avx2_minmax<_CMP_GE_OQ> (n, r, x, y),             \
+                      (generic_op<T, T, op_max<T>> (n, r, x, y)))       \
+  }                                                                     \
+  void                                                                  \
+  mx_simd_min (std::size_t n, T *r, const T *x, const T *y)             \
+  {                                                                     \
+    MX_SIMD_DISPATCH (avx2_minmax<_CMP_LE_OQ> (n, r, x, y),             \
+                      avx2_minmax<_CMP_LE_OQ> (n, r, x, y),             \
+                      (generic_op<T, T, op_min<T>> (n, r, x, y)))       \
+  }                                                                     \
+  void                                                                  \
+  mx_simd_isnan (std::size_t n, bool *r, const T *x)                    \
+  {                                                                     \
+    MX_SIMD_DISPATCH (avx2_isnan (n, r, x), avx2_isnan (n, r, x),       \
+                      for (std::size_t i = 0; i < n; i++)               \
+                        r[i] = std::isnan (x[i]))                       \
+  }                                                                     \
+  bool                                                                  \
+  mx_simd_any_nan (std::size_t n, const T *x)                           \
+  {                                                                     \
+    MX_SIMD_DISPATCH (return avx2_any_nan (n, x),                       \
+                      return avx2_any_nan (n, x),                       \
+                      for (std::size_t i = 0; i < n; i++)               \
+                        if (std::isnan (x[i]))                          \
+                          return true)                                  \
+    return false;                                                       \
+  }
+
+DEFINE_FLOAT_OPS (double)
+DEFINE_FLOAT_OPS (float)
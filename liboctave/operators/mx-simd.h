@@ -0,0 +1,97 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if ! defined (octave_mx_simd_h)
+#define octave_mx_simd_h 1
+
+#include "octave-config.h"
+
+#include <cstddef>
+#include <cstdint>
+
+// Element-wise kernels written with the SIMD instructions of x86
+// processors.  The instruction set is chosen at run time from those
+// that the processor supports, and a plain loop is used if there is
+// none.  Each kernel computes exactly the same result as the generic
+// loop in mx-inlines.cc that it replaces, including saturation of
+// integer results and the treatment of NaN.
+
+enum mx_simd_level
+{
+  MX_SIMD_NONE = 0,
+  MX_SIMD_AVX2 = 1,
+  MX_SIMD_AVX512 = 2
+};
+
+// Return the instruction set that the kernels use.
+extern OCTAVE_API mx_simd_level mx_simd_current_level ();
+
+// Return the best instruction set that the processor supports.
+extern OCTAVE_API mx_simd_level mx_simd_max_level ();
+
+// Use LEVEL, or the best supported instruction set if LEVEL is not
+// supported, and return the previous level.
+extern OCTAVE_API mx_simd_level mx_simd_set_level (mx_simd_level level);
+
+#define MX_SIMD_BINOP_DECLS(F, R, T)                                    \
+  extern OCTAVE_API void F (std::size_t n, R *r, const T *x, const T *y); \
+  extern OCTAVE_API void F (std::size_t n, R *r, const T *x, T y);      \
+  extern OCTAVE_API void F (std::size_t n, R *r, T x, const T *y);
+
+// Saturating arithmetic on 8 and 16 bit integers.
+
+#define MX_SIMD_INT_DECLS(T)                    \
+  MX_SIMD_BINOP_DECLS (mx_simd_add, T, T)       \
+  MX_SIMD_BINOP_DECLS (mx_simd_sub, T, T)       \
+  MX_SIMD_BINOP_DECLS (mx_simd_mul, T, T)
+
+MX_SIMD_INT_DECLS (int8_t)
+MX_SIMD_INT_DECLS (uint8_t)
+MX_SIMD_INT_DECLS (int16_t)
+MX_SIMD_INT_DECLS (uint16_t)
+
+// Comparisons, element-wise max and min, and NaN tests of floating
+// point values.
+
+#define MX_SIMD_FLOAT_DECLS(T)                                          \
+  MX_SIMD_BINOP_DECLS (mx_simd_lt, bool, T)                             \
+  MX_SIMD_BINOP_DECLS (mx_simd_le, bool, T)                             \
+  MX_SIMD_BINOP_DECLS (mx_simd_gt, bool, T)                             \
+  MX_SIMD_BINOP_DECLS (mx_simd_ge, bool, T)                             \
+  MX_SIMD_BINOP_DECLS (mx_simd_eq, bool, T)                             \
+  MX_SIMD_BINOP_DECLS (mx_simd_ne, bool, T)                             \
+  extern OCTAVE_API void mx_simd_max (std::size_t n, T *r, const T *x, const T *y); \
+  extern OCTAVE_API void mx_simd_min (std::size_t n, T *r, const T *x, const T *y); \
+  extern OCTAVE_API void mx_simd_isnan (std::size_t n, bool *r, const T *x); \
+  extern OCTAVE_API bool mx_simd_any_nan (std::size_t n, const T *x);
+
+MX_SIMD_FLOAT_DECLS (double)
+MX_SIMD_FLOAT_DECLS (float)
+
+#undef MX_SIMD_BINOP_DECLS
+#undef MX_SIMD_INT_DECLS
+#undef MX_SIMD_FLOAT_DECLS
+
+#endif
@@ -83,7 +83,7 @@ env::env ()
   do_get_host_name ();
 }
 
-env *env::s_instance = nullptr;
+OCTAVE_THREAD_LOCAL env *env::s_instance = nullptr;
 
 bool
 env::instance_ok ()
@@ -132,7 +132,7 @@ private:
   void error (const std::string&) const;
 
   // The real thing.
-  static env *s_instance;
+  OCTAVE_THREAD_LOCAL static env *s_instance;
 
   static void cleanup_instance ()
   { delete s_instance; s_instance = nullptr; }
@@ -57,7 +57,7 @@ OCTAVE_BEGIN_NAMESPACE(octave)
 
 char * do_completer_word_break_hook ();
 
-command_editor *command_editor::s_instance = nullptr;
+OCTAVE_THREAD_LOCAL command_editor *command_editor::s_instance = nullptr;
 
 std::set<command_editor::startup_hook_fcn> command_editor::s_startup_hook_set;
 
@@ -223,7 +223,7 @@ private:
 
   //--------
 
-  static command_editor *s_instance;  // the real thing.
+  OCTAVE_THREAD_LOCAL static command_editor *s_instance;  // the real thing.
 
   static std::set<startup_hook_fcn> s_startup_hook_set;
   static std::set<pre_input_hook_fcn> s_pre_input_hook_set;
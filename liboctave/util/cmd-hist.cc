@@ -52,7 +52,7 @@
 
 OCTAVE_BEGIN_NAMESPACE(octave)
 
-command_history *command_history::s_instance = nullptr;
+OCTAVE_THREAD_LOCAL command_history *command_history::s_instance = nullptr;
 
 #if defined (USE_READLINE)
 
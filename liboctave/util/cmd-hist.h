@@ -129,7 +129,7 @@ private:
   static void make_command_history ();
 
   // The real thing.
-  static command_history *s_instance;
+  OCTAVE_THREAD_LOCAL static command_history *s_instance;
 
   static void cleanup_instance ()
   {
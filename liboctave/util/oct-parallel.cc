@@ -0,0 +1,335 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "nproc-wrapper.h"
+#include "oct-parallel.h"
+#include "oct-syscalls.h"
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+// Zero means that the number of threads has not been set yet.
+static std::atomic<int> s_max_num_threads (0);
+
+static std::atomic<octave_idx_type> s_parallel_threshold (65536);
+
+// True in worker threads and in a thread that is executing its share
+// of a parallel loop.  Loops nested in a parallel loop are not split
+// again.
+static thread_local bool s_in_parallel_loop = false;
+
+static int
+default_num_threads ()
+{
+  unsigned long int nproc
+    = octave_num_processors_wrapper (OCTAVE_NPROC_CURRENT_OVERRIDABLE);
+
+  return std::max (1, static_cast<int> (nproc));
+}
+
+int
+max_num_threads ()
+{
+  int n = s_max_num_threads.load (std::memory_order_relaxed);
+
+  if (n == 0)
+    {
+      int expected = 0;
+      s_max_num_threads.compare_exchange_strong (expected,
+                                                 default_num_threads ());
+      n = s_max_num_threads.load ();
+    }
+
+  return n;
+}
+
+int
+set_max_num_threads (int n)
+{
+  int old_n = max_num_threads ();
+
+  s_max_num_threads = (n < 1 ? default_num_threads () : n);
+
+  return old_n;
+}
+
+octave_idx_type
+parallel_threshold ()
+{
+  return s_parallel_threshold.load (std::memory_order_relaxed);
+}
+
+octave_idx_type
+set_parallel_threshold (octave_idx_type n)
+{
+  return s_parallel_threshold.exchange (std::max<octave_idx_type> (n, 1));
+}
+
+// A set of tasks numbered 0 to N-1.  The thread that starts the job
+// and any idle workers claim tasks until none are left.
+
+class parallel_job
+{
+public:
+
+  parallel_job (std::size_t ntasks,
+                const std::function<void (std::size_t)>& task)
+    : m_ntasks (ntasks), m_task (task), m_next (0), m_done (0)
+  { }
+
+  OCTAVE_DISABLE_CONSTRUCT_COPY_MOVE (parallel_job)
+
+  ~parallel_job () = default;
+
+  void work ()
+  {
+    std::size_t i;
+
+    while ((i = m_next++) < m_ntasks)
+      {
+        try
+          {
+            m_task (i);
+          }
+        catch (...)
+          {
+            std::lock_guard<std::mutex> lock (m_mutex);
+
+            if (! m_exception)
+              m_exception = std::current_exception ();
+          }
+
+        if (++m_done == m_ntasks)
+          {
+            std::lock_guard<std::mutex> lock (m_mutex);
+            m_finished.notify_all ();
+          }
+      }
+  }
+
+  void wait ()
+  {
+    std::unique_lock<std::mutex> lock (m_mutex);
+
+    m_finished.wait (lock, [this] () { return m_done == m_ntasks; });
+
+    if (m_exception)
+      std::rethrow_exception (m_exception);
+  }
+
+private:
+
+  std::size_t m_ntasks;
+
+  // Only used while the thread that created the job waits for it, so a
+  // reference is enough.
+  const std::function<void (std::size_t)>& m_task;
+
+  std::atomic<std::size_t> m_next;
+
+  std::atomic<std::size_t> m_done;
+
+  std::mutex m_mutex;
+
+  std::condition_variable m_finished;
+
+  std::exception_ptr m_exception;
+};
+
+class thread_pool
+{
+public:
+
+  thread_pool ()
+    : m_pid (sys::getpid ()), m_stop (false)
+  { }
+
+  OCTAVE_DISABLE_COPY_MOVE (thread_pool)
+
+  ~thread_pool ()
+  {
+    {
+      std::lock_guard<std::mutex> lock (m_mutex);
+      m_stop = true;
+    }
+
+    m_ready.notify_all ();
+
+    for (auto& t : m_workers)
+      t.join ();
+  }
+
+  // The pool is never destroyed.  Its workers wait for work until the
+  // process exits, and a forked child must not try to join threads
+  // that only exist in its parent.
+
+  static thread_pool& instance ()
+  {
+    static thread_pool *s_instance = new thread_pool ();
+
+    return *s_instance;
+  }
+
+  // Threads do not survive fork, so a child process such as a parfor
+  // worker runs all loops serially.
+  bool usable () const { return m_pid == sys::getpid (); }
+
+  void run (std::size_t ntasks,
+            const std::function<void (std::size_t)>& task)
+  {
+    auto job = std::make_shared<parallel_job> (ntasks, task);
+
+    {
+      std::lock_guard<std::mutex> lock (m_mutex);
+
+      // The calling thread executes tasks too.
+      std::size_t nhelpers = ntasks - 1;
+
+      while (m_workers.size () < nhelpers)
+        m_workers.emplace_back (&thread_pool::worker_loop, this);
+
+      for (std::size_t i = 0; i < nhelpers; i++)
+        m_queue.push_back (job);
+    }
+
+    m_ready.notify_all ();
+
+    bool in_loop = s_in_parallel_loop;
+    s_in_parallel_loop = true;
+
+    job->work ();
+
+    s_in_parallel_loop = in_loop;
+
+    job->wait ();
+  }
+
+private:
+
+  void worker_loop ()
+  {
+    s_in_parallel_loop = true;
+
+    while (true)
+      {
+        std::shared_ptr<parallel_job> job;
+
+        {
+          std::unique_lock<std::mutex> lock (m_mutex);
+
+          m_ready.wait (lock, [this] ()
+                        { return m_stop || ! m_queue.empty (); });
+
+          if (m_stop)
+            return;
+
+          job = m_queue.front ();
+          m_queue.pop_front ();
+        }
+
+        job->work ();
+      }
+  }
+
+  pid_t m_pid;
+
+  bool m_stop;
+
+  std::mutex m_mutex;
+
+  std::condition_variable m_ready;
+
+  std::deque<std::shared_ptr<parallel_job>> m_queue;
+
+  std::vector<std::thread> m_workers;
+};
+
+bool
+in_parallel_loop ()
+{
+  return s_in_parallel_loop;
+}
+
+bool
+use_parallel_loop (octave_idx_type n, octave_idx_type cost)
+{
+  return (n > 1 && n * std::max<octave_idx_type> (cost, 1)
+                   >= parallel_threshold ()
+          && ! s_in_parallel_loop && max_num_threads () > 1);
+}
+
+void
+parallel_for (octave_idx_type n,
+              const std::function<void (octave_idx_type, octave_idx_type)>& fcn,
+              octave_idx_type cost)
+{
+  if (n <= 0)
+    return;
+
+  cost = std::max<octave_idx_type> (cost, 1);
+
+  // Use at most one range per thread, and do not create ranges that
+  // process much fewer elements than the threshold.
+
+  octave_idx_type min_size
+    = std::max<octave_idx_type> (parallel_threshold () / (2 * cost), 1);
+
+  octave_idx_type nranges
+    = std::min<octave_idx_type> (max_num_threads (), n / min_size);
+
+  thread_pool& pool = thread_pool::instance ();
+
+  if (nranges <= 1 || s_in_parallel_loop || ! pool.usable ())
+    {
+      fcn (0, n);
+      return;
+    }
+
+  octave_idx_type range_size = (n + nranges - 1) / nranges;
+  nranges = (n + range_size - 1) / range_size;
+
+  pool.run (nranges, [=, &fcn] (std::size_t i)
+  {
+    octave_idx_type begin = i * range_size;
+    octave_idx_type end = std::min (begin + range_size, n);
+
+    fcn (begin, end);
+  });
+}
+
+OCTAVE_END_NAMESPACE(octave)
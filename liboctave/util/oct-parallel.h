@@ -0,0 +1,132 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if ! defined (octave_oct_parallel_h)
+#define octave_oct_parallel_h 1
+
+#include "octave-config.h"
+
+#include <algorithm>
+#include <functional>
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+// Loops over large arrays in liboctave, such as element-wise
+// arithmetic and reductions, may be split among a pool of worker
+// threads that is shared by the whole process.  Loops over fewer
+// elements than the parallel threshold always run in the calling
+// thread.
+
+// Return the maximum number of threads, including the calling thread,
+// that a loop may use.
+extern OCTAVE_API int max_num_threads ();
+
+// Set the maximum number of threads and return the previous value.
+// If N is less than 1, use the number of processors available to the
+// process.
+extern OCTAVE_API int set_max_num_threads (int n);
+
+// Return the minimum number of elements for which a loop is split.
+extern OCTAVE_API octave_idx_type parallel_threshold ();
+
+// Set the parallel threshold and return the previous value.
+extern OCTAVE_API octave_idx_type set_parallel_threshold (octave_idx_type n);
+
+// Return true if a loop over N items that each process COST elements
+// should be split.  This is false if N*COST is below the threshold, if
+// only one thread may be used, and in loops that are already executing
+// in parallel.
+extern OCTAVE_API bool
+use_parallel_loop (octave_idx_type n, octave_idx_type cost = 1);
+
+// Return true in a thread that is executing its share of a loop that
+// was split.  Such code must not call back into the interpreter, for
+// example by checking for interrupts with octave_quit.
+extern OCTAVE_API bool in_parallel_loop ();
+
+// Call FCN (BEGIN, END) for consecutive ranges that cover [0, N), in
+// up to max_num_threads () threads at once.  Each item processes COST
+// elements, and ranges are not made much smaller than the threshold.
+// FCN must not depend on which thread executes a range.  If FCN throws
+// an exception for any range, the first exception is rethrown after
+// all ranges are finished.
+extern OCTAVE_API void
+parallel_for (octave_idx_type n,
+              const std::function<void (octave_idx_type, octave_idx_type)>& fcn,
+              octave_idx_type cost = 1);
+
+// Like parallel_for, but call FCN (0, N) directly, without creating a
+// std::function object, if the loop is not split.
+
+template <typename F>
+inline void
+maybe_parallel_for (octave_idx_type n, F fcn, octave_idx_type cost = 1)
+{
+  if (use_parallel_loop (n, cost))
+    parallel_for (n, fcn, cost);
+  else
+    fcn (0, n);
+}
+
+// Call FCN (L0, L1, U0, U1) for ranges of the independent vectors along
+// one dimension of an array.  N is the length of the vectors, L the
+// product of the preceding dimensions, which is the distance between
+// the elements of a vector, and U the product of the following
+// dimensions.  FCN processes the vectors whose indices in the preceding
+// and following dimensions are in [L0, L1) and [U0, U1).  The vectors
+// are split along the following dimensions if there are enough of
+// them, and along the preceding dimensions otherwise, so that both the
+// columns and the rows of a matrix are processed in parallel.
+
+template <typename F>
+inline void
+parallel_for_slices (octave_idx_type l, octave_idx_type n, octave_idx_type u,
+                     F fcn)
+{
+  if (l == 1 || u >= max_num_threads ())
+    maybe_parallel_for (u, [=, &fcn] (octave_idx_type u0, octave_idx_type u1)
+    {
+      fcn (0, l, u0, u1);
+    }, l*n);
+  else
+    {
+      // Ranges of the preceding dimensions are multiples of a block of
+      // elements, so that threads do not write to the same cache lines.
+      const octave_idx_type block = 16;
+
+      octave_idx_type nblocks = (l + block - 1) / block;
+
+      for (octave_idx_type k = 0; k < u; k++)
+        maybe_parallel_for (nblocks, [=, &fcn] (octave_idx_type b0,
+                                                octave_idx_type b1)
+        {
+          fcn (b0 * block, std::min (b1 * block, l), k, k+1);
+        }, block*n);
+    }
+}
+
+OCTAVE_END_NAMESPACE(octave)
+
+#endif
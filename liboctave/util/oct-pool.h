@@ -0,0 +1,153 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if ! defined (octave_oct_pool_h)
+#define octave_oct_pool_h 1
+
+#include "octave-config.h"
+
+#include <cstddef>
+
+#include <new>
+
+OCTAVE_BEGIN_NAMESPACE(octave)
+
+// Recycle memory blocks of SIZE bytes for small, frequently created
+// and destroyed objects such as the representations of scalar values.
+//
+// Each thread keeps its own list of free blocks, so no locking is
+// needed.  Blocks may be released by a different thread than the one
+// that allocated them.  At most MAX_FREE blocks are kept per thread,
+// the rest are returned to the global heap.
+
+template <std::size_t SIZE>
+class fixed_size_pool
+{
+public:
+
+  static void * allocate (std::size_t size)
+  {
+    free_list& lst = s_free_list;
+
+    // Objects of derived classes may be larger.
+    if (size != SIZE || ! lst.m_head)
+      return ::operator new (size);
+
+    link *p = lst.m_head;
+    lst.m_head = p->m_next;
+    lst.m_count--;
+
+    return p;
+  }
+
+  static void deallocate (void *ptr, std::size_t size)
+  {
+    if (! ptr)
+      return;
+
+    free_list& lst = s_free_list;
+
+    if (size != SIZE || lst.m_count >= lst.m_max_count)
+      {
+        ::operator delete (ptr);
+        return;
+      }
+
+    link *p = static_cast<link *> (ptr);
+    p->m_next = lst.m_head;
+    lst.m_head = p;
+    lst.m_count++;
+  }
+
+  // The number of blocks ready for reuse by this thread.
+  static std::size_t free_count () { return s_free_list.m_count; }
+
+private:
+
+  static const std::size_t MAX_FREE = 1024;
+
+  struct link
+  {
+    link *m_next;
+  };
+
+  static_assert (SIZE >= sizeof (link),
+                 "fixed_size_pool: SIZE must be at least the size of a pointer");
+
+  struct free_list
+  {
+    free_list () = default;
+
+    free_list (const free_list&) = delete;
+
+    free_list& operator = (const free_list&) = delete;
+
+    ~free_list ()
+    {
+      // Objects destroyed after this thread's pool go straight back to
+      // the heap.
+      m_max_count = 0;
+
+      while (m_head)
+        {
+          link *p = m_head;
+          m_head = p->m_next;
+          ::operator delete (p);
+        }
+
+      m_count = 0;
+    }
+
+    link *m_head {nullptr};
+
+    std::size_t m_count {0};
+
+    std::size_t m_max_count {MAX_FREE};
+  };
+
+  static thread_local free_list s_free_list;
+};
+
+template <std::size_t SIZE>
+thread_local typename fixed_size_pool<SIZE>::free_list
+fixed_size_pool<SIZE>::s_free_list;
+
+OCTAVE_END_NAMESPACE(octave)
+
+// Use a fixed_size_pool for all objects of class T allocated with new.
+// This macro must be used inside the definition of class T.
+
+#define OCTAVE_POOL_ALLOCATED(T)                                        \
+  static void * operator new (std::size_t size)                         \
+  {                                                                     \
+    return octave::fixed_size_pool<sizeof (T)>::allocate (size);        \
+  }                                                                     \
+                                                                        \
+  static void operator delete (void *ptr, std::size_t size)             \
+  {                                                                     \
+    octave::fixed_size_pool<sizeof (T)>::deallocate (ptr, size);        \
+  }
+
+#endif
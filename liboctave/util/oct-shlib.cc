@@ -60,7 +60,8 @@ extern "C"
 
 OCTAVE_BEGIN_NAMESPACE(octave)
 
-std::list<dynamic_library> possibly_unreferenced_dynamic_libraries;
+OCTAVE_THREAD_LOCAL std::list<dynamic_library>
+possibly_unreferenced_dynamic_libraries;
 
 void
 dynamic_library::delete_later ()
@@ -166,7 +167,7 @@ dynamic_library::dynlib_rep::remove_fcn_name (const std::string& fcn_name)
   return retval;
 }
 
-std::map<std::string, dynamic_library::dynlib_rep *>
+OCTAVE_THREAD_LOCAL std::map<std::string, dynamic_library::dynlib_rep *>
 dynamic_library::dynlib_rep::s_instances;
 
 dynamic_library::dynlib_rep dynamic_library::s_nil_rep;
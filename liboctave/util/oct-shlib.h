@@ -105,7 +105,8 @@ public: // FIXME: make this class private?
 
     OCTAVE_API void fake_reload ();
 
-    static OCTAVE_API std::map<std::string, dynlib_rep *> s_instances;
+    static OCTAVE_API OCTAVE_THREAD_LOCAL
+    std::map<std::string, dynlib_rep *> s_instances;
 
     // Set of hooked function names.
     typedef std::map<std::string, std::size_t>::iterator fcn_names_iterator;
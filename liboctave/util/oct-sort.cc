@@ -108,12 +108,18 @@
 // this file.
 
 #include <algorithm>
+#include <cstdint>
 #include <cstring>
+#include <memory>
 #include <stack>
+#include <type_traits>
+#include <vector>
 
 #include "lo-error.h"
 #include "lo-mappers.h"
 #include "quit.h"
+#include "oct-inttypes-fwd.h"
+#include "oct-parallel.h"
 #include "oct-sort.h"
 #include "oct-locbuf.h"
 
@@ -1512,6 +1518,316 @@ octave_sort<T>::sort (T *data, octave_idx_type *idx, octave_idx_type nel,
     }
 }
 
+// Keys for a radix sort of numeric values.  The order of the unsigned
+// keys is the order of the values, and -0 and +0 have the same key
+// because they compare equal.  A stable sort by these keys therefore
+// gives exactly the same result as the merge sort with std::less.
+
+template <typename T, typename = void>
+struct radix_sort_traits
+{
+  static const bool enabled = false;
+
+  typedef unsigned char key_type;
+
+  static key_type key (const T&) { return 0; }
+
+  static bool isnan (const T&) { return false; }
+};
+
+template <>
+struct radix_sort_traits<bool>
+{
+  static const bool enabled = true;
+
+  typedef unsigned char key_type;
+
+  static key_type key (bool x) { return x; }
+
+  static bool isnan (bool) { return false; }
+};
+
+template <typename T>
+struct radix_sort_traits<T, typename std::enable_if<std::is_integral<T>::value
+                                                    && ! std::is_same<T, bool>::value>::type>
+{
+  static const bool enabled = true;
+
+  typedef typename std::make_unsigned<T>::type key_type;
+
+  static key_type key (T x)
+  {
+    key_type k = static_cast<key_type> (x);
+
+    if (std::is_signed<T>::value)
+      k ^= static_cast<key_type> (key_type (1) << (8 * sizeof (T) - 1));
+
+    return k;
+  }
+
+  static bool isnan (T) { return false; }
+};
+
+template <typename T>
+struct radix_sort_traits<T, typename std::enable_if<std::is_floating_point<T>::value
+                                                    && (sizeof (T) == 4
+                                                        || sizeof (T) == 8)>::type>
+{
+  static const bool enabled = true;
+
+  typedef typename std::conditional<sizeof (T) == 4,
+                                    uint32_t, uint64_t>::type key_type;
+
+  static key_type key (T x)
+  {
+    key_type k = 0;
+
+    if (x != 0)
+      std::memcpy (&k, &x, sizeof (T));
+
+    const key_type sign = key_type (1) << (8 * sizeof (T) - 1);
+
+    return (k & sign) ? ~k : (k | sign);
+  }
+
+  static bool isnan (T x) { return x != x; }
+};
+
+template <typename T>
+struct radix_sort_traits<octave_int<T>>
+{
+  static const bool enabled = radix_sort_traits<T>::enabled;
+
+  typedef typename radix_sort_traits<T>::key_type key_type;
+
+  static key_type key (const octave_int<T>& x)
+  {
+    return radix_sort_traits<T>::key (x.value ());
+  }
+
+  static bool isnan (const octave_int<T>&) { return false; }
+};
+
+// Below this length, the merge sort is faster.
+static const octave_idx_type RADIX_SORT_MIN_LENGTH = 2048;
+
+// Sort DATA, and permute IDX along with it unless it is null, with a
+// stable LSD radix sort of 8-bit digits.  Large arrays are divided into
+// chunks that are counted and scattered in parallel.  Return false
+// without changing anything if the merge sort should be used instead:
+// for types without radix keys, for short arrays, for arrays that are
+// nearly sorted in either direction, which the merge sort handles in
+// almost linear time, and for arrays containing NaN, whose order only
+// the merge sort defines.
+
+template <typename T>
+static bool
+radix_sort (T *data, octave_idx_type *idx, octave_idx_type nel,
+            bool descending)
+{
+  typedef radix_sort_traits<T> traits;
+  typedef typename traits::key_type key_type;
+
+  if (! traits::enabled || nel < RADIX_SORT_MIN_LENGTH)
+    return false;
+
+  const int nbytes = sizeof (key_type);
+  const int nbins = 256;
+
+  auto key = [descending] (const T& x) -> key_type
+  {
+    key_type k = traits::key (x);
+
+    return descending ? static_cast<key_type> (~k) : k;
+  };
+
+  octave_idx_type nchunks = 1;
+
+  if (octave::use_parallel_loop (nel))
+    nchunks = std::min<octave_idx_type>
+                (octave::max_num_threads (),
+                 std::max<octave_idx_type> (nel / octave::parallel_threshold (),
+                                            2));
+
+  auto chunk_begin = [nel, nchunks] (octave_idx_type c)
+  {
+    return static_cast<octave_idx_type> ((static_cast<double> (nel) * c)
+                                         / nchunks);
+  };
+
+  auto for_each_chunk = [nel, nchunks] (const std::function<void (octave_idx_type)>& fcn)
+  {
+    if (nchunks == 1)
+      fcn (0);
+    else
+      octave::parallel_for (nchunks, [&fcn] (octave_idx_type b,
+                                             octave_idx_type e)
+      {
+        for (octave_idx_type c = b; c < e; c++)
+          fcn (c);
+      }, nel / nchunks);
+  };
+
+  // Count the digits of all keys, and the places where the keys are
+  // not in ascending or not in strictly descending order.
+
+  std::vector<octave_idx_type> counts (nchunks * nbytes * nbins, 0);
+  std::vector<octave_idx_type> nup (nchunks, 0);
+  std::vector<octave_idx_type> ndown (nchunks, 0);
+  std::vector<char> has_nan (nchunks, false);
+
+  for_each_chunk ([&] (octave_idx_type c)
+  {
+    octave_idx_type *cnt = counts.data () + c * nbytes * nbins;
+    octave_idx_type begin = chunk_begin (c);
+    octave_idx_type end = chunk_begin (c + 1);
+
+    key_type prev = key (data[begin]);
+
+    for (octave_idx_type i = begin; i < end; i++)
+      {
+        if (traits::isnan (data[i]))
+          {
+            has_nan[c] = true;
+            return;
+          }
+
+        key_type k = key (data[i]);
+
+        for (int b = 0; b < nbytes; b++)
+          cnt[b * nbins + ((k >> (8 * b)) & 0xFF)]++;
+
+        if (k < prev)
+          ndown[c]++;
+        else
+          nup[c]++;
+
+        prev = k;
+      }
+  });
+
+  octave_idx_type nbreaks = 0;
+  octave_idx_type nrbreaks = 0;
+
+  for (octave_idx_type c = 0; c < nchunks; c++)
+    {
+      if (has_nan[c])
+        return false;
+
+      nbreaks += ndown[c];
+      nrbreaks += nup[c];
+
+      if (c > 0)
+        {
+          if (key (data[chunk_begin (c)]) < key (data[chunk_begin (c) - 1]))
+            nbreaks++;
+          else
+            nrbreaks++;
+        }
+    }
+
+  // Each chunk counted its first element as being in ascending order.
+  nrbreaks -= nchunks;
+
+  if (nbreaks < nel / 16 || nrbreaks < nel / 16)
+    return false;
+
+  std::unique_ptr<T[]> tmp (new T [nel]);
+  std::unique_ptr<octave_idx_type[]> itmp (idx ? new octave_idx_type [nel]
+                                                : nullptr);
+
+  T *src = data;
+  T *dst = tmp.get ();
+  octave_idx_type *isrc = idx;
+  octave_idx_type *idst = itmp.get ();
+
+  std::vector<octave_idx_type> offsets (nchunks * nbins);
+
+  bool moved = false;
+
+  for (int b = 0; b < nbytes; b++)
+    {
+      // Skip digits that are the same in all keys.
+
+      bool all_same = false;
+
+      for (int d = 0; d < nbins && ! all_same; d++)
+        {
+          octave_idx_type n = 0;
+
+          for (octave_idx_type c = 0; c < nchunks; c++)
+            n += counts[(c * nbytes + b) * nbins + d];
+
+          all_same = (n == nel);
+        }
+
+      if (all_same)
+        continue;
+
+      // The counts of the first scattered digit are still valid.  Those
+      // of later digits change when elements move between chunks.
+
+      if (moved)
+        for_each_chunk ([&] (octave_idx_type c)
+        {
+          octave_idx_type *cnt = counts.data () + (c * nbytes + b) * nbins;
+
+          std::fill (cnt, cnt + nbins, 0);
+
+          for (octave_idx_type i = chunk_begin (c); i < chunk_begin (c + 1);
+               i++)
+            cnt[(key (src[i]) >> (8 * b)) & 0xFF]++;
+        });
+
+      // Elements with equal digits keep their order, so the elements of
+      // each chunk follow those of the previous chunks.
+
+      octave_idx_type pos = 0;
+
+      for (int d = 0; d < nbins; d++)
+        for (octave_idx_type c = 0; c < nchunks; c++)
+          {
+            offsets[c * nbins + d] = pos;
+            pos += counts[(c * nbytes + b) * nbins + d];
+          }
+
+      for_each_chunk ([&] (octave_idx_type c)
+      {
+        octave_idx_type *off = offsets.data () + c * nbins;
+
+        for (octave_idx_type i = chunk_begin (c); i < chunk_begin (c + 1);
+             i++)
+          {
+            octave_idx_type j = off[(key (src[i]) >> (8 * b)) & 0xFF]++;
+
+            dst[j] = src[i];
+
+            if (idx)
+              idst[j] = isrc[i];
+          }
+      });
+
+      std::swap (src, dst);
+      std::swap (isrc, idst);
+
+      moved = true;
+    }
+
+  if (src != data)
+    for_each_chunk ([&] (octave_idx_type c)
+    {
+      octave_idx_type begin = chunk_begin (c);
+      octave_idx_type end = chunk_begin (c + 1);
+
+      std::copy (src + begin, src + end, data + begin);
+
+      if (idx)
+        std::copy (isrc + begin, isrc + end, idx + begin);
+    });
+
+  return true;
+}
+
 template <typename T>
 using compare_fcn_ptr = bool (*) (typename ref_param<T>::type,
                                   typename ref_param<T>::type);
@@ -1522,12 +1838,18 @@ octave_sort<T>::sort (T *data, octave_idx_type nel)
 {
 #if defined (INLINE_ASCENDING_SORT)
   if (*m_compare.template target<compare_fcn_ptr<T>> () == ascending_compare)
-    sort (data, nel, std::less<T> ());
+    {
+      if (! radix_sort (data, nullptr, nel, false))
+        sort (data, nel, std::less<T> ());
+    }
   else
 #endif
 #if defined (INLINE_DESCENDING_SORT)
     if (*m_compare.template target<compare_fcn_ptr<T>> () == descending_compare)
-      sort (data, nel, std::greater<T> ());
+      {
+        if (! radix_sort (data, nullptr, nel, true))
+          sort (data, nel, std::greater<T> ());
+      }
     else
 #endif
       if (m_compare)
@@ -1540,12 +1862,18 @@ octave_sort<T>::sort (T *data, octave_idx_type *idx, octave_idx_type nel)
 {
 #if defined (INLINE_ASCENDING_SORT)
   if (*m_compare.template target<compare_fcn_ptr<T>> () == ascending_compare)
-    sort (data, idx, nel, std::less<T> ());
+    {
+      if (! radix_sort (data, idx, nel, false))
+        sort (data, idx, nel, std::less<T> ());
+    }
   else
 #endif
 #if defined (INLINE_DESCENDING_SORT)
     if (*m_compare.template target<compare_fcn_ptr<T>> () == descending_compare)
-      sort (data, idx, nel, std::greater<T> ());
+      {
+        if (! radix_sort (data, idx, nel, true))
+          sort (data, idx, nel, std::greater<T> ());
+      }
     else
 #endif
       if (m_compare)
@@ -30,7 +30,8 @@
 #include "lo-error.h"
 #include "singleton-cleanup.h"
 
-singleton_cleanup_list *singleton_cleanup_list::s_instance = nullptr;
+OCTAVE_THREAD_LOCAL singleton_cleanup_list *
+singleton_cleanup_list::s_instance = nullptr;
 
 singleton_cleanup_list::~singleton_cleanup_list ()
 {
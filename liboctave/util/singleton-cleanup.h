@@ -58,7 +58,7 @@ public:
 
 private:
 
-  static singleton_cleanup_list *s_instance;
+  OCTAVE_THREAD_LOCAL static singleton_cleanup_list *s_instance;
 
   static bool instance_ok ();
 
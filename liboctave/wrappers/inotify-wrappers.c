@@ -0,0 +1,198 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+// Directory change notification for the load path.  The functions in
+// this file return -1 if inotify is not available so that callers can
+// fall back to checking the time stamps of directories.
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#include <errno.h>
+#include <unistd.h>
+
+#if defined (HAVE_SYS_INOTIFY_H)
+#  include <sys/inotify.h>
+#  include <sys/vfs.h>
+#endif
+
+#include "inotify-wrappers.h"
+
+#if defined (HAVE_SYS_INOTIFY_H)
+
+// Changes made on other hosts to files on network file systems are not
+// reported by inotify, so directories on these file systems are not
+// watched.
+
+static int
+is_network_file_system (const char *dir)
+{
+  struct statfs buf;
+
+  if (statfs (dir, &buf) != 0)
+    return 1;
+
+  switch ((unsigned long) buf.f_type)
+    {
+    case 0x6969UL:        // NFS
+    case 0x517BUL:        // SMB
+    case 0xFF534D42UL:    // CIFS
+    case 0xFE534D42UL:    // SMB2
+    case 0x564C:          // NCP
+    case 0x65735546UL:    // FUSE
+    case 0x5346414FUL:    // AFS
+    case 0x6B414653UL:    // kAFS
+    case 0x47504653UL:    // GPFS
+    case 0x0BD00BD0UL:    // Lustre
+    case 0x00C36400UL:    // Ceph
+      return 1;
+
+    default:
+      return 0;
+    }
+}
+
+#endif
+
+int
+octave_inotify_init_wrapper (void)
+{
+#if defined (HAVE_SYS_INOTIFY_H)
+  return inotify_init1 (IN_NONBLOCK | IN_CLOEXEC);
+#else
+  return -1;
+#endif
+}
+
+// Only changes to the list of files in DIR are reported.  Changes to
+// the contents of files are detected by checking file time stamps when
+// functions are called.
+
+int
+octave_inotify_add_watch_wrapper (int fd, const char *dir)
+{
+#if defined (HAVE_SYS_INOTIFY_H)
+  if (is_network_file_system (dir))
+    return -1;
+
+  return inotify_add_watch (fd, dir,
+                            IN_CREATE | IN_DELETE | IN_MOVED_FROM
+                            | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF
+                            | IN_ONLYDIR);
+#else
+  (void) fd;
+  (void) dir;
+
+  return -1;
+#endif
+}
+
+int
+octave_inotify_rm_watch_wrapper (int fd, int wd)
+{
+#if defined (HAVE_SYS_INOTIFY_H)
+  return inotify_rm_watch (fd, wd);
+#else
+  (void) fd;
+  (void) wd;
+
+  return -1;
+#endif
+}
+
+// Read all pending events without blocking and store the watch
+// descriptors that they refer to in WDS.  Return the number of watch
+// descriptors stored, or -1 on error.  If the kernel event queue
+// overflowed or more than MAX_WDS events were pending, set *OVERFLOW
+// to 1 because some changes may not have been reported.
+
+int
+octave_inotify_read_wrapper (int fd, int *wds, size_t max_wds, int *overflow)
+{
+#if defined (HAVE_SYS_INOTIFY_H)
+  char buf[4096]
+    __attribute__ ((aligned (__alignof__ (struct inotify_event))));
+
+  size_t count = 0;
+
+  *overflow = 0;
+
+  for (;;)
+    {
+      ssize_t len = read (fd, buf, sizeof (buf));
+
+      if (len < 0)
+        {
+          if (errno == EAGAIN || errno == EWOULDBLOCK)
+            break;
+          else if (errno == EINTR)
+            continue;
+
+          return -1;
+        }
+      else if (len == 0)
+        break;
+
+      char *p = buf;
+
+      while (p < buf + len)
+        {
+          const struct inotify_event *event = (const struct inotify_event *) p;
+
+          if (event->mask & IN_Q_OVERFLOW)
+            *overflow = 1;
+          else if (count < max_wds)
+            wds[count++] = event->wd;
+          else
+            *overflow = 1;
+
+          p += sizeof (struct inotify_event) + event->len;
+        }
+    }
+
+  return count;
+#else
+  (void) fd;
+  (void) wds;
+  (void) max_wds;
+
+  *overflow = 0;
+
+  return -1;
+#endif
+}
+
+int
+octave_inotify_close_wrapper (int fd)
+{
+#if defined (HAVE_SYS_INOTIFY_H)
+  return close (fd);
+#else
+  (void) fd;
+
+  return -1;
+#endif
+}
@@ -0,0 +1,56 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if ! defined (octave_inotify_wrappers_h)
+#define octave_inotify_wrappers_h 1
+
+#if defined (__cplusplus)
+#  include <cstddef>
+#else
+#  include <stddef.h>
+#endif
+
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+extern OCTAVE_API int octave_inotify_init_wrapper (void);
+
+extern OCTAVE_API int
+octave_inotify_add_watch_wrapper (int fd, const char *dir);
+
+extern OCTAVE_API int octave_inotify_rm_watch_wrapper (int fd, int wd);
+
+extern OCTAVE_API int
+octave_inotify_read_wrapper (int fd, int *wds, size_t max_wds,
+                             int *overflow);
+
+extern OCTAVE_API int octave_inotify_close_wrapper (int fd);
+
+#if defined (__cplusplus)
+}
+#endif
+
+#endif
@@ -0,0 +1,115 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+// Memory mappings for the data of large arrays.  If anonymous mappings
+// are not available, octave_mmap_anonymous_wrapper returns NULL so that
+// callers can fall back to the heap.
+
+#if defined (HAVE_CONFIG_H)
+#  include "config.h"
+#endif
+
+#if defined (HAVE_SYS_MMAN_H)
+#  include <sys/mman.h>
+#endif
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "mman-wrappers.h"
+
+void *
+octave_mmap_anonymous_wrapper (size_t len)
+{
+#if defined (HAVE_SYS_MMAN_H) && defined (MAP_ANONYMOUS)
+  void *addr = mmap (NULL, len, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+  return addr == MAP_FAILED ? NULL : addr;
+#else
+  octave_unused_parameter (len);
+  return NULL;
+#endif
+}
+
+// Map the regular file NAME for reading and store its size in *LEN.
+// Returns NULL if the file cannot be mapped, for example because it is
+// empty or not a regular file.
+
+void *
+octave_mmap_file_wrapper (const char *name, size_t *len)
+{
+#if defined (HAVE_SYS_MMAN_H)
+  int fd = open (name, O_RDONLY);
+
+  if (fd < 0)
+    return NULL;
+
+  struct stat st;
+  void *addr = MAP_FAILED;
+
+  if (fstat (fd, &st) == 0 && S_ISREG (st.st_mode) && st.st_size > 0)
+    {
+      *len = st.st_size;
+
+      addr = mmap (NULL, *len, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+
+  close (fd);
+
+  return addr == MAP_FAILED ? NULL : addr;
+#else
+  octave_unused_parameter (name);
+  octave_unused_parameter (len);
+  return NULL;
+#endif
+}
+
+int
+octave_munmap_wrapper (void *addr, size_t len)
+{
+#if defined (HAVE_SYS_MMAN_H)
+  return munmap (addr, len);
+#else
+  octave_unused_parameter (addr);
+  octave_unused_parameter (len);
+  return -1;
+#endif
+}
+
+// Ask the kernel to back the range with transparent huge pages.
+
+int
+octave_madvise_hugepage_wrapper (void *addr, size_t len)
+{
+#if defined (HAVE_SYS_MMAN_H) && defined (MADV_HUGEPAGE)
+  return madvise (addr, len, MADV_HUGEPAGE);
+#else
+  octave_unused_parameter (addr);
+  octave_unused_parameter (len);
+  return -1;
+#endif
+}
@@ -0,0 +1,52 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if ! defined (octave_mman_wrappers_h)
+#define octave_mman_wrappers_h 1
+
+#if defined (__cplusplus)
+#  include <cstddef>
+#else
+#  include <stddef.h>
+#endif
+
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+extern OCTAVE_API void * octave_mmap_anonymous_wrapper (size_t len);
+
+extern OCTAVE_API void *
+octave_mmap_file_wrapper (const char *name, size_t *len);
+
+extern OCTAVE_API int octave_munmap_wrapper (void *addr, size_t len);
+
+extern OCTAVE_API int octave_madvise_hugepage_wrapper (void *addr, size_t len);
+
+#if defined (__cplusplus)
+}
+#endif
+
+#endif
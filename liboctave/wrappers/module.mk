@@ -12,9 +12,11 @@ NOINSTALL_WRAPPERS_INC = \
   %reldir%/glob-wrappers.h \
   %reldir%/hash-wrappers.h \
   %reldir%/iconv-wrappers.h \
+  %reldir%/inotify-wrappers.h \
   %reldir%/intprops-wrappers.h \
   %reldir%/localcharset-wrapper.h \
   %reldir%/math-wrappers.h \
+  %reldir%/mman-wrappers.h \
   %reldir%/mkostemp-wrapper.h \
   %reldir%/mkostemps-wrapper.h \
   %reldir%/nanosleep-wrapper.h \
@@ -58,9 +60,11 @@ WRAPPERS_SRC = \
   %reldir%/glob-wrappers.c \
   %reldir%/hash-wrappers.c \
   %reldir%/iconv-wrappers.c \
+  %reldir%/inotify-wrappers.c \
   %reldir%/intprops-wrappers.c \
   %reldir%/localcharset-wrapper.c \
   %reldir%/math-wrappers.c \
+  %reldir%/mman-wrappers.c \
   %reldir%/mkostemp-wrapper.c \
   %reldir%/mkostemps-wrapper.c \
   %reldir%/nanosleep-wrapper.c \
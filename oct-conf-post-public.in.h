@@ -359,8 +359,15 @@ octave_unused_parameter (const T&)
 /* time type in API is always 64 bits wide */
 #define OCTAVE_TIME_T int64_t
 
+/* Storage class of the interpreter instance and of library singletons
+   that must not be shared by interpreters running in different
+   threads.  */
 #if defined (__cplusplus) && ! defined (OCTAVE_THREAD_LOCAL)
-#  define OCTAVE_THREAD_LOCAL
+#  if defined (OCTAVE_ENABLE_THREAD_LOCAL_INTERPRETERS)
+#    define OCTAVE_THREAD_LOCAL thread_local
+#  else
+#    define OCTAVE_THREAD_LOCAL
+#  endif
 #endif
 
 #if defined (__cplusplus)
@@ -0,0 +1,719 @@
+########################################################################
+##
+## Copyright (C) 2024 The Octave Project Developers
+##
+## See the file COPYRIGHT.md in the top-level directory of this
+## distribution or <https://octave.org/copyright/>.
+##
+## This file is part of Octave.
+##
+## Octave is free software: you can redistribute it and/or modify it
+## under the terms of the GNU General Public License as published by
+## the Free Software Foundation, either version 3 of the License, or
+## (at your option) any later version.
+##
+## Octave is distributed in the hope that it will be useful, but
+## WITHOUT ANY WARRANTY; without even the implied warranty of
+## MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+## GNU General Public License for more details.
+##
+## You should have received a copy of the GNU General Public License
+## along with Octave; see the file COPYING.  If not, see
+## <https://www.gnu.org/licenses/>.
+##
+########################################################################
+
+classdef matfile < handle
+
+  ## -*- texinfo -*-
+  ## @deftypefn  {} {@var{m} =} matfile (@var{filename})
+  ## @deftypefnx {} {@var{m} =} matfile (@var{filename}, "Writable", @var{tf})
+  ## Access the variables in the file @var{filename} without loading them
+  ## into memory.
+  ##
+  ## @var{filename} must be an HDF5 file or an uncompressed Octave binary
+  ## file, as written by @code{save} with the @option{-hdf5} or
+  ## @option{-binary} options.  If @var{filename} has no extension,
+  ## @file{.mat} is appended.
+  ##
+  ## The variables in the file are accessed like the properties of @var{m}.
+  ## Parts of numeric and logical arrays are read from the file with the
+  ## usual indexing syntax, and only the requested elements are read:
+  ##
+  ## @example
+  ## @group
+  ## m = matfile ("results.mat");
+  ## col = m.A(:, 5);
+  ## blk = m.A(1:100, 201:300);
+  ## @end group
+  ## @end example
+  ##
+  ## Other variables, such as cell arrays and structures, are loaded
+  ## completely when they are accessed.
+  ##
+  ## If the option @qcode{"Writable"} is true, variables may also be
+  ## assigned.  Assigning to a part of an array writes only the changed
+  ## elements to the file, and assigning a whole variable adds it to the
+  ## file or replaces the previous value.  A file that does not exist is
+  ## created as an HDF5 file.  The option can be changed later with
+  ## @code{@var{m}.Properties.Writable = @var{tf}}.
+  ##
+  ## @code{who (@var{m})} and @code{whos (@var{m})} list the variables in
+  ## the file, and @code{size (@var{m}, @var{name})} returns the dimensions
+  ## of the variable @var{name}.  Only the headers of arrays are read to
+  ## find their names, classes, and dimensions.
+  ##
+  ## Indexing into an array with @code{()} requires a subscript for each
+  ## dimension of the array or a single linear index, and indexed
+  ## assignment cannot change the dimensions of an array.  Elements are
+  ## written in place only if the array was saved with the same type that
+  ## it has in memory; otherwise, or if the file is an Octave binary file
+  ## with a different byte order, the whole variable is saved again.
+  ##
+  ## @seealso{load, save, who, whos}
+  ## @end deftypefn
+
+  properties (SetAccess = private)
+
+    ## Structure with the fields Source, the absolute name of the file,
+    ## and Writable.
+    Properties = struct ("Source", "", "Writable", false);
+
+  endproperties
+
+  properties (Access = private)
+
+    ## Cached result of __matfile_whos__, or [] if it must be read again.
+    vars = [];
+
+  endproperties
+
+  methods
+
+    function this = matfile (filename, varargin)
+
+      if (nargin < 1)
+        print_usage ();
+      endif
+
+      if (! ischar (filename) || ! isrow (filename))
+        error ("matfile: FILENAME must be a string");
+      endif
+
+      writable = false;
+      if (nargin > 1)
+        if (nargin != 3 || ! strcmpi (varargin{1}, "Writable"))
+          error ("matfile: the only option is \"Writable\"");
+        endif
+        writable = varargin{2};
+        if (! (isscalar (writable) && (islogical (writable)
+                                       || isnumeric (writable))))
+          error ("matfile: Writable must be a logical value");
+        endif
+      endif
+
+      [~, ~, ext] = fileparts (filename);
+      if (isempty (ext))
+        filename = [filename ".mat"];
+      endif
+
+      filename = make_absolute_filename (tilde_expand (filename));
+
+      if (! writable && ! isfile (filename))
+        error ("matfile: unable to find file '%s'", filename);
+      endif
+
+      this.Properties.Source = filename;
+      this.Properties.Writable = logical (writable);
+
+    endfunction
+
+    function names = who (this)
+
+      info = var_list (this);
+
+      if (nargout == 0)
+        names = {info.name};
+        printf ("Variables in '%s':\n\n", this.Properties.Source);
+        printf ("%s", list_in_columns (names));
+        printf ("\n");
+        clear names;
+      else
+        names = {info.name}';
+      endif
+
+    endfunction
+
+    function s = whos (this)
+
+      info = var_list (this);
+
+      s = struct ("name", {info.name}, "size", {info.size},
+                  "bytes", {info.bytes}, "class", {info.class},
+                  "global", {info.global}, "sparse", false,
+                  "complex", {info.complex}, "nesting",
+                  struct ("function", "", "level", 1), "persistent", false);
+      s = s(:);
+
+      if (nargout == 0)
+        printf ("Variables in '%s':\n\n", this.Properties.Source);
+        w = max ([4, cellfun(@numel, {s.name})]);
+        printf ("  %-*s  %15s  %12s  %s\n", w, "Name", "Size", "Bytes",
+                "Class");
+        printf ("  %-*s  %15s  %12s  %s\n", w, "====", "====", "=====",
+                "=====");
+        for i = 1:numel (s)
+          sz = sprintf ("%dx", s(i).size)(1:end-1);
+          printf ("  %-*s  %15s  %12d  %s\n", w, s(i).name, sz, s(i).bytes,
+                  s(i).class);
+        endfor
+        printf ("\n");
+        clear s;
+      endif
+
+    endfunction
+
+    function varargout = size (this, varargin)
+
+      if (nargin > 1 && ischar (varargin{1}))
+        v = var_info (this, varargin{1});
+        sz = v.size;
+        varargin(1) = [];
+      else
+        sz = [1, 1];
+      endif
+
+      if (! isempty (varargin))
+        dims = [varargin{:}];
+        sz(end+1:max (dims)) = 1;
+        sz = sz(dims);
+      endif
+
+      if (nargout <= 1)
+        varargout{1} = sz;
+      else
+        n = nargout;
+        sz(end+1:n) = 1;
+        sz(n) = prod (sz(n:end));
+        varargout = num2cell (sz(1:n));
+      endif
+
+    endfunction
+
+    function disp (this)
+
+      printf ("  matfile object with properties:\n\n");
+      printf ("    Properties.Source   : %s\n", this.Properties.Source);
+      printf ("    Properties.Writable : %d\n\n",
+              this.Properties.Writable);
+
+      if (isfile (this.Properties.Source))
+        info = var_list (this);
+        for i = 1:numel (info)
+          sz = sprintf ("%dx", info(i).size)(1:end-1);
+          printf ("    %s: [%s %s]\n", info(i).name, sz, info(i).class);
+        endfor
+        if (! isempty (info))
+          printf ("\n");
+        endif
+      endif
+
+    endfunction
+
+    function val = subsref (this, s)
+
+      if (! strcmp (s(1).type, "."))
+        error ("matfile: variables must be accessed with '.'");
+      endif
+
+      name = s(1).subs;
+
+      if (strcmp (name, "Properties"))
+        val = this.Properties;
+        n = 1;
+      else
+        v = var_info (this, name);
+        if (numel (s) > 1 && strcmp (s(2).type, "()") && v.partial)
+          val = read_part (this, v, s(2).subs);
+          n = 2;
+        else
+          val = read_var (this, v);
+          n = 1;
+        endif
+      endif
+
+      if (numel (s) > n)
+        val = subsref (val, s(n+1:end));
+      endif
+
+    endfunction
+
+    function this = subsasgn (this, s, rhs)
+
+      if (! strcmp (s(1).type, "."))
+        error ("matfile: variables must be accessed with '.'");
+      endif
+
+      name = s(1).subs;
+
+      if (strcmp (name, "Properties"))
+        if (numel (s) != 2 || ! strcmp (s(2).type, ".")
+            || ! strcmp (s(2).subs, "Writable"))
+          error ("matfile: only Properties.Writable may be changed");
+        endif
+        if (! (isscalar (rhs) && (islogical (rhs) || isnumeric (rhs))))
+          error ("matfile: Writable must be a logical value");
+        endif
+        this.Properties.Writable = logical (rhs);
+        return;
+      endif
+
+      if (! this.Properties.Writable)
+        error ("matfile: unable to write to '%s'; set Properties.Writable to true",
+               this.Properties.Source);
+      endif
+
+      if (numel (s) == 1)
+        write_var (this, name, rhs);
+        return;
+      endif
+
+      v = [];
+      if (isfile (this.Properties.Source))
+        info = var_list (this);
+        v = info(strcmp ({info.name}, name));
+      endif
+
+      if (numel (s) == 2 && strcmp (s(2).type, "()") && ! isempty (v)
+          && v.partial && v.in_place)
+        write_part (this, v, s(2).subs, rhs);
+      else
+        ## Assign the whole variable.
+        if (isempty (v))
+          val = [];
+        else
+          val = read_var (this, v);
+        endif
+        val = subsasgn (val, s(2:end), rhs);
+        write_var (this, name, val);
+      endif
+
+    endfunction
+
+    function n = numArgumentsFromSubscript (this, ~, ~)
+      n = 1;
+    endfunction
+
+  endmethods
+
+  methods (Access = private)
+
+    function info = var_list (this)
+
+      if (isempty (this.vars))
+        this.vars = __matfile_whos__ (this.Properties.Source);
+      endif
+      info = this.vars;
+
+    endfunction
+
+    function v = var_info (this, name)
+
+      info = var_list (this);
+      v = info(strcmp ({info.name}, name));
+      if (isempty (v))
+        error ("matfile: variable '%s' not found in '%s'", name,
+               this.Properties.Source);
+      endif
+
+    endfunction
+
+    function val = read_var (this, v)
+
+      if (v.partial)
+        nd = numel (v.size);
+        val = __matfile_read__ (this.Properties.Source, v.name, v.offset,
+                                zeros (1, nd), v.size, ones (1, nd));
+      else
+        val = load (this.Properties.Source, v.name).(v.name);
+      endif
+
+    endfunction
+
+    function write_var (this, name, val)
+
+      __matfile_write__ (this.Properties.Source, name, val);
+      this.vars = [];
+
+    endfunction
+
+    function val = read_part (this, v, idx)
+
+      [start, count, stride, sub, shape] = matfile.block (v.size, idx);
+
+      val = __matfile_read__ (this.Properties.Source, v.name, v.offset,
+                              start, count, stride);
+
+      if (! isempty (shape))
+        val = reshape (val, shape);
+      endif
+
+      if (! all (cellfun (@(x) ischar (x) && strcmp (x, ":"), sub)))
+        val = val(sub{:});
+      endif
+
+      if (numel (idx) == 1)
+        ## Linear indexing.  The result has the orientation of a vector
+        ## and the shape of the index otherwise.
+        i = idx{1};
+        if (ischar (i) && strcmp (i, ":"))
+          val = val(:);
+        elseif (sum (v.size != 1) <= 1)
+          if (v.size(1) == 1)
+            val = val(:).';
+          else
+            val = val(:);
+          endif
+        elseif (! islogical (i))
+          val = reshape (val, size (i));
+        endif
+      endif
+
+    endfunction
+
+    function write_part (this, v, idx, rhs)
+
+      [start, count, stride, sub, shape] = matfile.block (v.size, idx);
+
+      src = this.Properties.Source;
+
+      direct = isempty (shape) ...
+               && all (cellfun (@(x) ischar (x) && strcmp (x, ":"), sub));
+
+      if (direct)
+        ## The elements are written as they are if the dimensions of RHS
+        ## agree with the block, ignoring singleton dimensions.
+        rdv = size (rhs);
+        if (isscalar (rhs))
+          rhs = repmat (rhs, count);
+        elseif (! isequal (rdv(rdv != 1), count(count != 1)))
+          error ("matfile: =: nonconformant arguments (op1 is %s, op2 is %s)",
+                 sprintf ("%dx", count)(1:end-1),
+                 sprintf ("%dx", rdv)(1:end-1));
+        endif
+        __matfile_write__ (src, v.name, v.offset, start, count, stride, rhs);
+      else
+        ## Change the elements in the block that contains them.
+        blk = __matfile_read__ (src, v.name, v.offset, start, count, stride);
+        bsz = size (blk);
+        if (! isempty (shape))
+          blk = reshape (blk, shape);
+        endif
+        psz = size (blk);
+        blk(sub{:}) = rhs;
+        if (! isequal (size (blk), psz))
+          error ("matfile: indexed assignment cannot resize '%s'", v.name);
+        endif
+        __matfile_write__ (src, v.name, v.offset, start, count, stride,
+                           reshape (blk, bsz));
+      endif
+
+    endfunction
+
+  endmethods
+
+  methods (Static, Access = private)
+
+    ## Find the smallest block of an array with dimensions DV that
+    ## contains the elements selected by the subscripts IDX.  START, COUNT,
+    ## and STRIDE describe the block as needed by __matfile_read__, and
+    ## SUB selects the elements in the block after it is reshaped to SHAPE,
+    ## if SHAPE is not empty.
+
+    function [start, count, stride, sub, shape] = block (dv, idx)
+
+      nd = numel (dv);
+      n = numel (idx);
+
+      if (n == 0)
+        error ("matfile: an index is required with '()'");
+      endif
+
+      ## Subscripts for dimensions after the last one must be 1.
+      for k = nd+1:n
+        i = idx{k};
+        if (! (ischar (i) && strcmp (i, ":")) && ! all (i(:) == 1))
+          error ("matfile: out of bound; value %d out of bound 1",
+                 max (i(:)));
+        endif
+      endfor
+      idx(nd+1:end) = [];
+      n = min (n, nd);
+
+      start = zeros (1, nd);
+      count = dv;
+      stride = ones (1, nd);
+      sub = repmat ({":"}, 1, n);
+      shape = [];
+
+      for k = 1:n-1
+        [start(k), count(k), stride(k), sub{k}] = ...
+          matfile.dim_block (idx{k}, dv(k));
+      endfor
+
+      if (n == nd)
+        [start(n), count(n), stride(n), sub{n}] = ...
+          matfile.dim_block (idx{n}, dv(n));
+      else
+        ## The last subscript is a linear index into the remaining
+        ## dimensions.
+        tdv = dv(n:nd);
+        i = idx{n};
+        if (! (ischar (i) && strcmp (i, ":")))
+          if (islogical (i))
+            i = find (i);
+          endif
+          i = double (i(:));
+          if (any (i < 1 | i != fix (i)))
+            error ("matfile: subscripts must be either integers 1 to (2^63)-1 or logicals");
+          endif
+          if (any (i > prod (tdv)))
+            error ("matfile: out of bound; value %d out of bound %d",
+                   max (i), prod (tdv));
+          endif
+          if (isempty (i))
+            count(n:nd) = 0;
+            sub{n} = [];
+          else
+            tsub = cell (1, numel (tdv));
+            [tsub{:}] = ind2sub (tdv, i);
+            for k = 1:numel (tdv)
+              start(n+k-1) = min (tsub{k}) - 1;
+              count(n+k-1) = max (tsub{k}) - start(n+k-1);
+              tsub{k} -= start(n+k-1);
+            endfor
+            sub{n} = sub2ind (count(n:nd), tsub{:});
+          endif
+        endif
+        shape = [count(1:n-1), prod(count(n:nd))];
+        if (n == 1)
+          shape(2) = 1;
+        endif
+      endif
+
+    endfunction
+
+    ## Return the block of a dimension of length LEN that contains the
+    ## elements selected by the subscript I.
+
+    function [start, count, stride, sub] = dim_block (i, len)
+
+      start = 0;
+      count = len;
+      stride = 1;
+      sub = ":";
+
+      if (ischar (i) && strcmp (i, ":"))
+        return;
+      endif
+
+      if (islogical (i))
+        if (numel (i) > len && any (i(len+1:end)))
+          error ("matfile: out of bound; value %d out of bound %d",
+                 find (i, 1, "last"), len);
+        endif
+        i = find (i);
+      endif
+
+      if (! isnumeric (i) || any (i(:) < 1 | i(:) != fix (i(:))))
+        error ("matfile: subscripts must be either integers 1 to (2^63)-1 or logicals");
+      endif
+
+      if (any (i(:) > len))
+        error ("matfile: out of bound; value %d out of bound %d",
+               max (i(:)), len);
+      endif
+
+      i = double (i(:));
+
+      if (isempty (i))
+        count = 0;
+        sub = [];
+      elseif (isscalar (i))
+        start = i - 1;
+        count = 1;
+      else
+        d = diff (i);
+        if (d(1) > 0 && all (d == d(1)))
+          ## Evenly spaced, increasing subscripts select a strided block.
+          start = i(1) - 1;
+          count = numel (i);
+          stride = d(1);
+        else
+          start = min (i) - 1;
+          count = max (i) - start;
+          sub = i - start;
+        endif
+      endif
+
+    endfunction
+
+  endmethods
+
+endclassdef
+
+
+%!shared x, c, z, b, s
+%! x = reshape (1:120, 4, 5, 6);
+%! c = single (x) + 2i;
+%! z = int16 (magic (6));
+%! b = logical (mod (magic (5), 2));
+%! s.a = 1;
+
+%!function check_matfile (fmt, x, c, z, b, s)
+%!  f = [tempname() ".mat"];
+%!  unwind_protect
+%!    save (fmt, f, "x", "c", "z", "b", "s");
+%!    m = matfile (f);
+%!    assert (sort (who (m)), sort ({"b"; "c"; "s"; "x"; "z"}));
+%!    assert (size (m, "x"), [4, 5, 6]);
+%!    assert (size (m, "x", 3), 6);
+%!    info = whos (m);
+%!    assert (info(strcmp ({info.name}, "c")).class, "single");
+%!    assert (info(strcmp ({info.name}, "c")).complex, true);
+%!    assert (m.x, x);
+%!    assert (m.x(2, 3, 4), x(2, 3, 4));
+%!    assert (m.x(:, [1 3 5], 2:3), x(:, [1 3 5], 2:3));
+%!    assert (m.x([4 1 2], 5, [6 1]), x([4 1 2], 5, [6 1]));
+%!    assert (m.x(:, 7:9), x(:, 7:9));
+%!    assert (m.x(3, [2 17 30]), x(3, [2 17 30]));
+%!    assert (m.x(5:10), x(5:10));
+%!    assert (m.x([9; 2; 100]), x([9; 2; 100]));
+%!    assert (m.x(:), x(:));
+%!    assert (m.x(1, [], 2), x(1, [], 2));
+%!    assert (m.x(2, 3, 4, 1), x(2, 3, 4));
+%!    assert (m.c(2:3, 1, 1:2), c(2:3, 1, 1:2));
+%!    assert (m.z(5:6, 1:2:5), z(5:6, 1:2:5));
+%!    assert (m.b(logical ([1 0 1 0 1]), 2), b(logical ([1 0 1 0 1]), 2));
+%!    assert (m.s, s);
+%!    assert (m.s.a, 1);
+%!    assert (m.Properties.Writable, false);
+%!    fail ("m.x(5, 1, 1)", "out of bound");
+%!    fail ("m.y", "variable 'y' not found");
+%!    fail ("m.x(1) = 2", "Properties.Writable");
+%!
+%!    m.Properties.Writable = true;
+%!    m.x(2, 3:4, 5) = [-1, -2];
+%!    x(2, 3:4, 5) = [-1, -2];
+%!    m.x([3 1], 1, 1) = [7; 8];
+%!    x([3 1], 1, 1) = [7; 8];
+%!    m.x(:, 2, 6) = 0;
+%!    x(:, 2, 6) = 0;
+%!    m.z(6, 6) = 1000;
+%!    z(6, 6) = 1000;
+%!    m.c(1, 1, 1) = 5;
+%!    c(1, 1, 1) = 5;
+%!    m.b(2, :) = true;
+%!    b(2, :) = true;
+%!    m.s.b = "text";
+%!    s.b = "text";
+%!    m.y = 1:3;
+%!    assert (m.x, x);
+%!    assert (m.z, z);
+%!    assert (m.c, c);
+%!    assert (m.b, b);
+%!    assert (m.s, s);
+%!    assert (m.y, 1:3);
+%!    fail ("m.x(5, 1, 1) = 1", "out of bound");
+%!
+%!    ## The file is still a valid data file.
+%!    vars = load (f);
+%!    assert (vars.x, x);
+%!    assert (vars.s, s);
+%!    assert (vars.y, 1:3);
+%!  unwind_protect_cleanup
+%!    unlink (f);
+%!  end_unwind_protect
+%!endfunction
+
+%!test
+%! check_matfile ("-binary", x, c, z, b, s);
+
+%!testif HAVE_HDF5
+%! check_matfile ("-hdf5", x, c, z, b, s);
+
+## Cell arrays, structures, strings, and sparse matrices are listed
+## from their dimensions without loading them
+%!function check_matfile_whos (fmt)
+%!  a = {rand(3, 4), "text"; {int8([1, 2])}, []};
+%!  t = struct ("p", {1, "two", {3}});
+%!  str = ["abc"; "def"];
+%!  sp = sparse ([1, 3], [2, 2], [4, 5], 3, 4);
+%!  spc = sp * 1i;
+%!  spb = sp > 4;
+%!  e = {};
+%!  f = [tempname() ".mat"];
+%!  unwind_protect
+%!    save (fmt, f, "a", "t", "str", "sp", "spc", "spb", "e");
+%!    m = matfile (f);
+%!    info = whos (m);
+%!    ## Compare with the loaded values, whose sizes may differ from those
+%!    ## of the saved ones.
+%!    clear a t str sp spc spb e;
+%!    load (f);
+%!    expected = whos ("a", "t", "str", "sp", "spc", "spb", "e");
+%!    assert (numel (info), numel (expected));
+%!    for i = 1:numel (expected)
+%!      v = info(strcmp ({info.name}, expected(i).name));
+%!      assert (v.size, expected(i).size);
+%!      assert (v.bytes, expected(i).bytes);
+%!      assert (v.class, expected(i).class);
+%!      assert (v.complex, expected(i).complex);
+%!    endfor
+%!    assert (m.a, a);
+%!    assert (m.t, t);
+%!    assert (m.spc, spc);
+%!  unwind_protect_cleanup
+%!    unlink (f);
+%!  end_unwind_protect
+%!endfunction
+
+%!test
+%! check_matfile_whos ("-binary");
+
+%!testif HAVE_HDF5
+%! check_matfile_whos ("-hdf5");
+
+## Arrays saved with a reduced type are written by saving them again
+%!test
+%! f = [tempname() ".mat"];
+%! unwind_protect
+%!   x = repmat ((1:100)', 1, 100);
+%!   save ("-binary", f, "x");
+%!   m = matfile (f, "Writable", true);
+%!   assert (m.x(50:52, 7), (50:52)');
+%!   m.x(1, 1) = 0.5;
+%!   x(1, 1) = 0.5;
+%!   assert (m.x, x);
+%!   assert (load (f).x, x);
+%! unwind_protect_cleanup
+%!   unlink (f);
+%! end_unwind_protect
+
+%!testif HAVE_HDF5
+%! f = [tempname() ".mat"];
+%! unwind_protect
+%!   m = matfile (f, "Writable", true);
+%!   m.a = zeros (3);
+%!   m.a(2, :) = 1:3;
+%!   assert (m.a, [0, 0, 0; 1, 2, 3; 0, 0, 0]);
+%!   assert (load (f).a, [0, 0, 0; 1, 2, 3; 0, 0, 0]);
+%! unwind_protect_cleanup
+%!   unlink (f);
+%! end_unwind_protect
+
+## Test input validation
+%!error <Invalid call> matfile ()
+%!error <FILENAME must be a string> matfile (1)
+%!error <unable to find file> matfile ("__no_such_file__.mat")
+%!error <only option is "Writable"> matfile ("a.mat", "Mode", true)
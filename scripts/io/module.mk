@@ -8,7 +8,9 @@ FCN_FILE_DIRS += %reldir%
   %reldir%/dlmwrite.m \
   %reldir%/fileread.m \
   %reldir%/importdata.m \
-  %reldir%/is_valid_file_id.m
+  %reldir%/is_valid_file_id.m \
+  %reldir%/matfile.m \
+  %reldir%/textscanreader.m
 
 %canon_reldir%dir = $(fcnfiledir)/io
 
@@ -0,0 +1,462 @@
+########################################################################
+##
+## Copyright (C) 2024 The Octave Project Developers
+##
+## See the file COPYRIGHT.md in the top-level directory of this
+## distribution or <https://octave.org/copyright/>.
+##
+## This file is part of Octave.
+##
+## Octave is free software: you can redistribute it and/or modify it
+## under the terms of the GNU General Public License as published by
+## the Free Software Foundation, either version 3 of the License, or
+## (at your option) any later version.
+##
+## Octave is distributed in the hope that it will be useful, but
+## WITHOUT ANY WARRANTY; without even the implied warranty of
+## MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+## GNU General Public License for more details.
+##
+## You should have received a copy of the GNU General Public License
+## along with Octave; see the file COPYING.  If not, see
+## <https://www.gnu.org/licenses/>.
+##
+########################################################################
+
+classdef textscanreader < handle
+
+  ## -*- texinfo -*-
+  ## @deftypefn  {} {@var{r} =} textscanreader (@var{file})
+  ## @deftypefnx {} {@var{r} =} textscanreader (@var{file}, @var{format})
+  ## @deftypefnx {} {@var{r} =} textscanreader (@dots{}, @var{param}, @var{value}, @dots{})
+  ## Create a reader that returns the records of a text file in batches.
+  ##
+  ## @var{file} is the name of a file or a file id returned by @code{fopen}
+  ## or @code{popen}.  Records are read with the format @var{format} and the
+  ## options @var{param}, @var{value}, @dots{} as by
+  ## @code{textscan (@var{fid}, @var{format}, @var{n}, @var{param}, @var{value}, @dots{})},
+  ## and each call to @code{read} returns the next @var{n} records in the
+  ## same form as @code{textscan}.  @var{n} is the value of the
+  ## @qcode{"ReadSize"} option, which is 10000 by default and can be changed
+  ## later with @code{@var{r}.ReadSize = @var{n}}.  If @var{format} is
+  ## omitted, the default is @qcode{"%f"}.
+  ##
+  ## Unlike repeated calls to @code{textscan}, the reader parses the format
+  ## and options once and keeps its input buffer between calls.  The next
+  ## block of the file is read by a background thread while the current one
+  ## is parsed.  Only the records of one batch and two blocks of the file are
+  ## held in memory at a time, so files that are larger than the available
+  ## memory can be processed:
+  ##
+  ## @example
+  ## @group
+  ## r = textscanreader ("server.log", "%s %s %f",
+  ##                     "Delimiter", ",", "ReadSize", 1e5);
+  ## total = 0;
+  ## while (hasdata (r))
+  ##   C = read (r);
+  ##   total += sum (C@{3@});
+  ## endwhile
+  ## @end group
+  ## @end example
+  ##
+  ## The methods of @var{r} are:
+  ##
+  ## @table @code
+  ## @item @var{C} = read (@var{r})
+  ## @itemx @var{C} = read (@var{r}, @var{n})
+  ## Read the next @var{r}.ReadSize records, or the next @var{n} records.
+  ##
+  ## @item @var{tf} = hasdata (@var{r})
+  ## Return true if more records can be read.  Only whitespace and empty
+  ## lines are ignored at the end of the file, so the last batch is empty if
+  ## the file ends with a comment.
+  ##
+  ## @item reset (@var{r})
+  ## Start again from the beginning of the file, or, for a file id, from the
+  ## position where the reader was created.  A reader for a pipe cannot be
+  ## reset.
+  ## @end table
+  ##
+  ## A file that is given by name is closed when @var{r} is deleted.  A file
+  ## id is left open, but other functions such as @code{fgetl} or
+  ## @code{fseek} cannot use it while @var{r} exists, and its position is
+  ## unspecified afterwards.  Closing the file id with @code{fclose} also
+  ## closes @var{r}.  A reader cannot be used in the workers of a
+  ## @code{parfor} loop, which are separate processes.
+  ##
+  ## @seealso{textscan, fopen, popen}
+  ## @end deftypefn
+
+  properties (SetAccess = private)
+
+    ## File name or file id.
+    Source = "";
+
+    Format = "%f";
+
+  endproperties
+
+  properties
+
+    ## Number of records returned by read.
+    ReadSize = 10000;
+
+  endproperties
+
+  properties (Access = private)
+
+    ## Options passed to textscan.
+    options = {};
+
+    fid = -1;
+
+    ## True if the file was opened by the reader.
+    own_fid = false;
+
+    ## Position of the file where reading starts.
+    start = 0;
+
+    ## Identifier of the reader returned by __textscan_reader_open__, or 0
+    ## if it is closed.
+    id = 0;
+
+    done = true;
+
+  endproperties
+
+  methods
+
+    function this = textscanreader (file, format, varargin)
+
+      if (nargin < 1)
+        print_usage ();
+      endif
+
+      if (ischar (file))
+        if (! isrow (file))
+          error ("textscanreader: FILE must be a string or a file id");
+        endif
+      elseif (! is_valid_file_id (file))
+        error ("textscanreader: FILE must be a string or a file id");
+      endif
+
+      if (nargin > 1)
+        if (! ischar (format))
+          error ("textscanreader: FORMAT must be a string");
+        endif
+        this.Format = format;
+      endif
+
+      if (mod (numel (varargin), 2) != 0)
+        error ("textscanreader: options must be given as PARAM, VALUE pairs");
+      endif
+
+      idx = 2 * find (strcmpi (varargin(1:2:end), "ReadSize")) - 1;
+      if (! isempty (idx))
+        this.ReadSize = varargin{idx(end)+1};
+        varargin([idx, idx+1]) = [];
+      endif
+      this.options = varargin;
+
+      this.Source = file;
+
+      if (ischar (file))
+        [this.fid, msg] = fopen (file, "r");
+        if (this.fid < 0)
+          error ("textscanreader: unable to open file '%s': %s", file, msg);
+        endif
+        this.own_fid = true;
+      else
+        this.fid = file;
+        this.start = ftell (file);
+      endif
+
+      open_reader (this);
+
+    endfunction
+
+    function delete (this)
+
+      close_reader (this);
+
+      if (this.own_fid && this.fid >= 0)
+        fclose (this.fid);
+        this.fid = -1;
+      endif
+
+    endfunction
+
+    function set.ReadSize (this, n)
+
+      if (! (isnumeric (n) && isscalar (n) && n >= 1 && n == fix (n)))
+        error ("textscanreader: ReadSize must be a positive integer");
+      endif
+      this.ReadSize = double (n);
+
+    endfunction
+
+    function C = read (this, n)
+
+      if (nargin < 2)
+        n = this.ReadSize;
+      elseif (! (isnumeric (n) && isscalar (n) && n >= 1 && n == fix (n)))
+        error ("textscanreader: N must be a positive integer");
+      endif
+
+      if (this.id == 0)
+        error ("textscanreader: reader is closed");
+      endif
+
+      [C, this.done] = __textscan_reader_read__ ("textscanreader", this.id,
+                                                 n);
+
+    endfunction
+
+    function tf = hasdata (this)
+
+      tf = ! this.done;
+
+    endfunction
+
+    function reset (this)
+
+      if (this.start < 0)
+        error ("textscanreader: FILE cannot be repositioned");
+      endif
+
+      ## Wait until the file is no longer read in the background.
+      close_reader (this, true);
+
+      if (fseek (this.fid, this.start, SEEK_SET) != 0)
+        error ("textscanreader: FILE cannot be repositioned");
+      endif
+
+      open_reader (this);
+
+    endfunction
+
+    function disp (this)
+
+      if (ischar (this.Source))
+        src = this.Source;
+      else
+        src = sprintf ("file id %d", this.Source);
+      endif
+
+      printf ("  textscanreader object with properties:\n\n");
+      printf ("    Source   : %s\n", src);
+      printf ("    Format   : %s\n", this.Format);
+      printf ("    ReadSize : %d\n\n", this.ReadSize);
+
+    endfunction
+
+  endmethods
+
+  methods (Access = private)
+
+    function open_reader (this)
+
+      try
+        [this.id, this.done] = __textscan_reader_open__ ("textscanreader",
+                                                         this.fid,
+                                                         this.Format,
+                                                         this.options{:});
+      catch err
+        if (this.own_fid)
+          fclose (this.fid);
+          this.fid = -1;
+        endif
+        rethrow (err);
+      end_try_catch
+
+    endfunction
+
+    function close_reader (this, wait)
+
+      if (this.id != 0)
+        __textscan_reader_close__ (this.id, nargin > 1 && wait);
+        this.id = 0;
+      endif
+
+    endfunction
+
+  endmethods
+
+endclassdef
+
+
+%!test
+%! f = tempname ();
+%! unwind_protect
+%!   fid = fopen (f, "wt");
+%!   fprintf (fid, "name,value\n");
+%!   fprintf (fid, "r%d,%d\n", [1:25; (1:25) * 10]);
+%!   fclose (fid);
+%!   r = textscanreader (f, "%s %f", "Delimiter", ",", "HeaderLines", 1,
+%!                       "ReadSize", 10);
+%!   assert (hasdata (r));
+%!   C = read (r);
+%!   assert (C{1}, arrayfun (@(i) sprintf ("r%d", i), (1:10)',
+%!                           "UniformOutput", false));
+%!   assert (C{2}, (10:10:100)');
+%!   C = read (r, 5);
+%!   assert (C{2}, (110:10:150)');
+%!   C = read (r);
+%!   assert (C{2}, (160:10:250)');
+%!   assert (! hasdata (r));
+%!   C = read (r);
+%!   assert (isempty (C{2}));
+%!   reset (r);
+%!   C = read (r, 100);
+%!   assert (C{2}, (10:10:250)');
+%!   assert (! hasdata (r));
+%!   delete (r);
+%! unwind_protect_cleanup
+%!   unlink (f);
+%! end_unwind_protect
+
+## Batches that span the blocks of the file give the same result as textscan
+%!test
+%! f = tempname ();
+%! unwind_protect
+%!   x = reshape (1:300000, 3, []);
+%!   fid = fopen (f, "wt");
+%!   fprintf (fid, "%d %d %d\n", x);
+%!   fclose (fid);
+%!   fid = fopen (f, "r");
+%!   r = textscanreader (fid, "%d %d %d", "CollectOutput", true,
+%!                       "ReadSize", 33333);
+%!   y = zeros (0, 3, "int32");
+%!   while (hasdata (r))
+%!     C = read (r);
+%!     assert (! isempty (C{1}));
+%!     y = [y; C{1}];
+%!   endwhile
+%!   delete (r);
+%!   fclose (fid);
+%!   assert (y, int32 (x'));
+%! unwind_protect_cleanup
+%!   unlink (f);
+%! end_unwind_protect
+
+%!test
+%! f = tempname ();
+%! unwind_protect
+%!   fid = fopen (f, "wt");
+%!   fprintf (fid, "1 2 3\n4 5 6\n7 8 9\n");
+%!   fclose (fid);
+%!   r = textscanreader (f, "", "ReadSize", 2);
+%!   C = read (r);
+%!   assert ([C{:}], [1, 2, 3; 4, 5, 6]);
+%!   C = read (r);
+%!   assert ([C{:}], [7, 8, 9]);
+%!   assert (! hasdata (r));
+%! unwind_protect_cleanup
+%!   unlink (f);
+%! end_unwind_protect
+
+## Trailing whitespace and empty lines
+%!test
+%! f = tempname ();
+%! unwind_protect
+%!   fid = fopen (f, "wt");
+%!   fprintf (fid, "1\n2\n  \n\n");
+%!   fclose (fid);
+%!   r = textscanreader (f, "%f", "ReadSize", 2);
+%!   C = read (r);
+%!   assert (C{1}, [1; 2]);
+%!   assert (! hasdata (r));
+%! unwind_protect_cleanup
+%!   unlink (f);
+%! end_unwind_protect
+
+## Closing the file closes the reader
+%!test
+%! f = tempname ();
+%! unwind_protect
+%!   fid = fopen (f, "wt");
+%!   fprintf (fid, "%d\n", 1:10);
+%!   fclose (fid);
+%!   fid = fopen (f, "r");
+%!   r = textscanreader (fid, "%f", "ReadSize", 4);
+%!   C = read (r);
+%!   assert (C{1}, (1:4)');
+%!   fclose (fid);
+%!   fail ("read (r)", "invalid reader ID");
+%!   delete (r);
+%! unwind_protect_cleanup
+%!   unlink (f);
+%! end_unwind_protect
+
+## The file id cannot be used otherwise while the reader exists
+%!test
+%! f = tempname ();
+%! unwind_protect
+%!   fid = fopen (f, "wt");
+%!   fprintf (fid, "%d\n", 1:10);
+%!   fclose (fid);
+%!   fid = fopen (f, "r");
+%!   r = textscanreader (fid, "%f", "ReadSize", 4);
+%!   fail ("fgetl (fid)", "is being read by a textscanreader");
+%!   fail ("fseek (fid, 0, SEEK_SET)", "is being read by a textscanreader");
+%!   fail ("textscanreader (fid)", "is being read by a textscanreader");
+%!   C = read (r);
+%!   assert (C{1}, (1:4)');
+%!   reset (r);
+%!   C = read (r);
+%!   assert (C{1}, (1:4)');
+%!   delete (r);
+%!   frewind (fid);
+%!   assert (fgetl (fid), "1");
+%!   fclose (fid);
+%! unwind_protect_cleanup
+%!   unlink (f);
+%! end_unwind_protect
+
+## parfor workers are forked processes without the background thread
+%!testif ; isunix ()
+%! f = tempname ();
+%! unwind_protect
+%!   fid = fopen (f, "wt");
+%!   fprintf (fid, "%d\n", 1:10);
+%!   fclose (fid);
+%!   r = textscanreader (f, "%f", "ReadSize", 4);
+%!   msg = "";
+%!   try
+%!     parfor (i = 1:2, 2)
+%!       C = read (r);
+%!     endparfor
+%!   catch err
+%!     msg = err.message;
+%!   end_try_catch
+%!   assert (msg, "textscanreader: reader cannot be used in a child process");
+%!   C = read (r);
+%!   assert (C{1}, (1:4)');
+%!   delete (r);
+%! unwind_protect_cleanup
+%!   unlink (f);
+%! end_unwind_protect
+
+%!testif ; isunix ()
+%! fid = popen ('printf "1 2\n3 4\n5 6\n"', "r");
+%! unwind_protect
+%!   r = textscanreader (fid, "%f %f", "ReadSize", 2);
+%!   C = read (r);
+%!   assert ([C{:}], [1, 2; 3, 4]);
+%!   assert (hasdata (r));
+%!   C = read (r);
+%!   assert ([C{:}], [5, 6]);
+%!   assert (! hasdata (r));
+%!   fail ("reset (r)", "FILE cannot be repositioned");
+%!   delete (r);
+%! unwind_protect_cleanup
+%!   pclose (fid);
+%! end_unwind_protect
+
+## Test input validation
+%!error <Invalid call> textscanreader ()
+%!error <FILE must be a string or a file id> textscanreader ({})
+%!error <FORMAT must be a string> textscanreader ("a.txt", 1)
+%!error <PARAM, VALUE pairs> textscanreader ("a.txt", "%f", "ReadSize")
+%!error <unable to open file> textscanreader ("__no_such_file__.txt")
@@ -60,7 +60,12 @@
 ## @code{Hierarchical} contains the hierarchical call tree.  Each node has an
 ## index into the @code{FunctionTable} identifying the function it corresponds
 ## to as well as data fields for number of calls and time spent at this level
-## in the call tree.
+## in the call tree.  The field @code{FrameStats} counts the stack frames
+## created for function calls while profiling (@code{FramesCreated}), how many
+## of them reused memory released by an earlier call (@code{FramesReused}) or
+## needed a new allocation (@code{FramesAllocated}), and how many needed a
+## separate allocation for their local variables
+## (@code{ValueArraysAllocated}).
 ## @end table
 ##
 ## @seealso{profshow, profexplore}
@@ -97,8 +102,9 @@ function retval = profile (arg)
       retval = struct ("ProfilerStatus", enabled);
 
     case "info"
-      [flat, tree] = __profiler_data__ ();
-      retval = struct ("FunctionTable", flat, "Hierarchical", tree);
+      [flat, tree, frames] = __profiler_data__ ();
+      retval = struct ("FunctionTable", flat, "Hierarchical", tree,
+                       "FrameStats", frames);
 
     otherwise
       warning ("profile: Unrecognized option '%s'", arg);
@@ -135,16 +141,21 @@ endfunction
 %! info = profile ("info");
 %! assert (isstruct (info));
 %! assert (size (info), [1, 1]);
-%! assert (fieldnames (info), {"FunctionTable"; "Hierarchical"});
+%! assert (fieldnames (info), {"FunctionTable"; "Hierarchical"; "FrameStats"});
 %! ftbl = info.FunctionTable;
 %! assert (fieldnames (ftbl), {"FunctionName"; "TotalTime"; "NumCalls"; "IsRecursive"; "Parents"; "Children"});
 %! hier = info.Hierarchical;
 %! assert (fieldnames (hier), {"Index"; "SelfTime"; "TotalTime"; "NumCalls"; "Children"});
+%! frames = info.FrameStats;
+%! assert (fieldnames (frames), {"FramesCreated"; "FramesReused"; "FramesAllocated"; "ValueArraysAllocated"});
+%! assert (frames.FramesCreated > 0);
+%! assert (frames.FramesCreated, frames.FramesReused + frames.FramesAllocated);
 %! profile ("clear");
 %! info = profile ("info");
 %! assert (isstruct (info));
 %! assert (size (info), [1, 1]);
-%! assert (fieldnames (info), {"FunctionTable"; "Hierarchical"});
+%! assert (fieldnames (info), {"FunctionTable"; "Hierarchical"; "FrameStats"});
+%! assert (info.FrameStats.FramesCreated, 0);
 %! ftbl = info.FunctionTable;
 %! assert (size (ftbl), [0, 1]);
 %! assert (fieldnames (ftbl), {"FunctionName"; "TotalTime"; "NumCalls"; "IsRecursive"; "Parents"; "Children"});
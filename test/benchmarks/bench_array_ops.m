@@ -0,0 +1,83 @@
+########################################################################
+##
+## Copyright (C) 2024 The Octave Project Developers
+##
+## See the file COPYRIGHT.md in the top-level directory of this
+## distribution or <https://octave.org/copyright/>.
+##
+## This file is part of Octave.
+##
+## Octave is free software: you can redistribute it and/or modify it
+## under the terms of the GNU General Public License as published by
+## the Free Software Foundation, either version 3 of the License, or
+## (at your option) any later version.
+##
+## Octave is distributed in the hope that it will be useful, but
+## WITHOUT ANY WARRANTY; without even the implied warranty of
+## MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+## GNU General Public License for more details.
+##
+## You should have received a copy of the GNU General Public License
+## along with Octave; see the file COPYING.  If not, see
+## <https://www.gnu.org/licenses/>.
+##
+########################################################################
+
+## -*- texinfo -*-
+## @deftypefn {} {@var{results} =} bench_array_ops ()
+## Measure element-wise arithmetic, reductions, and sorting of an array with
+## 1e7 elements, once with a single thread and once with the number of threads
+## returned by @code{maxNumCompThreads}.  The reported times are per element.
+## @seealso{run_benchmarks, maxNumCompThreads}
+## @end deftypefn
+
+function results = bench_array_ops ()
+
+  n = 1e7;
+  x = rand (n, 1);
+  y = rand (n, 1);
+  a = reshape (x, 1e3, []);
+  i8 = int8 (255 * x - 128);
+  j8 = int8 (255 * y - 128);
+
+  ops = {"x .* y", @() x .* y;
+         "x + 1", @() x + 1;
+         "x .* y + 2*x - y", @() x .* y + 2*x - y;
+         "x < y", @() x < y;
+         "max (x, y)", @() max (x, y);
+         "isnan (x)", @() isnan (x);
+         "int8 .* int8", @() i8 .* j8;
+         "int8 + int8", @() i8 + j8;
+         "sum (x)", @() sum (x);
+         "prod (x)", @() prod (x);
+         "sum (a)", @() sum (a);
+         "max (a)", @() max (a);
+         "cumsum (a)", @() cumsum (a);
+         "cumsum (a, 2)", @() cumsum (a, 2);
+         "cummax (a, 2)", @() cummax (a, [], 2);
+         "diff (a, 1, 2)", @() diff (a, 1, 2);
+         "filter (a)", @() filter ([1, 1], [1, -0.5], a);
+         "any (isnan (x))", @() any (isnan (x));
+         "sort (x)", @() sort (x);
+         "sort (a)", @() sort (a);
+         "sort (a, 2)", @() sort (a, 2);
+         "sort (int8)", @() sort (i8)};
+
+  results = struct ("name", {}, "time", {});
+
+  nthreads = maxNumCompThreads ();
+  unwind_protect
+    for nt = unique ([1, nthreads])
+      maxNumCompThreads (nt);
+      for i = 1:rows (ops)
+        t = bench_time (ops{i,2}) / n;
+        results(end+1) = struct ("name",
+                                 sprintf ("%s (%d threads)", ops{i,1}, nt),
+                                 "time", t);
+      endfor
+    endfor
+  unwind_protect_cleanup
+    maxNumCompThreads (nthreads);
+  end_unwind_protect
+
+endfunction
@@ -0,0 +1,71 @@
+########################################################################
+##
+## Copyright (C) 2024 The Octave Project Developers
+##
+## See the file COPYRIGHT.md in the top-level directory of this
+## distribution or <https://octave.org/copyright/>.
+##
+## This file is part of Octave.
+##
+## Octave is free software: you can redistribute it and/or modify it
+## under the terms of the GNU General Public License as published by
+## the Free Software Foundation, either version 3 of the License, or
+## (at your option) any later version.
+##
+## Octave is distributed in the hope that it will be useful, but
+## WITHOUT ANY WARRANTY; without even the implied warranty of
+## MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+## GNU General Public License for more details.
+##
+## You should have received a copy of the GNU General Public License
+## along with Octave; see the file COPYING.  If not, see
+## <https://www.gnu.org/licenses/>.
+##
+########################################################################
+
+## -*- texinfo -*-
+## @deftypefn {} {@var{results} =} bench_containers_map ()
+## Measure inserting keys into a containers.Map object one at a time, looking
+## up each key, and looking up all keys with a single call to @code{values}.
+## Maps with char and with double keys are measured.  The reported times are
+## per key.
+## @seealso{run_benchmarks, containers.Map}
+## @end deftypefn
+
+function results = bench_containers_map ()
+
+  n = 1e4;
+  keysets = {"char", arrayfun (@(k) sprintf ("key%d", k), randperm (n),
+                               "UniformOutput", false);
+             "double", num2cell (randperm (n))};
+
+  results = struct ("name", {}, "time", {});
+
+  for i = 1:rows (keysets)
+    type = keysets{i,1};
+    keys = keysets{i,2};
+    m = containers.Map ("KeyType", type, "ValueType", "any");
+    t = bench_time (@() insert_keys (m, keys)) / n;
+    results(end+1) = struct ("name", sprintf ("insert (%s keys)", type),
+                             "time", t);
+    t = bench_time (@() lookup_keys (m, keys)) / n;
+    results(end+1) = struct ("name", sprintf ("lookup (%s keys)", type),
+                             "time", t);
+    t = bench_time (@() values (m, keys)) / n;
+    results(end+1) = struct ("name", sprintf ("values (%s keys)", type),
+                             "time", t);
+  endfor
+
+endfunction
+
+function insert_keys (m, keys)
+  for i = 1:numel (keys)
+    m(keys{i}) = i;
+  endfor
+endfunction
+
+function lookup_keys (m, keys)
+  for i = 1:numel (keys)
+    m(keys{i});
+  endfor
+endfunction
@@ -0,0 +1,75 @@
+########################################################################
+##
+## Copyright (C) 2024 The Octave Project Developers
+##
+## See the file COPYRIGHT.md in the top-level directory of this
+## distribution or <https://octave.org/copyright/>.
+##
+## This file is part of Octave.
+##
+## Octave is free software: you can redistribute it and/or modify it
+## under the terms of the GNU General Public License as published by
+## the Free Software Foundation, either version 3 of the License, or
+## (at your option) any later version.
+##
+## Octave is distributed in the hope that it will be useful, but
+## WITHOUT ANY WARRANTY; without even the implied warranty of
+## MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+## GNU General Public License for more details.
+##
+## You should have received a copy of the GNU General Public License
+## along with Octave; see the file COPYING.  If not, see
+## <https://www.gnu.org/licenses/>.
+##
+########################################################################
+
+## -*- texinfo -*-
+## @deftypefn {} {@var{results} =} bench_dlmread ()
+## Measure reading a CSV file of about 75 MB with @code{dlmread}, once with a
+## single thread and once with the number of threads returned by
+## @code{maxNumCompThreads}.  The names of the results include the throughput
+## in megabytes of text per second.  For comparison, the same file is also read
+## from a file id, which always uses the general, serial parser.
+## @seealso{run_benchmarks, maxNumCompThreads}
+## @end deftypefn
+
+function results = bench_dlmread ()
+
+  file = [tempname(), ".csv"];
+
+  fid = fopen (file, "wt");
+  fprintf (fid, "%.15g,%.15g,%.15g,%.15g,%.15g,%.15g\n", randn (6, 5e5));
+  fprintf (fid, "%d,%d,%d,%d,%d,%d\n", randi (1e6, 6, 5e5));
+  fclose (fid);
+
+  info = dir (file);
+  mbytes = info.bytes / 2^20;
+
+  results = struct ("name", {}, "time", {});
+
+  nthreads = maxNumCompThreads ();
+  unwind_protect
+    for nt = unique ([1, nthreads])
+      maxNumCompThreads (nt);
+      t = bench_time (@() dlmread (file, ","), 3);
+      results(end+1) = struct ("name",
+                               sprintf ("dlmread file (%d threads, %.0f MB/s)",
+                                        nt, mbytes / t),
+                               "time", t);
+    endfor
+    t = bench_time (@() read_fid (file), 1);
+    results(end+1) = struct ("name",
+                             sprintf ("dlmread fid (%.0f MB/s)", mbytes / t),
+                             "time", t);
+  unwind_protect_cleanup
+    maxNumCompThreads (nthreads);
+    unlink (file);
+  end_unwind_protect
+
+endfunction
+
+function data = read_fid (file)
+  fid = fopen (file, "rt");
+  data = dlmread (fid, ",");
+  fclose (fid);
+endfunction
@@ -0,0 +1,79 @@
+########################################################################
+##
+## Copyright (C) 2024 The Octave Project Developers
+##
+## See the file COPYRIGHT.md in the top-level directory of this
+## distribution or <https://octave.org/copyright/>.
+##
+## This file is part of Octave.
+##
+## Octave is free software: you can redistribute it and/or modify it
+## under the terms of the GNU General Public License as published by
+## the Free Software Foundation, either version 3 of the License, or
+## (at your option) any later version.
+##
+## Octave is distributed in the hope that it will be useful, but
+## WITHOUT ANY WARRANTY; without even the implied warranty of
+## MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+## GNU General Public License for more details.
+##
+## You should have received a copy of the GNU General Public License
+## along with Octave; see the file COPYING.  If not, see
+## <https://www.gnu.org/licenses/>.
+##
+########################################################################
+
+## -*- texinfo -*-
+## @deftypefn {} {@var{results} =} bench_fcn_call ()
+## Measure the cost of calling small functions, where creating the stack
+## frame for the call is a large part of the work: a subfunction, a function
+## with many local variables, and an anonymous function.  The reported times
+## are per call.
+## @seealso{run_benchmarks, profile}
+## @end deftypefn
+
+function results = bench_fcn_call ()
+
+  n = 1e5;
+  tests = {"accessor subfunction", @() call_accessor (n);
+           "many locals subfunction", @() call_many_locals (n);
+           "anonymous function", @() call_anonymous (n)};
+
+  results = struct ("name", {}, "time", {});
+
+  for i = 1:rows (tests)
+    t = bench_time (tests{i,2}) / n;
+    results(end+1) = struct ("name", tests{i,1}, "time", t);
+  endfor
+
+endfunction
+
+function call_accessor (n)
+  s.value = 1;
+  for i = 1:n
+    get_value (s);
+  endfor
+endfunction
+
+function call_many_locals (n)
+  for i = 1:n
+    many_locals (i);
+  endfor
+endfunction
+
+function call_anonymous (n)
+  f = @(x) x + 1;
+  for i = 1:n
+    f (i);
+  endfor
+endfunction
+
+function v = get_value (s)
+  v = s.value;
+endfunction
+
+function r = many_locals (x)
+  a = x; b = a; c = b; d = c; e = d; f = e; g = f; h = g; k = h;
+  l = k; m = l; n = m; o = n; p = o; q = p; r = q; t = r; u = t;
+  r = u;
+endfunction
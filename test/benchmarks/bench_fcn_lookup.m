@@ -0,0 +1,87 @@
+########################################################################
+##
+## Copyright (C) 2024 The Octave Project Developers
+##
+## See the file COPYRIGHT.md in the top-level directory of this
+## distribution or <https://octave.org/copyright/>.
+##
+## This file is part of Octave.
+##
+## Octave is free software: you can redistribute it and/or modify it
+## under the terms of the GNU General Public License as published by
+## the Free Software Foundation, either version 3 of the License, or
+## (at your option) any later version.
+##
+## Octave is distributed in the hope that it will be useful, but
+## WITHOUT ANY WARRANTY; without even the implied warranty of
+## MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+## GNU General Public License for more details.
+##
+## You should have received a copy of the GNU General Public License
+## along with Octave; see the file COPYING.  If not, see
+## <https://www.gnu.org/licenses/>.
+##
+########################################################################
+
+## -*- texinfo -*-
+## @deftypefn {} {@var{results} =} bench_fcn_lookup ()
+## Measure the cost of calling a built-in function, a subfunction, and a
+## function file on the load path with and without the per call site cache of
+## function lookups.  The reported times are per call.
+## @seealso{run_benchmarks, __fcn_lookup_cache__}
+## @end deftypefn
+
+function results = bench_fcn_lookup ()
+
+  n = 1e5;
+  tests = {"builtin", @() call_builtin (n);
+           "subfunction", @() call_subfunction (n);
+           "load path function", @() call_path_function (n)};
+
+  results = struct ("name", {}, "time", {});
+
+  old_cache = __fcn_lookup_cache__ ();
+  unwind_protect
+    for i = 1:rows (tests)
+      for cache = [false, true]
+        __fcn_lookup_cache__ (cache);
+        name = sprintf ("%s call (%s)", tests{i,1}, cache_name (cache));
+        t = bench_time (tests{i,2}) / n;
+        results(end+1) = struct ("name", name, "time", t);
+      endfor
+    endfor
+  unwind_protect_cleanup
+    __fcn_lookup_cache__ (old_cache);
+  end_unwind_protect
+
+endfunction
+
+function s = cache_name (cache)
+  if (cache)
+    s = "cached";
+  else
+    s = "uncached";
+  endif
+endfunction
+
+function call_builtin (n)
+  x = 1;
+  for i = 1:n
+    numel (x);
+  endfor
+endfunction
+
+function call_subfunction (n)
+  for i = 1:n
+    noop ();
+  endfor
+endfunction
+
+function call_path_function (n)
+  for i = 1:n
+    deal (i);
+  endfor
+endfunction
+
+function noop ()
+endfunction
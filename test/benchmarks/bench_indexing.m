@@ -0,0 +1,81 @@
+########################################################################
+##
+## Copyright (C) 2024 The Octave Project Developers
+##
+## See the file COPYRIGHT.md in the top-level directory of this
+## distribution or <https://octave.org/copyright/>.
+##
+## This file is part of Octave.
+##
+## Octave is free software: you can redistribute it and/or modify it
+## under the terms of the GNU General Public License as published by
+## the Free Software Foundation, either version 3 of the License, or
+## (at your option) any later version.
+##
+## Octave is distributed in the hope that it will be useful, but
+## WITHOUT ANY WARRANTY; without even the implied warranty of
+## MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+## GNU General Public License for more details.
+##
+## You should have received a copy of the GNU General Public License
+## along with Octave; see the file COPYING.  If not, see
+## <https://www.gnu.org/licenses/>.
+##
+########################################################################
+
+## -*- texinfo -*-
+## @deftypefn {} {@var{results} =} bench_indexing ()
+## Measure indexing and indexed assignment of arrays with 1e7 elements by
+## index vectors, logical masks, and column indices, once with a single thread
+## and once with the number of threads returned by @code{maxNumCompThreads}.
+## An indexed assignment also copies the array that is assigned to.  The
+## reported times are per element of the array.
+## @seealso{run_benchmarks, maxNumCompThreads}
+## @end deftypefn
+
+function results = bench_indexing ()
+
+  n = 1e7;
+  x = rand (n, 1);
+  a = reshape (x, 1e3, []);
+  idx = randi (n, n, 1);
+  perm = randperm (n);
+  cols = randperm (columns (a));
+  mask = x < 0.5;
+  v = rand (nnz (mask), 1);
+  b = rand (size (a));
+
+  ops = {"x(idx)", @() x(idx);
+         "x(perm)", @() x(perm);
+         "x(mask)", @() x(mask);
+         "x(1:2:end)", @() x(1:2:end);
+         "a(:, cols)", @() a(:, cols);
+         "a(1:2:end, cols)", @() a(1:2:end, cols);
+         "a(101:900, :)", @() a(101:900, :);
+         "x(perm) = x", @() assign (x, {perm}, x);
+         "x(mask) = v", @() assign (x, {mask}, v);
+         "x(mask) = 0", @() assign (x, {mask}, 0);
+         "a(:, cols) = b", @() assign (a, {":", cols}, b)};
+
+  results = struct ("name", {}, "time", {});
+
+  nthreads = maxNumCompThreads ();
+  unwind_protect
+    for nt = unique ([1, nthreads])
+      maxNumCompThreads (nt);
+      for i = 1:rows (ops)
+        t = bench_time (ops{i,2}) / n;
+        results(end+1) = struct ("name",
+                                 sprintf ("%s (%d threads)", ops{i,1}, nt),
+                                 "time", t);
+      endfor
+    endfor
+  unwind_protect_cleanup
+    maxNumCompThreads (nthreads);
+  end_unwind_protect
+
+endfunction
+
+function x = assign (x, idx, rhs)
+  x(idx{:}) = rhs;
+endfunction
@@ -0,0 +1,97 @@
+########################################################################
+##
+## Copyright (C) 2024 The Octave Project Developers
+##
+## See the file COPYRIGHT.md in the top-level directory of this
+## distribution or <https://octave.org/copyright/>.
+##
+## This file is part of Octave.
+##
+## Octave is free software: you can redistribute it and/or modify it
+## under the terms of the GNU General Public License as published by
+## the Free Software Foundation, either version 3 of the License, or
+## (at your option) any later version.
+##
+## Octave is distributed in the hope that it will be useful, but
+## WITHOUT ANY WARRANTY; without even the implied warranty of
+## MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+## GNU General Public License for more details.
+##
+## You should have received a copy of the GNU General Public License
+## along with Octave; see the file COPYING.  If not, see
+## <https://www.gnu.org/licenses/>.
+##
+########################################################################
+
+## -*- texinfo -*-
+## @deftypefn {} {@var{results} =} bench_interpreter ()
+## Compare the tree evaluator and the bytecode interpreter on code that is
+## dominated by interpreter overhead: a scalar accumulation loop, naive
+## recursive Fibonacci numbers, and a while-loop Jacobi stencil.
+## @seealso{run_benchmarks, __vm_enable__}
+## @end deftypefn
+
+function results = bench_interpreter ()
+
+  tests = {"scalar loop",  @() scalar_loop (1e6);
+           "recursive fib", @() fib (20);
+           "while-loop stencil", @() stencil (200, 50)};
+
+  results = struct ("name", {}, "time", {});
+
+  old_vm = __vm_enable__ ();
+  unwind_protect
+    for i = 1:rows (tests)
+      for vm = [false, true]
+        __vm_enable__ (vm);
+        name = sprintf ("%s (%s)", tests{i,1}, evaluator_name (vm));
+        results(end+1) = struct ("name", name, "time", bench_time (tests{i,2}));
+      endfor
+    endfor
+  unwind_protect_cleanup
+    __vm_enable__ (old_vm);
+  end_unwind_protect
+
+endfunction
+
+function s = evaluator_name (vm)
+  if (vm)
+    s = "bytecode";
+  else
+    s = "tree";
+  endif
+endfunction
+
+function s = scalar_loop (n)
+  s = 0;
+  for i = 1:n
+    s = s + i * 0.5;
+    if (s > 1e9)
+      s = s - 1e9;
+    endif
+  endfor
+endfunction
+
+function r = fib (n)
+  if (n < 2)
+    r = n;
+  else
+    r = fib (n-1) + fib (n-2);
+  endif
+endfunction
+
+function u = stencil (n, nsteps)
+  u = zeros (1, n);
+  u(1) = 1;
+  k = 0;
+  while (k < nsteps)
+    v = u;
+    i = 2;
+    while (i < n)
+      v(i) = 0.25 * u(i-1) + 0.5 * u(i) + 0.25 * u(i+1);
+      i = i + 1;
+    endwhile
+    u = v;
+    k = k + 1;
+  endwhile
+endfunction
@@ -0,0 +1,83 @@
+########################################################################
+##
+## Copyright (C) 2024 The Octave Project Developers
+##
+## See the file COPYRIGHT.md in the top-level directory of this
+## distribution or <https://octave.org/copyright/>.
+##
+## This file is part of Octave.
+##
+## Octave is free software: you can redistribute it and/or modify it
+## under the terms of the GNU General Public License as published by
+## the Free Software Foundation, either version 3 of the License, or
+## (at your option) any later version.
+##
+## Octave is distributed in the hope that it will be useful, but
+## WITHOUT ANY WARRANTY; without even the implied warranty of
+## MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+## GNU General Public License for more details.
+##
+## You should have received a copy of the GNU General Public License
+## along with Octave; see the file COPYING.  If not, see
+## <https://www.gnu.org/licenses/>.
+##
+########################################################################
+
+## -*- texinfo -*-
+## @deftypefn {} {@var{results} =} bench_save_load ()
+## Measure saving and loading a workspace of about 100 MB in @sc{matlab}'s v6
+## and v7 formats, once with a single thread and once with the number of
+## threads returned by @code{maxNumCompThreads}.  The workspace holds random
+## numbers, which compress poorly, integer-valued arrays, which compress well,
+## and many small variables.  The reported times are for the whole workspace,
+## and the names include the throughput in megabytes of data per second.
+## @seealso{run_benchmarks, maxNumCompThreads}
+## @end deftypefn
+
+function results = bench_save_load ()
+
+  s.noise = rand (2e3, 2.5e3);
+  s.counts = round (100 * randn (2e3, 2.5e3));
+  s.labels = int32 (randi (20, 1e7, 1));
+  for i = 1:200
+    s.(sprintf ("small%d", i)) = rand (10);
+  endfor
+
+  info = whos ("s");
+  mbytes = info.bytes / 2^20;
+
+  file = [tempname(), ".mat"];
+
+  results = struct ("name", {}, "time", {});
+
+  nthreads = maxNumCompThreads ();
+  unwind_protect
+    for nt = unique ([1, nthreads])
+      maxNumCompThreads (nt);
+      for fmt = {"-v6", "-v7"}
+        t = bench_time (@() save_file (file, fmt{1}, s), 3);
+        results(end+1) = struct ("name",
+                                 sprintf ("save %s (%d threads, %.0f MB/s)",
+                                          fmt{1}, nt, mbytes / t),
+                                 "time", t);
+        t = bench_time (@() load_file (file), 3);
+        results(end+1) = struct ("name",
+                                 sprintf ("load %s (%d threads, %.0f MB/s)",
+                                          fmt{1}, nt, mbytes / t),
+                                 "time", t);
+      endfor
+    endfor
+  unwind_protect_cleanup
+    maxNumCompThreads (nthreads);
+    unlink (file);
+  end_unwind_protect
+
+endfunction
+
+function save_file (file, fmt, s)
+  save (fmt, file, "-struct", "s");
+endfunction
+
+function s = load_file (file)
+  s = load (file);
+endfunction
@@ -0,0 +1,49 @@
+########################################################################
+##
+## Copyright (C) 2024 The Octave Project Developers
+##
+## See the file COPYRIGHT.md in the top-level directory of this
+## distribution or <https://octave.org/copyright/>.
+##
+## This file is part of Octave.
+##
+## Octave is free software: you can redistribute it and/or modify it
+## under the terms of the GNU General Public License as published by
+## the Free Software Foundation, either version 3 of the License, or
+## (at your option) any later version.
+##
+## Octave is distributed in the hope that it will be useful, but
+## WITHOUT ANY WARRANTY; without even the implied warranty of
+## MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+## GNU General Public License for more details.
+##
+## You should have received a copy of the GNU General Public License
+## along with Octave; see the file COPYING.  If not, see
+## <https://www.gnu.org/licenses/>.
+##
+########################################################################
+
+## -*- texinfo -*-
+## @deftypefn  {} {@var{t} =} bench_time (@var{fcn})
+## @deftypefnx {} {@var{t} =} bench_time (@var{fcn}, @var{nrep})
+## Return the best wall clock time in seconds of @var{nrep} calls to the
+## function handle @var{fcn}.
+##
+## @var{fcn} is called once before timing starts so that function lookup,
+## parsing, and compilation are not included.  The default for @var{nrep}
+## is 5.
+## @seealso{run_benchmarks}
+## @end deftypefn
+
+function t = bench_time (fcn, nrep = 5)
+
+  fcn ();
+
+  t = Inf;
+  for i = 1:nrep
+    t0 = tic ();
+    fcn ();
+    t = min (t, toc (t0));
+  endfor
+
+endfunction
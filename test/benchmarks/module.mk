@@ -0,0 +1,13 @@
+benchmarks_EXTRA_DIST = \
+  %reldir%/bench_array_ops.m \
+  %reldir%/bench_containers_map.m \
+  %reldir%/bench_dlmread.m \
+  %reldir%/bench_fcn_call.m \
+  %reldir%/bench_fcn_lookup.m \
+  %reldir%/bench_indexing.m \
+  %reldir%/bench_interpreter.m \
+  %reldir%/bench_save_load.m \
+  %reldir%/bench_time.m \
+  %reldir%/run_benchmarks.m
+
+EXTRA_DIST += $(benchmarks_EXTRA_DIST)
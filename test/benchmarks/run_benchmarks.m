@@ -0,0 +1,80 @@
+########################################################################
+##
+## Copyright (C) 2024 The Octave Project Developers
+##
+## See the file COPYRIGHT.md in the top-level directory of this
+## distribution or <https://octave.org/copyright/>.
+##
+## This file is part of Octave.
+##
+## Octave is free software: you can redistribute it and/or modify it
+## under the terms of the GNU General Public License as published by
+## the Free Software Foundation, either version 3 of the License, or
+## (at your option) any later version.
+##
+## Octave is distributed in the hope that it will be useful, but
+## WITHOUT ANY WARRANTY; without even the implied warranty of
+## MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+## GNU General Public License for more details.
+##
+## You should have received a copy of the GNU General Public License
+## along with Octave; see the file COPYING.  If not, see
+## <https://www.gnu.org/licenses/>.
+##
+########################################################################
+
+## -*- texinfo -*-
+## @deftypefn  {} {} run_benchmarks ()
+## @deftypefnx {} {} run_benchmarks (@var{pattern})
+## @deftypefnx {} {@var{results} =} run_benchmarks (@dots{})
+## Run the performance benchmarks in this directory and print a summary.
+##
+## Each benchmark is a function @file{bench_@var{name}.m} that takes no
+## arguments and returns a struct array with the fields @qcode{"name"} and
+## @qcode{"time"} (the best wall clock time in seconds, see
+## @code{bench_time}).  If @var{pattern} is given, only the benchmarks whose
+## @var{name} matches the regular expression @var{pattern} are run.
+##
+## Example:
+##
+## @example
+## @group
+## cd test/benchmarks
+## run_benchmarks ("interpreter");
+## @end group
+## @end example
+##
+## @seealso{bench_time}
+## @end deftypefn
+
+function results = run_benchmarks (pattern = "")
+
+  bench_dir = fileparts (mfilename ("fullpath"));
+  files = dir (fullfile (bench_dir, "bench_*.m"));
+
+  results = struct ("benchmark", {}, "name", {}, "time", {});
+
+  for i = 1:numel (files)
+    [~, fcn] = fileparts (files(i).name);
+    if (strcmp (fcn, "bench_time"))
+      continue;
+    endif
+    bench = fcn(7:end);
+    if (! isempty (pattern) && isempty (regexp (bench, pattern, "once")))
+      continue;
+    endif
+
+    printf ("%s\n", bench);
+    r = feval (fcn);
+    for j = 1:numel (r)
+      printf ("  %-40s %12.4g s\n", r(j).name, r(j).time);
+      results(end+1) = struct ("benchmark", bench, "name", r(j).name,
+                               "time", r(j).time);
+    endfor
+  endfor
+
+  if (nargout == 0)
+    clear results;
+  endif
+
+endfunction
@@ -0,0 +1,244 @@
+########################################################################
+##
+## Copyright (C) 2024 The Octave Project Developers
+##
+## See the file COPYRIGHT.md in the top-level directory of this
+## distribution or <https://octave.org/copyright/>.
+##
+## This file is part of Octave.
+##
+## Octave is free software: you can redistribute it and/or modify it
+## under the terms of the GNU General Public License as published by
+## the Free Software Foundation, either version 3 of the License, or
+## (at your option) any later version.
+##
+## Octave is distributed in the hope that it will be useful, but
+## WITHOUT ANY WARRANTY; without even the implied warranty of
+## MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+## GNU General Public License for more details.
+##
+## You should have received a copy of the GNU General Public License
+## along with Octave; see the file COPYING.  If not, see
+## <https://www.gnu.org/licenses/>.
+##
+########################################################################
+
+## Each function is evaluated once by the tree evaluator and once by
+## the bytecode interpreter and the results are compared.
+
+%!function varargout = __vm_run__ (fcn, varargin)
+%!  nout = max (nargout, 1);
+%!  old = __vm_enable__ (false);
+%!  unwind_protect
+%!    tree = cell (1, nout);
+%!    [tree{:}] = fcn (varargin{:});
+%!    __vm_enable__ (true);
+%!    vm = cell (1, nout);
+%!    [vm{:}] = fcn (varargin{:});
+%!  unwind_protect_cleanup
+%!    __vm_enable__ (old);
+%!  end_unwind_protect
+%!  assert (vm, tree);
+%!  varargout = vm;
+%!endfunction
+
+%!function r = __vm_sum__ (n)
+%!  r = 0;
+%!  for i = 1:n
+%!    if (mod (i, 3) == 0)
+%!      continue;
+%!    elseif (i > 50)
+%!      break;
+%!    endif
+%!    r += i;
+%!  endfor
+%!endfunction
+
+%!function r = __vm_fib__ (n)
+%!  if (n < 2)
+%!    r = n;
+%!  else
+%!    r = __vm_fib__ (n-1) + __vm_fib__ (n-2);
+%!  endif
+%!endfunction
+
+%!function [u, k] = __vm_stencil__ (n, tol)
+%!  u = zeros (1, n);
+%!  u(1) = 1;
+%!  u(n) = 1;
+%!  k = 0;
+%!  delta = Inf;
+%!  while (delta > tol && k < 1000)
+%!    v = u;
+%!    i = 2;
+%!    while (i < n)
+%!      v(i) = (u(i-1) + u(i+1)) / 2;
+%!      i = i + 1;
+%!    endwhile
+%!    delta = max (abs (v - u));
+%!    u = v;
+%!    k++;
+%!  endwhile
+%!endfunction
+
+%!function [x, i] = __vm_do_until__ (x)
+%!  i = 0;
+%!  do
+%!    i = i + 1;
+%!    if (i == 2)
+%!      continue;
+%!    endif
+%!    x = x * 2;
+%!  until (x > 100 || ! (i < 20))
+%!endfunction
+
+%!function r = __vm_switch__ (v)
+%!  r = {};
+%!  for x = v
+%!    switch (x)
+%!      case 3
+%!        continue;
+%!      case 5
+%!        break;
+%!      otherwise
+%!        r{end+1} = x;
+%!    endswitch
+%!  endfor
+%!endfunction
+
+%!function r = __vm_try__ (v)
+%!  r = 0;
+%!  for x = v
+%!    try
+%!      if (x < 0)
+%!        error ("negative");
+%!      endif
+%!      r = r + x;
+%!    catch
+%!      r = r - 1;
+%!      continue;
+%!    end_try_catch
+%!    r = r * 2;
+%!  endfor
+%!endfunction
+
+%!function r = __vm_return__ (v)
+%!  r = -1;
+%!  for i = 1:numel (v)
+%!    k = 1;
+%!    while (true)
+%!      if (k > i)
+%!        break;
+%!      endif
+%!      k++;
+%!    endwhile
+%!    if (v(i) == 0)
+%!      r = i;
+%!      return;
+%!    endif
+%!  endfor
+%!endfunction
+
+%!function r = __vm_loop_values__ (x)
+%!  r = {};
+%!  for c = x
+%!    r{end+1} = c;
+%!  endfor
+%!  r{end+1} = c;
+%!endfunction
+
+%!function r = __vm_colon_loop__ (base, inc, limit)
+%!  r = {};
+%!  for k = base:inc:limit
+%!    r{end+1} = k;
+%!  endfor
+%!  r{end+1} = k;
+%!endfunction
+
+%!function r = __vm_ops__ (a, b)
+%!  r = {a + b, a - b, a * b, a / b, a .* b, a ./ b, a ^ b, -a, !a, a', ...
+%!       a && b, a || b, (a > 0) & (b > 0)};
+%!endfunction
+
+%!function r = __vm_cmp__ (a, b)
+%!  r = {a < b, a <= b, a == b, a != b, a >= b, a > b};
+%!endfunction
+
+%!function __vm_nothing__ ()
+%!endfunction
+
+%!function __vm_undefined_condition__ (kind)
+%!  switch (kind)
+%!    case "if"
+%!      if (__vm_nothing__ ())
+%!      endif
+%!    case "while"
+%!      while (__vm_nothing__ ())
+%!      endwhile
+%!  endswitch
+%!endfunction
+
+%!function x = __vm_undefined_rhs__ ()
+%!  x = __vm_nothing__ ();
+%!endfunction
+
+%!assert (__vm_run__ (@__vm_sum__, 100), 867)
+%!assert (__vm_run__ (@__vm_sum__, 0), 0)
+%!assert (__vm_run__ (@__vm_fib__, 15), 610)
+
+%!test
+%! [u, k] = __vm_run__ (@__vm_stencil__, 10, 1e-3);
+%! assert (u(1), 1);
+%! assert (k > 0);
+
+%!test
+%! [x, i] = __vm_run__ (@__vm_do_until__, 1);
+%! assert ([x, i], [128, 8]);
+
+%!assert (__vm_run__ (@__vm_switch__, 1:10), {1, 2, 4})
+%!assert (__vm_run__ (@__vm_try__, [1, -2, 3]), 8)
+%!assert (__vm_run__ (@__vm_return__, [1, 2, 0, 4]), 3)
+%!assert (__vm_run__ (@__vm_return__, [1, 2]), -1)
+
+%!test
+%! __vm_run__ (@__vm_loop_values__, 1:3);
+%! __vm_run__ (@__vm_loop_values__, 5);
+%! __vm_run__ (@__vm_loop_values__, [1, 2; 3, 4]);
+%! __vm_run__ (@__vm_loop_values__, {1, "a"});
+%! __vm_run__ (@__vm_loop_values__, "abc");
+%! __vm_run__ (@__vm_loop_values__, zeros (0, 3));
+%! __vm_run__ (@__vm_loop_values__, zeros (2, 2, 2));
+%! __vm_run__ (@__vm_loop_values__, [true, false]);
+%! __vm_run__ (@__vm_colon_loop__, 1, 2, 7);
+%! __vm_run__ (@__vm_colon_loop__, int8 (100), -30, -100);
+%! __vm_run__ (@__vm_colon_loop__, uint16 (3), 1, 1);
+%! __vm_run__ (@__vm_colon_loop__, single (1), 0.25, 2);
+
+%!test
+%! __vm_run__ (@__vm_ops__, 3, 4);
+%! __vm_run__ (@__vm_ops__, 0, -2.5);
+%! __vm_run__ (@__vm_ops__, int8 (7), 2);
+%! __vm_run__ (@__vm_ops__, single (1.5), 2);
+%! __vm_run__ (@__vm_ops__, 1+2i, 3);
+%! __vm_run__ (@__vm_cmp__, 3, 4);
+%! __vm_run__ (@__vm_cmp__, NaN, NaN);
+%! __vm_run__ (@__vm_cmp__, -Inf, Inf);
+%! __vm_run__ (@__vm_cmp__, int8 (7), 7);
+
+%!assert (__vm_compile__ ("__vm_sum__"))
+%!assert (__vm_compile__ ("__vm_switch__"))
+
+%!test
+%! old = __vm_enable__ (true);
+%! unwind_protect
+%!   fail ('__vm_undefined_condition__ ("if")',
+%!         "if: undefined value used in conditional expression");
+%!   fail ('__vm_undefined_condition__ ("while")',
+%!         "while: undefined value used in conditional expression");
+%!   fail ("__vm_undefined_rhs__ ()",
+%!         "value on right hand side of assignment is undefined");
+%!   fail ("__vm_loop_values__ (@sin)",
+%!         "invalid type in for loop expression");
+%! unwind_protect_cleanup
+%!   __vm_enable__ (old);
+%! end_unwind_protect
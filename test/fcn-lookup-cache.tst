@@ -0,0 +1,76 @@
+########################################################################
+##
+## Copyright (C) 2024 The Octave Project Developers
+##
+## See the file COPYRIGHT.md in the top-level directory of this
+## distribution or <https://octave.org/copyright/>.
+##
+## This file is part of Octave.
+##
+## Octave is free software: you can redistribute it and/or modify it
+## under the terms of the GNU General Public License as published by
+## the Free Software Foundation, either version 3 of the License, or
+## (at your option) any later version.
+##
+## Octave is distributed in the hope that it will be useful, but
+## WITHOUT ANY WARRANTY; without even the implied warranty of
+## MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+## GNU General Public License for more details.
+##
+## You should have received a copy of the GNU General Public License
+## along with Octave; see the file COPYING.  If not, see
+## <https://www.gnu.org/licenses/>.
+##
+########################################################################
+
+## Each call site caches the function it found.  Check that the cached
+## function is discarded when the function it refers to changes.
+
+%!function r = __flc_call__ ()
+%!  r = __flc_fcn__ ();
+%!endfunction
+
+%!function r = __flc_length__ (x)
+%!  r = length (x);
+%!endfunction
+
+%!function __flc_write__ (file, val)
+%!  fid = fopen (file, "wt");
+%!  fprintf (fid, "function r = __flc_fcn__ ()\n  r = %d;\nendfunction\n", val);
+%!  fclose (fid);
+%!endfunction
+
+%!test
+%! tmp_dir = tempname ();
+%! mkdir (tmp_dir);
+%! file = fullfile (tmp_dir, "__flc_fcn__.m");
+%! unwind_protect
+%!   __flc_write__ (file, 1);
+%!   addpath (tmp_dir);
+%!   assert (__flc_call__ (), 1);
+%!   assert (__flc_call__ (), 1);
+%!   __flc_write__ (file, 2);
+%!   clear __flc_fcn__;
+%!   assert (__flc_call__ (), 2);
+%!   rmpath (tmp_dir);
+%!   fail ("__flc_call__ ()", "'__flc_fcn__' undefined");
+%! unwind_protect_cleanup
+%!   if (any (strcmp (tmp_dir, strsplit (path (), pathsep ()))))
+%!     rmpath (tmp_dir);
+%!   endif
+%!   confirm_recursive_rmdir (false, "local");
+%!   sts = rmdir (tmp_dir, "s");
+%! end_unwind_protect
+
+%!test
+%! m = containers.Map ({"a", "b"}, {1, 2});
+%! for cache = [true, false]
+%!   old = __fcn_lookup_cache__ (cache);
+%!   unwind_protect
+%!     assert (__flc_length__ (1:5), 5);
+%!     assert (__flc_length__ (m), 2);
+%!     assert (__flc_length__ ("abc"), 3);
+%!   unwind_protect_cleanup
+%!     __fcn_lookup_cache__ (old);
+%!   end_unwind_protect
+%! endfor
@@ -130,6 +130,58 @@
 %! __printf_assert__ ("\n");
 %! assert (__prog_output_assert__ ("1234"));
 
+%!test
+%! y = zeros (1, 10);
+%! s = 0;
+%! p = 1;
+%! parfor (i = 1:10, 4)
+%!   t = i^2;
+%!   y(i) = t;
+%!   s += t;
+%!   p = p * 2;
+%! endparfor
+%! assert (y, (1:10).^2);
+%! assert (s, sum ((1:10).^2));
+%! assert (p, 2^10);
+%! assert (i, 10);
+
+%!test
+%! A = magic (4);
+%! B = zeros (4);
+%! parfor (k = 1:4, Inf)
+%!   B(:,k) = 2 * A(:,k);
+%! endparfor
+%! assert (B, 2*A);
+
+## loop-carried dependency, executed serially
+%!test
+%! x = 1;
+%! parfor (i = 2:5, 2)
+%!   x(i) = x(i-1) + 1;
+%! endparfor
+%! assert (x, 1:5);
+
+## workers draw from differently seeded generators
+%!test
+%! r = zeros (1, 2);
+%! parfor (i = 1:2, 2)
+%!   r(i) = rand ();
+%! endparfor
+%! assert (r(1) != r(2));
+%! parfor (i = 1:2, 2)
+%!   r(i) = randn ();
+%! endparfor
+%! assert (r(1) != r(2));
+
+%!error <parfor worker error>
+%! parfor (i = 1:4, 2)
+%!   error ("parfor worker error");
+%! endparfor
+
+%!error <MAXPROC must be a non-negative number>
+%! parfor (i = 1:4, -1)
+%! endparfor
+
 %!test <*55622>
 %! cnt = 0;
 %! for k = zeros (0,3)
@@ -246,3 +298,93 @@
 %!   endif
 %! endfor
 %! assert (i, zeros (1,0));
+
+## The same operator expression evaluated with operands of different types
+%!test
+%! vals = {1, int8(100), single(2.5), true, 1+2i, [1, 2], "a", int8(100), 3};
+%! r = cell (size (vals));
+%! for i = 1:numel (vals)
+%!   r{i} = vals{i} + vals{i};
+%!   s{i} = vals{i}' * vals{i};
+%! endfor
+%! assert (r, {2, int8(127), single(5), 2, 2+4i, [2, 4], 194, int8(127), 6});
+%! assert (s{5}, 5);
+%! assert (s{6}, [1, 2; 2, 4]);
+%! assert (s{9}, 9);
+
+## Integer and single precision ranges are not stored as arrays
+%!test
+%! r = zeros (1, 0, "int8");
+%! for k = int8 (-128):int8 (60):int8 (127)
+%!   r(end+1) = k;
+%!   assert (class (k), "int8");
+%! endfor
+%! assert (r, int8 (-128):int8 (60):int8 (127));
+%! assert (k, int8 (112));
+
+%!test
+%! r = zeros (1, 0, "uint64");
+%! for k = intmax ("uint64"):-3:intmax ("uint64")-10
+%!   r(end+1) = k;
+%! endfor
+%! assert (r, intmax ("uint64"):-3:intmax ("uint64")-10);
+%! r = zeros (1, 0, "int16");
+%! for k = int16 (5):-2:-5
+%!   r(end+1) = k;
+%! endfor
+%! assert (r, int16 (5):-2:-5);
+
+%!test
+%! r = zeros (1, 0, "single");
+%! for k = single (0):0.1:1
+%!   r(end+1) = k;
+%!   assert (class (k), "single");
+%! endfor
+%! assert (r, single (0):0.1:1);
+
+%!test
+%! n = 0;
+%! for k = int32 (1):int32 (1e8)
+%!   if (++n == 5)
+%!     break;
+%!   endif
+%! endfor
+%! assert (k, int32 (5));
+
+%!test
+%! for k = int32 (3):int32 (1)
+%! endfor
+%! assert (k, zeros (1, 0, "int32"));
+
+%!error <colon operator increment invalid \(not an integer\)>
+%! for k = int8 (1):1.5:100
+%! endfor
+
+%!test
+%! code = ["k = 0;                      ", ...
+%!         "for i = single (1):Inf;     ", ...
+%!         "  if (++k > 3)              ", ...
+%!         "    break;                  ", ...
+%!         "  endif                     ", ...
+%!         "endfor                      ", ...
+%!         "assert (i, single (4));     "];
+%! fail (code, "warning", "FOR loop limit is infinite");
+
+## Elements of row vectors and columns of matrices
+%!test
+%! x = single ([1, 2; 3, 4]);
+%! r = {};
+%! for c = x
+%!   r{end+1} = c;
+%! endfor
+%! assert (r, {single([1; 3]), single([2; 4])});
+%! r = {};
+%! for c = [true, false, 1+2i, 3]
+%!   r{end+1} = c;
+%! endfor
+%! assert (r, {1, 0, 1+2i, 3});
+%! r = {};
+%! for c = sparse ([1, 0, 2])
+%!   r{end+1} = c;
+%! endfor
+%! assert (r, {sparse(1), sparse(0), sparse(2)});
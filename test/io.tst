@@ -206,6 +206,25 @@
 %!
 %! assert (save_status && load_status);
 
+## Compressed elements of several megabytes, which are compressed in blocks
+%!testif HAVE_ZLIB
+%! x = reshape (1:1e6, 1e3, 1e3);
+%! y = {rand(500), "abc"; int8(x(1:700,:)), struct("z", {x(:,1:400)})};
+%! nthreads = maxNumCompThreads ();
+%! matfile = [tempname(), ".mat"];
+%! unwind_protect
+%!   for nt = unique ([1, 4])
+%!     maxNumCompThreads (nt);
+%!     save ("-v7", matfile, "x", "y");
+%!     s = load (matfile);
+%!     assert (s.x, x);
+%!     assert (s.y, y);
+%!   endfor
+%! unwind_protect_cleanup
+%!   maxNumCompThreads (nthreads);
+%!   unlink (matfile);
+%! end_unwind_protect
+
 %!testif HAVE_HDF5
 %!
 %! s8  =   int8 (fix ((2^8  - 1) * (rand (2, 2) - 0.5)));
@@ -0,0 +1,122 @@
+////////////////////////////////////////////////////////////////////////
+//
+// Copyright (C) 2024 The Octave Project Developers
+//
+// See the file COPYRIGHT.md in the top-level directory of this
+// distribution or <https://octave.org/copyright/>.
+//
+// This file is part of Octave.
+//
+// Octave is free software: you can redistribute it and/or modify it
+// under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Octave is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Octave; see the file COPYING.  If not, see
+// <https://www.gnu.org/licenses/>.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "oct.h"
+#include "interpreter.h"
+
+// Run an independent interpreter in each of N threads.  All of them
+// assign a different value to the same variable and then wait until
+// every interpreter has been created before reading it back, so the
+// interpreters are alive at the same time.
+
+DEFUN_DLD (concurrent_interpreters, args, ,
+           "R = concurrent_interpreters (N)")
+{
+  if (args.length () != 1)
+    print_usage ();
+
+  octave_idx_type n = args(0).idx_type_value ();
+
+  std::vector<double> results (n, -1);
+  std::vector<std::string> errors (n);
+
+  std::mutex mtx;
+  std::condition_variable cv;
+  octave_idx_type nready = 0;
+
+  auto run = [&] (octave_idx_type k)
+  {
+    try
+      {
+        octave::interpreter interp;
+
+        interp.initialize_history (false);
+        interp.initialize_load_path (false);
+        interp.initialize ();
+
+        int parse_status = 0;
+
+        interp.eval_string ("x = " + std::to_string (k + 1) + ";",
+                            true, parse_status);
+
+        {
+          std::unique_lock<std::mutex> lock (mtx);
+
+          if (++nready == n)
+            cv.notify_all ();
+          else
+            cv.wait (lock, [&] () { return nready == n; });
+        }
+
+        octave_value y = interp.eval_string ("x + sum (1:1000)", true,
+                                             parse_status);
+
+        results[k] = y.double_value ();
+      }
+    catch (const octave::execution_exception& ee)
+      {
+        errors[k] = ee.message ();
+      }
+    catch (const std::exception& e)
+      {
+        errors[k] = e.what ();
+      }
+
+    // Do not leave the other threads waiting if this one failed.
+    std::lock_guard<std::mutex> lock (mtx);
+
+    if (! errors[k].empty () && nready < n)
+      {
+        nready = n;
+        cv.notify_all ();
+      }
+  };
+
+  std::vector<std::thread> threads;
+
+  for (octave_idx_type k = 0; k < n; k++)
+    threads.emplace_back (run, k);
+
+  for (auto& t : threads)
+    t.join ();
+
+  for (const auto& msg : errors)
+    if (! msg.empty ())
+      error ("concurrent_interpreters: %s", msg.c_str ());
+
+  RowVector r (n);
+
+  for (octave_idx_type k = 0; k < n; k++)
+    r(k) = results[k];
+
+  return ovl (r);
+}
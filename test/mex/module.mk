@@ -1,8 +1,10 @@
 mex_TEST_FILES = \
   %reldir%/bug-54096.tst \
   %reldir%/bug-51725.tst \
+  %reldir%/concurrent-interpreters.tst \
   %reldir%/mexnumtst.tst \
-  $(MEX_TEST_SRC)
+  $(MEX_TEST_SRC) \
+  $(OCT_TEST_SRC)
 
 MEX_TEST_SRC = \
   %reldir%/bug_54096.c \
@@ -11,12 +13,25 @@ MEX_TEST_SRC = \
 
 MEX_TEST_FUNCTIONS = $(MEX_TEST_SRC:%.c=%.mex)
 
+OCT_TEST_SRC = \
+  %reldir%/concurrent_interpreters.cc
+
+OCT_TEST_FUNCTIONS = $(OCT_TEST_SRC:%.cc=%.oct)
+
 ## Since these definitions for MKOCTFILE and MKMEXFILE are only used
 ## here, defining them in this file is probably OK.  If they are ever
 ## used elsewhere, maybe then they could be moved to build-aux/module.mk
-## or the main Makefile.am file.  The MKOCTFILE variables are included
-## for completeness, in case we someday want to test building .oct
-## files as well.
+## or the main Makefile.am file.
+
+AM_V_mkoctfile = $(am__v_mkoctfile_@AM_V@)
+am__v_mkoctfile_ = $(am__v_mkoctfile_@AM_DEFAULT_V@)
+am__v_mkoctfile_0 = @echo "  MKOCTFILE     " $@;
+am__v_mkoctfile_1 =
+
+AM_VOPT_mkoctfile = $(am__vopt_mkoctfile_@AM_V@)
+am__vopt_mkoctfile_ = $(am__vopt_mkoctfile_@AM_DEFAULT_V@)
+am__vopt_mkoctfile_0 =
+am__vopt_mkoctfile_1 = -v
 
 AM_V_mkmexfile = $(am__v_mkmexfile_@AM_V@)
 am__v_mkmexfile_ = $(am__v_mkmexfile_@AM_DEFAULT_V@)
@@ -28,9 +43,18 @@ am__vopt_mkmexfile_ = $(am__vopt_mkmexfile_@AM_DEFAULT_V@)
 am__vopt_mkmexfile_0 =
 am__vopt_mkmexfile_1 = -v
 
-## And probably many others...
 MKOCTFILECPPFLAGS = \
   -I$(top_builddir) \
+  -I$(top_builddir)/liboctave -I$(top_srcdir)/liboctave \
+  -I$(top_srcdir)/liboctave/array \
+  -I$(top_builddir)/liboctave/numeric -I$(top_srcdir)/liboctave/numeric \
+  -I$(top_builddir)/liboctave/operators -I$(top_srcdir)/liboctave/operators \
+  -I$(top_srcdir)/liboctave/system \
+  -I$(top_srcdir)/liboctave/util \
+  -I$(top_srcdir)/libinterp/octave-value \
+  -I$(top_builddir)/libinterp -I$(top_srcdir)/libinterp \
+  -I$(top_srcdir)/libinterp/operators \
+  -I$(top_builddir)/libinterp/parse-tree -I$(top_srcdir)/libinterp/parse-tree \
   -I$(top_srcdir)/libinterp/corefcn \
   -I$(top_builddir)/libinterp/corefcn
 MKOCTFILELDFLAGS = \
@@ -58,6 +82,9 @@ MKMEXFILE = \
 $(MEX_TEST_FUNCTIONS) : %.mex : %.c | %reldir%/$(octave_dirstamp)
 	$(AM_V_mkmexfile)$(MKMEXFILE) $(AM_VOPT_mkmexfile) $< -o $@ || rm -f $@
 
+$(OCT_TEST_FUNCTIONS) : %.oct : %.cc | %reldir%/$(octave_dirstamp)
+	$(AM_V_mkoctfile)$(MKOCTFILE) $(AM_VOPT_mkoctfile) $< -o $@ || rm -f $@
+
 DIRSTAMP_FILES += %reldir%/$(octave_dirstamp)
 
 ## Until we decide how to handle installing the executable MEX files,